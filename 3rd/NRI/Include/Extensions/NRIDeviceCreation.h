@@ -10,6 +10,7 @@ NriEnum(Message, uint8_t,
     ERROR // "wingdi.h" must not be included after
 );
 
+// NONE and Validation objects are sub-allocated from 64 KB slabs, other backends allocate every object separately
 NriStruct(AllocationCallbacks) {
     void* (*Allocate)(void* userArg, size_t size, size_t alignment);
     void* (*Reallocate)(void* userArg, void* memory, size_t size, size_t alignment);
@@ -32,6 +33,23 @@ NriStruct(VKBindingOffsets) {
     uint32_t storageTextureAndBufferOffset;
 };
 
+// Expensive per-element checks of NRI validation (cheap state-machine checks are always on)
+NriBits(ValidationBits, uint8_t,
+    NONE                            = 0,
+    BARRIERS                        = NriBit(0),  // usage and layout of every barrier in "CmdBarrier"
+    DESCRIPTORS                     = NriBit(1),  // every descriptor in "UpdateDescriptorRanges" and "UpdateDynamicConstantBuffers"
+    MEMORY_BINDINGS                 = NriBit(2),  // requirements of every binding in "Bind[Buffer/Texture/AccelerationStructure]Memory"
+    ALL                             = NriMember(ValidationBits, BARRIERS) |
+                                      NriMember(ValidationBits, DESCRIPTORS) |
+                                      NriMember(ValidationBits, MEMORY_BINDINGS)
+);
+
+// Tuning of NRI validation, zero-initialized means "all checks on every call"
+NriStruct(ValidationDesc) {
+    NriOptional Nri(ValidationBits) disabledChecks;
+    NriOptional uint32_t expensiveCheckPeriod;  // if > 1, enabled expensive checks are sampled on every Nth call of each category
+};
+
 NriStruct(VKExtensions) {
     const char* const* instanceExtensions;
     uint32_t instanceExtensionNum;
@@ -64,10 +82,14 @@ NriStruct(DeviceCreationDesc) {
     Nri(VKBindingOffsets) vkBindingOffsets;
     NriOptional Nri(VKExtensions) vkExtensions;
 
+    // NRI validation specific
+    NriOptional Nri(ValidationDesc) validationDesc;
+
     // Switches (disabled by default)
     bool enableNRIValidation;
     bool enableGraphicsAPIValidation;
     bool enableD3D11CommandBufferEmulation;     // enable? but why? (auto-enabled if deferred contexts are not supported)
+    bool enableNONEHostMemory;                  // NONE: buffers, textures and memory are host allocations, copies are executed on the CPU at submit, fences are real counters, descriptor pools track occupancy, upload texture alignments are D3D12 ones
 
     // Switches (enabled by default)
     bool disableVKRayTracing;                   // to save CPU memory in some implementations
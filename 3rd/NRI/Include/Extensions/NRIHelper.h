@@ -4,6 +4,14 @@
 
 NriNamespaceBegin
 
+NriForwardStruct(DataUploader);
+NriForwardStruct(Defragmenter);
+NriForwardStruct(TransientPool);
+NriForwardStruct(MemoryBudget);
+NriForwardStruct(BindlessTable);
+NriForwardStruct(DescriptorSetCache);
+NriForwardStruct(PipelineCache);
+
 NriStruct(VideoMemoryInfo) {
     uint64_t budgetSize;    // the OS-provided video memory budget. If "usageSize" > "budgetSize", the application may incur stuttering or performance penalties
     uint64_t usageSize;     // specifies the application’s current video memory usage
@@ -31,6 +39,17 @@ NriStruct(BufferUploadDesc) {
     Nri(AccessStage) after;
 };
 
+NriStruct(DataUploaderDesc) {
+    NriOptional uint64_t stagingBufferSize; // bigger uploads are split into pieces (but a texture subresource is never split), 1 Mb if 0
+    NriOptional uint32_t uploadMaxNum;      // pieces in flight, the next piece is filled while the GPU copies previous ones, 4 if 0
+};
+
+// An upload is complete once "fence" reaches "value"
+NriStruct(UploadTicket) {
+    NriPtr(Fence) fence;
+    uint64_t value;
+};
+
 NriStruct(ResourceGroupDesc) {
     Nri(MemoryLocation) memoryLocation;
     NriPtr(Texture) const* textures;
@@ -38,6 +57,117 @@ NriStruct(ResourceGroupDesc) {
     NriPtr(Buffer) const* buffers;
     uint32_t bufferNum;
     uint64_t preferredMemorySize; // desired chunk size (but can be greater if a resource doesn't fit), 256 Mb if 0
+    bool enableBestFitPacking; // sort by memory type, alignment and size, then pack best-fit-decreasing (fewer and tighter allocations, but slower and in-memory order is not preserved)
+};
+
+NriStruct(DefragmenterDesc) {
+    NriPtr(Fence) fence; // signaled by the application after "CmdDefragment" work, moved-out resources and emptied memory are retired once it passes
+};
+
+// A live resource moved into another memory: "dst" resource is created by the defragmenter and must replace "src" in the application
+NriStruct(DefragmentationMove) {
+    NriPtr(Buffer) srcBuffer; // or "srcTexture"
+    NriPtr(Texture) srcTexture;
+    NriPtr(Buffer) dstBuffer; // or "dstTexture"
+    NriPtr(Texture) dstTexture;
+    NriPtr(Memory) srcMemory;
+    NriPtr(Memory) dstMemory;
+    uint64_t srcOffset;
+    uint64_t dstOffset;
+    uint64_t size;
+};
+
+// A resource used only by passes "[firstPass; lastPass]" of a frame. Resources with disjoint lifetimes may share memory
+NriStruct(TransientResourceDesc) {
+    NriPtr(Buffer) buffer; // or "texture", created but not bound to memory
+    NriPtr(Texture) texture;
+    Nri(AccessLayoutStage) firstUse; // "layout" is ignored for buffers
+    Nri(AccessLayoutStage) lastUse;
+    uint32_t firstPass;
+    uint32_t lastPass;
+};
+
+NriStruct(TransientPoolDesc) {
+    const NriPtr(TransientResourceDesc) resources;
+    uint32_t resourceNum;
+    Nri(MemoryLocation) memoryLocation;
+};
+
+NriStruct(TransientPoolStats) {
+    uint64_t memorySize;    // allocated memory
+    uint64_t livePeakSize;  // the lower bound: max total size of resources alive within a pass
+    uint64_t unaliasedSize; // memory needed without aliasing
+    uint32_t memoryNum;
+};
+
+// "EvictMemory" is called for eviction candidates (lowest priority first, then least recently used). Return "true" if resources placed in "memory" are going
+// to be destroyed and "memory" freed via "FreeBudgetedMemory" (memory stays committed until then), or "false" to keep it (for example, if it's still in use by the GPU)
+NriStruct(MemoryBudgetDesc) {
+    bool (*EvictMemory)(NriPtr(Memory) memory, void* userArg);
+    void* userArg;
+    NriOptional uint64_t localBudgetSize;       // if not 0, overrides the OS-provided budget for "DEVICE" and "DEVICE_UPLOAD" (needed on NONE with host memory, where budget is unknown)
+    NriOptional uint64_t nonLocalBudgetSize;    // if not 0, overrides the OS-provided budget for "HOST_UPLOAD" and "HOST_READBACK"
+};
+
+NriStruct(MemoryBudgetStats) {
+    uint64_t committedSize;     // allocated via the budget manager for the memory location
+    uint64_t budgetSize;        // of the memory segment (local or non-local) the memory location belongs to, 0 if unknown (not enforced)
+    uint64_t usageSize;         // of the memory segment, including allocations made outside of the budget manager
+    uint64_t headroomSize;      // "budgetSize - usageSize", 0 if over budget or unknown
+    uint64_t evictedSize;       // accepted evictions, total
+    uint32_t rejectedNum;       // allocations rejected over budget, total
+};
+
+// A descriptor set with one big range, whose elements are addressed by indices stable for the lifetime of a resource
+NriStruct(BindlessTableDesc) {
+    const NriPtr(PipelineLayout) pipelineLayout;
+    NriPtr(Fence) fence;                    // freed indices are reused once it reaches "fenceValue" passed to "FreeBindlessIndices"
+    uint32_t setIndex;                      // the set must have a single range, usually with "PARTIALLY_BOUND" and "VARIABLE_SIZED_ARRAY" flags
+    uint32_t descriptorNum;                 // must not exceed "descriptorNum" of the range
+    Nri(DescriptorType) descriptorType;     // of the range
+};
+
+NriStruct(BindlessWriteDesc) {
+    const NriPtr(Descriptor) descriptor;
+    uint32_t index;
+};
+
+// Descriptor sets written once and reused while the same descriptors are requested. The pool can't free individual sets, so when it's full
+// the least recently used set of the same pipeline layout and set index is rewritten instead (eviction). If there is no such set or it's
+// still in use by the GPU, another pool is added
+NriStruct(DescriptorSetCacheDesc) {
+    Nri(DescriptorPoolDesc) descriptorPoolDesc; // of each pool, "descriptorSetMaxNum" and descriptor maximums define when eviction starts
+    NriPtr(Fence) fence;                        // a set is evicted only once it reaches "fenceValue" of the last "GetCachedDescriptorSet" returning the set
+};
+
+// The key. "ranges" and "dynamicConstantBuffers" are compared by descriptor pointers, so they must be specified in the same order to hit
+NriStruct(CachedDescriptorSetDesc) {
+    const NriPtr(PipelineLayout) pipelineLayout;
+    const NriPtr(DescriptorRangeUpdateDesc) ranges;     // written as "UpdateDescriptorRanges(set, 0, rangeNum, ranges)" on a miss
+    NriOptional const NriPtr(Descriptor) const* dynamicConstantBuffers; // written as "UpdateDynamicConstantBuffers(set, 0, dynamicConstantBufferNum, dynamicConstantBuffers)"
+    uint32_t rangeNum;
+    NriOptional uint32_t dynamicConstantBufferNum;
+    uint32_t setIndex;
+};
+
+NriStruct(DescriptorSetCacheStats) {
+    uint64_t hitNum;
+    uint64_t missNum;
+    uint64_t evictionNum;   // misses served by rewriting an evicted set
+    uint32_t setNum;        // allocated from the pools
+    uint32_t descriptorPoolNum;
+};
+
+// Pipelines deduplicated by content: the key is built from all members of the desc, shaders are compared by bytecode
+NriStruct(PipelineCacheDesc) {
+    NriOptional const void* data;   // previously saved "GetPipelineCacheData" output, merged into the native pipeline cache of the device
+    NriOptional uint64_t dataSize;
+};
+
+NriStruct(PipelineCacheStats) {
+    uint64_t hitNum;
+    uint64_t missNum;
+    uint32_t pipelineNum;   // created by the cache
 };
 
 NriStruct(FormatProps) {
@@ -73,11 +203,98 @@ NriStruct(HelperInterface) {
     Nri(Result) (NRI_CALL *UploadData)                  (NriRef(Queue) queue, const NriPtr(TextureUploadDesc) textureUploadDescs, uint32_t textureUploadDescNum,
                                                             const NriPtr(BufferUploadDesc) bufferUploadDescs, uint32_t bufferUploadDescNum);
 
+    // Asynchronous version of "UploadData", reusing staging memory and command buffers across calls. Not thread safe
+    // Data can be released right after the call, but resources must not be used before the ticket is reached (poll it with "GetFenceValue" or "Wait" for it)
+    Nri(Result) (NRI_CALL *CreateDataUploader)          (NriRef(Queue) queue, const NriRef(DataUploaderDesc) dataUploaderDesc, NriOut NriRef(DataUploader*) dataUploader);
+    void        (NRI_CALL *DestroyDataUploader)         (NriRef(DataUploader) dataUploader); // waits for uploads in flight
+    Nri(Result) (NRI_CALL *UploadDataAsync)             (NriRef(DataUploader) dataUploader, const NriPtr(TextureUploadDesc) textureUploadDescs, uint32_t textureUploadDescNum,
+                                                            const NriPtr(BufferUploadDesc) bufferUploadDescs, uint32_t bufferUploadDescNum, NriOut NriRef(UploadTicket) uploadTicket);
+
+    // Incremental defragmentation of memory, which is owned by the defragmenter. Not thread safe. Per frame:
+    //  - "BeginDefragmentation": retires completed moves, plans new ones within the byte budget and creates destination resources
+    //    (memory with moves out of it in flight is not a destination until "fence" passes them)
+    //  - "CmdDefragment": records copies (sources must be in "COPY_SOURCE" state, destinations are left in "COPY_DESTINATION" state)
+    //  - submit, signal "DefragmenterDesc::fence" with "fenceValue" and replace "src" resources with "dst" ones (the defragmenter destroys "src" resources)
+    Nri(Result) (NRI_CALL *CreateDefragmenter)                      (NriRef(Device) device, const NriRef(DefragmenterDesc) defragmenterDesc, NriOut NriRef(Defragmenter*) defragmenter);
+    void        (NRI_CALL *DestroyDefragmenter)                     (NriRef(Defragmenter) defragmenter); // GPU must be idle, tracked resources must be destroyed before
+    Nri(Result) (NRI_CALL *AllocateAndBindDefragmentableMemory)     (NriRef(Defragmenter) defragmenter, const NriRef(ResourceGroupDesc) resourceGroupDesc);
+    void        (NRI_CALL *ReleaseDefragmentableResources)          (NriRef(Defragmenter) defragmenter, NriPtr(Buffer) const* buffers, uint32_t bufferNum, NriPtr(Texture) const* textures, uint32_t textureNum); // before destruction, emptied memory is freed in "BeginDefragmentation"
+    const NriPtr(DefragmentationMove) (NRI_CALL *BeginDefragmentation) (NriRef(Defragmenter) defragmenter, uint64_t byteBudget, uint64_t fenceValue, NriOut NonNriRef(uint32_t) moveNum);
+    void        (NRI_CALL *CmdDefragment)                           (NriRef(CommandBuffer) commandBuffer, NriRef(Defragmenter) defragmenter);
+
+    // Transient resources aliased in memory by lifetime. Resources must be destroyed before the pool
+    // "GetTransientPoolBarriers" returns barriers from "UNKNOWN" to "firstUse" for resources starting at "pass" (previous contents are discarded), to be issued before the pass
+    Nri(Result) (NRI_CALL *CreateTransientPool)                     (NriRef(Device) device, const NriRef(TransientPoolDesc) transientPoolDesc, NriOut NriRef(TransientPool*) transientPool);
+    void        (NRI_CALL *DestroyTransientPool)                    (NriRef(TransientPool) transientPool);
+    void        (NRI_CALL *GetTransientPoolBarriers)                (const NriRef(TransientPool) transientPool, uint32_t pass, NriOut NriRef(BarrierGroupDesc) barrierGroupDesc);
+    void        (NRI_CALL *GetTransientPoolStats)                   (const NriRef(TransientPool) transientPool, NriOut NriRef(TransientPoolStats) transientPoolStats);
+
+    // Memory budget manager, tracking committed memory per memory location. Not thread safe. On NONE works only if "enableNONEHostMemory" is set,
+    // otherwise it's a dummy: allocations succeed, but nothing is tracked or evicted and stats are zeros
+    //  - "AllocateBudgetedMemory": if doesn't fit, evicts memory of lower or equal priority, returns "OUT_OF_MEMORY" if still doesn't fit (defer and retry later)
+    //  - "TouchBudgetedMemory": marks memory as used in the current frame
+    //  - "UpdateMemoryBudget": once per frame, queries budgets, advances the frame and evicts if over budget (budget can shrink)
+    Nri(Result) (NRI_CALL *CreateMemoryBudget)                      (NriRef(Device) device, const NriRef(MemoryBudgetDesc) memoryBudgetDesc, NriOut NriRef(MemoryBudget*) memoryBudget);
+    void        (NRI_CALL *DestroyMemoryBudget)                     (NriRef(MemoryBudget) memoryBudget); // frees memory still tracked
+    Nri(Result) (NRI_CALL *AllocateBudgetedMemory)                  (NriRef(MemoryBudget) memoryBudget, const NriRef(AllocateMemoryDesc) allocateMemoryDesc, Nri(MemoryLocation) memoryLocation, NriOut NriRef(Memory*) memory);
+    void        (NRI_CALL *FreeBudgetedMemory)                      (NriRef(MemoryBudget) memoryBudget, NriRef(Memory) memory);
+    void        (NRI_CALL *TouchBudgetedMemory)                     (NriRef(MemoryBudget) memoryBudget, NriPtr(Memory) const* memories, uint32_t memoryNum);
+    void        (NRI_CALL *UpdateMemoryBudget)                      (NriRef(MemoryBudget) memoryBudget);
+    void        (NRI_CALL *GetMemoryBudgetStats)                    (const NriRef(MemoryBudget) memoryBudget, Nri(MemoryLocation) memoryLocation, NriOut NriRef(MemoryBudgetStats) memoryBudgetStats);
+
+    // Bindless table. Thread safe, except "UpdateBindlessTable" and "DestroyBindlessTable", which must not run concurrently with other calls
+    //  - "AllocateBindlessIndices": all or nothing, returns "OUT_OF_MEMORY" only if fewer than "indexNum" indices are free
+    //  - "FreeBindlessIndices": indices are reused once "BindlessTableDesc::fence" reaches "fenceValue" (the last frame, which can use them)
+    //  - "WriteBindlessDescriptors": writes are queued, the last write to an index wins
+    //  - "UpdateBindlessTable": once per frame before recording, reclaims freed indices and applies queued writes (consecutive indices are coalesced)
+    Nri(Result) (NRI_CALL *CreateBindlessTable)                     (NriRef(Device) device, const NriRef(BindlessTableDesc) bindlessTableDesc, NriOut NriRef(BindlessTable*) bindlessTable);
+    void        (NRI_CALL *DestroyBindlessTable)                    (NriRef(BindlessTable) bindlessTable);
+    Nri(Result) (NRI_CALL *AllocateBindlessIndices)                 (NriRef(BindlessTable) bindlessTable, NriOut uint32_t* indices, uint32_t indexNum);
+    void        (NRI_CALL *FreeBindlessIndices)                     (NriRef(BindlessTable) bindlessTable, const uint32_t* indices, uint32_t indexNum, uint64_t fenceValue);
+    void        (NRI_CALL *WriteBindlessDescriptors)                (NriRef(BindlessTable) bindlessTable, const NriPtr(BindlessWriteDesc) bindlessWriteDescs, uint32_t bindlessWriteDescNum);
+    void        (NRI_CALL *UpdateBindlessTable)                     (NriRef(BindlessTable) bindlessTable);
+    NriPtr(DescriptorSet) (NRI_CALL *GetBindlessTableDescriptorSet) (const NriRef(BindlessTable) bindlessTable);
+
+    // Descriptor set cache. Thread safe, except "DestroyDescriptorSetCache"
+    //  - "GetCachedDescriptorSet": returns an already written set on a hit. On a miss, a new set is allocated and written or, if the pool is full, an evicted one
+    //    is rewritten. If all sets of the same pipeline layout and set index are still in use by the GPU, a new pool is added
+    //  - "fenceValue": "DescriptorSetCacheDesc::fence" reaches it once the GPU is done with the returned set (usually the value signaled at the end of the frame)
+    //  - "PurgeCachedDescriptorSets": sets are keyed by descriptor pointers, which can be reused by new descriptors. Must be called before destroying
+    //    descriptors, which have been passed to "GetCachedDescriptorSet", otherwise a new descriptor at the same address hits a set with the destroyed one
+    //  - sets with "VARIABLE_SIZED_ARRAY" ranges are not supported (use "BindlessTable")
+    Nri(Result) (NRI_CALL *CreateDescriptorSetCache)                (NriRef(Device) device, const NriRef(DescriptorSetCacheDesc) descriptorSetCacheDesc, NriOut NriRef(DescriptorSetCache*) descriptorSetCache);
+    void        (NRI_CALL *DestroyDescriptorSetCache)               (NriRef(DescriptorSetCache) descriptorSetCache);
+    Nri(Result) (NRI_CALL *GetCachedDescriptorSet)                  (NriRef(DescriptorSetCache) descriptorSetCache, const NriRef(CachedDescriptorSetDesc) cachedDescriptorSetDesc, uint64_t fenceValue, NriOut NriRef(DescriptorSet*) descriptorSet);
+    void        (NRI_CALL *PurgeCachedDescriptorSets)               (NriRef(DescriptorSetCache) descriptorSetCache, const NriPtr(Descriptor) const* descriptors, uint32_t descriptorNum);
+    void        (NRI_CALL *GetDescriptorSetCacheStats)              (const NriRef(DescriptorSetCache) descriptorSetCache, NriOut NriRef(DescriptorSetCacheStats) descriptorSetCacheStats);
+
+    // Pipeline cache. Thread safe, except "DestroyPipelineCache"
+    //  - "GetCachedGraphicsPipeline" and "GetCachedComputePipeline": return an already created pipeline on a hit (identical desc and shader bytecode),
+    //    otherwise create it. Returned pipelines are owned by the cache and destroyed with it
+    //  - different pipelines are created in parallel, concurrent requests of a pipeline being created wait for it (counted as hits)
+    //  - failed creations are not cached, the next request retries (concurrent requests waiting for it get the error)
+    //  - "PurgeCachedPipelines": pipelines are keyed by the pipeline layout pointer, which can be reused by a new layout. Must be called before destroying
+    //    a pipeline layout, which has been passed to "GetCachedGraphicsPipeline" or "GetCachedComputePipeline", otherwise a new layout at the same address
+    //    hits a pipeline created with the destroyed one. Destroys pipelines created with the layout, they must not be in use by the GPU. Must not run
+    //    concurrently with requests using the layout
+    Nri(Result) (NRI_CALL *CreatePipelineCache)                     (NriRef(Device) device, const NriRef(PipelineCacheDesc) pipelineCacheDesc, NriOut NriRef(PipelineCache*) pipelineCache);
+    void        (NRI_CALL *DestroyPipelineCache)                    (NriRef(PipelineCache) pipelineCache);
+    Nri(Result) (NRI_CALL *GetCachedGraphicsPipeline)               (NriRef(PipelineCache) pipelineCache, const NriRef(GraphicsPipelineDesc) graphicsPipelineDesc, NriOut NriRef(Pipeline*) pipeline);
+    Nri(Result) (NRI_CALL *GetCachedComputePipeline)                (NriRef(PipelineCache) pipelineCache, const NriRef(ComputePipelineDesc) computePipelineDesc, NriOut NriRef(Pipeline*) pipeline);
+    void        (NRI_CALL *PurgeCachedPipelines)                    (NriRef(PipelineCache) pipelineCache, const NriRef(PipelineLayout) pipelineLayout);
+    void        (NRI_CALL *GetPipelineCacheStats)                   (const NriRef(PipelineCache) pipelineCache, NriOut NriRef(PipelineCacheStats) pipelineCacheStats);
+
     // WFI
     Nri(Result) (NRI_CALL *WaitForIdle)                 (NriRef(Queue) queue);
 
     // Information about video memory
     Nri(Result) (NRI_CALL *QueryVideoMemoryInfo)        (const NriRef(Device) device, Nri(MemoryLocation) memoryLocation, NriOut NriRef(VideoMemoryInfo) videoMemoryInfo);
+
+    // Native pipeline cache of the device (VK only, D3D drivers cache pipelines on their own, "UNSUPPORTED" is returned)
+    //  - "MergePipelineCacheData": merges data saved by "GetPipelineCacheData" (incompatible data is ignored), must not run concurrently with pipeline creation
+    //  - "GetPipelineCacheData": if "data" is NULL, returns the size. Usually saved to disk on shutdown and merged on the next run
+    Nri(Result) (NRI_CALL *MergePipelineCacheData)      (NriRef(Device) device, const void* data, uint64_t dataSize);
+    Nri(Result) (NRI_CALL *GetPipelineCacheData)        (const NriRef(Device) device, NriOptional void* data, NriOut NonNriRef(uint64_t) dataSize);
 };
 
 // Format utilities
@@ -6,20 +6,35 @@ NriNamespaceBegin
 
 NriForwardStruct(Streamer);
 
+static const uint32_t NriConstant(INVALID_CONSTANT_OFFSET) = (uint32_t)(-1); // constants can't be placed in the constant ring
+
 NriStruct(StreamerDesc) {
     // Statically allocated ring-buffer for dynamic constants
-    NriOptional Nri(MemoryLocation) constantBufferMemoryLocation; // UPLOAD or DEVICE_UPLOAD
+    NriOptional Nri(MemoryLocation) constantBufferMemoryLocation; // UPLOAD or DEVICE_UPLOAD (can be non-coherent, written ranges get flushed)
     NriOptional uint64_t constantBufferSize;
 
     // Dynamically (re)allocated ring-buffer for copying and rendering
-    Nri(MemoryLocation) dynamicBufferMemoryLocation; // UPLOAD or DEVICE_UPLOAD
+    Nri(MemoryLocation) dynamicBufferMemoryLocation; // UPLOAD or DEVICE_UPLOAD (can be non-coherent, the region of a frame gets flushed)
     Nri(BufferUsageBits) dynamicBufferUsageBits;
-    uint32_t frameInFlightNum;
+    uint32_t frameInFlightNum; // used to reclaim memory if "fence" is not provided
+
+    // If provided, memory is reclaimed as soon as the fence reaches the value set by "SetStreamerFenceValue" (instead of waiting for "frameInFlightNum" frames)
+    NriOptional NriPtr(Fence) fence;
+
+    // Shrink the dynamic buffer after this number of frames using much less memory than allocated (0 - never shrink)
+    NriOptional uint32_t shrinkFrameNum;
+
+    // Worker threads helping "CopyStreamerUpdateRequests" with big payloads (0 - copy on the calling thread only)
+    NriOptional uint32_t copyThreadNum;
+
+    // Don't copy buffer updates, which are identical (by content hash) to what the same destination range received in the previous frame
+    // Requires destinations not to be modified by other means (or recreated) between frames. Costs hashing of the data on the host
+    NriOptional bool skipUnchangedBufferUpdates;
 };
 
 NriStruct(BufferUpdateRequestDesc) {
     // Data to upload
-    const void* data; // pointer must be valid until "CopyStreamerUpdateRequests" call
+    const void* data; // pointer must be valid until "CopyStreamerUpdateRequests" call (ignored by "ReserveStreamerBufferUpdateRequest")
     uint64_t dataSize;
 
     // Destination (ignored for constants)
@@ -27,6 +42,11 @@ NriStruct(BufferUpdateRequestDesc) {
     NriOptional uint64_t dstBufferOffset;
 };
 
+NriStruct(ConstantBufferUpdateRequestDesc) {
+    const void* data;
+    uint32_t dataSize;
+};
+
 NriStruct(TextureUpdateRequestDesc) {
     // Data to upload
     const void* data; // pointer must be valid until "CopyStreamerUpdateRequests" call
@@ -38,6 +58,24 @@ NriStruct(TextureUpdateRequestDesc) {
     Nri(TextureRegionDesc) dstRegionDesc;
 };
 
+NriStruct(StreamerStats) {
+    // The last "CopyStreamerUpdateRequests"
+    uint64_t requestedSize;         // bytes requested in the dynamic buffer (including alignment)
+    uint64_t copiedSize;            // bytes copied by the host
+    uint32_t bufferRequestNum;
+    uint32_t textureRequestNum;
+    uint32_t uploadCommandNum;      // copy commands recorded by "CmdUploadStreamerUpdateRequests" (contiguous updates get merged)
+    uint32_t skippedRequestNum;     // buffer updates skipped due to unchanged content
+
+    // Lifetime
+    uint64_t peakRequestedSize;     // high-water mark of "requestedSize"
+    uint64_t inFlightSize;          // bytes occupied by frames in flight
+    uint64_t dynamicBufferSize;     // current ring capacity
+    uint32_t growNum;               // the dynamic buffer was recreated due to lack of space
+    uint32_t shrinkNum;             // the dynamic buffer was recreated to release memory
+    uint32_t garbageBufferNum;      // retired dynamic buffers waiting for the GPU
+};
+
 NriStruct(StreamerInterface) {
     Nri(Result)     (NRI_CALL *CreateStreamer)                  (NriRef(Device) device, const NriRef(StreamerDesc) streamerDesc, NriOut NriRef(Streamer*) streamer);
     void            (NRI_CALL *DestroyStreamer)                 (NriRef(Streamer) streamer);
@@ -47,15 +85,30 @@ NriStruct(StreamerInterface) {
     NriPtr(Buffer)  (NRI_CALL *GetStreamerDynamicBuffer)        (NriRef(Streamer) streamer); // Valid only after "CopyStreamerUpdateRequests"
 
     // Add an update request. Return the offset in the ring buffer and don't invoke any work
+    // Thread safe, but must not overlap with "CopyStreamerUpdateRequests". Not lock-free: producers are spread across as many locked lists
+    // as hardware threads (a thread sticks to one list), contention is possible only if there are more producers than hardware threads
     uint64_t        (NRI_CALL *AddStreamerBufferUpdateRequest)  (NriRef(Streamer) streamer, const NriRef(BufferUpdateRequestDesc) bufferUpdateRequestDesc);
     uint64_t        (NRI_CALL *AddStreamerTextureUpdateRequest) (NriRef(Streamer) streamer, const NriRef(TextureUpdateRequestDesc) textureUpdateRequestDesc);
 
+    // Add an update request, but instead of providing "data" get a pointer to write "dataSize" bytes to (write-only, valid until "CopyStreamerUpdateRequests")
+    // If possible, the pointer references the mapped dynamic buffer directly, avoiding an intermediate copy. Thread safe, "NULL" on failure
+    void*           (NRI_CALL *ReserveStreamerBufferUpdateRequest) (NriRef(Streamer) streamer, const NriRef(BufferUpdateRequestDesc) bufferUpdateRequestDesc, NriOut NonNriRef(uint64_t) offset);
+
     // (HOST) Copy data and get the offset in the dedicated ring buffer (for dynamic constant buffers)
+    // Thread safe. Data still in use by the GPU is never overwritten: if the ring is full, it waits for "StreamerDesc::fence". Returns "INVALID_CONSTANT_OFFSET"
+    // (and reports an error) if data is bigger than the ring or the ring is full of data, which can't be waited for (no fence or the current frame)
     uint32_t        (NRI_CALL *UpdateStreamerConstantBuffer)    (NriRef(Streamer) streamer, const void* data, uint32_t dataSize);
+    void            (NRI_CALL *UpdateStreamerConstantBuffers)   (NriRef(Streamer) streamer, const NriPtr(ConstantBufferUpdateRequestDesc) constantBufferUpdateRequestDescs, uint32_t constantBufferUpdateRequestDescNum, NriOut uint32_t* offsets);
+
+    // (HOST) Set the value "StreamerDesc::fence" will be signaled with once the GPU is done with data gathered by the next "CopyStreamerUpdateRequests"
+    void            (NRI_CALL *SetStreamerFenceValue)           (NriRef(Streamer) streamer, uint64_t fenceValue);
 
-    // (HOST) Copy gathered requests to the internal buffer, potentially a new one if the capacity exceeded. Must be called once per frame
+    // (HOST) Copy gathered requests to the internal buffer, potentially a new one if the capacity exceeded. Must be called once per frame. On failure nothing gets uploaded, requests stay queued for the next call
     Nri(Result)     (NRI_CALL *CopyStreamerUpdateRequests)      (NriRef(Streamer) streamer);
 
+    // Statistics, updated by "CopyStreamerUpdateRequests"
+    void            (NRI_CALL *GetStreamerStats)                (const NriRef(Streamer) streamer, NriOut NriRef(StreamerStats) streamerStats);
+
     // (DEVICE) Copy data to destinations (if any), barriers are externally controlled. Must be called after "CopyStreamerUpdateRequests"
     // WARNING: D3D12 can silently promote a resource state to COPY_DESTINATION!
     void            (NRI_CALL *CmdUploadStreamerUpdateRequests) (NriRef(CommandBuffer) commandBuffer, NriRef(Streamer) streamer);
@@ -110,6 +110,8 @@ NriStruct(CoreInterface) {
     void                (NRI_CALL *FreeMemory)                      (NriRef(Memory) memory);
 
     // Descriptor pool ("DescriptorSet" entities don't require destroying)
+    // A linear allocator: allocation bumps offsets, all sets are released at once by "ResetDescriptorPool", which must be called only after the GPU is done with them
+    // (for example, a pool per frame in flight, reset after waiting for the frame fence). Returns "OUT_OF_MEMORY" if the pool is full
     Nri(Result)         (NRI_CALL *AllocateDescriptorSets)          (NriRef(DescriptorPool) descriptorPool, const NriRef(PipelineLayout) pipelineLayout, uint32_t setIndex, NriOut NriPtr(DescriptorSet)* descriptorSets, uint32_t instanceNum, uint32_t variableDescriptorNum);
     void                (NRI_CALL *ResetDescriptorPool)             (NriRef(DescriptorPool) descriptorPool);
 
@@ -228,6 +230,9 @@ NriStruct(CoreInterface) {
     uint64_t            (NRI_CALL *GetBufferNativeObject)           (const NriRef(Buffer) buffer);               // ID3D11Buffer*                   | ID3D12Resource*             | VkBuffer
     uint64_t            (NRI_CALL *GetTextureNativeObject)          (const NriRef(Texture) texture);             // ID3D11Resource*                 | ID3D12Resource*             | VkImage
     uint64_t            (NRI_CALL *GetDescriptorNativeObject)       (const NriRef(Descriptor) descriptor);       // ID3D11View/ID3D11SamplerState*  | D3D12_CPU_DESCRIPTOR_HANDLE | VkImageView/VkBufferView/VkSampler
+
+    // Descriptor pool usage (appended, entries above keep their offsets)
+    void                (NRI_CALL *GetDescriptorPoolStats)          (const NriRef(DescriptorPool) descriptorPool, NriOut NriRef(DescriptorPoolStats) descriptorPoolStats);
 };
 
 // A friendly way to get a supported depth format
@@ -525,6 +525,16 @@ NriStruct(DescriptorPoolDesc) {
     uint32_t accelerationStructureMaxNum;
 };
 
+// Occupancy of a descriptor pool. "peak" values help to size per-frame pools
+NriStruct(DescriptorPoolStats) {
+    uint32_t descriptorSetNum;          // allocated since the last reset
+    uint32_t descriptorSetMaxNum;
+    uint32_t descriptorNum;             // of all types, allocated since the last reset
+    uint32_t descriptorMaxNum;          // 0 if unknown (a wrapped native pool)
+    uint32_t peakDescriptorSetNum;      // the highest "descriptorSetNum" since creation
+    uint32_t peakDescriptorNum;         // the highest "descriptorNum" since creation
+};
+
 #pragma endregion
 
 //============================================================================================================================================================================================
@@ -1172,6 +1182,7 @@ NriStruct(MemoryDesc) {
     uint32_t alignment;
     Nri(MemoryType) type;
     bool mustBeDedicated; // must be put into a dedicated Memory, containing only 1 object with offset = 0
+    bool isHostNonCoherent; // CPU writes become visible to the GPU only after "UnmapBuffer", which flushes the mapped range (VK only)
 };
 
 NriStruct(AllocateMemoryDesc) {
@@ -360,7 +360,9 @@ static Result EnumerateAdaptersVK(AdapterDesc* adapterDescs, uint32_t& adapterDe
 static Result FinalizeDeviceCreation(const DeviceCreationDesc& deviceCreationDesc, DeviceBase& deviceImpl, Device*& device) {
     MaybeUnused(deviceCreationDesc);
 #if NRI_ENABLE_VALIDATION_SUPPORT
-    if (deviceCreationDesc.enableNRIValidation && deviceCreationDesc.graphicsAPI != GraphicsAPI::NONE) {
+    // NONE is functional only in the host memory mode
+    bool isValidatable = deviceCreationDesc.graphicsAPI != GraphicsAPI::NONE || deviceCreationDesc.enableNONEHostMemory;
+    if (deviceCreationDesc.enableNRIValidation && isValidatable) {
         Device* deviceVal = (Device*)CreateDeviceValidation(deviceCreationDesc, deviceImpl);
         if (!deviceVal) {
             nriDestroyDevice((Device&)deviceImpl);
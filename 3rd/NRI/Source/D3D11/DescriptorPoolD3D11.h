@@ -27,11 +27,15 @@ struct DescriptorPoolD3D11 final : public DebugNameBase {
     //================================================================================================================
 
     inline void Reset() {
+        m_PeakDescriptorSetNum = std::max(m_PeakDescriptorSetNum, m_DescriptorSetIndex);
+        m_PeakDescriptorNum = std::max(m_PeakDescriptorNum, m_DescriptorPoolOffset);
+
         m_DescriptorPoolOffset = 0;
         m_DescriptorSetIndex = 0;
     }
 
     Result AllocateDescriptorSets(const PipelineLayout& pipelineLayout, uint32_t setIndex, DescriptorSet** descriptorSets, uint32_t instanceNum, uint32_t variableDescriptorNum);
+    void GetStats(DescriptorPoolStats& descriptorPoolStats);
 
 private:
     DeviceD3D11& m_Device;
@@ -39,6 +43,8 @@ private:
     Vector<const DescriptorD3D11*> m_DescriptorPool;
     uint32_t m_DescriptorPoolOffset = 0;
     uint32_t m_DescriptorSetIndex = 0;
+    uint32_t m_PeakDescriptorSetNum = 0;
+    uint32_t m_PeakDescriptorNum = 0;
 };
 
 } // namespace nri
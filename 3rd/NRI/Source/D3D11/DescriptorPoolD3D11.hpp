@@ -2,7 +2,6 @@
 
 Result DescriptorPoolD3D11::Create(const DescriptorPoolDesc& descriptorPoolDesc) {
     uint32_t descriptorNum = descriptorPoolDesc.samplerMaxNum;
-    descriptorNum += descriptorPoolDesc.samplerMaxNum;
     descriptorNum += descriptorPoolDesc.constantBufferMaxNum;
     descriptorNum += descriptorPoolDesc.dynamicConstantBufferMaxNum;
     descriptorNum += descriptorPoolDesc.textureMaxNum;
@@ -24,6 +23,11 @@ NRI_INLINE Result DescriptorPoolD3D11::AllocateDescriptorSets(const PipelineLayo
 
     const PipelineLayoutD3D11& pipelineLayoutD3D11 = (PipelineLayoutD3D11&)pipelineLayout;
 
+    // All or nothing
+    const BindingSet& bindingSet = pipelineLayoutD3D11.GetBindingSet(setIndex);
+    if (m_DescriptorSetIndex + instanceNum > m_DescriptorSets.size() || m_DescriptorPoolOffset + (uint64_t)bindingSet.descriptorNum * instanceNum > m_DescriptorPool.size())
+        return Result::OUT_OF_MEMORY;
+
     for (uint32_t i = 0; i < instanceNum; i++) {
         const DescriptorD3D11** descriptors = m_DescriptorPool.data() + m_DescriptorPoolOffset;
         DescriptorSetD3D11* descriptorSet = &m_DescriptorSets[m_DescriptorSetIndex++];
@@ -35,3 +39,15 @@ NRI_INLINE Result DescriptorPoolD3D11::AllocateDescriptorSets(const PipelineLayo
 
     return Result::SUCCESS;
 }
+
+NRI_INLINE void DescriptorPoolD3D11::GetStats(DescriptorPoolStats& descriptorPoolStats) {
+    m_PeakDescriptorSetNum = std::max(m_PeakDescriptorSetNum, m_DescriptorSetIndex);
+    m_PeakDescriptorNum = std::max(m_PeakDescriptorNum, m_DescriptorPoolOffset);
+
+    descriptorPoolStats.descriptorSetNum = m_DescriptorSetIndex;
+    descriptorPoolStats.descriptorSetMaxNum = (uint32_t)m_DescriptorSets.size();
+    descriptorPoolStats.descriptorNum = m_DescriptorPoolOffset;
+    descriptorPoolStats.descriptorMaxNum = (uint32_t)m_DescriptorPool.size();
+    descriptorPoolStats.peakDescriptorSetNum = m_PeakDescriptorSetNum;
+    descriptorPoolStats.peakDescriptorNum = m_PeakDescriptorNum;
+}
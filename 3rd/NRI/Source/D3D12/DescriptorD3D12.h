@@ -12,7 +12,8 @@ struct DescriptorD3D12 final : public DebugNameBase {
     }
 
     inline ~DescriptorD3D12() {
-        m_Device.FreeDescriptorHandle(m_HeapType, m_Handle);
+        if (m_DescriptorPointerCPU) // the handle is not allocated if "Create" has failed
+            m_Device.FreeDescriptorHandle(m_HeapType, m_Handle);
     }
 
     inline operator ID3D12Resource*() const {
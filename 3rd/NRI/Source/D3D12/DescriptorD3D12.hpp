@@ -346,7 +346,7 @@ Result DescriptorD3D12::Create(const SamplerDesc& samplerDesc) {
     if (result != Result::SUCCESS)
         return result;
 
-    m_DescriptorPointerCPU = m_Device.GetDescriptorPointerCPU(m_Handle);
+    m_DescriptorPointerCPU = m_Device.GetDescriptorPointerCPU(m_HeapType, m_Handle);
 
     bool useAnisotropy = samplerDesc.anisotropy > 1 ? true : false;
     bool useComparison = samplerDesc.compareFunc != CompareFunc::NONE;
@@ -411,7 +411,7 @@ Result DescriptorD3D12::CreateConstantBufferView(const D3D12_CONSTANT_BUFFER_VIE
 
     Result result = m_Device.GetDescriptorHandle(m_HeapType, m_Handle);
     if (result == Result::SUCCESS) {
-        m_DescriptorPointerCPU = m_Device.GetDescriptorPointerCPU(m_Handle);
+        m_DescriptorPointerCPU = m_Device.GetDescriptorPointerCPU(m_HeapType, m_Handle);
         m_Device->CreateConstantBufferView(&desc, {m_DescriptorPointerCPU});
     }
 
@@ -423,7 +423,7 @@ Result DescriptorD3D12::CreateShaderResourceView(ID3D12Resource* resource, const
 
     Result result = m_Device.GetDescriptorHandle(m_HeapType, m_Handle);
     if (result == Result::SUCCESS) {
-        m_DescriptorPointerCPU = m_Device.GetDescriptorPointerCPU(m_Handle);
+        m_DescriptorPointerCPU = m_Device.GetDescriptorPointerCPU(m_HeapType, m_Handle);
         m_Device->CreateShaderResourceView(resource, &desc, {m_DescriptorPointerCPU});
         m_Resource = resource;
     }
@@ -436,7 +436,7 @@ Result DescriptorD3D12::CreateUnorderedAccessView(ID3D12Resource* resource, cons
 
     Result result = m_Device.GetDescriptorHandle(m_HeapType, m_Handle);
     if (result == Result::SUCCESS) {
-        m_DescriptorPointerCPU = m_Device.GetDescriptorPointerCPU(m_Handle);
+        m_DescriptorPointerCPU = m_Device.GetDescriptorPointerCPU(m_HeapType, m_Handle);
         m_Device->CreateUnorderedAccessView(resource, nullptr, &desc, {m_DescriptorPointerCPU});
         m_Resource = resource;
         m_IsIntegerFormat = GetFormatProps(format).isInteger;
@@ -450,7 +450,7 @@ Result DescriptorD3D12::CreateRenderTargetView(ID3D12Resource* resource, const D
 
     Result result = m_Device.GetDescriptorHandle(m_HeapType, m_Handle);
     if (result == Result::SUCCESS) {
-        m_DescriptorPointerCPU = m_Device.GetDescriptorPointerCPU(m_Handle);
+        m_DescriptorPointerCPU = m_Device.GetDescriptorPointerCPU(m_HeapType, m_Handle);
         m_Device->CreateRenderTargetView(resource, &desc, {m_DescriptorPointerCPU});
         m_Resource = resource;
     }
@@ -463,7 +463,7 @@ Result DescriptorD3D12::CreateDepthStencilView(ID3D12Resource* resource, const D
 
     Result result = m_Device.GetDescriptorHandle(m_HeapType, m_Handle);
     if (result == Result::SUCCESS) {
-        m_DescriptorPointerCPU = m_Device.GetDescriptorPointerCPU(m_Handle);
+        m_DescriptorPointerCPU = m_Device.GetDescriptorPointerCPU(m_HeapType, m_Handle);
         m_Device->CreateDepthStencilView(resource, &desc, {m_DescriptorPointerCPU});
         m_Resource = resource;
     }
@@ -41,14 +41,18 @@ struct DescriptorPoolD3D12 final : public DebugNameBase {
 
     Result AllocateDescriptorSets(const PipelineLayout& pipelineLayout, uint32_t setIndex, DescriptorSet** descriptorSets, uint32_t instanceNum, uint32_t variableDescriptorNum);
     void Reset();
+    void GetStats(DescriptorPoolStats& descriptorPoolStats);
 
 private:
     DeviceD3D12& m_Device;
     std::array<DescriptorHeapDesc, DescriptorHeapType::MAX_NUM> m_DescriptorHeapDescs = {};
     std::array<ID3D12DescriptorHeap*, DescriptorHeapType::MAX_NUM> m_DescriptorHeaps = {};
+    std::array<uint32_t, DescriptorHeapType::MAX_NUM> m_DescriptorHeapCapacities = {};
     Vector<DescriptorSetD3D12> m_DescriptorSets;
     uint32_t m_DescriptorHeapNum = 0;
     uint32_t m_DescriptorSetNum = 0;
+    uint32_t m_PeakDescriptorSetNum = 0;
+    uint32_t m_PeakDescriptorNum = 0;
 };
 
 } // namespace nri
@@ -26,6 +26,7 @@ Result DescriptorPoolD3D12::Create(const DescriptorPoolDesc& descriptorPoolDesc)
             descriptorHeapDesc.basePointerCPU = descriptorHeap->GetCPUDescriptorHandleForHeapStart().ptr;
             descriptorHeapDesc.basePointerGPU = descriptorHeap->GetGPUDescriptorHandleForHeapStart().ptr;
             descriptorHeapDesc.descriptorSize = m_Device->GetDescriptorHandleIncrementSize((D3D12_DESCRIPTOR_HEAP_TYPE)i);
+            m_DescriptorHeapCapacities[i] = descriptorHeapSize[i];
 
             m_DescriptorHeaps[m_DescriptorHeapNum] = descriptorHeap;
             m_DescriptorHeapNum++;
@@ -57,6 +58,7 @@ Result DescriptorPoolD3D12::Create(const DescriptorPoolD3D12Desc& descriptorPool
             descriptorHeapDesc.basePointerCPU = descriptorHeaps[i]->GetCPUDescriptorHandleForHeapStart().ptr;
             descriptorHeapDesc.basePointerGPU = descriptorHeaps[i]->GetGPUDescriptorHandleForHeapStart().ptr;
             descriptorHeapDesc.descriptorSize = m_Device->GetDescriptorHandleIncrementSize(desc.Type);
+            m_DescriptorHeapCapacities[i] = desc.NumDescriptors;
 
             m_DescriptorHeaps[m_DescriptorHeapNum] = descriptorHeaps[i];
             m_DescriptorHeapNum++;
@@ -103,12 +105,18 @@ NRI_INLINE Result DescriptorPoolD3D12::AllocateDescriptorSets(const PipelineLayo
     MaybeUnused(variableDescriptorNum);
 
     if (m_DescriptorSetNum + instanceNum > m_DescriptorSets.size())
-        return Result::FAILURE;
+        return Result::OUT_OF_MEMORY;
 
     const PipelineLayoutD3D12& pipelineLayoutD3D12 = (PipelineLayoutD3D12&)pipelineLayout;
     const DescriptorSetMapping& descriptorSetMapping = pipelineLayoutD3D12.GetDescriptorSetMapping(setIndex);
     const DynamicConstantBufferMapping& dynamicConstantBufferMapping = pipelineLayoutD3D12.GetDynamicConstantBufferMapping(setIndex);
 
+    // All or nothing, otherwise offsets would run past the end of the heaps
+    for (uint32_t i = 0; i < DescriptorHeapType::MAX_NUM; i++) {
+        if (m_DescriptorHeapDescs[i].num + (uint64_t)descriptorSetMapping.descriptorNum[i] * instanceNum > m_DescriptorHeapCapacities[i])
+            return Result::OUT_OF_MEMORY;
+    }
+
     for (uint32_t i = 0; i < instanceNum; i++) {
         DescriptorSetD3D12* descriptorSet = &m_DescriptorSets[m_DescriptorSetNum++];
         descriptorSet->Initialize(&descriptorSetMapping, dynamicConstantBufferMapping.rootConstantNum);
@@ -119,8 +127,30 @@ NRI_INLINE Result DescriptorPoolD3D12::AllocateDescriptorSets(const PipelineLayo
 }
 
 NRI_INLINE void DescriptorPoolD3D12::Reset() {
+    DescriptorPoolStats descriptorPoolStats = {};
+    GetStats(descriptorPoolStats); // updates peaks
+
     for (DescriptorHeapDesc& descriptorHeapDesc : m_DescriptorHeapDescs)
         descriptorHeapDesc.num = 0;
 
     m_DescriptorSetNum = 0;
 }
+
+NRI_INLINE void DescriptorPoolD3D12::GetStats(DescriptorPoolStats& descriptorPoolStats) {
+    uint32_t descriptorNum = 0;
+    uint32_t descriptorMaxNum = 0;
+    for (uint32_t i = 0; i < DescriptorHeapType::MAX_NUM; i++) {
+        descriptorNum += m_DescriptorHeapDescs[i].num;
+        descriptorMaxNum += m_DescriptorHeapCapacities[i];
+    }
+
+    m_PeakDescriptorSetNum = std::max(m_PeakDescriptorSetNum, m_DescriptorSetNum);
+    m_PeakDescriptorNum = std::max(m_PeakDescriptorNum, descriptorNum);
+
+    descriptorPoolStats.descriptorSetNum = m_DescriptorSetNum;
+    descriptorPoolStats.descriptorSetMaxNum = (uint32_t)m_DescriptorSets.size();
+    descriptorPoolStats.descriptorNum = descriptorNum;
+    descriptorPoolStats.descriptorMaxNum = descriptorMaxNum;
+    descriptorPoolStats.peakDescriptorSetNum = m_PeakDescriptorSetNum;
+    descriptorPoolStats.peakDescriptorNum = m_PeakDescriptorNum;
+}
@@ -50,9 +50,9 @@ struct DeviceD3D12 final : public DeviceBase {
     }
 
     inline void FreeDescriptorHandle(D3D12_DESCRIPTOR_HEAP_TYPE type, const DescriptorHandle& descriptorHandle) {
-        ExclusiveScope lock(m_FreeDescriptorLocks[type]);
-        auto& freeDescriptors = m_FreeDescriptors[type];
-        freeDescriptors.push_back(descriptorHandle);
+        Result result = m_DescriptorSlotAllocator.Free(type, descriptorHandle.heapIndex * DESCRIPTORS_BATCH_SIZE + descriptorHandle.heapOffset);
+        if (result == Result::INVALID_ARGUMENT)
+            REPORT_ERROR(this, "descriptor (heap %u, offset %u) is freed twice or has never been allocated", (uint32_t)descriptorHandle.heapIndex, (uint32_t)descriptorHandle.heapOffset);
     }
 
     inline bool HasPix() const {
@@ -98,9 +98,9 @@ struct DeviceD3D12 final : public DeviceBase {
 
     Result Create(const DeviceCreationDesc& deviceCreationDesc, const DeviceCreationD3D12Desc& deviceCreationD3D12Desc);
     Result CreateDefaultDrawSignatures(ID3D12RootSignature* rootSignature, bool enableDrawParametersEmulation);
-    Result CreateCpuOnlyVisibleDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE type);
+    Result CreateCpuOnlyVisibleDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE type, uint32_t heapIndex);
     Result GetDescriptorHandle(D3D12_DESCRIPTOR_HEAP_TYPE type, DescriptorHandle& descriptorHandle);
-    DescriptorPointerCPU GetDescriptorPointerCPU(const DescriptorHandle& descriptorHandle);
+    DescriptorPointerCPU GetDescriptorPointerCPU(D3D12_DESCRIPTOR_HEAP_TYPE type, const DescriptorHandle& descriptorHandle);
     void GetMemoryDesc(MemoryLocation memoryLocation, const D3D12_RESOURCE_DESC& resourceDesc, MemoryDesc& memoryDesc) const;
     void GetMemoryDesc(const AccelerationStructureDesc& accelerationStructureDesc, MemoryLocation memoryLocation, MemoryDesc& memoryDesc);
     void GetAccelerationStructurePrebuildInfo(const AccelerationStructureDesc& accelerationStructureDesc, D3D12_RAYTRACING_ACCELERATION_STRUCTURE_PREBUILD_INFO& prebuildInfo);
@@ -168,8 +168,8 @@ private:
     ComPtr<ID3D12CommandSignature> m_DispatchCommandSignature;
     ComPtr<ID3D12CommandSignature> m_DispatchRaysCommandSignature;
     ComPtr<D3D12MA::Allocator> m_Vma;
-    Vector<DescriptorHeapDesc> m_DescriptorHeaps;
-    Vector<Vector<DescriptorHandle>> m_FreeDescriptors;
+    Vector<Vector<DescriptorHeapDesc>> m_DescriptorHeaps; // per "D3D12_DESCRIPTOR_HEAP_TYPE"
+    DescriptorSlotAllocator m_DescriptorSlotAllocator;
     UnorderedMap<uint64_t, ComPtr<ID3D12CommandSignature>> m_DrawCommandSignatures;
     UnorderedMap<uint64_t, ComPtr<ID3D12CommandSignature>> m_DrawIndexedCommandSignatures;
     UnorderedMap<uint32_t, ComPtr<ID3D12CommandSignature>> m_DrawMeshCommandSignatures;
@@ -179,8 +179,7 @@ private:
     uint8_t m_Version = 0;
     bool m_IsWrapped = false;
 
-    std::array<Lock, D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES> m_FreeDescriptorLocks;
-    Lock m_DescriptorHeapLock;
+    RwLock m_DescriptorHeapLock;
 };
 
 } // namespace nri
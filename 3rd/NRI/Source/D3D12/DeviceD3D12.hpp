@@ -37,14 +37,18 @@ static inline uint64_t HashRootSignatureAndStride(ID3D12RootSignature* rootSigna
     return ((uint64_t)stride << 52ull) | ((uint64_t)rootSignature & ((1ull << 52) - 1));
 }
 
+static Result AddDescriptorHeap(void* userArg, uint32_t poolIndex, uint32_t pageIndex) {
+    return ((DeviceD3D12*)userArg)->CreateCpuOnlyVisibleDescriptorHeap((D3D12_DESCRIPTOR_HEAP_TYPE)poolIndex, pageIndex);
+}
+
 DeviceD3D12::DeviceD3D12(const CallbackInterface& callbacks, const AllocationCallbacks& allocationCallbacks)
     : DeviceBase(callbacks, allocationCallbacks)
     , m_DescriptorHeaps(GetStdAllocator())
-    , m_FreeDescriptors(GetStdAllocator())
+    , m_DescriptorSlotAllocator(GetAllocationCallbacks(), GetId(), {AddDescriptorHeap, this, D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES, DESCRIPTORS_BATCH_SIZE, HeapIndexType(-1)})
     , m_DrawCommandSignatures(GetStdAllocator())
     , m_DrawIndexedCommandSignatures(GetStdAllocator())
     , m_DrawMeshCommandSignatures(GetStdAllocator()) {
-    m_FreeDescriptors.resize(D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES, Vector<DescriptorHandle>(GetStdAllocator()));
+    m_DescriptorHeaps.resize(D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES, Vector<DescriptorHeapDesc>(GetStdAllocator()));
 
     m_Desc.graphicsAPI = GraphicsAPI::D3D12;
     m_Desc.nriVersionMajor = NRI_VERSION_MAJOR;
@@ -662,14 +666,8 @@ void DeviceD3D12::InitializePixExt() {
     m_Pix.library = pixLibrary;
 }
 
-Result DeviceD3D12::CreateCpuOnlyVisibleDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE type) {
-    // IMPORTANT: m_FreeDescriptorLocks[type] must be acquired before calling this function
-    ExclusiveScope lock(m_DescriptorHeapLock);
-
-    size_t heapIndex = m_DescriptorHeaps.size();
-    if (heapIndex >= HeapIndexType(-1))
-        return Result::OUT_OF_MEMORY;
-
+Result DeviceD3D12::CreateCpuOnlyVisibleDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE type, uint32_t heapIndex) {
+    // IMPORTANT: called by "m_DescriptorSlotAllocator" under its growth lock, heaps of a type are added in order
     ComPtr<ID3D12DescriptorHeap> descriptorHeap;
     D3D12_DESCRIPTOR_HEAP_DESC desc = {type, DESCRIPTORS_BATCH_SIZE, D3D12_DESCRIPTOR_HEAP_FLAG_NONE, NRI_NODE_MASK};
     HRESULT hr = m_Device->CreateDescriptorHeap(&desc, IID_PPV_ARGS(&descriptorHeap));
@@ -679,35 +677,32 @@ Result DeviceD3D12::CreateCpuOnlyVisibleDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYP
     descriptorHeapDesc.heap = descriptorHeap;
     descriptorHeapDesc.basePointerCPU = descriptorHeap->GetCPUDescriptorHandleForHeapStart().ptr;
     descriptorHeapDesc.descriptorSize = m_Device->GetDescriptorHandleIncrementSize(type);
-    m_DescriptorHeaps.push_back(descriptorHeapDesc);
 
-    auto& freeDescriptors = m_FreeDescriptors[type];
-    for (uint32_t i = 0; i < desc.NumDescriptors; i++)
-        freeDescriptors.push_back({(HeapIndexType)heapIndex, (HeapOffsetType)i});
+    ExclusiveScope lock(m_DescriptorHeapLock);
+
+    auto& descriptorHeaps = m_DescriptorHeaps[type];
+    CHECK(descriptorHeaps.size() == heapIndex, "Unexpected");
+    descriptorHeaps.push_back(descriptorHeapDesc);
 
     return Result::SUCCESS;
 }
 
 Result DeviceD3D12::GetDescriptorHandle(D3D12_DESCRIPTOR_HEAP_TYPE type, DescriptorHandle& descriptorHandle) {
-    ExclusiveScope lock(m_FreeDescriptorLocks[type]);
-
-    auto& freeDescriptors = m_FreeDescriptors[type];
-    if (freeDescriptors.empty()) {
-        Result result = CreateCpuOnlyVisibleDescriptorHeap(type);
-        if (result != Result::SUCCESS)
-            return result;
-    }
+    uint32_t slot = 0;
+    Result result = m_DescriptorSlotAllocator.Allocate(type, slot);
+    if (result != Result::SUCCESS)
+        return result;
 
-    descriptorHandle = freeDescriptors.back();
-    freeDescriptors.pop_back();
+    descriptorHandle.heapIndex = (HeapIndexType)(slot / DESCRIPTORS_BATCH_SIZE);
+    descriptorHandle.heapOffset = (HeapOffsetType)(slot % DESCRIPTORS_BATCH_SIZE);
 
     return Result::SUCCESS;
 }
 
-DescriptorPointerCPU DeviceD3D12::GetDescriptorPointerCPU(const DescriptorHandle& descriptorHandle) {
-    ExclusiveScope lock(m_DescriptorHeapLock);
+DescriptorPointerCPU DeviceD3D12::GetDescriptorPointerCPU(D3D12_DESCRIPTOR_HEAP_TYPE type, const DescriptorHandle& descriptorHandle) {
+    SharedScope lock(m_DescriptorHeapLock);
 
-    const DescriptorHeapDesc& descriptorHeapDesc = m_DescriptorHeaps[descriptorHandle.heapIndex];
+    const DescriptorHeapDesc& descriptorHeapDesc = m_DescriptorHeaps[type][descriptorHandle.heapIndex];
     DescriptorPointerCPU descriptorPointerCPU = descriptorHeapDesc.basePointerCPU + descriptorHandle.heapOffset * descriptorHeapDesc.descriptorSize;
 
     return descriptorPointerCPU;
@@ -2,6 +2,18 @@
 
 #include "SharedExternal.h"
 
+#include "HelperBindlessTable.h"
+#include "HelperDataUpload.h"
+#include "HelperDefragmenter.h"
+#include "HelperDescriptorSetCache.h"
+#include "HelperDeviceMemoryAllocator.h"
+#include "HelperMemoryBudget.h"
+#include "HelperMemorySubAllocator.h"
+#include "HelperPipelineCache.h"
+#include "HelperTransientPool.h"
+#include "HelperWaitIdle.h"
+#include "Streamer.h"
+
 using namespace nri;
 
 template <typename T>
@@ -9,9 +21,28 @@ constexpr T* DummyObject() {
     return (T*)(size_t)(1);
 }
 
+struct DeviceNONE;
+
+// Host memory mode only ("DeviceCreationDesc::enableNONEHostMemory")
+struct QueueNONE {
+    inline QueueNONE(DeviceNONE& device)
+        : m_Device(device) {
+    }
+
+    inline DeviceNONE& GetDevice() const {
+        return m_Device;
+    }
+
+private:
+    DeviceNONE& m_Device;
+};
+
 struct DeviceNONE final : public DeviceBase {
-    inline DeviceNONE(const CallbackInterface& callbacks, const AllocationCallbacks& allocationCallbacks, const AdapterDesc* adapterDesc)
-        : DeviceBase(callbacks, allocationCallbacks) {
+    inline DeviceNONE(const CallbackInterface& callbacks, const AllocationCallbacks& allocationCallbacks, const AdapterDesc* adapterDesc, bool isHostMemory)
+        : DeviceBase(callbacks, allocationCallbacks)
+        , m_Queue(*this)
+        , m_MemorySubAllocator(m_iCore, (Device&)*this)
+        , m_IsHostMemory(isHostMemory) {
         if (adapterDesc)
             m_Desc.adapterDesc = *adapterDesc;
 
@@ -54,8 +85,9 @@ struct DeviceNONE final : public DeviceBase {
         m_Desc.bufferTextureGranularity = 1;
         m_Desc.bufferMaxSize = uint32_t(-1);
 
-        m_Desc.uploadBufferTextureRowAlignment = 1;
-        m_Desc.uploadBufferTextureSliceAlignment = 1;
+        // Host memory mode uses the D3D12 ones, so padded upload layouts get exercised
+        m_Desc.uploadBufferTextureRowAlignment = isHostMemory ? 256 : 1;
+        m_Desc.uploadBufferTextureSliceAlignment = isHostMemory ? 512 : 1;
         m_Desc.bufferShaderResourceOffsetAlignment = 1;
         m_Desc.constantBufferOffsetAlignment = 1;
         m_Desc.shaderBindingTableAlignment = 1;
@@ -188,11 +220,38 @@ struct DeviceNONE final : public DeviceBase {
         m_Desc.isRayTracingSupported = true;
         m_Desc.isMeshShaderSupported = true;
         m_Desc.isLowLatencySupported = true;
+
+        if (m_IsHostMemory)
+            FillFunctionTable(m_iCore);
     }
 
     inline ~DeviceNONE() {
     }
 
+    inline const CoreInterface& GetCoreInterface() const {
+        return m_iCore;
+    }
+
+    inline QueueNONE& GetQueue() {
+        return m_Queue;
+    }
+
+    inline HelperMemorySubAllocator& GetMemorySubAllocator() {
+        return m_MemorySubAllocator;
+    }
+
+    inline bool IsHostMemory() const {
+        return m_IsHostMemory;
+    }
+
+    // Simulated video memory usage: "MemoryType" is "MemoryLocation" in host memory mode
+    inline std::atomic_uint64_t& GetHostMemoryUsage(MemoryType memoryType) {
+        MemoryLocation memoryLocation = (MemoryLocation)memoryType;
+        bool isLocal = memoryLocation == MemoryLocation::DEVICE || memoryLocation == MemoryLocation::DEVICE_UPLOAD;
+
+        return m_HostMemoryUsages[isLocal ? 0 : 1];
+    }
+
     //================================================================================================================
     // DeviceBase
     //================================================================================================================
@@ -217,10 +276,15 @@ struct DeviceNONE final : public DeviceBase {
 
 private:
     DeviceDesc m_Desc = {};
+    CoreInterface m_iCore = {};
+    QueueNONE m_Queue;
+    HelperMemorySubAllocator m_MemorySubAllocator;
+    std::array<std::atomic_uint64_t, 2> m_HostMemoryUsages = {}; // local and non-local
+    bool m_IsHostMemory = false;
 };
 
 Result CreateDeviceNONE(const DeviceCreationDesc& desc, DeviceBase*& device) {
-    DeviceNONE* impl = Allocate<DeviceNONE>(desc.allocationCallbacks, desc.callbackInterface, desc.allocationCallbacks, desc.adapterDesc);
+    DeviceNONE* impl = Allocate<DeviceNONE>(desc.allocationCallbacks, desc.callbackInterface, desc.allocationCallbacks, desc.adapterDesc, desc.enableNONEHostMemory);
 
     if (!impl) {
         Destroy(desc.allocationCallbacks, impl);
@@ -262,19 +326,23 @@ static uint32_t NRI_CALL GetQuerySize(const QueryPool&) {
 }
 
 static void NRI_CALL GetBufferMemoryDesc(const Buffer&, MemoryLocation, MemoryDesc& memoryDesc) {
-    memoryDesc = {1};
+    memoryDesc = {};
+    memoryDesc.size = 1;
 }
 
 static void NRI_CALL GetTextureMemoryDesc(const Texture&, MemoryLocation, MemoryDesc& memoryDesc) {
-    memoryDesc = {1};
+    memoryDesc = {};
+    memoryDesc.size = 1;
 }
 
 static void NRI_CALL GetBufferMemoryDesc2(const Device&, const BufferDesc&, MemoryLocation, MemoryDesc& memoryDesc) {
-    memoryDesc = {1};
+    memoryDesc = {};
+    memoryDesc.size = 1;
 }
 
 static void NRI_CALL GetTextureMemoryDesc2(const Device&, const TextureDesc&, MemoryLocation, MemoryDesc& memoryDesc) {
-    memoryDesc = {1};
+    memoryDesc = {};
+    memoryDesc.size = 1;
 }
 
 static Result NRI_CALL GetQueue(Device&, QueueType, uint32_t, Queue*& queue) {
@@ -579,13 +647,20 @@ static void NRI_CALL UpdateDynamicConstantBuffers(DescriptorSet&, uint32_t, uint
 static void NRI_CALL CopyDescriptorSet(DescriptorSet&, const DescriptorSetCopyDesc&) {
 }
 
-static Result NRI_CALL AllocateDescriptorSets(DescriptorPool&, const PipelineLayout&, uint32_t, DescriptorSet**, uint32_t, uint32_t) {
+static Result NRI_CALL AllocateDescriptorSets(DescriptorPool&, const PipelineLayout&, uint32_t, DescriptorSet** descriptorSets, uint32_t instanceNum, uint32_t) {
+    for (uint32_t i = 0; i < instanceNum; i++)
+        descriptorSets[i] = DummyObject<DescriptorSet>();
+
     return Result::SUCCESS;
 }
 
 static void NRI_CALL ResetDescriptorPool(DescriptorPool&) {
 }
 
+static void NRI_CALL GetDescriptorPoolStats(const DescriptorPool&, DescriptorPoolStats& descriptorPoolStats) {
+    descriptorPoolStats = {};
+}
+
 static void NRI_CALL ResetCommandAllocator(CommandAllocator&) {
 }
 
@@ -623,6 +698,577 @@ static uint64_t NRI_CALL GetDescriptorNativeObject(const Descriptor&) {
     return 0;
 }
 
+//================================================================================================================
+// Host memory mode: resources live in host memory, recorded copies are executed on the CPU at submit
+//================================================================================================================
+
+constexpr uint32_t HOST_MEMORY_ALIGNMENT = 256;
+constexpr uint32_t HOST_TEXTURE_ALIGNMENT = 4096; // like small placed textures on D3D12, buffers and textures have different alignments
+
+struct MemoryNONE {
+    DeviceNONE& device;
+    uint8_t* data;
+    uint64_t size;
+    MemoryType type;
+};
+
+struct BufferNONE {
+    DeviceNONE& device;
+    BufferDesc desc;
+    MemoryNONE* memory;
+    uint64_t memoryOffset;
+    HelperMemoryAllocation allocation; // "ResourceAllocatorInterface"
+};
+
+struct TextureNONE {
+    DeviceNONE& device;
+    TextureDesc desc;
+    MemoryNONE* memory;
+    uint64_t memoryOffset;
+    HelperMemoryAllocation allocation; // "ResourceAllocatorInterface"
+};
+
+struct FenceNONE {
+    DeviceNONE& device;
+    uint64_t value;
+};
+
+// Descriptors of a set counted by "AllocateDescriptorSetsHost", dynamic constant buffers included
+struct DescriptorSetSizeNONE {
+    uint32_t descriptorNum; // without the variable sized array
+    bool hasVariableSizedArray;
+};
+
+struct PipelineLayoutNONE {
+    inline PipelineLayoutNONE(DeviceNONE& device)
+        : device(device)
+        , descriptorSetSizes(device.GetStdAllocator()) {
+    }
+
+    DeviceNONE& device;
+    Vector<DescriptorSetSizeNONE> descriptorSetSizes;
+};
+
+// Sets are dummy objects, only the occupancy is tracked. The capacity is checked for all descriptor types at once (like in D3D11)
+struct DescriptorPoolNONE {
+    DeviceNONE& device;
+    uint32_t descriptorSetMaxNum;
+    uint32_t descriptorMaxNum;
+    uint32_t descriptorSetNum;
+    uint32_t descriptorNum;
+    uint32_t peakDescriptorSetNum;
+    uint32_t peakDescriptorNum;
+};
+
+struct CommandAllocatorNONE {
+    DeviceNONE& device;
+};
+
+enum class CommandTypeNONE : uint8_t {
+    COPY_BUFFER,
+    COPY_TEXTURE,
+    UPLOAD_BUFFER_TO_TEXTURE,
+    READBACK_TEXTURE_TO_BUFFER
+};
+
+struct CommandNONE {
+    CommandTypeNONE type;
+    BufferNONE* buffer; // destination for COPY_BUFFER
+    const BufferNONE* srcBuffer;
+    TextureNONE* texture; // destination for COPY_TEXTURE
+    const TextureNONE* srcTexture;
+    TextureRegionDesc textureRegion;
+    TextureRegionDesc srcTextureRegion;
+    TextureDataLayoutDesc dataLayout;
+    bool isWholeTexture;
+    uint64_t dstOffset;
+    uint64_t srcOffset;
+    uint64_t size;
+};
+
+struct CommandBufferNONE {
+    inline CommandBufferNONE(DeviceNONE& device)
+        : device(device)
+        , commands(device.GetStdAllocator()) {
+    }
+
+    DeviceNONE& device;
+    Vector<CommandNONE> commands;
+};
+
+static inline uint8_t* GetHostMemory(MemoryNONE* memory, uint64_t offset) {
+    return memory ? memory->data + offset : nullptr;
+}
+
+// Layout: layers are outer, mips are inner, rows and slices are tightly packed (in blocks)
+static uint64_t GetMipSizeNONE(const TextureDesc& textureDesc, Mip_t mip, uint64_t* rowPitch = nullptr, uint64_t* slicePitch = nullptr) {
+    const FormatProps& formatProps = GetFormatProps(textureDesc.format);
+
+    uint64_t w = (GetDimension(GraphicsAPI::NONE, textureDesc, 0, mip) + formatProps.blockWidth - 1) / formatProps.blockWidth;
+    uint64_t h = (GetDimension(GraphicsAPI::NONE, textureDesc, 1, mip) + formatProps.blockWidth - 1) / formatProps.blockWidth;
+    uint64_t d = GetDimension(GraphicsAPI::NONE, textureDesc, 2, mip);
+
+    uint64_t row = w * formatProps.stride;
+    uint64_t slice = row * h;
+
+    if (rowPitch)
+        *rowPitch = row;
+    if (slicePitch)
+        *slicePitch = slice;
+
+    return slice * d * textureDesc.sampleNum;
+}
+
+static uint64_t GetSubresourceOffsetNONE(const TextureDesc& textureDesc, Dim_t layer, Mip_t mip) {
+    uint64_t layerSize = 0;
+    uint64_t mipOffset = 0;
+    for (Mip_t i = 0; i < textureDesc.mipNum; i++) {
+        if (i == mip)
+            mipOffset = layerSize;
+
+        layerSize += GetMipSizeNONE(textureDesc, i);
+    }
+
+    return layer * layerSize + mipOffset;
+}
+
+static void CopyTextureRegionNONE(TextureNONE& texture, const TextureRegionDesc& textureRegion, uint8_t* data, const TextureDataLayoutDesc& dataLayout, bool isUpload) {
+    uint8_t* textureData = GetHostMemory(texture.memory, texture.memoryOffset);
+    if (!textureData || !data)
+        return;
+
+    const TextureDesc& textureDesc = texture.desc;
+    const FormatProps& formatProps = GetFormatProps(textureDesc.format);
+
+    uint64_t rowPitch = 0;
+    uint64_t slicePitch = 0;
+    GetMipSizeNONE(textureDesc, textureRegion.mipOffset, &rowPitch, &slicePitch);
+
+    Dim_t width = textureRegion.width == WHOLE_SIZE ? GetDimension(GraphicsAPI::NONE, textureDesc, 0, textureRegion.mipOffset) : textureRegion.width;
+    Dim_t height = textureRegion.height == WHOLE_SIZE ? GetDimension(GraphicsAPI::NONE, textureDesc, 1, textureRegion.mipOffset) : textureRegion.height;
+    Dim_t depth = textureRegion.depth == WHOLE_SIZE ? GetDimension(GraphicsAPI::NONE, textureDesc, 2, textureRegion.mipOffset) : textureRegion.depth;
+
+    // Partial blocks (mips smaller than a block) still occupy a whole block
+    uint64_t rowSize = (uint64_t)((width + formatProps.blockWidth - 1) / formatProps.blockWidth) * formatProps.stride;
+    uint32_t rowNum = (height + formatProps.blockWidth - 1) / formatProps.blockWidth;
+    uint64_t x = (uint64_t)(textureRegion.x / formatProps.blockWidth) * formatProps.stride;
+    uint32_t y = textureRegion.y / formatProps.blockWidth;
+
+    uint8_t* subresource = textureData + GetSubresourceOffsetNONE(textureDesc, textureRegion.layerOffset, textureRegion.mipOffset);
+    for (uint32_t z = 0; z < depth; z++) {
+        for (uint32_t row = 0; row < rowNum; row++) {
+            uint8_t* texel = subresource + (textureRegion.z + z) * slicePitch + (y + row) * rowPitch + x;
+            uint8_t* mem = data + dataLayout.offset + z * dataLayout.slicePitch + row * dataLayout.rowPitch;
+
+            if (isUpload)
+                memcpy(texel, mem, rowSize);
+            else
+                memcpy(mem, texel, rowSize);
+        }
+    }
+}
+
+static void CopyTextureNONE(const CommandNONE& command) {
+    const TextureNONE& src = *command.srcTexture;
+    uint8_t* srcData = GetHostMemory(src.memory, src.memoryOffset);
+    uint8_t* dstData = GetHostMemory(command.texture->memory, command.texture->memoryOffset);
+    if (!srcData || !dstData)
+        return;
+
+    if (command.isWholeTexture) {
+        memcpy(dstData, srcData, GetSubresourceOffsetNONE(src.desc, src.desc.layerNum, 0));
+        return;
+    }
+
+    // The source subresource is the data layout of the destination region
+    const TextureRegionDesc& srcRegion = command.srcTextureRegion;
+    const FormatProps& formatProps = GetFormatProps(src.desc.format);
+
+    uint64_t rowPitch = 0;
+    uint64_t slicePitch = 0;
+    GetMipSizeNONE(src.desc, srcRegion.mipOffset, &rowPitch, &slicePitch);
+
+    TextureDataLayoutDesc dataLayout = {};
+    dataLayout.offset = srcRegion.z * slicePitch + (srcRegion.y / formatProps.blockWidth) * rowPitch + (srcRegion.x / formatProps.blockWidth) * formatProps.stride;
+    dataLayout.rowPitch = (uint32_t)rowPitch;
+    dataLayout.slicePitch = (uint32_t)slicePitch;
+
+    uint8_t* subresource = srcData + GetSubresourceOffsetNONE(src.desc, srcRegion.layerOffset, srcRegion.mipOffset);
+    CopyTextureRegionNONE(*command.texture, command.textureRegion, subresource, dataLayout, true);
+}
+
+static void ExecuteCommandsNONE(const CommandBufferNONE& commandBuffer) {
+    for (const CommandNONE& command : commandBuffer.commands) {
+        if (command.type == CommandTypeNONE::COPY_TEXTURE) {
+            CopyTextureNONE(command);
+            continue;
+        }
+
+        uint8_t* buffer = GetHostMemory(command.buffer->memory, command.buffer->memoryOffset);
+
+        if (command.type == CommandTypeNONE::COPY_BUFFER) {
+            const uint8_t* srcBuffer = GetHostMemory(command.srcBuffer->memory, command.srcBuffer->memoryOffset);
+            if (buffer && srcBuffer)
+                memmove(buffer + command.dstOffset, srcBuffer + command.srcOffset, command.size);
+        } else
+            CopyTextureRegionNONE(*command.texture, command.textureRegion, buffer, command.dataLayout, command.type == CommandTypeNONE::UPLOAD_BUFFER_TO_TEXTURE);
+    }
+}
+
+static const BufferDesc& NRI_CALL GetBufferDescHost(const Buffer& buffer) {
+    return ((BufferNONE&)buffer).desc;
+}
+
+static const TextureDesc& NRI_CALL GetTextureDescHost(const Texture& texture) {
+    return ((TextureNONE&)texture).desc;
+}
+
+static void NRI_CALL GetBufferMemoryDesc2Host(const Device&, const BufferDesc& bufferDesc, MemoryLocation memoryLocation, MemoryDesc& memoryDesc) {
+    memoryDesc = {};
+    memoryDesc.size = Align(bufferDesc.size, HOST_MEMORY_ALIGNMENT);
+    memoryDesc.alignment = HOST_MEMORY_ALIGNMENT;
+    memoryDesc.type = (MemoryType)memoryLocation;
+}
+
+static void NRI_CALL GetTextureMemoryDesc2Host(const Device&, const TextureDesc& textureDesc, MemoryLocation memoryLocation, MemoryDesc& memoryDesc) {
+    TextureDesc desc = FixTextureDesc(textureDesc);
+
+    memoryDesc = {};
+    memoryDesc.size = Align(GetSubresourceOffsetNONE(desc, desc.layerNum, 0), HOST_MEMORY_ALIGNMENT);
+    memoryDesc.alignment = HOST_TEXTURE_ALIGNMENT;
+    memoryDesc.type = (MemoryType)memoryLocation;
+}
+
+static void NRI_CALL GetBufferMemoryDescHost(const Buffer& buffer, MemoryLocation memoryLocation, MemoryDesc& memoryDesc) {
+    const BufferNONE& bufferNONE = (BufferNONE&)buffer;
+
+    GetBufferMemoryDesc2Host((Device&)bufferNONE.device, bufferNONE.desc, memoryLocation, memoryDesc);
+}
+
+static void NRI_CALL GetTextureMemoryDescHost(const Texture& texture, MemoryLocation memoryLocation, MemoryDesc& memoryDesc) {
+    const TextureNONE& textureNONE = (TextureNONE&)texture;
+
+    GetTextureMemoryDesc2Host((Device&)textureNONE.device, textureNONE.desc, memoryLocation, memoryDesc);
+}
+
+static Result NRI_CALL GetQueueHost(Device& device, QueueType, uint32_t, Queue*& queue) {
+    queue = (Queue*)&((DeviceNONE&)device).GetQueue();
+
+    return Result::SUCCESS;
+}
+
+static Result NRI_CALL CreateCommandAllocatorHost(Queue& queue, CommandAllocator*& commandAllocator) {
+    DeviceNONE& device = ((QueueNONE&)queue).GetDevice();
+    commandAllocator = (CommandAllocator*)Allocate<CommandAllocatorNONE>(device.GetObjectPool(), CommandAllocatorNONE{device});
+
+    return commandAllocator ? Result::SUCCESS : Result::OUT_OF_MEMORY;
+}
+
+static Result NRI_CALL CreateCommandBufferHost(CommandAllocator& commandAllocator, CommandBuffer*& commandBuffer) {
+    DeviceNONE& device = ((CommandAllocatorNONE&)commandAllocator).device;
+    commandBuffer = (CommandBuffer*)Allocate<CommandBufferNONE>(device.GetObjectPool(), device);
+
+    return commandBuffer ? Result::SUCCESS : Result::OUT_OF_MEMORY;
+}
+
+static Result NRI_CALL CreateFenceHost(Device& device, uint64_t initialValue, Fence*& fence) {
+    DeviceNONE& deviceNONE = (DeviceNONE&)device;
+    fence = (Fence*)Allocate<FenceNONE>(deviceNONE.GetObjectPool(), FenceNONE{deviceNONE, initialValue});
+
+    return fence ? Result::SUCCESS : Result::OUT_OF_MEMORY;
+}
+
+static Result NRI_CALL CreatePipelineLayoutHost(Device& device, const PipelineLayoutDesc& pipelineLayoutDesc, PipelineLayout*& pipelineLayout) {
+    DeviceNONE& deviceNONE = (DeviceNONE&)device;
+    PipelineLayoutNONE* pipelineLayoutNONE = Allocate<PipelineLayoutNONE>(deviceNONE.GetObjectPool(), deviceNONE);
+    pipelineLayout = (PipelineLayout*)pipelineLayoutNONE;
+    if (!pipelineLayoutNONE)
+        return Result::OUT_OF_MEMORY;
+
+    for (uint32_t i = 0; i < pipelineLayoutDesc.descriptorSetNum; i++) {
+        const DescriptorSetDesc& descriptorSetDesc = pipelineLayoutDesc.descriptorSets[i];
+
+        DescriptorSetSizeNONE descriptorSetSize = {descriptorSetDesc.dynamicConstantBufferNum, false};
+        for (uint32_t j = 0; j < descriptorSetDesc.rangeNum; j++) {
+            const DescriptorRangeDesc& descriptorRangeDesc = descriptorSetDesc.ranges[j];
+            if (descriptorRangeDesc.flags & DescriptorRangeBits::VARIABLE_SIZED_ARRAY)
+                descriptorSetSize.hasVariableSizedArray = true;
+            else
+                descriptorSetSize.descriptorNum += descriptorRangeDesc.descriptorNum;
+        }
+
+        pipelineLayoutNONE->descriptorSetSizes.push_back(descriptorSetSize);
+    }
+
+    return Result::SUCCESS;
+}
+
+static Result NRI_CALL CreateDescriptorPoolHost(Device& device, const DescriptorPoolDesc& descriptorPoolDesc, DescriptorPool*& descriptorPool) {
+    uint32_t descriptorMaxNum = descriptorPoolDesc.samplerMaxNum;
+    descriptorMaxNum += descriptorPoolDesc.constantBufferMaxNum;
+    descriptorMaxNum += descriptorPoolDesc.dynamicConstantBufferMaxNum;
+    descriptorMaxNum += descriptorPoolDesc.textureMaxNum;
+    descriptorMaxNum += descriptorPoolDesc.storageTextureMaxNum;
+    descriptorMaxNum += descriptorPoolDesc.bufferMaxNum;
+    descriptorMaxNum += descriptorPoolDesc.storageBufferMaxNum;
+    descriptorMaxNum += descriptorPoolDesc.structuredBufferMaxNum;
+    descriptorMaxNum += descriptorPoolDesc.storageStructuredBufferMaxNum;
+    descriptorMaxNum += descriptorPoolDesc.accelerationStructureMaxNum;
+
+    DeviceNONE& deviceNONE = (DeviceNONE&)device;
+    descriptorPool = (DescriptorPool*)Allocate<DescriptorPoolNONE>(deviceNONE.GetObjectPool(), DescriptorPoolNONE{deviceNONE, descriptorPoolDesc.descriptorSetMaxNum, descriptorMaxNum, 0, 0, 0, 0});
+
+    return descriptorPool ? Result::SUCCESS : Result::OUT_OF_MEMORY;
+}
+
+static Result NRI_CALL CreateBufferHost(Device& device, const BufferDesc& bufferDesc, Buffer*& buffer) {
+    DeviceNONE& deviceNONE = (DeviceNONE&)device;
+    buffer = (Buffer*)Allocate<BufferNONE>(deviceNONE.GetObjectPool(), BufferNONE{deviceNONE, bufferDesc, nullptr, 0, {}});
+
+    return buffer ? Result::SUCCESS : Result::OUT_OF_MEMORY;
+}
+
+static Result NRI_CALL CreateTextureHost(Device& device, const TextureDesc& textureDesc, Texture*& texture) {
+    DeviceNONE& deviceNONE = (DeviceNONE&)device;
+    texture = (Texture*)Allocate<TextureNONE>(deviceNONE.GetObjectPool(), TextureNONE{deviceNONE, FixTextureDesc(textureDesc), nullptr, 0, {}});
+
+    return texture ? Result::SUCCESS : Result::OUT_OF_MEMORY;
+}
+
+static Result NRI_CALL AllocateMemoryHost(Device& device, const AllocateMemoryDesc& allocateMemoryDesc, Memory*& memory) {
+    DeviceNONE& deviceNONE = (DeviceNONE&)device;
+    const AllocationCallbacks& allocationCallbacks = deviceNONE.GetAllocationCallbacks();
+
+    memory = nullptr;
+
+    uint8_t* data = (uint8_t*)allocationCallbacks.Allocate(allocationCallbacks.userArg, (size_t)allocateMemoryDesc.size, HOST_MEMORY_ALIGNMENT);
+    if (!data)
+        return Result::OUT_OF_MEMORY;
+
+    memset(data, 0, (size_t)allocateMemoryDesc.size);
+
+    memory = (Memory*)Allocate<MemoryNONE>(deviceNONE.GetObjectPool(), MemoryNONE{deviceNONE, data, allocateMemoryDesc.size, allocateMemoryDesc.type});
+    if (!memory) {
+        allocationCallbacks.Free(allocationCallbacks.userArg, data);
+        return Result::OUT_OF_MEMORY;
+    }
+
+    deviceNONE.GetHostMemoryUsage(allocateMemoryDesc.type) += allocateMemoryDesc.size;
+
+    return Result::SUCCESS;
+}
+
+static void NRI_CALL FreeMemoryHost(Memory& memory) {
+    MemoryNONE& memoryNONE = (MemoryNONE&)memory;
+    const AllocationCallbacks& allocationCallbacks = memoryNONE.device.GetAllocationCallbacks();
+
+    memoryNONE.device.GetHostMemoryUsage(memoryNONE.type) -= memoryNONE.size;
+
+    allocationCallbacks.Free(allocationCallbacks.userArg, memoryNONE.data);
+    Destroy(memoryNONE.device.GetObjectPool(), &memoryNONE);
+}
+
+static Result NRI_CALL BindBufferMemoryHost(Device&, const BufferMemoryBindingDesc* memoryBindingDescs, uint32_t memoryBindingDescNum) {
+    for (uint32_t i = 0; i < memoryBindingDescNum; i++) {
+        const BufferMemoryBindingDesc& memoryBindingDesc = memoryBindingDescs[i];
+
+        BufferNONE& buffer = (BufferNONE&)*memoryBindingDesc.buffer;
+        buffer.memory = (MemoryNONE*)memoryBindingDesc.memory;
+        buffer.memoryOffset = memoryBindingDesc.offset;
+    }
+
+    return Result::SUCCESS;
+}
+
+static Result NRI_CALL BindTextureMemoryHost(Device&, const TextureMemoryBindingDesc* memoryBindingDescs, uint32_t memoryBindingDescNum) {
+    for (uint32_t i = 0; i < memoryBindingDescNum; i++) {
+        const TextureMemoryBindingDesc& memoryBindingDesc = memoryBindingDescs[i];
+
+        TextureNONE& texture = (TextureNONE&)*memoryBindingDesc.texture;
+        texture.memory = (MemoryNONE*)memoryBindingDesc.memory;
+        texture.memoryOffset = memoryBindingDesc.offset;
+    }
+
+    return Result::SUCCESS;
+}
+
+static void NRI_CALL DestroyCommandAllocatorHost(CommandAllocator& commandAllocator) {
+    CommandAllocatorNONE& commandAllocatorNONE = (CommandAllocatorNONE&)commandAllocator;
+    Destroy(commandAllocatorNONE.device.GetObjectPool(), &commandAllocatorNONE);
+}
+
+static void NRI_CALL DestroyCommandBufferHost(CommandBuffer& commandBuffer) {
+    CommandBufferNONE& commandBufferNONE = (CommandBufferNONE&)commandBuffer;
+    Destroy(commandBufferNONE.device.GetObjectPool(), &commandBufferNONE);
+}
+
+static void NRI_CALL DestroyBufferHost(Buffer& buffer) {
+    BufferNONE& bufferNONE = (BufferNONE&)buffer;
+    bufferNONE.device.GetMemorySubAllocator().Free(bufferNONE.allocation);
+
+    Destroy(bufferNONE.device.GetObjectPool(), &bufferNONE);
+}
+
+static void NRI_CALL DestroyTextureHost(Texture& texture) {
+    TextureNONE& textureNONE = (TextureNONE&)texture;
+    textureNONE.device.GetMemorySubAllocator().Free(textureNONE.allocation);
+
+    Destroy(textureNONE.device.GetObjectPool(), &textureNONE);
+}
+
+static void NRI_CALL DestroyFenceHost(Fence& fence) {
+    FenceNONE& fenceNONE = (FenceNONE&)fence;
+    Destroy(fenceNONE.device.GetObjectPool(), &fenceNONE);
+}
+
+static void NRI_CALL DestroyPipelineLayoutHost(PipelineLayout& pipelineLayout) {
+    PipelineLayoutNONE& pipelineLayoutNONE = (PipelineLayoutNONE&)pipelineLayout;
+    Destroy(pipelineLayoutNONE.device.GetObjectPool(), &pipelineLayoutNONE);
+}
+
+static void NRI_CALL DestroyDescriptorPoolHost(DescriptorPool& descriptorPool) {
+    DescriptorPoolNONE& descriptorPoolNONE = (DescriptorPoolNONE&)descriptorPool;
+    Destroy(descriptorPoolNONE.device.GetObjectPool(), &descriptorPoolNONE);
+}
+
+static Result NRI_CALL AllocateDescriptorSetsHost(DescriptorPool& descriptorPool, const PipelineLayout& pipelineLayout, uint32_t setIndex, DescriptorSet** descriptorSets, uint32_t instanceNum, uint32_t variableDescriptorNum) {
+    DescriptorPoolNONE& descriptorPoolNONE = (DescriptorPoolNONE&)descriptorPool;
+    const PipelineLayoutNONE& pipelineLayoutNONE = (const PipelineLayoutNONE&)pipelineLayout;
+
+    if (setIndex >= pipelineLayoutNONE.descriptorSetSizes.size())
+        return Result::INVALID_ARGUMENT;
+
+    const DescriptorSetSizeNONE& descriptorSetSize = pipelineLayoutNONE.descriptorSetSizes[setIndex];
+    uint64_t descriptorNum = descriptorSetSize.descriptorNum + (descriptorSetSize.hasVariableSizedArray ? variableDescriptorNum : 0);
+
+    // All or nothing
+    if (descriptorPoolNONE.descriptorSetNum + (uint64_t)instanceNum > descriptorPoolNONE.descriptorSetMaxNum || descriptorPoolNONE.descriptorNum + descriptorNum * instanceNum > descriptorPoolNONE.descriptorMaxNum)
+        return Result::OUT_OF_MEMORY;
+
+    for (uint32_t i = 0; i < instanceNum; i++)
+        descriptorSets[i] = DummyObject<DescriptorSet>();
+
+    descriptorPoolNONE.descriptorSetNum += instanceNum;
+    descriptorPoolNONE.descriptorNum += (uint32_t)descriptorNum * instanceNum;
+
+    return Result::SUCCESS;
+}
+
+static void NRI_CALL GetDescriptorPoolStatsHost(const DescriptorPool& descriptorPool, DescriptorPoolStats& descriptorPoolStats) {
+    DescriptorPoolNONE& descriptorPoolNONE = (DescriptorPoolNONE&)descriptorPool;
+    descriptorPoolNONE.peakDescriptorSetNum = std::max(descriptorPoolNONE.peakDescriptorSetNum, descriptorPoolNONE.descriptorSetNum);
+    descriptorPoolNONE.peakDescriptorNum = std::max(descriptorPoolNONE.peakDescriptorNum, descriptorPoolNONE.descriptorNum);
+
+    descriptorPoolStats.descriptorSetNum = descriptorPoolNONE.descriptorSetNum;
+    descriptorPoolStats.descriptorSetMaxNum = descriptorPoolNONE.descriptorSetMaxNum;
+    descriptorPoolStats.descriptorNum = descriptorPoolNONE.descriptorNum;
+    descriptorPoolStats.descriptorMaxNum = descriptorPoolNONE.descriptorMaxNum;
+    descriptorPoolStats.peakDescriptorSetNum = descriptorPoolNONE.peakDescriptorSetNum;
+    descriptorPoolStats.peakDescriptorNum = descriptorPoolNONE.peakDescriptorNum;
+}
+
+static void NRI_CALL ResetDescriptorPoolHost(DescriptorPool& descriptorPool) {
+    DescriptorPoolStats descriptorPoolStats = {};
+    GetDescriptorPoolStatsHost(descriptorPool, descriptorPoolStats); // updates peaks
+
+    DescriptorPoolNONE& descriptorPoolNONE = (DescriptorPoolNONE&)descriptorPool;
+    descriptorPoolNONE.descriptorSetNum = 0;
+    descriptorPoolNONE.descriptorNum = 0;
+}
+
+static Result NRI_CALL BeginCommandBufferHost(CommandBuffer& commandBuffer, const DescriptorPool*) {
+    ((CommandBufferNONE&)commandBuffer).commands.clear();
+
+    return Result::SUCCESS;
+}
+
+static void NRI_CALL CmdCopyBufferHost(CommandBuffer& commandBuffer, Buffer& dstBuffer, uint64_t dstOffset, const Buffer& srcBuffer, uint64_t srcOffset, uint64_t size) {
+    const BufferNONE& src = (BufferNONE&)srcBuffer;
+
+    CommandNONE command = {};
+    command.type = CommandTypeNONE::COPY_BUFFER;
+    command.buffer = (BufferNONE*)&dstBuffer;
+    command.srcBuffer = &src;
+    command.dstOffset = dstOffset;
+    command.srcOffset = srcOffset;
+    command.size = size == WHOLE_SIZE ? src.desc.size : size;
+
+    ((CommandBufferNONE&)commandBuffer).commands.push_back(command);
+}
+
+static void NRI_CALL CmdCopyTextureHost(CommandBuffer& commandBuffer, Texture& dstTexture, const TextureRegionDesc* dstRegion, const Texture& srcTexture, const TextureRegionDesc* srcRegion) {
+    CommandNONE command = {};
+    command.type = CommandTypeNONE::COPY_TEXTURE;
+    command.texture = (TextureNONE*)&dstTexture;
+    command.srcTexture = (TextureNONE*)&srcTexture;
+    command.isWholeTexture = !dstRegion && !srcRegion;
+
+    if (!command.isWholeTexture) {
+        command.textureRegion = dstRegion ? *dstRegion : TextureRegionDesc{};
+        command.srcTextureRegion = srcRegion ? *srcRegion : TextureRegionDesc{};
+
+        // Size is taken from the source region
+        command.textureRegion.width = command.srcTextureRegion.width;
+        command.textureRegion.height = command.srcTextureRegion.height;
+        command.textureRegion.depth = command.srcTextureRegion.depth;
+        if (command.textureRegion.width == WHOLE_SIZE)
+            command.textureRegion.width = GetDimension(GraphicsAPI::NONE, command.srcTexture->desc, 0, command.srcTextureRegion.mipOffset);
+        if (command.textureRegion.height == WHOLE_SIZE)
+            command.textureRegion.height = GetDimension(GraphicsAPI::NONE, command.srcTexture->desc, 1, command.srcTextureRegion.mipOffset);
+        if (command.textureRegion.depth == WHOLE_SIZE)
+            command.textureRegion.depth = GetDimension(GraphicsAPI::NONE, command.srcTexture->desc, 2, command.srcTextureRegion.mipOffset);
+    }
+
+    ((CommandBufferNONE&)commandBuffer).commands.push_back(command);
+}
+
+static void NRI_CALL CmdUploadBufferToTextureHost(CommandBuffer& commandBuffer, Texture& dstTexture, const TextureRegionDesc& dstRegion, const Buffer& srcBuffer, const TextureDataLayoutDesc& srcDataLayout) {
+    CommandNONE command = {};
+    command.type = CommandTypeNONE::UPLOAD_BUFFER_TO_TEXTURE;
+    command.buffer = (BufferNONE*)&srcBuffer;
+    command.texture = (TextureNONE*)&dstTexture;
+    command.textureRegion = dstRegion;
+    command.dataLayout = srcDataLayout;
+
+    ((CommandBufferNONE&)commandBuffer).commands.push_back(command);
+}
+
+static void NRI_CALL CmdReadbackTextureToBufferHost(CommandBuffer& commandBuffer, Buffer& dstBuffer, const TextureDataLayoutDesc& dstDataLayout, const Texture& srcTexture, const TextureRegionDesc& srcRegion) {
+    CommandNONE command = {};
+    command.type = CommandTypeNONE::READBACK_TEXTURE_TO_BUFFER;
+    command.buffer = (BufferNONE*)&dstBuffer;
+    command.texture = (TextureNONE*)&srcTexture;
+    command.textureRegion = srcRegion;
+    command.dataLayout = dstDataLayout;
+
+    ((CommandBufferNONE&)commandBuffer).commands.push_back(command);
+}
+
+static void NRI_CALL QueueSubmitHost(Queue&, const QueueSubmitDesc& queueSubmitDesc) {
+    for (uint32_t i = 0; i < queueSubmitDesc.commandBufferNum; i++)
+        ExecuteCommandsNONE(*(CommandBufferNONE*)queueSubmitDesc.commandBuffers[i]);
+
+    for (uint32_t i = 0; i < queueSubmitDesc.signalFenceNum; i++) {
+        FenceNONE& fence = *(FenceNONE*)queueSubmitDesc.signalFences[i].fence;
+        fence.value = std::max(fence.value, queueSubmitDesc.signalFences[i].value);
+    }
+}
+
+static void NRI_CALL WaitHost(Fence&, uint64_t) {
+    // Submissions are executed synchronously
+}
+
+static uint64_t NRI_CALL GetFenceValueHost(Fence& fence) {
+    return ((FenceNONE&)fence).value;
+}
+
+static void* NRI_CALL MapBufferHost(Buffer& buffer, uint64_t offset, uint64_t) {
+    BufferNONE& bufferNONE = (BufferNONE&)buffer;
+    uint8_t* data = GetHostMemory(bufferNONE.memory, bufferNONE.memoryOffset);
+
+    return data ? data + offset : nullptr;
+}
+
 Result DeviceNONE::FillFunctionTable(CoreInterface& table) const {
     table.GetDeviceDesc = ::GetDeviceDesc;
     table.GetBufferDesc = ::GetBufferDesc;
@@ -727,6 +1373,47 @@ Result DeviceNONE::FillFunctionTable(CoreInterface& table) const {
     table.GetBufferNativeObject = ::GetBufferNativeObject;
     table.GetTextureNativeObject = ::GetTextureNativeObject;
     table.GetDescriptorNativeObject = ::GetDescriptorNativeObject;
+    table.GetDescriptorPoolStats = ::GetDescriptorPoolStats;
+
+    if (m_IsHostMemory) {
+        table.GetBufferDesc = ::GetBufferDescHost;
+        table.GetTextureDesc = ::GetTextureDescHost;
+        table.GetBufferMemoryDesc = ::GetBufferMemoryDescHost;
+        table.GetTextureMemoryDesc = ::GetTextureMemoryDescHost;
+        table.GetBufferMemoryDesc2 = ::GetBufferMemoryDesc2Host;
+        table.GetTextureMemoryDesc2 = ::GetTextureMemoryDesc2Host;
+        table.GetQueue = ::GetQueueHost;
+        table.CreateCommandAllocator = ::CreateCommandAllocatorHost;
+        table.CreateCommandBuffer = ::CreateCommandBufferHost;
+        table.CreateBuffer = ::CreateBufferHost;
+        table.CreateTexture = ::CreateTextureHost;
+        table.CreateFence = ::CreateFenceHost;
+        table.CreatePipelineLayout = ::CreatePipelineLayoutHost;
+        table.CreateDescriptorPool = ::CreateDescriptorPoolHost;
+        table.DestroyCommandAllocator = ::DestroyCommandAllocatorHost;
+        table.DestroyCommandBuffer = ::DestroyCommandBufferHost;
+        table.DestroyBuffer = ::DestroyBufferHost;
+        table.DestroyTexture = ::DestroyTextureHost;
+        table.DestroyFence = ::DestroyFenceHost;
+        table.DestroyPipelineLayout = ::DestroyPipelineLayoutHost;
+        table.DestroyDescriptorPool = ::DestroyDescriptorPoolHost;
+        table.AllocateDescriptorSets = ::AllocateDescriptorSetsHost;
+        table.ResetDescriptorPool = ::ResetDescriptorPoolHost;
+        table.GetDescriptorPoolStats = ::GetDescriptorPoolStatsHost;
+        table.AllocateMemory = ::AllocateMemoryHost;
+        table.BindBufferMemory = ::BindBufferMemoryHost;
+        table.BindTextureMemory = ::BindTextureMemoryHost;
+        table.FreeMemory = ::FreeMemoryHost;
+        table.BeginCommandBuffer = ::BeginCommandBufferHost;
+        table.CmdCopyBuffer = ::CmdCopyBufferHost;
+        table.CmdCopyTexture = ::CmdCopyTextureHost;
+        table.CmdUploadBufferToTexture = ::CmdUploadBufferToTextureHost;
+        table.CmdReadbackTextureToBuffer = ::CmdReadbackTextureToBufferHost;
+        table.QueueSubmit = ::QueueSubmitHost;
+        table.Wait = ::WaitHost;
+        table.GetFenceValue = ::GetFenceValueHost;
+        table.MapBuffer = ::MapBufferHost;
+    }
 
     return Result::SUCCESS;
 }
@@ -748,6 +1435,199 @@ static Result NRI_CALL UploadData(Queue&, const TextureUploadDesc*, uint32_t, co
     return Result::SUCCESS;
 }
 
+static Result NRI_CALL CreateDataUploader(Queue&, const DataUploaderDesc&, DataUploader*& dataUploader) {
+    dataUploader = DummyObject<DataUploader>();
+
+    return Result::SUCCESS;
+}
+
+static void NRI_CALL DestroyDataUploader(DataUploader&) {
+}
+
+static Result NRI_CALL UploadDataAsync(DataUploader&, const TextureUploadDesc*, uint32_t, const BufferUploadDesc*, uint32_t, UploadTicket& uploadTicket) {
+    uploadTicket = {};
+
+    return Result::SUCCESS;
+}
+
+static Result NRI_CALL CreateDefragmenter(Device&, const DefragmenterDesc&, Defragmenter*& defragmenter) {
+    defragmenter = DummyObject<Defragmenter>();
+
+    return Result::SUCCESS;
+}
+
+static void NRI_CALL DestroyDefragmenter(Defragmenter&) {
+}
+
+static Result NRI_CALL AllocateAndBindDefragmentableMemory(Defragmenter&, const ResourceGroupDesc&) {
+    return Result::SUCCESS;
+}
+
+static void NRI_CALL ReleaseDefragmentableResources(Defragmenter&, Buffer* const*, uint32_t, Texture* const*, uint32_t) {
+}
+
+static const DefragmentationMove* NRI_CALL BeginDefragmentation(Defragmenter&, uint64_t, uint64_t, uint32_t& moveNum) {
+    moveNum = 0;
+
+    return nullptr;
+}
+
+static void NRI_CALL CmdDefragment(CommandBuffer&, Defragmenter&) {
+}
+
+static Result NRI_CALL CreateTransientPool(Device&, const TransientPoolDesc&, TransientPool*& transientPool) {
+    transientPool = DummyObject<TransientPool>();
+
+    return Result::SUCCESS;
+}
+
+static void NRI_CALL DestroyTransientPool(TransientPool&) {
+}
+
+static void NRI_CALL GetTransientPoolBarriers(const TransientPool&, uint32_t, BarrierGroupDesc& barrierGroupDesc) {
+    barrierGroupDesc = {};
+}
+
+static void NRI_CALL GetTransientPoolStats(const TransientPool&, TransientPoolStats& transientPoolStats) {
+    transientPoolStats = {};
+}
+
+// Dummy: all memory objects are the same dummy object, which can't be tracked (see "CreateMemoryBudgetHost")
+static Result NRI_CALL CreateMemoryBudget(Device&, const MemoryBudgetDesc&, MemoryBudget*& memoryBudget) {
+    memoryBudget = DummyObject<MemoryBudget>();
+
+    return Result::SUCCESS;
+}
+
+static void NRI_CALL DestroyMemoryBudget(MemoryBudget&) {
+}
+
+static Result NRI_CALL AllocateBudgetedMemory(MemoryBudget&, const AllocateMemoryDesc&, MemoryLocation, Memory*& memory) {
+    memory = DummyObject<Memory>();
+
+    return Result::SUCCESS;
+}
+
+static void NRI_CALL FreeBudgetedMemory(MemoryBudget&, Memory&) {
+}
+
+static void NRI_CALL TouchBudgetedMemory(MemoryBudget&, Memory* const*, uint32_t) {
+}
+
+static void NRI_CALL UpdateMemoryBudget(MemoryBudget&) {
+}
+
+static void NRI_CALL GetMemoryBudgetStats(const MemoryBudget&, MemoryLocation, MemoryBudgetStats& memoryBudgetStats) {
+    memoryBudgetStats = {};
+}
+
+// Not a dummy: indices, deferred frees and batched writes work on top of the core interface
+static Result NRI_CALL CreateBindlessTable(Device& device, const BindlessTableDesc& bindlessTableDesc, BindlessTable*& bindlessTable) {
+    DeviceNONE& deviceNONE = (DeviceNONE&)device;
+    HelperBindlessTable* impl = Allocate<HelperBindlessTable>(deviceNONE.GetAllocationCallbacks(), deviceNONE.GetCoreInterface(), device);
+    Result result = impl->Create(bindlessTableDesc);
+
+    if (result != Result::SUCCESS) {
+        Destroy(deviceNONE.GetAllocationCallbacks(), impl);
+        bindlessTable = nullptr;
+    } else
+        bindlessTable = (BindlessTable*)impl;
+
+    return result;
+}
+
+static void NRI_CALL DestroyBindlessTable(BindlessTable& bindlessTable) {
+    Destroy(((DeviceBase&)((HelperBindlessTable&)bindlessTable).GetDevice()).GetAllocationCallbacks(), (HelperBindlessTable*)&bindlessTable);
+}
+
+static Result NRI_CALL AllocateBindlessIndices(BindlessTable& bindlessTable, uint32_t* indices, uint32_t indexNum) {
+    return ((HelperBindlessTable&)bindlessTable).AllocateIndices(indices, indexNum);
+}
+
+static void NRI_CALL FreeBindlessIndices(BindlessTable& bindlessTable, const uint32_t* indices, uint32_t indexNum, uint64_t fenceValue) {
+    ((HelperBindlessTable&)bindlessTable).FreeIndices(indices, indexNum, fenceValue);
+}
+
+static void NRI_CALL WriteBindlessDescriptors(BindlessTable& bindlessTable, const BindlessWriteDesc* bindlessWriteDescs, uint32_t bindlessWriteDescNum) {
+    ((HelperBindlessTable&)bindlessTable).WriteDescriptors(bindlessWriteDescs, bindlessWriteDescNum);
+}
+
+static void NRI_CALL UpdateBindlessTable(BindlessTable& bindlessTable) {
+    ((HelperBindlessTable&)bindlessTable).Update();
+}
+
+static DescriptorSet* NRI_CALL GetBindlessTableDescriptorSet(const BindlessTable& bindlessTable) {
+    return ((HelperBindlessTable&)bindlessTable).GetDescriptorSet();
+}
+
+// Not a dummy: lookups, LRU and stats work on top of the core interface
+static Result NRI_CALL CreateDescriptorSetCache(Device& device, const DescriptorSetCacheDesc& descriptorSetCacheDesc, DescriptorSetCache*& descriptorSetCache) {
+    DeviceNONE& deviceNONE = (DeviceNONE&)device;
+
+    HelperDescriptorSetCache* impl = Allocate<HelperDescriptorSetCache>(deviceNONE.GetAllocationCallbacks(), deviceNONE.GetCoreInterface(), device);
+    Result result = impl->Create(descriptorSetCacheDesc);
+
+    if (result != Result::SUCCESS) {
+        Destroy(deviceNONE.GetAllocationCallbacks(), impl);
+        descriptorSetCache = nullptr;
+    } else
+        descriptorSetCache = (DescriptorSetCache*)impl;
+
+    return result;
+}
+
+static void NRI_CALL DestroyDescriptorSetCache(DescriptorSetCache& descriptorSetCache) {
+    Destroy(((DeviceBase&)((HelperDescriptorSetCache&)descriptorSetCache).GetDevice()).GetAllocationCallbacks(), (HelperDescriptorSetCache*)&descriptorSetCache);
+}
+
+static Result NRI_CALL GetCachedDescriptorSet(DescriptorSetCache& descriptorSetCache, const CachedDescriptorSetDesc& cachedDescriptorSetDesc, uint64_t fenceValue, DescriptorSet*& descriptorSet) {
+    return ((HelperDescriptorSetCache&)descriptorSetCache).GetDescriptorSet(cachedDescriptorSetDesc, fenceValue, descriptorSet);
+}
+
+static void NRI_CALL PurgeCachedDescriptorSets(DescriptorSetCache& descriptorSetCache, const Descriptor* const* descriptors, uint32_t descriptorNum) {
+    ((HelperDescriptorSetCache&)descriptorSetCache).Purge(descriptors, descriptorNum);
+}
+
+static void NRI_CALL GetDescriptorSetCacheStats(const DescriptorSetCache& descriptorSetCache, DescriptorSetCacheStats& descriptorSetCacheStats) {
+    ((HelperDescriptorSetCache&)descriptorSetCache).GetStats(descriptorSetCacheStats);
+}
+
+// Not a dummy: lookups and stats work on top of the core interface
+static Result NRI_CALL CreatePipelineCache(Device& device, const PipelineCacheDesc& pipelineCacheDesc, PipelineCache*& pipelineCache) {
+    DeviceNONE& deviceNONE = (DeviceNONE&)device;
+
+    HelperPipelineCache* impl = Allocate<HelperPipelineCache>(deviceNONE.GetAllocationCallbacks(), deviceNONE.GetCoreInterface(), device);
+    Result result = impl->Create(pipelineCacheDesc);
+
+    if (result != Result::SUCCESS) {
+        Destroy(deviceNONE.GetAllocationCallbacks(), impl);
+        pipelineCache = nullptr;
+    } else
+        pipelineCache = (PipelineCache*)impl;
+
+    return result;
+}
+
+static void NRI_CALL DestroyPipelineCache(PipelineCache& pipelineCache) {
+    Destroy(((DeviceBase&)((HelperPipelineCache&)pipelineCache).GetDevice()).GetAllocationCallbacks(), (HelperPipelineCache*)&pipelineCache);
+}
+
+static Result NRI_CALL GetCachedGraphicsPipeline(PipelineCache& pipelineCache, const GraphicsPipelineDesc& graphicsPipelineDesc, Pipeline*& pipeline) {
+    return ((HelperPipelineCache&)pipelineCache).GetGraphicsPipeline(graphicsPipelineDesc, pipeline);
+}
+
+static Result NRI_CALL GetCachedComputePipeline(PipelineCache& pipelineCache, const ComputePipelineDesc& computePipelineDesc, Pipeline*& pipeline) {
+    return ((HelperPipelineCache&)pipelineCache).GetComputePipeline(computePipelineDesc, pipeline);
+}
+
+static void NRI_CALL PurgeCachedPipelines(PipelineCache& pipelineCache, const PipelineLayout& pipelineLayout) {
+    ((HelperPipelineCache&)pipelineCache).Purge(pipelineLayout);
+}
+
+static void NRI_CALL GetPipelineCacheStats(const PipelineCache& pipelineCache, PipelineCacheStats& pipelineCacheStats) {
+    ((HelperPipelineCache&)pipelineCache).GetStats(pipelineCacheStats);
+}
+
 static Result NRI_CALL WaitForIdle(Queue&) {
     return Result::SUCCESS;
 }
@@ -758,12 +1638,247 @@ static Result NRI_CALL QueryVideoMemoryInfo(const Device&, MemoryLocation, Video
     return Result::SUCCESS;
 }
 
+static Result NRI_CALL MergePipelineCacheData(Device&, const void*, uint64_t) {
+    return Result::UNSUPPORTED;
+}
+
+static Result NRI_CALL GetPipelineCacheData(const Device&, void*, uint64_t& dataSize) {
+    dataSize = 0;
+
+    return Result::UNSUPPORTED;
+}
+
+static Result NRI_CALL UploadDataHost(Queue& queue, const TextureUploadDesc* textureUploadDescs, uint32_t textureUploadDescNum, const BufferUploadDesc* bufferUploadDescs, uint32_t bufferUploadDescNum) {
+    DeviceNONE& deviceNONE = ((QueueNONE&)queue).GetDevice();
+    HelperDataUpload helperDataUpload(deviceNONE.GetCoreInterface(), (Device&)deviceNONE, queue);
+
+    return helperDataUpload.UploadData(textureUploadDescs, textureUploadDescNum, bufferUploadDescs, bufferUploadDescNum);
+}
+
+static Result NRI_CALL CreateDataUploaderHost(Queue& queue, const DataUploaderDesc& dataUploaderDesc, DataUploader*& dataUploader) {
+    DeviceNONE& deviceNONE = ((QueueNONE&)queue).GetDevice();
+    HelperDataUpload* impl = Allocate<HelperDataUpload>(deviceNONE.GetAllocationCallbacks(), deviceNONE.GetCoreInterface(), (Device&)deviceNONE, queue);
+    Result result = impl->Create(dataUploaderDesc);
+
+    if (result != Result::SUCCESS) {
+        Destroy(deviceNONE.GetAllocationCallbacks(), impl);
+        dataUploader = nullptr;
+    } else
+        dataUploader = (DataUploader*)impl;
+
+    return result;
+}
+
+static void NRI_CALL DestroyDataUploaderHost(DataUploader& dataUploader) {
+    Destroy(((DeviceBase&)((HelperDataUpload&)dataUploader).GetDevice()).GetAllocationCallbacks(), (HelperDataUpload*)&dataUploader);
+}
+
+static Result NRI_CALL UploadDataAsyncHost(DataUploader& dataUploader, const TextureUploadDesc* textureUploadDescs, uint32_t textureUploadDescNum, const BufferUploadDesc* bufferUploadDescs, uint32_t bufferUploadDescNum, UploadTicket& uploadTicket) {
+    return ((HelperDataUpload&)dataUploader).UploadData(textureUploadDescs, textureUploadDescNum, bufferUploadDescs, bufferUploadDescNum, uploadTicket);
+}
+
+static Result NRI_CALL CreateDefragmenterHost(Device& device, const DefragmenterDesc& defragmenterDesc, Defragmenter*& defragmenter) {
+    DeviceNONE& deviceNONE = (DeviceNONE&)device;
+    HelperDefragmenter* impl = Allocate<HelperDefragmenter>(deviceNONE.GetAllocationCallbacks(), deviceNONE.GetCoreInterface(), device);
+    Result result = impl->Create(defragmenterDesc);
+
+    if (result != Result::SUCCESS) {
+        Destroy(deviceNONE.GetAllocationCallbacks(), impl);
+        defragmenter = nullptr;
+    } else
+        defragmenter = (Defragmenter*)impl;
+
+    return result;
+}
+
+static void NRI_CALL DestroyDefragmenterHost(Defragmenter& defragmenter) {
+    Destroy(((DeviceBase&)((HelperDefragmenter&)defragmenter).GetDevice()).GetAllocationCallbacks(), (HelperDefragmenter*)&defragmenter);
+}
+
+static Result NRI_CALL AllocateAndBindDefragmentableMemoryHost(Defragmenter& defragmenter, const ResourceGroupDesc& resourceGroupDesc) {
+    return ((HelperDefragmenter&)defragmenter).AllocateAndBindMemory(resourceGroupDesc);
+}
+
+static void NRI_CALL ReleaseDefragmentableResourcesHost(Defragmenter& defragmenter, Buffer* const* buffers, uint32_t bufferNum, Texture* const* textures, uint32_t textureNum) {
+    ((HelperDefragmenter&)defragmenter).ReleaseResources(buffers, bufferNum, textures, textureNum);
+}
+
+static const DefragmentationMove* NRI_CALL BeginDefragmentationHost(Defragmenter& defragmenter, uint64_t byteBudget, uint64_t fenceValue, uint32_t& moveNum) {
+    return ((HelperDefragmenter&)defragmenter).BeginDefragmentation(byteBudget, fenceValue, moveNum);
+}
+
+static void NRI_CALL CmdDefragmentHost(CommandBuffer& commandBuffer, Defragmenter& defragmenter) {
+    ((HelperDefragmenter&)defragmenter).CmdDefragment(commandBuffer);
+}
+
+static Result NRI_CALL CreateTransientPoolHost(Device& device, const TransientPoolDesc& transientPoolDesc, TransientPool*& transientPool) {
+    DeviceNONE& deviceNONE = (DeviceNONE&)device;
+    HelperTransientPool* impl = Allocate<HelperTransientPool>(deviceNONE.GetAllocationCallbacks(), deviceNONE.GetCoreInterface(), device);
+    Result result = impl->Create(transientPoolDesc);
+
+    if (result != Result::SUCCESS) {
+        Destroy(deviceNONE.GetAllocationCallbacks(), impl);
+        transientPool = nullptr;
+    } else
+        transientPool = (TransientPool*)impl;
+
+    return result;
+}
+
+static void NRI_CALL DestroyTransientPoolHost(TransientPool& transientPool) {
+    Destroy(((DeviceBase&)((HelperTransientPool&)transientPool).GetDevice()).GetAllocationCallbacks(), (HelperTransientPool*)&transientPool);
+}
+
+static void NRI_CALL GetTransientPoolBarriersHost(const TransientPool& transientPool, uint32_t pass, BarrierGroupDesc& barrierGroupDesc) {
+    ((HelperTransientPool&)transientPool).GetBarriers(pass, barrierGroupDesc);
+}
+
+static void NRI_CALL GetTransientPoolStatsHost(const TransientPool& transientPool, TransientPoolStats& transientPoolStats) {
+    transientPoolStats = ((HelperTransientPool&)transientPool).GetStats();
+}
+
+static Result NRI_CALL CreateMemoryBudgetHost(Device& device, const MemoryBudgetDesc& memoryBudgetDesc, MemoryBudget*& memoryBudget) {
+    DeviceNONE& deviceNONE = (DeviceNONE&)device;
+    HelperMemoryBudget* impl = Allocate<HelperMemoryBudget>(deviceNONE.GetAllocationCallbacks(), deviceNONE.GetCoreInterface(), device);
+    Result result = impl->Create(memoryBudgetDesc);
+
+    if (result != Result::SUCCESS) {
+        Destroy(deviceNONE.GetAllocationCallbacks(), impl);
+        memoryBudget = nullptr;
+    } else
+        memoryBudget = (MemoryBudget*)impl;
+
+    return result;
+}
+
+static void NRI_CALL DestroyMemoryBudgetHost(MemoryBudget& memoryBudget) {
+    Destroy(((DeviceBase&)((HelperMemoryBudget&)memoryBudget).GetDevice()).GetAllocationCallbacks(), (HelperMemoryBudget*)&memoryBudget);
+}
+
+static Result NRI_CALL AllocateBudgetedMemoryHost(MemoryBudget& memoryBudget, const AllocateMemoryDesc& allocateMemoryDesc, MemoryLocation memoryLocation, Memory*& memory) {
+    return ((HelperMemoryBudget&)memoryBudget).AllocateMemory(allocateMemoryDesc, memoryLocation, memory);
+}
+
+static void NRI_CALL FreeBudgetedMemoryHost(MemoryBudget& memoryBudget, Memory& memory) {
+    ((HelperMemoryBudget&)memoryBudget).FreeMemory(memory);
+}
+
+static void NRI_CALL TouchBudgetedMemoryHost(MemoryBudget& memoryBudget, Memory* const* memories, uint32_t memoryNum) {
+    ((HelperMemoryBudget&)memoryBudget).TouchMemory(memories, memoryNum);
+}
+
+static void NRI_CALL UpdateMemoryBudgetHost(MemoryBudget& memoryBudget) {
+    ((HelperMemoryBudget&)memoryBudget).Update();
+}
+
+static void NRI_CALL GetMemoryBudgetStatsHost(const MemoryBudget& memoryBudget, MemoryLocation memoryLocation, MemoryBudgetStats& memoryBudgetStats) {
+    ((HelperMemoryBudget&)memoryBudget).GetStats(memoryLocation, memoryBudgetStats);
+}
+
+static Result NRI_CALL QueryVideoMemoryInfoHost(const Device& device, MemoryLocation memoryLocation, VideoMemoryInfo& videoMemoryInfo) {
+    DeviceNONE& deviceNONE = (DeviceNONE&)device;
+
+    // Budget is unknown, it can be simulated via "MemoryBudgetDesc"
+    videoMemoryInfo = {};
+    videoMemoryInfo.usageSize = deviceNONE.GetHostMemoryUsage((MemoryType)memoryLocation);
+
+    return Result::SUCCESS;
+}
+
+static Result NRI_CALL WaitForIdleHost(Queue& queue) {
+    DeviceNONE& deviceNONE = ((QueueNONE&)queue).GetDevice();
+
+    return WaitIdle(deviceNONE.GetCoreInterface(), (Device&)deviceNONE, queue);
+}
+
+static uint32_t NRI_CALL CalculateAllocationNumberHost(const Device& device, const ResourceGroupDesc& resourceGroupDesc) {
+    DeviceNONE& deviceNONE = (DeviceNONE&)device;
+    HelperDeviceMemoryAllocator allocator(deviceNONE.GetCoreInterface(), (Device&)device);
+
+    return allocator.CalculateAllocationNumber(resourceGroupDesc);
+}
+
+static Result NRI_CALL AllocateAndBindMemoryHost(Device& device, const ResourceGroupDesc& resourceGroupDesc, Memory** allocations) {
+    DeviceNONE& deviceNONE = (DeviceNONE&)device;
+    HelperDeviceMemoryAllocator allocator(deviceNONE.GetCoreInterface(), device);
+
+    return allocator.AllocateAndBindMemory(resourceGroupDesc, allocations);
+}
+
 Result DeviceNONE::FillFunctionTable(HelperInterface& table) const {
     table.CalculateAllocationNumber = ::CalculateAllocationNumber;
     table.AllocateAndBindMemory = ::AllocateAndBindMemory;
     table.UploadData = ::UploadData;
+    table.CreateDataUploader = ::CreateDataUploader;
+    table.DestroyDataUploader = ::DestroyDataUploader;
+    table.UploadDataAsync = ::UploadDataAsync;
+    table.CreateDefragmenter = ::CreateDefragmenter;
+    table.DestroyDefragmenter = ::DestroyDefragmenter;
+    table.AllocateAndBindDefragmentableMemory = ::AllocateAndBindDefragmentableMemory;
+    table.ReleaseDefragmentableResources = ::ReleaseDefragmentableResources;
+    table.BeginDefragmentation = ::BeginDefragmentation;
+    table.CmdDefragment = ::CmdDefragment;
+    table.CreateTransientPool = ::CreateTransientPool;
+    table.DestroyTransientPool = ::DestroyTransientPool;
+    table.GetTransientPoolBarriers = ::GetTransientPoolBarriers;
+    table.GetTransientPoolStats = ::GetTransientPoolStats;
+    table.CreateMemoryBudget = ::CreateMemoryBudget;
+    table.DestroyMemoryBudget = ::DestroyMemoryBudget;
+    table.AllocateBudgetedMemory = ::AllocateBudgetedMemory;
+    table.FreeBudgetedMemory = ::FreeBudgetedMemory;
+    table.TouchBudgetedMemory = ::TouchBudgetedMemory;
+    table.UpdateMemoryBudget = ::UpdateMemoryBudget;
+    table.GetMemoryBudgetStats = ::GetMemoryBudgetStats;
+    table.CreateBindlessTable = ::CreateBindlessTable;
+    table.DestroyBindlessTable = ::DestroyBindlessTable;
+    table.AllocateBindlessIndices = ::AllocateBindlessIndices;
+    table.FreeBindlessIndices = ::FreeBindlessIndices;
+    table.WriteBindlessDescriptors = ::WriteBindlessDescriptors;
+    table.UpdateBindlessTable = ::UpdateBindlessTable;
+    table.GetBindlessTableDescriptorSet = ::GetBindlessTableDescriptorSet;
+    table.CreateDescriptorSetCache = ::CreateDescriptorSetCache;
+    table.DestroyDescriptorSetCache = ::DestroyDescriptorSetCache;
+    table.GetCachedDescriptorSet = ::GetCachedDescriptorSet;
+    table.PurgeCachedDescriptorSets = ::PurgeCachedDescriptorSets;
+    table.GetDescriptorSetCacheStats = ::GetDescriptorSetCacheStats;
+    table.CreatePipelineCache = ::CreatePipelineCache;
+    table.DestroyPipelineCache = ::DestroyPipelineCache;
+    table.GetCachedGraphicsPipeline = ::GetCachedGraphicsPipeline;
+    table.GetCachedComputePipeline = ::GetCachedComputePipeline;
+    table.PurgeCachedPipelines = ::PurgeCachedPipelines;
+    table.GetPipelineCacheStats = ::GetPipelineCacheStats;
     table.WaitForIdle = ::WaitForIdle;
     table.QueryVideoMemoryInfo = ::QueryVideoMemoryInfo;
+    table.MergePipelineCacheData = ::MergePipelineCacheData;
+    table.GetPipelineCacheData = ::GetPipelineCacheData;
+
+    if (m_IsHostMemory) {
+        table.CalculateAllocationNumber = ::CalculateAllocationNumberHost;
+        table.AllocateAndBindMemory = ::AllocateAndBindMemoryHost;
+        table.UploadData = ::UploadDataHost;
+        table.CreateDataUploader = ::CreateDataUploaderHost;
+        table.DestroyDataUploader = ::DestroyDataUploaderHost;
+        table.UploadDataAsync = ::UploadDataAsyncHost;
+        table.CreateDefragmenter = ::CreateDefragmenterHost;
+        table.DestroyDefragmenter = ::DestroyDefragmenterHost;
+        table.AllocateAndBindDefragmentableMemory = ::AllocateAndBindDefragmentableMemoryHost;
+        table.ReleaseDefragmentableResources = ::ReleaseDefragmentableResourcesHost;
+        table.BeginDefragmentation = ::BeginDefragmentationHost;
+        table.CmdDefragment = ::CmdDefragmentHost;
+        table.CreateTransientPool = ::CreateTransientPoolHost;
+        table.DestroyTransientPool = ::DestroyTransientPoolHost;
+        table.GetTransientPoolBarriers = ::GetTransientPoolBarriersHost;
+        table.GetTransientPoolStats = ::GetTransientPoolStatsHost;
+        table.CreateMemoryBudget = ::CreateMemoryBudgetHost;
+        table.DestroyMemoryBudget = ::DestroyMemoryBudgetHost;
+        table.AllocateBudgetedMemory = ::AllocateBudgetedMemoryHost;
+        table.FreeBudgetedMemory = ::FreeBudgetedMemoryHost;
+        table.TouchBudgetedMemory = ::TouchBudgetedMemoryHost;
+        table.UpdateMemoryBudget = ::UpdateMemoryBudgetHost;
+        table.GetMemoryBudgetStats = ::GetMemoryBudgetStatsHost;
+        table.WaitForIdle = ::WaitForIdleHost;
+        table.QueryVideoMemoryInfo = ::QueryVideoMemoryInfoHost;
+    }
 
     return Result::SUCCESS;
 }
@@ -948,11 +2063,66 @@ static Result AllocateAccelerationStructure(Device&, const AllocateAccelerationS
     return Result::SUCCESS;
 }
 
+static Result AllocateBufferHost(Device& device, const AllocateBufferDesc& bufferDesc, Buffer*& buffer) {
+    Result result = CreateBufferHost(device, bufferDesc.desc, buffer);
+    if (result != Result::SUCCESS)
+        return result;
+
+    BufferNONE& bufferNONE = (BufferNONE&)*buffer;
+
+    MemoryDesc memoryDesc = {};
+    GetBufferMemoryDescHost(*buffer, bufferDesc.memoryLocation, memoryDesc);
+    memoryDesc.mustBeDedicated |= bufferDesc.dedicated;
+
+    result = ((DeviceNONE&)device).GetMemorySubAllocator().Allocate(memoryDesc, false, bufferDesc.memoryPriority, bufferNONE.allocation);
+    if (result != Result::SUCCESS) {
+        DestroyBufferHost(*buffer);
+        buffer = nullptr;
+
+        return result;
+    }
+
+    bufferNONE.memory = (MemoryNONE*)bufferNONE.allocation.memory;
+    bufferNONE.memoryOffset = bufferNONE.allocation.offset;
+
+    return Result::SUCCESS;
+}
+
+static Result AllocateTextureHost(Device& device, const AllocateTextureDesc& textureDesc, Texture*& texture) {
+    Result result = CreateTextureHost(device, textureDesc.desc, texture);
+    if (result != Result::SUCCESS)
+        return result;
+
+    TextureNONE& textureNONE = (TextureNONE&)*texture;
+
+    MemoryDesc memoryDesc = {};
+    GetTextureMemoryDescHost(*texture, textureDesc.memoryLocation, memoryDesc);
+    memoryDesc.mustBeDedicated |= textureDesc.dedicated;
+
+    result = ((DeviceNONE&)device).GetMemorySubAllocator().Allocate(memoryDesc, true, textureDesc.memoryPriority, textureNONE.allocation);
+    if (result != Result::SUCCESS) {
+        DestroyTextureHost(*texture);
+        texture = nullptr;
+
+        return result;
+    }
+
+    textureNONE.memory = (MemoryNONE*)textureNONE.allocation.memory;
+    textureNONE.memoryOffset = textureNONE.allocation.offset;
+
+    return Result::SUCCESS;
+}
+
 Result DeviceNONE::FillFunctionTable(ResourceAllocatorInterface& table) const {
     table.AllocateBuffer = ::AllocateBuffer;
     table.AllocateTexture = ::AllocateTexture;
     table.AllocateAccelerationStructure = ::AllocateAccelerationStructure;
 
+    if (m_IsHostMemory) {
+        table.AllocateBuffer = ::AllocateBufferHost;
+        table.AllocateTexture = ::AllocateTextureHost;
+    }
+
     return Result::SUCCESS;
 }
 
@@ -978,6 +2148,11 @@ static uint32_t UpdateStreamerConstantBuffer(Streamer&, const void*, uint32_t) {
     return 0;
 }
 
+static void UpdateStreamerConstantBuffers(Streamer&, const ConstantBufferUpdateRequestDesc*, uint32_t constantBufferUpdateRequestDescNum, uint32_t* offsets) {
+    for (uint32_t i = 0; i < constantBufferUpdateRequestDescNum; i++)
+        offsets[i] = 0;
+}
+
 static uint64_t AddStreamerBufferUpdateRequest(Streamer&, const BufferUpdateRequestDesc&) {
     return 0;
 }
@@ -986,10 +2161,23 @@ static uint64_t AddStreamerTextureUpdateRequest(Streamer&, const TextureUpdateRe
     return 0;
 }
 
+static void* ReserveStreamerBufferUpdateRequest(Streamer&, const BufferUpdateRequestDesc&, uint64_t& offset) {
+    offset = 0;
+
+    return nullptr;
+}
+
+static void SetStreamerFenceValue(Streamer&, uint64_t) {
+}
+
 static Result CopyStreamerUpdateRequests(Streamer&) {
     return Result::SUCCESS;
 }
 
+static void GetStreamerStats(const Streamer&, StreamerStats& streamerStats) {
+    streamerStats = {};
+}
+
 static Buffer* GetStreamerDynamicBuffer(Streamer&) {
     return nullptr;
 }
@@ -997,6 +2185,68 @@ static Buffer* GetStreamerDynamicBuffer(Streamer&) {
 static void CmdUploadStreamerUpdateRequests(CommandBuffer&, Streamer&) {
 }
 
+static Result CreateStreamerHost(Device& device, const StreamerDesc& streamerDesc, Streamer*& streamer) {
+    DeviceNONE& deviceNONE = (DeviceNONE&)device;
+    StreamerImpl* impl = Allocate<StreamerImpl>(deviceNONE.GetAllocationCallbacks(), device, deviceNONE.GetCoreInterface());
+    Result result = impl->Create(streamerDesc);
+
+    if (result != Result::SUCCESS) {
+        Destroy(deviceNONE.GetAllocationCallbacks(), impl);
+        streamer = nullptr;
+    } else
+        streamer = (Streamer*)impl;
+
+    return result;
+}
+
+static void DestroyStreamerHost(Streamer& streamer) {
+    Destroy(((DeviceBase&)((StreamerImpl&)streamer).GetDevice()).GetAllocationCallbacks(), (StreamerImpl*)&streamer);
+}
+
+static Buffer* GetStreamerConstantBufferHost(Streamer& streamer) {
+    return ((StreamerImpl&)streamer).GetConstantBuffer();
+}
+
+static uint32_t UpdateStreamerConstantBufferHost(Streamer& streamer, const void* data, uint32_t dataSize) {
+    return ((StreamerImpl&)streamer).UpdateConstantBuffer(data, dataSize);
+}
+
+static void UpdateStreamerConstantBuffersHost(Streamer& streamer, const ConstantBufferUpdateRequestDesc* constantBufferUpdateRequestDescs, uint32_t constantBufferUpdateRequestDescNum, uint32_t* offsets) {
+    ((StreamerImpl&)streamer).UpdateConstantBuffers(constantBufferUpdateRequestDescs, constantBufferUpdateRequestDescNum, offsets);
+}
+
+static uint64_t AddStreamerBufferUpdateRequestHost(Streamer& streamer, const BufferUpdateRequestDesc& bufferUpdateRequestDesc) {
+    return ((StreamerImpl&)streamer).AddBufferUpdateRequest(bufferUpdateRequestDesc);
+}
+
+static uint64_t AddStreamerTextureUpdateRequestHost(Streamer& streamer, const TextureUpdateRequestDesc& textureUpdateRequestDesc) {
+    return ((StreamerImpl&)streamer).AddTextureUpdateRequest(textureUpdateRequestDesc);
+}
+
+static void* ReserveStreamerBufferUpdateRequestHost(Streamer& streamer, const BufferUpdateRequestDesc& bufferUpdateRequestDesc, uint64_t& offset) {
+    return ((StreamerImpl&)streamer).ReserveBufferUpdateRequest(bufferUpdateRequestDesc, offset);
+}
+
+static void SetStreamerFenceValueHost(Streamer& streamer, uint64_t fenceValue) {
+    ((StreamerImpl&)streamer).SetFenceValue(fenceValue);
+}
+
+static Result CopyStreamerUpdateRequestsHost(Streamer& streamer) {
+    return ((StreamerImpl&)streamer).CopyUpdateRequests();
+}
+
+static void GetStreamerStatsHost(const Streamer& streamer, StreamerStats& streamerStats) {
+    ((StreamerImpl&)streamer).GetStats(streamerStats);
+}
+
+static Buffer* GetStreamerDynamicBufferHost(Streamer& streamer) {
+    return ((StreamerImpl&)streamer).GetDynamicBuffer();
+}
+
+static void CmdUploadStreamerUpdateRequestsHost(CommandBuffer& commandBuffer, Streamer& streamer) {
+    ((StreamerImpl&)streamer).CmdUploadUpdateRequests(commandBuffer);
+}
+
 Result DeviceNONE::FillFunctionTable(StreamerInterface& table) const {
     table.CreateStreamer = ::CreateStreamer;
     table.DestroyStreamer = ::DestroyStreamer;
@@ -1004,10 +2254,30 @@ Result DeviceNONE::FillFunctionTable(StreamerInterface& table) const {
     table.GetStreamerDynamicBuffer = ::GetStreamerDynamicBuffer;
     table.AddStreamerBufferUpdateRequest = ::AddStreamerBufferUpdateRequest;
     table.AddStreamerTextureUpdateRequest = ::AddStreamerTextureUpdateRequest;
+    table.ReserveStreamerBufferUpdateRequest = ::ReserveStreamerBufferUpdateRequest;
     table.UpdateStreamerConstantBuffer = ::UpdateStreamerConstantBuffer;
+    table.UpdateStreamerConstantBuffers = ::UpdateStreamerConstantBuffers;
+    table.SetStreamerFenceValue = ::SetStreamerFenceValue;
     table.CopyStreamerUpdateRequests = ::CopyStreamerUpdateRequests;
+    table.GetStreamerStats = ::GetStreamerStats;
     table.CmdUploadStreamerUpdateRequests = ::CmdUploadStreamerUpdateRequests;
 
+    if (m_IsHostMemory) {
+        table.CreateStreamer = ::CreateStreamerHost;
+        table.DestroyStreamer = ::DestroyStreamerHost;
+        table.GetStreamerConstantBuffer = ::GetStreamerConstantBufferHost;
+        table.GetStreamerDynamicBuffer = ::GetStreamerDynamicBufferHost;
+        table.AddStreamerBufferUpdateRequest = ::AddStreamerBufferUpdateRequestHost;
+        table.AddStreamerTextureUpdateRequest = ::AddStreamerTextureUpdateRequestHost;
+        table.ReserveStreamerBufferUpdateRequest = ::ReserveStreamerBufferUpdateRequestHost;
+        table.UpdateStreamerConstantBuffer = ::UpdateStreamerConstantBufferHost;
+        table.UpdateStreamerConstantBuffers = ::UpdateStreamerConstantBuffersHost;
+        table.SetStreamerFenceValue = ::SetStreamerFenceValueHost;
+        table.CopyStreamerUpdateRequests = ::CopyStreamerUpdateRequestsHost;
+        table.GetStreamerStats = ::GetStreamerStatsHost;
+        table.CmdUploadStreamerUpdateRequests = ::CmdUploadStreamerUpdateRequestsHost;
+    }
+
     return Result::SUCCESS;
 }
 
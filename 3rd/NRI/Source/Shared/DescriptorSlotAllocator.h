@@ -0,0 +1,130 @@
+// © 2021 NVIDIA Corporation
+
+#pragma once
+
+constexpr uint32_t DESCRIPTOR_SLOT_POOL_MAX_NUM = 4;         // "D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES"
+constexpr uint32_t DESCRIPTOR_SLOT_MAGAZINE_SIZE = 64;       // slots moved between a thread cache and a pool at once
+constexpr uint32_t DESCRIPTOR_SLOT_SEGMENT_BASE_SIZE = 64;   // magazines in the first segment, each next segment is 2x bigger
+constexpr uint32_t DESCRIPTOR_SLOT_SEGMENT_MAX_NUM = 21;     // enough magazines for 2^32 slots
+constexpr uint32_t DESCRIPTOR_SLOT_INVALID = uint32_t(-1);
+
+// Called under the growth lock to back slots "[pageIndex * pageSize; (pageIndex + 1) * pageSize)" of a pool (for example, by a descriptor heap)
+typedef nri::Result (*DescriptorSlotPageCallback)(void* userArg, uint32_t poolIndex, uint32_t pageIndex);
+
+struct DescriptorSlotAllocatorDesc {
+    DescriptorSlotPageCallback AddPage;
+    void* userArg;
+    uint32_t poolNum;
+    uint32_t pageSize;
+    uint32_t pageMaxNum;
+};
+
+struct DescriptorSlotMagazine {
+    std::atomic_uint32_t next; // "index + 1" of the next magazine in a stack, "0" terminates
+    std::array<uint32_t, DESCRIPTOR_SLOT_MAGAZINE_SIZE> slots;
+};
+
+// Lock-free (tags prevent ABA) stacks of magazines. Magazines are never freed before the allocator, so reading a stale "next" is safe
+struct alignas(LOCK_CACHELINE_SIZE) DescriptorSlotPool {
+    std::atomic_uint64_t fullMagazines; // "tag << 32 | (index + 1)"
+    std::atomic_uint32_t slotNum;       // slots handed out at least once
+    std::atomic_uint32_t capacity;      // slots backed by pages
+};
+
+struct DescriptorSlotCache {
+    std::array<uint32_t, DESCRIPTOR_SLOT_MAGAZINE_SIZE * 2> slots;
+    uint32_t slotNum;
+};
+
+struct DescriptorSlotThreadCache {
+    std::array<DescriptorSlotCache, DESCRIPTOR_SLOT_POOL_MAX_NUM> pools;
+    ThreadToken* threadToken; // caches of finished threads are adopted by new threads, with their slots
+    DescriptorSlotThreadCache* next;
+};
+
+// Allocates indices of descriptor slots. Each thread allocates and frees from its own cache, which exchanges full magazines
+// with the pool without locks. Never used slots are handed out by bumping "slotNum", the lock is taken only to add a page
+class DescriptorSlotAllocator {
+public:
+    DescriptorSlotAllocator(const AllocationCallbacks& allocationCallbacks, uint64_t id, const DescriptorSlotAllocatorDesc& desc);
+    ~DescriptorSlotAllocator();
+
+    DescriptorSlotAllocator(const DescriptorSlotAllocator&) = delete;
+    DescriptorSlotAllocator& operator=(const DescriptorSlotAllocator&) = delete;
+
+    inline nri::Result Allocate(uint32_t poolIndex, uint32_t& slot) {
+        DescriptorSlotThreadCache* threadCache = GetThreadCache();
+        if (!threadCache)
+            return nri::Result::OUT_OF_MEMORY;
+
+        DescriptorSlotCache& cache = threadCache->pools[poolIndex];
+        if (!cache.slotNum) {
+            nri::Result result = Refill(cache, poolIndex);
+            if (result != nri::Result::SUCCESS)
+                return result;
+        }
+
+        slot = cache.slots[--cache.slotNum];
+
+        return nri::Result::SUCCESS;
+    }
+
+    // "INVALID_ARGUMENT" if the slot has never been allocated or is freed more times than allocated (detected once a pool runs out of empty magazines)
+    inline nri::Result Free(uint32_t poolIndex, uint32_t slot) {
+        if (slot >= GetCapacity(poolIndex))
+            return nri::Result::INVALID_ARGUMENT;
+
+        DescriptorSlotThreadCache* threadCache = GetThreadCache();
+        if (!threadCache)
+            return nri::Result::OUT_OF_MEMORY; // the slot is lost
+
+        DescriptorSlotCache& cache = threadCache->pools[poolIndex];
+        if (cache.slotNum == cache.slots.size() && !Flush(cache, poolIndex))
+            return nri::Result::INVALID_ARGUMENT;
+
+        cache.slots[cache.slotNum++] = slot;
+
+        return nri::Result::SUCCESS;
+    }
+
+    inline uint32_t GetCapacity(uint32_t poolIndex) const {
+        return m_Pools[poolIndex].capacity.load(std::memory_order_acquire);
+    }
+
+private:
+    inline DescriptorSlotThreadCache* GetThreadCache() {
+        static thread_local ThreadCacheEntries<DescriptorSlotThreadCache> t_Caches = {};
+
+        ThreadCacheEntries<DescriptorSlotThreadCache>& caches = t_Caches;
+        DescriptorSlotThreadCache* cache = caches.Find(m_Id);
+        if (!cache) {
+            cache = AcquireThreadCache();
+            if (cache)
+                caches.Add(m_Id, cache);
+        }
+
+        return cache;
+    }
+
+    DescriptorSlotThreadCache* AcquireThreadCache();
+    DescriptorSlotMagazine& GetMagazine(uint32_t index) const;
+    uint32_t PopMagazine(std::atomic_uint64_t& stack);
+    void PushMagazine(std::atomic_uint64_t& stack, uint32_t index);
+    nri::Result Refill(DescriptorSlotCache& cache, uint32_t poolIndex);
+    bool Reclaim(DescriptorSlotCache& cache, uint32_t poolIndex);
+    bool Flush(DescriptorSlotCache& cache, uint32_t poolIndex);
+    nri::Result AddPage(uint32_t poolIndex, uint32_t capacity);
+    bool AddMagazines(uint32_t magazineNum);
+
+    std::array<DescriptorSlotPool, DESCRIPTOR_SLOT_POOL_MAX_NUM> m_Pools = {};
+    std::atomic_uint64_t m_EmptyMagazines = 0;
+    std::array<DescriptorSlotMagazine*, DESCRIPTOR_SLOT_SEGMENT_MAX_NUM> m_Segments = {};
+    const AllocationCallbacks& m_AllocationCallbacks;
+    DescriptorSlotAllocatorDesc m_Desc = {};
+    uint64_t m_Id = 0;
+    uint32_t m_MagazineNum = 0;
+    uint32_t m_SegmentNum = 0;
+    Lock m_GrowthLock;
+    Lock m_ThreadCacheLock;
+    DescriptorSlotThreadCache* m_ThreadCaches = nullptr;
+};
@@ -0,0 +1,221 @@
+// © 2021 NVIDIA Corporation
+
+DescriptorSlotAllocator::DescriptorSlotAllocator(const AllocationCallbacks& allocationCallbacks, uint64_t id, const DescriptorSlotAllocatorDesc& desc)
+    : m_AllocationCallbacks(allocationCallbacks)
+    , m_Desc(desc)
+    , m_Id(id) {
+    assert(desc.poolNum <= DESCRIPTOR_SLOT_POOL_MAX_NUM);
+    assert(desc.pageSize);
+}
+
+DescriptorSlotAllocator::~DescriptorSlotAllocator() {
+    for (uint32_t i = 0; i < m_SegmentNum; i++)
+        m_AllocationCallbacks.Free(m_AllocationCallbacks.userArg, m_Segments[i]);
+
+    while (m_ThreadCaches) {
+        DescriptorSlotThreadCache* next = m_ThreadCaches->next;
+        ReleaseThreadToken(m_ThreadCaches->threadToken);
+        Destroy(m_AllocationCallbacks, m_ThreadCaches);
+        m_ThreadCaches = next;
+    }
+}
+
+DescriptorSlotThreadCache* DescriptorSlotAllocator::AcquireThreadCache() {
+    ThreadToken* threadToken = AcquireThreadToken();
+    if (!threadToken)
+        return nullptr;
+
+    ExclusiveScope lock(m_ThreadCacheLock);
+
+    // Evicted from "thread_local" entries
+    DescriptorSlotThreadCache* abandonedCache = nullptr;
+    for (DescriptorSlotThreadCache* cache = m_ThreadCaches; cache; cache = cache->next) {
+        if (cache->threadToken == threadToken) {
+            ReleaseThreadToken(threadToken);
+            return cache;
+        }
+
+        if (!abandonedCache && !cache->threadToken->isAlive.load(std::memory_order_acquire))
+            abandonedCache = cache;
+    }
+
+    // Adopt the cache of a finished thread, the number of caches doesn't exceed the peak number of threads
+    if (abandonedCache) {
+        ReleaseThreadToken(abandonedCache->threadToken);
+        abandonedCache->threadToken = threadToken;
+
+        return abandonedCache;
+    }
+
+    DescriptorSlotThreadCache* cache = ::Allocate<DescriptorSlotThreadCache>(m_AllocationCallbacks, DescriptorSlotThreadCache{{}, threadToken, m_ThreadCaches});
+    if (cache)
+        m_ThreadCaches = cache;
+    else
+        ReleaseThreadToken(threadToken);
+
+    return cache;
+}
+
+DescriptorSlotMagazine& DescriptorSlotAllocator::GetMagazine(uint32_t index) const {
+    // Segment "i" starts at "BASE * (2^i - 1)"
+    uint32_t segment = FindMostSignificantBit(index / DESCRIPTOR_SLOT_SEGMENT_BASE_SIZE + 1);
+    uint32_t offset = index - DESCRIPTOR_SLOT_SEGMENT_BASE_SIZE * ((1u << segment) - 1);
+
+    return m_Segments[segment][offset];
+}
+
+uint32_t DescriptorSlotAllocator::PopMagazine(std::atomic_uint64_t& stack) {
+    uint64_t head = stack.load(std::memory_order_acquire);
+
+    while (true) {
+        uint32_t index = (uint32_t)head;
+        if (!index)
+            return DESCRIPTOR_SLOT_INVALID;
+
+        uint64_t tag = (head >> 32) + 1;
+        uint32_t next = GetMagazine(index - 1).next.load(std::memory_order_relaxed);
+        if (stack.compare_exchange_weak(head, (tag << 32) | next, std::memory_order_acquire, std::memory_order_acquire))
+            return index - 1;
+    }
+}
+
+void DescriptorSlotAllocator::PushMagazine(std::atomic_uint64_t& stack, uint32_t index) {
+    DescriptorSlotMagazine& magazine = GetMagazine(index);
+    uint64_t head = stack.load(std::memory_order_relaxed);
+
+    while (true) {
+        magazine.next.store((uint32_t)head, std::memory_order_relaxed);
+
+        uint64_t tag = (head >> 32) + 1;
+        if (stack.compare_exchange_weak(head, (tag << 32) | (index + 1), std::memory_order_release, std::memory_order_relaxed))
+            return;
+    }
+}
+
+nri::Result DescriptorSlotAllocator::Refill(DescriptorSlotCache& cache, uint32_t poolIndex) {
+    DescriptorSlotPool& pool = m_Pools[poolIndex];
+
+    while (true) {
+        // Freed slots first
+        uint32_t index = PopMagazine(pool.fullMagazines);
+        if (index != DESCRIPTOR_SLOT_INVALID) {
+            const DescriptorSlotMagazine& magazine = GetMagazine(index);
+            std::copy(magazine.slots.begin(), magazine.slots.end(), cache.slots.begin());
+            cache.slotNum = DESCRIPTOR_SLOT_MAGAZINE_SIZE;
+
+            PushMagazine(m_EmptyMagazines, index);
+
+            return nri::Result::SUCCESS;
+        }
+
+        // Never used slots
+        uint32_t capacity = pool.capacity.load(std::memory_order_acquire);
+        uint32_t slotNum = pool.slotNum.load(std::memory_order_relaxed);
+        if (slotNum < capacity) {
+            uint32_t num = std::min(capacity - slotNum, DESCRIPTOR_SLOT_MAGAZINE_SIZE);
+            if (pool.slotNum.compare_exchange_weak(slotNum, slotNum + num, std::memory_order_relaxed)) {
+                for (uint32_t i = 0; i < num; i++)
+                    cache.slots[i] = slotNum + num - 1 - i; // ascending order of allocation
+
+                cache.slotNum = num;
+
+                return nri::Result::SUCCESS;
+            }
+
+            continue;
+        }
+
+        // Slots left in caches of finished threads, before growing
+        if (Reclaim(cache, poolIndex))
+            return nri::Result::SUCCESS;
+
+        nri::Result result = AddPage(poolIndex, capacity);
+        if (result != nri::Result::SUCCESS)
+            return result;
+    }
+}
+
+bool DescriptorSlotAllocator::Reclaim(DescriptorSlotCache& cache, uint32_t poolIndex) {
+    ExclusiveScope lock(m_ThreadCacheLock);
+
+    // Finished threads don't touch their caches, which can be adopted only under the lock
+    for (DescriptorSlotThreadCache* threadCache = m_ThreadCaches; threadCache; threadCache = threadCache->next) {
+        DescriptorSlotCache& abandonedCache = threadCache->pools[poolIndex];
+        if (abandonedCache.slotNum && !threadCache->threadToken->isAlive.load(std::memory_order_acquire)) {
+            std::copy(abandonedCache.slots.begin(), abandonedCache.slots.begin() + abandonedCache.slotNum, cache.slots.begin());
+            cache.slotNum = abandonedCache.slotNum;
+            abandonedCache.slotNum = 0;
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool DescriptorSlotAllocator::Flush(DescriptorSlotCache& cache, uint32_t poolIndex) {
+    // Magazines are added with pages: their number covers all slots, so an empty one is available unless slots are freed twice
+    uint32_t index = PopMagazine(m_EmptyMagazines);
+    if (index == DESCRIPTOR_SLOT_INVALID)
+        return false;
+
+    cache.slotNum -= DESCRIPTOR_SLOT_MAGAZINE_SIZE;
+
+    DescriptorSlotMagazine& magazine = GetMagazine(index);
+    std::copy(cache.slots.begin() + cache.slotNum, cache.slots.begin() + cache.slotNum + DESCRIPTOR_SLOT_MAGAZINE_SIZE, magazine.slots.begin());
+
+    PushMagazine(m_Pools[poolIndex].fullMagazines, index);
+
+    return true;
+}
+
+nri::Result DescriptorSlotAllocator::AddPage(uint32_t poolIndex, uint32_t capacity) {
+    ExclusiveScope lock(m_GrowthLock);
+
+    // Already added by another thread
+    DescriptorSlotPool& pool = m_Pools[poolIndex];
+    if (pool.capacity.load(std::memory_order_relaxed) != capacity)
+        return nri::Result::SUCCESS;
+
+    uint32_t pageIndex = capacity / m_Desc.pageSize;
+    if (pageIndex >= m_Desc.pageMaxNum || capacity > uint32_t(-1) - m_Desc.pageSize)
+        return nri::Result::OUT_OF_MEMORY;
+
+    if (!AddMagazines((m_Desc.pageSize + DESCRIPTOR_SLOT_MAGAZINE_SIZE - 1) / DESCRIPTOR_SLOT_MAGAZINE_SIZE))
+        return nri::Result::OUT_OF_MEMORY;
+
+    nri::Result result = m_Desc.AddPage(m_Desc.userArg, poolIndex, pageIndex);
+    if (result != nri::Result::SUCCESS)
+        return result;
+
+    pool.capacity.store(capacity + m_Desc.pageSize, std::memory_order_release);
+
+    return nri::Result::SUCCESS;
+}
+
+bool DescriptorSlotAllocator::AddMagazines(uint32_t magazineNum) {
+    // IMPORTANT: "m_GrowthLock" must be acquired before calling this function
+    for (uint32_t i = 0; i < magazineNum; i++) {
+        uint32_t index = m_MagazineNum;
+
+        uint32_t segmentCapacity = DESCRIPTOR_SLOT_SEGMENT_BASE_SIZE * ((1u << m_SegmentNum) - 1);
+        if (index == segmentCapacity) {
+            if (m_SegmentNum == DESCRIPTOR_SLOT_SEGMENT_MAX_NUM)
+                return false;
+
+            size_t num = DESCRIPTOR_SLOT_SEGMENT_BASE_SIZE << m_SegmentNum;
+            DescriptorSlotMagazine* segment = (DescriptorSlotMagazine*)m_AllocationCallbacks.Allocate(m_AllocationCallbacks.userArg, num * sizeof(DescriptorSlotMagazine), alignof(DescriptorSlotMagazine));
+            if (!segment)
+                return false;
+
+            Construct(segment, num);
+            m_Segments[m_SegmentNum++] = segment;
+        }
+
+        // Published by the release in "PushMagazine"
+        m_MagazineNum++;
+        PushMagazine(m_EmptyMagazines, index);
+    }
+
+    return true;
+}
@@ -39,15 +39,31 @@ struct DebugNameBaseVal {
     }
 };
 
+// Per-thread scratch arena of a device
+struct ScratchArenaSlot {
+    inline ScratchArenaSlot(const AllocationCallbacks& allocator, ThreadToken* owner, ScratchArenaSlot* nextSlot)
+        : arena(allocator)
+        , threadToken(owner)
+        , next(nextSlot) {
+    }
+
+    ScratchArena arena;
+    ThreadToken* threadToken; // arenas of finished threads are adopted by new threads, with their chunks
+    ScratchArenaSlot* next;
+};
+
+
 struct DeviceBase : public DebugNameBaseVal {
     inline DeviceBase(const CallbackInterface& callbacks, const AllocationCallbacks& allocationCallbacks, uint64_t signature = 0)
-        : m_CallbackInterface(callbacks)
-        , m_AllocationCallbacks(allocationCallbacks)
-        , m_StdAllocator(m_AllocationCallbacks)
+        :
 #ifndef NDEBUG
-        , m_Signature(signature)
+        m_Signature(signature),
 #endif
-    {
+        m_CallbackInterface(callbacks)
+        , m_AllocationCallbacks(allocationCallbacks)
+        , m_StdAllocator(m_AllocationCallbacks)
+        , m_Id(GenerateId())
+        , m_ObjectPool(m_AllocationCallbacks, m_Id) {
         MaybeUnused(signature);
     }
 
@@ -59,11 +75,38 @@ struct DeviceBase : public DebugNameBaseVal {
         return m_AllocationCallbacks;
     }
 
-    void ReportMessage(Message messageType, const char* file, uint32_t line, const char* format, ...) const;
+    // Only NONE and Validation objects come from the pool, D3D11, D3D12 and VK objects are allocated via "AllocationCallbacks"
+    inline ObjectPool& GetObjectPool() {
+        return m_ObjectPool;
+    }
 
-    virtual ~DeviceBase() {
+    // Unique across devices, also identifies per-device caches in "thread_local" storage
+    inline uint64_t GetId() const {
+        return m_Id;
     }
 
+    // Ids of devices and other owners of "thread_local" caches never repeat
+    static uint64_t GenerateId();
+
+    // Arenas are owned by the device and live until its destruction, their number doesn't exceed the peak number of threads.
+    // Ids are unique, so cached pointers of destroyed devices never match
+    inline ScratchArena& GetScratchArena() const {
+        static thread_local ThreadCacheEntries<ScratchArena> t_Arenas = {};
+
+        ThreadCacheEntries<ScratchArena>& arenas = t_Arenas;
+        ScratchArena* arena = arenas.Find(m_Id);
+        if (!arena) {
+            arena = &AcquireScratchArena();
+            arenas.Add(m_Id, arena);
+        }
+
+        return *arena;
+    }
+
+    void ReportMessage(Message messageType, const char* file, uint32_t line, const char* format, ...) const;
+
+    virtual ~DeviceBase();
+
     virtual const DeviceDesc& GetDesc() const = 0;
     virtual void Destruct() = 0;
 
@@ -115,6 +158,9 @@ struct DeviceBase : public DebugNameBaseVal {
         return Result::UNSUPPORTED;
     }
 
+private:
+    ScratchArena& AcquireScratchArena() const;
+
 protected:
 #ifndef NDEBUG
     uint64_t m_Signature = 0; // .natvis
@@ -122,6 +168,12 @@ protected:
     CallbackInterface m_CallbackInterface = {};
     AllocationCallbacks m_AllocationCallbacks = {};
     StdAllocator<uint8_t> m_StdAllocator;
+
+private:
+    uint64_t m_Id = 0;
+    mutable Lock m_ScratchArenaLock;
+    mutable ScratchArenaSlot* m_ScratchArenaSlots = nullptr;
+    ObjectPool m_ObjectPool;
 };
 
 } // namespace nri
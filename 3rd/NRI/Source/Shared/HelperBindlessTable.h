@@ -0,0 +1,51 @@
+// © 2021 NVIDIA Corporation
+
+#pragma once
+
+namespace nri {
+
+struct BindlessFree {
+    uint64_t fenceValue;
+    uint32_t index;
+};
+
+// One descriptor set with a single range. Free indices are a lock-free stack shared by all threads (per-thread caches would strand
+// indices of a fixed size table), frees wait for the fence, writes are queued and applied in batches by "Update"
+struct HelperBindlessTable {
+    HelperBindlessTable(const CoreInterface& NRI, Device& device);
+    ~HelperBindlessTable();
+
+    inline Device& GetDevice() {
+        return m_Device;
+    }
+
+    inline DescriptorSet* GetDescriptorSet() const {
+        return m_DescriptorSet;
+    }
+
+    Result Create(const BindlessTableDesc& bindlessTableDesc);
+    Result AllocateIndices(uint32_t* indices, uint32_t indexNum);
+    void FreeIndices(const uint32_t* indices, uint32_t indexNum, uint64_t fenceValue);
+    void WriteDescriptors(const BindlessWriteDesc* bindlessWriteDescs, uint32_t bindlessWriteDescNum);
+    void Update();
+
+private:
+    void PushIndices(uint32_t first, uint32_t last);
+    void ApplyWrites();
+
+    const CoreInterface& m_NRI;
+    Device& m_Device;
+    Vector<BindlessFree> m_PendingFrees;
+    Vector<BindlessWriteDesc> m_PendingWrites;
+    Vector<BindlessWriteDesc> m_Writes;   // being applied, the capacity is reused
+    Vector<Descriptor*> m_Descriptors;    // a run of consecutive indices
+    std::atomic_uint32_t* m_NextIndices = nullptr; // "index + 1" of the next free index, "0" terminates
+    std::atomic_uint64_t m_FreeIndices = 0;        // "tag << 32 | (index + 1)", tags prevent ABA
+    DescriptorPool* m_DescriptorPool = nullptr;
+    DescriptorSet* m_DescriptorSet = nullptr;
+    Fence* m_Fence = nullptr;
+    Lock m_FreeLock;
+    Lock m_WriteLock;
+};
+
+} // namespace nri
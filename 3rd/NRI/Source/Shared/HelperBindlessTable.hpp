@@ -0,0 +1,213 @@
+// © 2021 NVIDIA Corporation
+
+static void SetDescriptorMaxNum(DescriptorPoolDesc& descriptorPoolDesc, DescriptorType descriptorType, uint32_t descriptorNum) {
+    switch (descriptorType) {
+        case DescriptorType::SAMPLER:
+            descriptorPoolDesc.samplerMaxNum = descriptorNum;
+            break;
+        case DescriptorType::CONSTANT_BUFFER:
+            descriptorPoolDesc.constantBufferMaxNum = descriptorNum;
+            break;
+        case DescriptorType::TEXTURE:
+            descriptorPoolDesc.textureMaxNum = descriptorNum;
+            break;
+        case DescriptorType::STORAGE_TEXTURE:
+            descriptorPoolDesc.storageTextureMaxNum = descriptorNum;
+            break;
+        case DescriptorType::BUFFER:
+            descriptorPoolDesc.bufferMaxNum = descriptorNum;
+            break;
+        case DescriptorType::STORAGE_BUFFER:
+            descriptorPoolDesc.storageBufferMaxNum = descriptorNum;
+            break;
+        case DescriptorType::STRUCTURED_BUFFER:
+            descriptorPoolDesc.structuredBufferMaxNum = descriptorNum;
+            break;
+        case DescriptorType::STORAGE_STRUCTURED_BUFFER:
+            descriptorPoolDesc.storageStructuredBufferMaxNum = descriptorNum;
+            break;
+        case DescriptorType::ACCELERATION_STRUCTURE:
+            descriptorPoolDesc.accelerationStructureMaxNum = descriptorNum;
+            break;
+        default:
+            break;
+    }
+}
+
+HelperBindlessTable::HelperBindlessTable(const CoreInterface& NRI, Device& device)
+    : m_NRI(NRI)
+    , m_Device(device)
+    , m_PendingFrees(((DeviceBase&)device).GetStdAllocator())
+    , m_PendingWrites(((DeviceBase&)device).GetStdAllocator())
+    , m_Writes(((DeviceBase&)device).GetStdAllocator())
+    , m_Descriptors(((DeviceBase&)device).GetStdAllocator()) {
+}
+
+HelperBindlessTable::~HelperBindlessTable() {
+    if (m_DescriptorPool)
+        m_NRI.DestroyDescriptorPool(*m_DescriptorPool);
+
+    if (m_NextIndices) {
+        const AllocationCallbacks& allocationCallbacks = ((DeviceBase&)m_Device).GetAllocationCallbacks();
+        allocationCallbacks.Free(allocationCallbacks.userArg, m_NextIndices);
+    }
+}
+
+Result HelperBindlessTable::Create(const BindlessTableDesc& bindlessTableDesc) {
+    m_Fence = bindlessTableDesc.fence;
+
+    DescriptorPoolDesc descriptorPoolDesc = {};
+    descriptorPoolDesc.descriptorSetMaxNum = 1;
+    SetDescriptorMaxNum(descriptorPoolDesc, bindlessTableDesc.descriptorType, bindlessTableDesc.descriptorNum);
+
+    Result result = m_NRI.CreateDescriptorPool(m_Device, descriptorPoolDesc, m_DescriptorPool);
+    if (result != Result::SUCCESS)
+        return result;
+
+    // "variableDescriptorNum" is ignored if the range is not "VARIABLE_SIZED_ARRAY"
+    result = m_NRI.AllocateDescriptorSets(*m_DescriptorPool, *bindlessTableDesc.pipelineLayout, bindlessTableDesc.setIndex, &m_DescriptorSet, 1, bindlessTableDesc.descriptorNum);
+    if (result != Result::SUCCESS)
+        return result;
+
+    uint32_t descriptorNum = bindlessTableDesc.descriptorNum;
+    if (!descriptorNum)
+        return Result::SUCCESS;
+
+    const AllocationCallbacks& allocationCallbacks = ((DeviceBase&)m_Device).GetAllocationCallbacks();
+    m_NextIndices = (std::atomic_uint32_t*)allocationCallbacks.Allocate(allocationCallbacks.userArg, descriptorNum * sizeof(std::atomic_uint32_t), alignof(std::atomic_uint32_t));
+    if (!m_NextIndices)
+        return Result::OUT_OF_MEMORY;
+
+    // All indices are free, the lowest ones on top
+    for (uint32_t i = 0; i < descriptorNum; i++)
+        new (m_NextIndices + i) std::atomic_uint32_t(i + 1 < descriptorNum ? i + 2 : 0);
+
+    m_FreeIndices.store(1, std::memory_order_release);
+
+    return Result::SUCCESS;
+}
+
+Result HelperBindlessTable::AllocateIndices(uint32_t* indices, uint32_t indexNum) {
+    if (!indexNum)
+        return Result::SUCCESS;
+
+    uint64_t head = m_FreeIndices.load(std::memory_order_acquire);
+
+    while (true) {
+        // A chain of "indexNum" indices is taken at once. Links of popped indices change only after the head (and its tag) changes,
+        // so the chain read from an unchanged head is valid
+        uint32_t next = (uint32_t)head;
+        uint32_t i = 0;
+        for (; i < indexNum && next; i++) {
+            indices[i] = next - 1;
+            next = m_NextIndices[next - 1].load(std::memory_order_relaxed);
+        }
+
+        if (i < indexNum) {
+            uint64_t currentHead = m_FreeIndices.load(std::memory_order_acquire);
+            if (currentHead == head)
+                return Result::OUT_OF_MEMORY;
+
+            head = currentHead;
+            continue;
+        }
+
+        uint64_t tag = (head >> 32) + 1;
+        if (m_FreeIndices.compare_exchange_weak(head, (tag << 32) | next, std::memory_order_acquire, std::memory_order_acquire))
+            return Result::SUCCESS;
+    }
+}
+
+void HelperBindlessTable::FreeIndices(const uint32_t* indices, uint32_t indexNum, uint64_t fenceValue) {
+    ExclusiveScope lock(m_FreeLock);
+
+    for (uint32_t i = 0; i < indexNum; i++)
+        m_PendingFrees.push_back({fenceValue, indices[i]});
+}
+
+void HelperBindlessTable::WriteDescriptors(const BindlessWriteDesc* bindlessWriteDescs, uint32_t bindlessWriteDescNum) {
+    ExclusiveScope lock(m_WriteLock);
+
+    m_PendingWrites.insert(m_PendingWrites.end(), bindlessWriteDescs, bindlessWriteDescs + bindlessWriteDescNum);
+}
+
+void HelperBindlessTable::Update() {
+    { // Reclaim indices no longer used by the GPU
+        uint64_t completedValue = m_NRI.GetFenceValue(*m_Fence);
+
+        ExclusiveScope lock(m_FreeLock);
+
+        // Reclaimed indices are linked into a chain, which is pushed at once
+        uint32_t first = 0;
+        uint32_t last = 0;
+        size_t pendingFreeNum = 0;
+        for (const BindlessFree& pendingFree : m_PendingFrees) {
+            if (pendingFree.fenceValue <= completedValue) {
+                m_NextIndices[pendingFree.index].store(first, std::memory_order_relaxed);
+                first = pendingFree.index + 1;
+                if (!last)
+                    last = first;
+            } else
+                m_PendingFrees[pendingFreeNum++] = pendingFree;
+        }
+
+        m_PendingFrees.resize(pendingFreeNum);
+
+        if (first)
+            PushIndices(first - 1, last - 1);
+    }
+
+    {
+        ExclusiveScope lock(m_WriteLock);
+        m_Writes.swap(m_PendingWrites);
+    }
+
+    ApplyWrites();
+}
+
+void HelperBindlessTable::PushIndices(uint32_t first, uint32_t last) {
+    uint64_t head = m_FreeIndices.load(std::memory_order_relaxed);
+
+    while (true) {
+        m_NextIndices[last].store((uint32_t)head, std::memory_order_relaxed);
+
+        uint64_t tag = (head >> 32) + 1;
+        if (m_FreeIndices.compare_exchange_weak(head, (tag << 32) | (first + 1), std::memory_order_release, std::memory_order_relaxed))
+            return;
+    }
+}
+
+void HelperBindlessTable::ApplyWrites() {
+    // Stable, so the last write to an index wins
+    std::stable_sort(m_Writes.begin(), m_Writes.end(), [](const BindlessWriteDesc& a, const BindlessWriteDesc& b) {
+        return a.index < b.index;
+    });
+
+    uint32_t baseIndex = 0;
+    for (size_t i = 0; i < m_Writes.size(); i++) {
+        const BindlessWriteDesc& write = m_Writes[i];
+        if (i + 1 < m_Writes.size() && m_Writes[i + 1].index == write.index)
+            continue;
+
+        if (!m_Descriptors.empty() && write.index != baseIndex + m_Descriptors.size()) {
+            DescriptorRangeUpdateDesc rangeUpdateDesc = {m_Descriptors.data(), (uint32_t)m_Descriptors.size(), baseIndex};
+            m_NRI.UpdateDescriptorRanges(*m_DescriptorSet, 0, 1, &rangeUpdateDesc);
+
+            m_Descriptors.clear();
+        }
+
+        if (m_Descriptors.empty())
+            baseIndex = write.index;
+
+        m_Descriptors.push_back((Descriptor*)write.descriptor);
+    }
+
+    if (!m_Descriptors.empty()) {
+        DescriptorRangeUpdateDesc rangeUpdateDesc = {m_Descriptors.data(), (uint32_t)m_Descriptors.size(), baseIndex};
+        m_NRI.UpdateDescriptorRanges(*m_DescriptorSet, 0, 1, &rangeUpdateDesc);
+
+        m_Descriptors.clear();
+    }
+
+    m_Writes.clear();
+}
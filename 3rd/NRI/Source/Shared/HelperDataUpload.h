@@ -5,22 +5,45 @@
 namespace nri {
 
 constexpr size_t BASE_UPLOAD_BUFFER_SIZE = 1 * 1024 * 1024;
+constexpr uint32_t BASE_UPLOAD_SLOT_NUM = 4;
+
+// Resources used by a submission, reused once the GPU is done with them
+struct HelperUploadSlot {
+    CommandAllocator* commandAllocator;
+    CommandBuffer* commandBuffer;
+    Buffer* buffer;
+    Memory* memory;
+    uint64_t size;
+    uint64_t fenceValue; // busy until the fence reaches this value
+};
 
 struct HelperDataUpload {
     inline HelperDataUpload(const CoreInterface& NRI, Device& device, Queue& queue)
         : m_NRI(NRI)
         , m_Device(device)
         , m_Queue(queue)
-        , m_UploadBufferSize(BASE_UPLOAD_BUFFER_SIZE) {
+        , m_Slots(((DeviceBase&)device).GetStdAllocator()) {
     }
 
+    inline Device& GetDevice() {
+        return m_Device;
+    }
+
+    ~HelperDataUpload();
+
+    Result Create(const DataUploaderDesc& dataUploaderDesc);
     Result UploadData(const TextureUploadDesc* textureDataDescs, uint32_t textureDataDescNum, const BufferUploadDesc* bufferDataDescs, uint32_t bufferDataDescNum);
+    Result UploadData(const TextureUploadDesc* textureDataDescs, uint32_t textureDataDescNum, const BufferUploadDesc* bufferDataDescs, uint32_t bufferDataDescNum, UploadTicket& uploadTicket);
 
 private:
-    Result Create();
+    Result AcquireSlot();
+    Result CreateUploadBuffer(HelperUploadSlot& slot, uint64_t size);
+    Result ResizeUploadBuffer(uint64_t size);
+    Result BeginCommandBuffer();
+    Result EndCommandBufferAndSubmit();
+    Result SubmitAndContinue();
     Result UploadTextures(const TextureUploadDesc* textureDataDescs, uint32_t textureDataDescNum);
     Result UploadBuffers(const BufferUploadDesc* bufferDataDescs, uint32_t bufferDataDescNum);
-    Result EndCommandBuffersAndSubmit();
     bool CopyTextureContent(const TextureUploadDesc& textureDataDesc, Dim_t& layerOffset, Mip_t& mipOffset, bool& isCapacityInsufficient);
     void CopyTextureSubresourceContent(const TextureSubresourceUploadDesc& subresource, uint64_t alignedRowPitch, uint64_t alignedSlicePitch);
     bool CopyBufferContent(const BufferUploadDesc& bufferDataDesc, uint64_t& bufferContentOffset);
@@ -28,15 +51,17 @@ private:
     const CoreInterface& m_NRI;
     Device& m_Device;
     Queue& m_Queue;
-    CommandBuffer* m_CommandBuffer = nullptr;
+    Vector<HelperUploadSlot> m_Slots;
+    CommandBuffer* m_CommandBuffer = nullptr; // of the current slot
+    Buffer* m_UploadBuffer = nullptr;         // of the current slot
     Fence* m_Fence = nullptr;
-    CommandAllocator* m_CommandAllocators = nullptr;
-    Buffer* m_UploadBuffer = nullptr;
-    Memory* m_UploadBufferMemory = nullptr;
     uint8_t* m_MappedMemory = nullptr;
+    uint64_t m_StagingBufferSize = BASE_UPLOAD_BUFFER_SIZE;
     uint64_t m_UploadBufferSize = 0;
     uint64_t m_UploadBufferOffset = 0;
     uint64_t m_FenceValue = 1;
+    uint32_t m_SlotMaxNum = BASE_UPLOAD_SLOT_NUM;
+    uint32_t m_CurrentSlot = 0;
 };
 
 } // namespace nri
\ No newline at end of file
@@ -63,106 +63,235 @@ static void DoTransition(const CoreInterface& m_NRI, CommandBuffer* commandBuffe
     }
 }
 
+HelperDataUpload::~HelperDataUpload() {
+    if (m_Fence)
+        m_NRI.Wait(*m_Fence, m_FenceValue - 1);
+
+    for (HelperUploadSlot& slot : m_Slots) {
+        m_NRI.DestroyCommandBuffer(*slot.commandBuffer);
+        m_NRI.DestroyCommandAllocator(*slot.commandAllocator);
+
+        if (slot.buffer) {
+            m_NRI.DestroyBuffer(*slot.buffer);
+            m_NRI.FreeMemory(*slot.memory);
+        }
+    }
+
+    if (m_Fence)
+        m_NRI.DestroyFence(*m_Fence);
+}
+
+Result HelperDataUpload::Create(const DataUploaderDesc& dataUploaderDesc) {
+    if (dataUploaderDesc.stagingBufferSize)
+        m_StagingBufferSize = dataUploaderDesc.stagingBufferSize;
+
+    if (dataUploaderDesc.uploadMaxNum)
+        m_SlotMaxNum = dataUploaderDesc.uploadMaxNum;
+
+    return m_NRI.CreateFence(m_Device, 0, m_Fence);
+}
+
 Result HelperDataUpload::UploadData(const TextureUploadDesc* textureUploadDescs, uint32_t textureUploadDescNum, const BufferUploadDesc* bufferUploadDescs, uint32_t bufferUploadDescNum) {
-    const DeviceDesc& deviceDesc = m_NRI.GetDeviceDesc(m_Device);
+    Result result = Create({});
+    if (result != Result::SUCCESS)
+        return result;
+
+    // The destructor waits for completion
+    UploadTicket uploadTicket = {};
+
+    return UploadData(textureUploadDescs, textureUploadDescNum, bufferUploadDescs, bufferUploadDescNum, uploadTicket);
+}
+
+Result HelperDataUpload::UploadData(const TextureUploadDesc* textureUploadDescs, uint32_t textureUploadDescNum, const BufferUploadDesc* bufferUploadDescs, uint32_t bufferUploadDescNum, UploadTicket& uploadTicket) {
+    uploadTicket = {m_Fence, m_FenceValue - 1};
+
+    if (!textureUploadDescNum && !bufferUploadDescNum)
+        return Result::SUCCESS;
+
+    // Record
+    Result result = AcquireSlot();
+    if (result != Result::SUCCESS)
+        return result;
+
+    result = BeginCommandBuffer();
+    if (result != Result::SUCCESS)
+        return result;
+
+    result = UploadTextures(textureUploadDescs, textureUploadDescNum);
+    if (result == Result::SUCCESS)
+        result = UploadBuffers(bufferUploadDescs, bufferUploadDescNum);
+
+    if (result != Result::SUCCESS) {
+        m_NRI.EndCommandBuffer(*m_CommandBuffer);
+        return result;
+    }
+
+    // Submit without waiting
+    result = EndCommandBufferAndSubmit();
+    if (result != Result::SUCCESS)
+        return result;
 
-    for (uint32_t i = 0; i < textureUploadDescNum; i++) {
-        if (!textureUploadDescs[i].subresources)
-            continue;
+    uploadTicket.value = m_Slots[m_CurrentSlot].fenceValue;
 
-        const TextureSubresourceUploadDesc& subresource = textureUploadDescs[i].subresources[0];
+    return Result::SUCCESS;
+}
 
-        uint32_t sliceRowNum = std::max(subresource.slicePitch / subresource.rowPitch, 1u);
-        uint64_t alignedRowPitch = Align(subresource.rowPitch, deviceDesc.uploadBufferTextureRowAlignment);
-        uint64_t alignedSlicePitch = Align(sliceRowNum * alignedRowPitch, deviceDesc.uploadBufferTextureSliceAlignment);
-        uint64_t contentSize = alignedSlicePitch * std::max(subresource.sliceNum, 1u);
+Result HelperDataUpload::AcquireSlot() {
+    // Prefer an idle slot, otherwise create a new one or take the oldest
+    uint64_t completedFenceValue = m_NRI.GetFenceValue(*m_Fence);
+    uint32_t slotIndex = 0;
 
-        m_UploadBufferSize = std::max(m_UploadBufferSize, contentSize);
+    for (uint32_t i = 0; i < (uint32_t)m_Slots.size(); i++) {
+        if (m_Slots[i].fenceValue < m_Slots[slotIndex].fenceValue)
+            slotIndex = i;
     }
 
-    m_UploadBufferSize = Align(m_UploadBufferSize, COPY_ALIGNMENT);
+    if (m_Slots.empty() || (m_Slots[slotIndex].fenceValue > completedFenceValue && m_Slots.size() < m_SlotMaxNum)) {
+        HelperUploadSlot slot = {};
+
+        Result result = m_NRI.CreateCommandAllocator(m_Queue, slot.commandAllocator);
+        if (result != Result::SUCCESS)
+            return result;
+
+        result = m_NRI.CreateCommandBuffer(*slot.commandAllocator, slot.commandBuffer);
+        if (result != Result::SUCCESS) {
+            m_NRI.DestroyCommandAllocator(*slot.commandAllocator);
+            return result;
+        }
 
-    Result result = Create();
-    if (result == Result::SUCCESS) {
-        result = UploadTextures(textureUploadDescs, textureUploadDescNum);
-        if (result == Result::SUCCESS)
-            result = UploadBuffers(bufferUploadDescs, bufferUploadDescNum);
+        slotIndex = (uint32_t)m_Slots.size();
+        m_Slots.push_back(slot);
     }
 
-    m_NRI.DestroyCommandBuffer(*m_CommandBuffer);
-    m_NRI.DestroyCommandAllocator(*m_CommandAllocators);
-    m_NRI.DestroyFence(*m_Fence);
-    m_NRI.DestroyBuffer(*m_UploadBuffer);
-    m_NRI.FreeMemory(*m_UploadBufferMemory);
+    m_CurrentSlot = slotIndex;
+
+    // A new slot gets an upload buffer of the base size
+    HelperUploadSlot& slot = m_Slots[m_CurrentSlot];
+    if (!slot.buffer)
+        return CreateUploadBuffer(slot, m_StagingBufferSize);
+
+    return Result::SUCCESS;
+}
+
+Result HelperDataUpload::ResizeUploadBuffer(uint64_t size) {
+    // The slot is idle and nothing recorded so far references the upload buffer
+    HelperUploadSlot& slot = m_Slots[m_CurrentSlot];
+
+    m_NRI.DestroyBuffer(*slot.buffer);
+    m_NRI.FreeMemory(*slot.memory);
+
+    slot.buffer = nullptr;
+    slot.memory = nullptr;
+    slot.size = 0;
+
+    Result result = CreateUploadBuffer(slot, Align(size, COPY_ALIGNMENT));
+
+    m_UploadBuffer = slot.buffer;
+    m_UploadBufferSize = slot.size;
 
     return result;
 }
 
-Result HelperDataUpload::Create() {
+Result HelperDataUpload::CreateUploadBuffer(HelperUploadSlot& slot, uint64_t size) {
     BufferDesc bufferDesc = {};
-    bufferDesc.size = m_UploadBufferSize;
+    bufferDesc.size = size;
 
-    Result result = m_NRI.CreateBuffer(m_Device, bufferDesc, m_UploadBuffer);
+    Result result = m_NRI.CreateBuffer(m_Device, bufferDesc, slot.buffer);
     if (result != Result::SUCCESS)
         return result;
 
     MemoryDesc memoryDesc = {};
-    m_NRI.GetBufferMemoryDesc(*m_UploadBuffer, MemoryLocation::HOST_UPLOAD, memoryDesc);
+    m_NRI.GetBufferMemoryDesc(*slot.buffer, MemoryLocation::HOST_UPLOAD, memoryDesc);
 
     AllocateMemoryDesc allocateMemoryDesc = {};
     allocateMemoryDesc.type = memoryDesc.type;
     allocateMemoryDesc.size = memoryDesc.size;
 
-    result = m_NRI.AllocateMemory(m_Device, allocateMemoryDesc, m_UploadBufferMemory);
-    if (result != Result::SUCCESS)
+    result = m_NRI.AllocateMemory(m_Device, allocateMemoryDesc, slot.memory);
+    if (result != Result::SUCCESS) {
+        m_NRI.DestroyBuffer(*slot.buffer);
+        slot.buffer = nullptr;
+
         return result;
+    }
 
-    const BufferMemoryBindingDesc bufferMemoryBindingDesc = {m_UploadBufferMemory, m_UploadBuffer, 0};
+    const BufferMemoryBindingDesc bufferMemoryBindingDesc = {slot.memory, slot.buffer, 0};
     result = m_NRI.BindBufferMemory(m_Device, &bufferMemoryBindingDesc, 1);
-    if (result != Result::SUCCESS)
+    if (result != Result::SUCCESS) {
+        m_NRI.DestroyBuffer(*slot.buffer);
+        m_NRI.FreeMemory(*slot.memory);
+        slot.buffer = nullptr;
+        slot.memory = nullptr;
+
         return result;
+    }
+
+    slot.size = size;
+
+    return Result::SUCCESS;
+}
+
+Result HelperDataUpload::BeginCommandBuffer() {
+    HelperUploadSlot& slot = m_Slots[m_CurrentSlot];
+
+    // The slot can be reused only when the GPU is done with it
+    m_NRI.Wait(*m_Fence, slot.fenceValue);
+    m_NRI.ResetCommandAllocator(*slot.commandAllocator);
+
+    m_CommandBuffer = slot.commandBuffer;
+    m_UploadBuffer = slot.buffer;
+    m_UploadBufferSize = slot.size;
+    m_UploadBufferOffset = 0;
+
+    return m_NRI.BeginCommandBuffer(*m_CommandBuffer, nullptr);
+}
 
-    result = m_NRI.CreateFence(m_Device, 0, m_Fence);
+Result HelperDataUpload::EndCommandBufferAndSubmit() {
+    const Result result = m_NRI.EndCommandBuffer(*m_CommandBuffer);
     if (result != Result::SUCCESS)
         return result;
 
-    result = m_NRI.CreateCommandAllocator(m_Queue, m_CommandAllocators);
+    FenceSubmitDesc fenceSubmitDesc = {};
+    fenceSubmitDesc.fence = m_Fence;
+    fenceSubmitDesc.value = m_FenceValue;
+
+    QueueSubmitDesc queueSubmitDesc = {};
+    queueSubmitDesc.commandBufferNum = 1;
+    queueSubmitDesc.commandBuffers = &m_CommandBuffer;
+    queueSubmitDesc.signalFences = &fenceSubmitDesc;
+    queueSubmitDesc.signalFenceNum = 1;
+
+    m_NRI.QueueSubmit(m_Queue, queueSubmitDesc);
+
+    m_Slots[m_CurrentSlot].fenceValue = m_FenceValue++;
+
+    return Result::SUCCESS;
+}
+
+Result HelperDataUpload::SubmitAndContinue() {
+    Result result = EndCommandBufferAndSubmit();
     if (result != Result::SUCCESS)
         return result;
 
-    result = m_NRI.CreateCommandBuffer(*m_CommandAllocators, m_CommandBuffer);
+    // Continue in another slot (if possible) to fill it while the GPU copies from the submitted one
+    result = AcquireSlot();
     if (result != Result::SUCCESS)
         return result;
 
-    return result;
+    return BeginCommandBuffer();
 }
 
 Result HelperDataUpload::UploadTextures(const TextureUploadDesc* textureUploadDescs, uint32_t textureDataDescNum) {
     if (!textureDataDescNum)
         return Result::SUCCESS;
 
-    bool isInitial = true;
+    DoTransition(m_NRI, m_CommandBuffer, true, textureUploadDescs, textureDataDescNum);
+
     uint32_t i = 0;
     Dim_t layerOffset = 0;
     Mip_t mipOffset = 0;
 
-    while (i < textureDataDescNum) {
-        if (!isInitial) {
-            Result result = EndCommandBuffersAndSubmit();
-            if (result != Result::SUCCESS)
-                return result;
-        }
-
-        Result result = m_NRI.BeginCommandBuffer(*m_CommandBuffer, nullptr);
-        if (result != Result::SUCCESS)
-            return result;
-
-        if (isInitial) {
-            DoTransition(m_NRI, m_CommandBuffer, true, textureUploadDescs, textureDataDescNum);
-            isInitial = false;
-        }
-
-        m_UploadBufferOffset = 0;
+    while (true) {
         bool isCapacityInsufficient = false;
 
         for (; i < textureDataDescNum && CopyTextureContent(textureUploadDescs[i], layerOffset, mipOffset, isCapacityInsufficient); i++)
@@ -170,72 +299,50 @@ Result HelperDataUpload::UploadTextures(const TextureUploadDesc* textureUploadDe
 
         if (isCapacityInsufficient)
             return Result::OUT_OF_MEMORY;
+
+        if (i == textureDataDescNum)
+            break;
+
+        // The upload buffer is full
+        Result result = SubmitAndContinue();
+        if (result != Result::SUCCESS)
+            return result;
     }
 
     DoTransition(m_NRI, m_CommandBuffer, false, textureUploadDescs, textureDataDescNum);
 
-    return EndCommandBuffersAndSubmit();
+    return Result::SUCCESS;
 }
 
 Result HelperDataUpload::UploadBuffers(const BufferUploadDesc* bufferUploadDescs, uint32_t bufferUploadDescNum) {
     if (!bufferUploadDescNum)
         return Result::SUCCESS;
 
-    bool isInitial = true;
+    DoTransition(m_NRI, m_CommandBuffer, true, bufferUploadDescs, bufferUploadDescNum);
+
     uint32_t i = 0;
     uint64_t bufferContentOffset = 0;
 
-    while (i < bufferUploadDescNum) {
-        if (!isInitial) {
-            Result result = EndCommandBuffersAndSubmit();
-            if (result != Result::SUCCESS)
-                return result;
-        }
-
-        Result result = m_NRI.BeginCommandBuffer(*m_CommandBuffer, nullptr);
-        if (result != Result::SUCCESS)
-            return result;
-
-        if (isInitial) {
-            DoTransition(m_NRI, m_CommandBuffer, true, bufferUploadDescs, bufferUploadDescNum);
-            isInitial = false;
-        }
-
-        m_UploadBufferOffset = 0;
+    while (true) {
         m_MappedMemory = (uint8_t*)m_NRI.MapBuffer(*m_UploadBuffer, 0, m_UploadBufferSize);
+        if (!m_MappedMemory)
+            return Result::FAILURE;
 
         for (; i < bufferUploadDescNum && CopyBufferContent(bufferUploadDescs[i], bufferContentOffset); i++)
             ;
 
         m_NRI.UnmapBuffer(*m_UploadBuffer);
-    }
-
-    DoTransition(m_NRI, m_CommandBuffer, false, bufferUploadDescs, bufferUploadDescNum);
-
-    return EndCommandBuffersAndSubmit();
-}
-
-Result HelperDataUpload::EndCommandBuffersAndSubmit() {
-    const Result result = m_NRI.EndCommandBuffer(*m_CommandBuffer);
-    if (result != Result::SUCCESS)
-        return result;
-
-    FenceSubmitDesc fenceSubmitDesc = {};
-    fenceSubmitDesc.fence = m_Fence;
-    fenceSubmitDesc.value = m_FenceValue;
-
-    QueueSubmitDesc queueSubmitDesc = {};
-    queueSubmitDesc.commandBufferNum = 1;
-    queueSubmitDesc.commandBuffers = &m_CommandBuffer;
-    queueSubmitDesc.signalFences = &fenceSubmitDesc;
-    queueSubmitDesc.signalFenceNum = 1;
 
-    m_NRI.QueueSubmit(m_Queue, queueSubmitDesc);
-    m_NRI.Wait(*m_Fence, m_FenceValue);
+        if (i == bufferUploadDescNum)
+            break;
 
-    m_FenceValue++;
+        // The upload buffer is full
+        Result result = SubmitAndContinue();
+        if (result != Result::SUCCESS)
+            return result;
+    }
 
-    m_NRI.ResetCommandAllocator(*m_CommandAllocators);
+    DoTransition(m_NRI, m_CommandBuffer, false, bufferUploadDescs, bufferUploadDescNum);
 
     return Result::SUCCESS;
 }
@@ -258,8 +365,15 @@ bool HelperDataUpload::CopyTextureContent(const TextureUploadDesc& textureUpload
             uint64_t freeSpace = m_UploadBufferSize - m_UploadBufferOffset;
 
             if (contentSize > freeSpace) {
-                isCapacityInsufficient = contentSize > m_UploadBufferSize;
-                return false;
+                // Continue in another upload buffer
+                if (m_UploadBufferOffset)
+                    return false;
+
+                // Doesn't fit even into an empty one
+                if (ResizeUploadBuffer(contentSize) != Result::SUCCESS) {
+                    isCapacityInsufficient = true;
+                    return false;
+                }
             }
 
             CopyTextureSubresourceContent(subresource, alignedRowPitch, alignedSlicePitch);
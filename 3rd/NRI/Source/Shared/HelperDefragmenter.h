@@ -0,0 +1,74 @@
+// © 2021 NVIDIA Corporation
+
+#pragma once
+
+namespace nri {
+
+struct DefragmenterHeap {
+    Memory* memory; // "nullptr" if the slot is unused
+    uint64_t size;
+    uint64_t usedSize;
+    uint64_t moveFenceValue; // moved-out resources may still be read until the fence reaches this value
+    MemoryType type;
+    bool isDedicated;
+    bool isRetiring; // empty, freed once the fence passes "moveFenceValue"
+};
+
+struct DefragmenterPlacement {
+    Buffer* buffer; // or "texture"
+    Texture* texture;
+    uint64_t offset;
+    uint64_t size;
+    uint32_t alignment;
+    uint32_t heap;
+};
+
+struct DefragmenterRange {
+    uint32_t heap;
+    uint64_t offset;
+    uint64_t end;
+    bool isTexture;
+};
+
+struct DefragmenterGarbage {
+    Buffer* buffer;
+    Texture* texture;
+    uint64_t fenceValue;
+};
+
+// Tracks placements of resource groups and compacts sparse heaps by moving resources into gaps of fuller heaps of the same memory type
+struct HelperDefragmenter {
+    HelperDefragmenter(const CoreInterface& NRI, Device& device);
+    ~HelperDefragmenter();
+
+    inline Device& GetDevice() {
+        return m_Device;
+    }
+
+    Result Create(const DefragmenterDesc& defragmenterDesc);
+    Result AllocateAndBindMemory(const ResourceGroupDesc& resourceGroupDesc);
+    void ReleaseResources(Buffer* const* buffers, uint32_t bufferNum, Texture* const* textures, uint32_t textureNum);
+    const DefragmentationMove* BeginDefragmentation(uint64_t byteBudget, uint64_t fenceValue, uint32_t& moveNum);
+    void CmdDefragment(CommandBuffer& commandBuffer);
+
+private:
+    uint32_t AddHeap(Memory* memory);
+    void AddPlacement(const DefragmenterPlacement& placement);
+    void RemovePlacement(const void* resource);
+    void RetireHeapIfEmpty(uint32_t heap);
+    uint64_t GetCompletedFenceValue() const;
+    void Retire(uint64_t completedFenceValue);
+    bool FindFreeRange(const Vector<DefragmenterRange>& ranges, uint32_t heap, const DefragmenterPlacement& placement, uint64_t& offset) const;
+    Result MovePlacement(DefragmenterPlacement& placement, uint32_t dstHeap, uint64_t dstOffset, uint64_t fenceValue);
+
+    const CoreInterface& m_NRI;
+    Device& m_Device;
+    Vector<DefragmenterHeap> m_Heaps;
+    Vector<DefragmenterPlacement> m_Placements;
+    UnorderedMap<const void*, uint32_t> m_PlacementIndices;
+    Vector<DefragmentationMove> m_Moves;
+    Vector<DefragmenterGarbage> m_Garbage;
+    Fence* m_Fence = nullptr;
+};
+
+} // namespace nri
@@ -0,0 +1,412 @@
+// © 2021 NVIDIA Corporation
+
+static inline bool IsRangeLess(const DefragmenterRange& a, const DefragmenterRange& b) {
+    if (a.heap != b.heap)
+        return a.heap < b.heap;
+
+    return a.offset < b.offset;
+}
+
+HelperDefragmenter::HelperDefragmenter(const CoreInterface& NRI, Device& device)
+    : m_NRI(NRI)
+    , m_Device(device)
+    , m_Heaps(((DeviceBase&)device).GetStdAllocator())
+    , m_Placements(((DeviceBase&)device).GetStdAllocator())
+    , m_PlacementIndices(((DeviceBase&)device).GetStdAllocator())
+    , m_Moves(((DeviceBase&)device).GetStdAllocator())
+    , m_Garbage(((DeviceBase&)device).GetStdAllocator()) {
+}
+
+HelperDefragmenter::~HelperDefragmenter() {
+    for (const DefragmenterGarbage& garbage : m_Garbage) {
+        if (garbage.buffer)
+            m_NRI.DestroyBuffer(*garbage.buffer);
+        else
+            m_NRI.DestroyTexture(*garbage.texture);
+    }
+
+    for (const DefragmenterHeap& heap : m_Heaps) {
+        if (heap.memory)
+            m_NRI.FreeMemory(*heap.memory);
+    }
+}
+
+Result HelperDefragmenter::Create(const DefragmenterDesc& defragmenterDesc) {
+    m_Fence = defragmenterDesc.fence;
+
+    return Result::SUCCESS;
+}
+
+Result HelperDefragmenter::AllocateAndBindMemory(const ResourceGroupDesc& resourceGroupDesc) {
+    uint32_t allocationNum = HelperDeviceMemoryAllocator(m_NRI, m_Device).CalculateAllocationNumber(resourceGroupDesc);
+
+    Vector<Memory*> allocations(allocationNum, nullptr, ((DeviceBase&)m_Device).GetStdAllocator());
+
+    HelperDeviceMemoryAllocator allocator(m_NRI, m_Device);
+    Result result = allocator.AllocateAndBindMemory(resourceGroupDesc, allocations.data());
+    if (result != Result::SUCCESS)
+        return result;
+
+    // Track placements
+    UnorderedMap<const Memory*, uint32_t> heaps(((DeviceBase&)m_Device).GetStdAllocator());
+    for (Memory* memory : allocations)
+        heaps[memory] = AddHeap(memory);
+
+    for (const BufferMemoryBindingDesc& bindingDesc : allocator.GetBufferBindingDescs()) {
+        MemoryDesc memoryDesc = {};
+        m_NRI.GetBufferMemoryDesc(*bindingDesc.buffer, resourceGroupDesc.memoryLocation, memoryDesc);
+
+        uint32_t heap = heaps[bindingDesc.memory];
+        m_Heaps[heap].type = memoryDesc.type;
+        m_Heaps[heap].isDedicated = memoryDesc.mustBeDedicated;
+
+        AddPlacement({bindingDesc.buffer, nullptr, bindingDesc.offset, memoryDesc.size, memoryDesc.alignment, heap});
+    }
+
+    for (const TextureMemoryBindingDesc& bindingDesc : allocator.GetTextureBindingDescs()) {
+        MemoryDesc memoryDesc = {};
+        m_NRI.GetTextureMemoryDesc(*bindingDesc.texture, resourceGroupDesc.memoryLocation, memoryDesc);
+
+        uint32_t heap = heaps[bindingDesc.memory];
+        m_Heaps[heap].type = memoryDesc.type;
+        m_Heaps[heap].isDedicated = memoryDesc.mustBeDedicated;
+
+        AddPlacement({nullptr, bindingDesc.texture, bindingDesc.offset, memoryDesc.size, memoryDesc.alignment, heap});
+    }
+
+    return Result::SUCCESS;
+}
+
+void HelperDefragmenter::ReleaseResources(Buffer* const* buffers, uint32_t bufferNum, Texture* const* textures, uint32_t textureNum) {
+    for (uint32_t i = 0; i < bufferNum; i++)
+        RemovePlacement(buffers[i]);
+
+    for (uint32_t i = 0; i < textureNum; i++)
+        RemovePlacement(textures[i]);
+}
+
+const DefragmentationMove* HelperDefragmenter::BeginDefragmentation(uint64_t byteBudget, uint64_t fenceValue, uint32_t& moveNum) {
+    uint64_t completedFenceValue = GetCompletedFenceValue();
+    Retire(completedFenceValue);
+
+    m_Moves.clear();
+    moveNum = 0;
+
+    if (!byteBudget)
+        return nullptr;
+
+    // Occupied ranges, sorted by heap and offset
+    Vector<DefragmenterRange> ranges(((DeviceBase&)m_Device).GetStdAllocator());
+    ranges.reserve(m_Placements.size());
+
+    for (const DefragmenterPlacement& placement : m_Placements)
+        ranges.push_back({placement.heap, placement.offset, placement.offset + placement.size, placement.texture != nullptr});
+
+    std::sort(ranges.begin(), ranges.end(), IsRangeLess);
+
+    // Heaps by occupancy: the emptiest ones are evacuated into gaps of the fullest ones
+    Vector<uint32_t> order(((DeviceBase&)m_Device).GetStdAllocator());
+    for (uint32_t i = 0; i < (uint32_t)m_Heaps.size(); i++) {
+        const DefragmenterHeap& heap = m_Heaps[i];
+        if (heap.memory && !heap.isDedicated && !heap.isRetiring && heap.usedSize)
+            order.push_back(i);
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return m_Heaps[a].usedSize < m_Heaps[b].usedSize;
+    });
+
+    // Copies of a pass don't chain: a heap is either a source or a destination
+    Vector<uint8_t> roles(m_Heaps.size(), 0, ((DeviceBase&)m_Device).GetStdAllocator());
+    constexpr uint8_t SOURCE = 0x1;
+    constexpr uint8_t DESTINATION = 0x2;
+
+    Vector<uint32_t> candidates(((DeviceBase&)m_Device).GetStdAllocator());
+    uint64_t movedSize = 0;
+
+    for (size_t i = 0; i < order.size() && movedSize < byteBudget; i++) {
+        uint32_t srcHeap = order[i];
+        if (roles[srcHeap] & DESTINATION)
+            continue;
+
+        // Biggest resources first
+        candidates.clear();
+        for (uint32_t j = 0; j < (uint32_t)m_Placements.size(); j++) {
+            if (m_Placements[j].heap == srcHeap)
+                candidates.push_back(j);
+        }
+
+        std::stable_sort(candidates.begin(), candidates.end(), [&](uint32_t a, uint32_t b) {
+            return m_Placements[a].size > m_Placements[b].size;
+        });
+
+        for (uint32_t candidate : candidates) {
+            DefragmenterPlacement& placement = m_Placements[candidate];
+            if (movedSize + placement.size > byteBudget)
+                continue;
+
+            // Fullest destination with a fitting gap. Ranges vacated by earlier passes are not tracked, so a heap is not a destination
+            // until the copies out of it are completed
+            for (size_t j = order.size(); j > i + 1; j--) {
+                uint32_t dstHeap = order[j - 1];
+                if ((roles[dstHeap] & SOURCE) || m_Heaps[dstHeap].type != m_Heaps[srcHeap].type || m_Heaps[dstHeap].moveFenceValue > completedFenceValue)
+                    continue;
+
+                uint64_t dstOffset = 0;
+                if (!FindFreeRange(ranges, dstHeap, placement, dstOffset))
+                    continue;
+
+                if (MovePlacement(placement, dstHeap, dstOffset, fenceValue) != Result::SUCCESS) {
+                    moveNum = (uint32_t)m_Moves.size();
+                    return m_Moves.empty() ? nullptr : m_Moves.data();
+                }
+
+                DefragmenterRange range = {dstHeap, dstOffset, dstOffset + placement.size, placement.texture != nullptr};
+                ranges.insert(std::upper_bound(ranges.begin(), ranges.end(), range, IsRangeLess), range);
+
+                roles[srcHeap] |= SOURCE;
+                roles[dstHeap] |= DESTINATION;
+                movedSize += placement.size;
+
+                break;
+            }
+        }
+
+        if (!m_Heaps[srcHeap].usedSize)
+            m_Heaps[srcHeap].isRetiring = true;
+    }
+
+    moveNum = (uint32_t)m_Moves.size();
+
+    return m_Moves.empty() ? nullptr : m_Moves.data();
+}
+
+void HelperDefragmenter::CmdDefragment(CommandBuffer& commandBuffer) {
+    if (m_Moves.empty())
+        return;
+
+    // Destinations are new resources
+    Vector<BufferBarrierDesc> bufferBarriers(((DeviceBase&)m_Device).GetStdAllocator());
+    Vector<TextureBarrierDesc> textureBarriers(((DeviceBase&)m_Device).GetStdAllocator());
+
+    for (const DefragmentationMove& move : m_Moves) {
+        if (move.dstBuffer) {
+            BufferBarrierDesc barrier = {};
+            barrier.buffer = move.dstBuffer;
+            barrier.before = {AccessBits::UNKNOWN, StageBits::NONE};
+            barrier.after = {AccessBits::COPY_DESTINATION, StageBits::COPY};
+
+            bufferBarriers.push_back(barrier);
+        } else {
+            const TextureDesc& textureDesc = m_NRI.GetTextureDesc(*move.dstTexture);
+
+            TextureBarrierDesc barrier = {};
+            barrier.texture = move.dstTexture;
+            barrier.before = {AccessBits::UNKNOWN, Layout::UNKNOWN, StageBits::NONE};
+            barrier.after = {AccessBits::COPY_DESTINATION, Layout::COPY_DESTINATION, StageBits::COPY};
+            barrier.mipNum = textureDesc.mipNum;
+            barrier.layerNum = textureDesc.layerNum;
+            barrier.planes = PlaneBits::ALL;
+
+            textureBarriers.push_back(barrier);
+        }
+    }
+
+    BarrierGroupDesc barrierGroup = {};
+    barrierGroup.buffers = bufferBarriers.data();
+    barrierGroup.bufferNum = (uint32_t)bufferBarriers.size();
+    barrierGroup.textures = textureBarriers.data();
+    barrierGroup.textureNum = (uint32_t)textureBarriers.size();
+
+    m_NRI.CmdBarrier(commandBuffer, barrierGroup);
+
+    for (const DefragmentationMove& move : m_Moves) {
+        if (move.dstBuffer)
+            m_NRI.CmdCopyBuffer(commandBuffer, *move.dstBuffer, 0, *move.srcBuffer, 0, WHOLE_SIZE);
+        else
+            m_NRI.CmdCopyTexture(commandBuffer, *move.dstTexture, nullptr, *move.srcTexture, nullptr);
+    }
+}
+
+uint32_t HelperDefragmenter::AddHeap(Memory* memory) {
+    uint32_t heap = 0;
+    for (; heap < (uint32_t)m_Heaps.size(); heap++) {
+        if (!m_Heaps[heap].memory)
+            break;
+    }
+
+    if (heap == (uint32_t)m_Heaps.size())
+        m_Heaps.push_back({});
+
+    m_Heaps[heap] = {};
+    m_Heaps[heap].memory = memory;
+
+    return heap;
+}
+
+void HelperDefragmenter::AddPlacement(const DefragmenterPlacement& placement) {
+    DefragmenterHeap& heap = m_Heaps[placement.heap];
+    heap.size = std::max(heap.size, placement.offset + placement.size);
+    heap.usedSize += placement.size;
+
+    const void* resource = placement.buffer ? (const void*)placement.buffer : (const void*)placement.texture;
+    m_PlacementIndices[resource] = (uint32_t)m_Placements.size();
+    m_Placements.push_back(placement);
+}
+
+void HelperDefragmenter::RemovePlacement(const void* resource) {
+    auto it = m_PlacementIndices.find(resource);
+    if (it == m_PlacementIndices.end())
+        return;
+
+    uint32_t index = it->second;
+    m_PlacementIndices.erase(it);
+
+    uint32_t heap = m_Placements[index].heap;
+    m_Heaps[heap].usedSize -= m_Placements[index].size;
+
+    // Swap with the last one
+    const DefragmenterPlacement& last = m_Placements.back();
+    if (index != m_Placements.size() - 1) {
+        const void* lastResource = last.buffer ? (const void*)last.buffer : (const void*)last.texture;
+        m_PlacementIndices[lastResource] = index;
+        m_Placements[index] = last;
+    }
+
+    m_Placements.pop_back();
+
+    RetireHeapIfEmpty(heap);
+}
+
+void HelperDefragmenter::RetireHeapIfEmpty(uint32_t heap) {
+    DefragmenterHeap& defragmenterHeap = m_Heaps[heap];
+    if (defragmenterHeap.usedSize)
+        return;
+
+    // Released resources are destroyed after "ReleaseResources" and moved-out resources may still be in use by the GPU, the memory is freed in "Retire"
+    defragmenterHeap.isRetiring = true;
+}
+
+uint64_t HelperDefragmenter::GetCompletedFenceValue() const {
+    return m_Fence ? m_NRI.GetFenceValue(*m_Fence) : uint64_t(-1);
+}
+
+void HelperDefragmenter::Retire(uint64_t completedFenceValue) {
+    for (size_t i = 0; i < m_Garbage.size();) {
+        const DefragmenterGarbage& garbage = m_Garbage[i];
+        if (garbage.fenceValue <= completedFenceValue) {
+            if (garbage.buffer)
+                m_NRI.DestroyBuffer(*garbage.buffer);
+            else
+                m_NRI.DestroyTexture(*garbage.texture);
+
+            m_Garbage[i] = m_Garbage.back();
+            m_Garbage.pop_back();
+        } else
+            i++;
+    }
+
+    for (DefragmenterHeap& heap : m_Heaps) {
+        if (heap.memory && heap.isRetiring && heap.moveFenceValue <= completedFenceValue) {
+            m_NRI.FreeMemory(*heap.memory);
+            heap = {};
+        }
+    }
+}
+
+bool HelperDefragmenter::FindFreeRange(const Vector<DefragmenterRange>& ranges, uint32_t heap, const DefragmenterPlacement& placement, uint64_t& offset) const {
+    const DeviceDesc& deviceDesc = m_NRI.GetDeviceDesc(m_Device);
+    uint64_t granularity = std::max(deviceDesc.bufferTextureGranularity, 1u);
+    bool isTexture = placement.texture != nullptr;
+
+    DefragmenterRange key = {heap, 0, 0, false};
+    auto it = std::lower_bound(ranges.begin(), ranges.end(), key, IsRangeLess);
+
+    // First fit between occupied ranges, linear and non-linear resources don't share a granularity page
+    uint64_t begin = 0;
+    bool isPrevTexture = isTexture;
+    uint64_t heapSize = m_Heaps[heap].size;
+
+    while (true) {
+        bool isLast = it == ranges.end() || it->heap != heap;
+        uint64_t end = isLast ? heapSize : it->offset;
+
+        uint64_t start = isPrevTexture != isTexture ? Align(begin, granularity) : begin;
+        start = Align(start, placement.alignment);
+
+        uint64_t limit = (!isLast && it->isTexture != isTexture) ? Align(start + placement.size, granularity) : start + placement.size;
+        if (limit <= end) {
+            offset = start;
+            return true;
+        }
+
+        if (isLast)
+            return false;
+
+        begin = std::max(begin, it->end);
+        isPrevTexture = it->isTexture;
+        it++;
+    }
+}
+
+Result HelperDefragmenter::MovePlacement(DefragmenterPlacement& placement, uint32_t dstHeap, uint64_t dstOffset, uint64_t fenceValue) {
+    DefragmenterHeap& src = m_Heaps[placement.heap];
+    DefragmenterHeap& dst = m_Heaps[dstHeap];
+
+    DefragmentationMove move = {};
+    move.srcBuffer = placement.buffer;
+    move.srcTexture = placement.texture;
+    move.srcMemory = src.memory;
+    move.dstMemory = dst.memory;
+    move.srcOffset = placement.offset;
+    move.dstOffset = dstOffset;
+    move.size = placement.size;
+
+    // Create and bind a twin resource in the destination
+    if (placement.buffer) {
+        Result result = m_NRI.CreateBuffer(m_Device, m_NRI.GetBufferDesc(*placement.buffer), move.dstBuffer);
+        if (result != Result::SUCCESS)
+            return result;
+
+        BufferMemoryBindingDesc bindingDesc = {dst.memory, move.dstBuffer, dstOffset};
+        result = m_NRI.BindBufferMemory(m_Device, &bindingDesc, 1);
+        if (result != Result::SUCCESS) {
+            m_NRI.DestroyBuffer(*move.dstBuffer);
+            return result;
+        }
+    } else {
+        Result result = m_NRI.CreateTexture(m_Device, m_NRI.GetTextureDesc(*placement.texture), move.dstTexture);
+        if (result != Result::SUCCESS)
+            return result;
+
+        TextureMemoryBindingDesc bindingDesc = {dst.memory, move.dstTexture, dstOffset};
+        result = m_NRI.BindTextureMemory(m_Device, &bindingDesc, 1);
+        if (result != Result::SUCCESS) {
+            m_NRI.DestroyTexture(*move.dstTexture);
+            return result;
+        }
+    }
+
+    m_Moves.push_back(move);
+    m_Garbage.push_back({move.srcBuffer, move.srcTexture, fenceValue});
+
+    // Track the new resource instead of the old one
+    src.usedSize -= placement.size;
+    src.moveFenceValue = std::max(src.moveFenceValue, fenceValue);
+    dst.usedSize += placement.size;
+
+    const void* srcResource = placement.buffer ? (const void*)placement.buffer : (const void*)placement.texture;
+    const void* dstResource = move.dstBuffer ? (const void*)move.dstBuffer : (const void*)move.dstTexture;
+
+    auto it = m_PlacementIndices.find(srcResource);
+    uint32_t index = it->second;
+    m_PlacementIndices.erase(it);
+    m_PlacementIndices[dstResource] = index;
+
+    placement.buffer = move.dstBuffer;
+    placement.texture = move.dstTexture;
+    placement.offset = dstOffset;
+    placement.heap = dstHeap;
+
+    return Result::SUCCESS;
+}
@@ -0,0 +1,70 @@
+// © 2021 NVIDIA Corporation
+
+#pragma once
+
+namespace nri {
+
+constexpr uint32_t CACHED_DESCRIPTOR_SET_NONE = uint32_t(-1);
+
+struct CachedDescriptorSet {
+    Vector<uint64_t> key; // layout, set index, range and dynamic constant buffer numbers, then per range "descriptorNum, baseDescriptor" and descriptors. Empty if purged
+    DescriptorSet* descriptorSet;
+    uint64_t hash;
+    uint64_t fenceValue;
+    uint32_t nextWithSameHash;
+    uint32_t prev; // LRU list of the group, "prev" is less recently used
+    uint32_t next;
+    uint32_t group;
+};
+
+// Sets of the same pipeline layout and set index, only they can be rewritten with each other's descriptors
+struct CachedDescriptorSetGroup {
+    const PipelineLayout* pipelineLayout;
+    uint32_t setIndex;
+    uint32_t leastRecentlyUsed;
+    uint32_t mostRecentlyUsed;
+};
+
+struct HelperDescriptorSetCache {
+    HelperDescriptorSetCache(const CoreInterface& NRI, Device& device);
+    ~HelperDescriptorSetCache();
+
+    inline Device& GetDevice() {
+        return m_Device;
+    }
+
+    Result Create(const DescriptorSetCacheDesc& descriptorSetCacheDesc);
+    Result GetDescriptorSet(const CachedDescriptorSetDesc& cachedDescriptorSetDesc, uint64_t fenceValue, DescriptorSet*& descriptorSet);
+    void Purge(const Descriptor* const* descriptors, uint32_t descriptorNum);
+    void GetStats(DescriptorSetCacheStats& descriptorSetCacheStats);
+
+private:
+    void BuildKey(const CachedDescriptorSetDesc& cachedDescriptorSetDesc);
+    uint32_t Find(uint64_t hash) const;
+    uint32_t GetGroup(const PipelineLayout& pipelineLayout, uint32_t setIndex);
+    bool References(const CachedDescriptorSet& cachedSet, const Descriptor* const* sortedDescriptors, uint32_t descriptorNum) const;
+    Result AllocateSet(const CachedDescriptorSetDesc& cachedDescriptorSetDesc, DescriptorSet*& descriptorSet);
+    Result AddDescriptorPool();
+    void Link(uint32_t index);
+    void LinkAsLeastRecentlyUsed(uint32_t index);
+    void Unlink(uint32_t index);
+    void RemoveFromHashChain(uint32_t index);
+
+    const CoreInterface& m_NRI;
+    Device& m_Device;
+    Vector<CachedDescriptorSet> m_Sets;
+    Vector<CachedDescriptorSetGroup> m_Groups;
+    UnorderedMap<uint64_t, uint32_t> m_SetIndices; // hash => the first set in the chain
+    Vector<uint64_t> m_Key;                        // of the current request, the capacity is reused
+    Vector<DescriptorPool*> m_DescriptorPools;     // sets are allocated from the last one
+    DescriptorPoolDesc m_DescriptorPoolDesc = {};
+    Fence* m_Fence = nullptr;
+    uint64_t m_HitNum = 0;
+    uint64_t m_MissNum = 0;
+    uint64_t m_EvictionNum = 0;
+    uint32_t m_PoolSetNum = 0; // allocated from the last pool
+    bool m_IsPoolFull = false;
+    Lock m_Lock;
+};
+
+} // namespace nri
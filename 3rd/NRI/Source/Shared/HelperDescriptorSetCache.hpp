@@ -0,0 +1,335 @@
+// © 2021 NVIDIA Corporation
+
+static inline uint64_t HashDescriptorSetKey(const Vector<uint64_t>& key) {
+    constexpr uint64_t K0 = 0x9E3779B97F4A7C15ull;
+    constexpr uint64_t K1 = 0xC2B2AE3D27D4EB4Full;
+
+    uint64_t hash = key.size() * K0;
+    for (uint64_t word : key) {
+        hash ^= word * K1;
+        hash = ((hash << 31) | (hash >> 33)) * K0;
+    }
+
+    return hash ^ (hash >> 29);
+}
+
+HelperDescriptorSetCache::HelperDescriptorSetCache(const CoreInterface& NRI, Device& device)
+    : m_NRI(NRI)
+    , m_Device(device)
+    , m_Sets(((DeviceBase&)device).GetStdAllocator())
+    , m_Groups(((DeviceBase&)device).GetStdAllocator())
+    , m_SetIndices(((DeviceBase&)device).GetStdAllocator())
+    , m_Key(((DeviceBase&)device).GetStdAllocator())
+    , m_DescriptorPools(((DeviceBase&)device).GetStdAllocator()) {
+}
+
+HelperDescriptorSetCache::~HelperDescriptorSetCache() {
+    // Sets are freed with the pools
+    for (DescriptorPool* descriptorPool : m_DescriptorPools)
+        m_NRI.DestroyDescriptorPool(*descriptorPool);
+}
+
+Result HelperDescriptorSetCache::Create(const DescriptorSetCacheDesc& descriptorSetCacheDesc) {
+    m_Fence = descriptorSetCacheDesc.fence;
+    m_DescriptorPoolDesc = descriptorSetCacheDesc.descriptorPoolDesc;
+
+    return AddDescriptorPool();
+}
+
+Result HelperDescriptorSetCache::GetDescriptorSet(const CachedDescriptorSetDesc& cachedDescriptorSetDesc, uint64_t fenceValue, DescriptorSet*& descriptorSet) {
+    ExclusiveScope lock(m_Lock);
+
+    BuildKey(cachedDescriptorSetDesc);
+    uint64_t hash = HashDescriptorSetKey(m_Key);
+
+    // Hit
+    for (uint32_t i = Find(hash); i != CACHED_DESCRIPTOR_SET_NONE; i = m_Sets[i].nextWithSameHash) {
+        CachedDescriptorSet& cachedSet = m_Sets[i];
+        if (cachedSet.hash == hash && cachedSet.key == m_Key) {
+            Unlink(i);
+            Link(i);
+
+            cachedSet.fenceValue = std::max(cachedSet.fenceValue, fenceValue);
+            descriptorSet = cachedSet.descriptorSet;
+            m_HitNum++;
+
+            return Result::SUCCESS;
+        }
+    }
+
+    // Miss
+    m_MissNum++;
+    descriptorSet = nullptr;
+
+    uint32_t group = GetGroup(*cachedDescriptorSetDesc.pipelineLayout, cachedDescriptorSetDesc.setIndex);
+    uint32_t index = CACHED_DESCRIPTOR_SET_NONE;
+
+    DescriptorSet* newSet = nullptr;
+    if (!m_IsPoolFull) {
+        Result result = AllocateSet(cachedDescriptorSetDesc, newSet);
+        if (result != Result::SUCCESS && result != Result::OUT_OF_MEMORY)
+            return result;
+    }
+
+    if (!newSet) {
+        // Purged sets are moved to the head regardless of their fence values, those still in use are skipped. Past them the least recently
+        // used set has the smallest fence value, if it's still in use, all others are too
+        uint64_t completedValue = m_NRI.GetFenceValue(*m_Fence);
+
+        index = m_Groups[group].leastRecentlyUsed;
+        while (index != CACHED_DESCRIPTOR_SET_NONE && m_Sets[index].key.empty() && m_Sets[index].fenceValue > completedValue)
+            index = m_Sets[index].next;
+
+        if (index != CACHED_DESCRIPTOR_SET_NONE && m_Sets[index].fenceValue <= completedValue) {
+            Unlink(index);
+
+            if (!m_Sets[index].key.empty())
+                RemoveFromHashChain(index);
+
+            m_EvictionNum++;
+        } else {
+            // Nothing to evict in this group (sets of other groups can't be reused, since the pool can't free individual sets)
+            index = CACHED_DESCRIPTOR_SET_NONE;
+
+            Result result = AddDescriptorPool();
+            if (result != Result::SUCCESS)
+                return result;
+
+            result = AllocateSet(cachedDescriptorSetDesc, newSet);
+            if (result != Result::SUCCESS) {
+                // Doesn't fit even into an empty pool, don't keep it
+                m_NRI.DestroyDescriptorPool(*m_DescriptorPools.back());
+                m_DescriptorPools.pop_back();
+                m_IsPoolFull = true;
+
+                return result;
+            }
+        }
+    }
+
+    if (newSet) {
+        index = (uint32_t)m_Sets.size();
+        m_Sets.push_back({Vector<uint64_t>(((DeviceBase&)m_Device).GetStdAllocator()), newSet, 0, 0, CACHED_DESCRIPTOR_SET_NONE, CACHED_DESCRIPTOR_SET_NONE, CACHED_DESCRIPTOR_SET_NONE, group});
+    }
+
+    CachedDescriptorSet& cachedSet = m_Sets[index];
+    cachedSet.key.assign(m_Key.begin(), m_Key.end());
+    cachedSet.hash = hash;
+    cachedSet.fenceValue = fenceValue;
+
+    auto it = m_SetIndices.find(hash);
+    if (it != m_SetIndices.end()) {
+        cachedSet.nextWithSameHash = it->second;
+        it->second = index;
+    } else {
+        cachedSet.nextWithSameHash = CACHED_DESCRIPTOR_SET_NONE;
+        m_SetIndices.emplace(hash, index);
+    }
+
+    Link(index);
+
+    // Written under the lock, so a concurrent hit never sees a partially written set
+    if (cachedDescriptorSetDesc.rangeNum)
+        m_NRI.UpdateDescriptorRanges(*cachedSet.descriptorSet, 0, cachedDescriptorSetDesc.rangeNum, cachedDescriptorSetDesc.ranges);
+
+    if (cachedDescriptorSetDesc.dynamicConstantBufferNum)
+        m_NRI.UpdateDynamicConstantBuffers(*cachedSet.descriptorSet, 0, cachedDescriptorSetDesc.dynamicConstantBufferNum, cachedDescriptorSetDesc.dynamicConstantBuffers);
+
+    descriptorSet = cachedSet.descriptorSet;
+
+    return Result::SUCCESS;
+}
+
+void HelperDescriptorSetCache::Purge(const Descriptor* const* descriptors, uint32_t descriptorNum) {
+    if (!descriptorNum)
+        return;
+
+    Scratch<const Descriptor*> sortedDescriptors = AllocateScratch((DeviceBase&)m_Device, const Descriptor*, descriptorNum);
+    for (uint32_t i = 0; i < descriptorNum; i++)
+        sortedDescriptors[i] = descriptors[i];
+
+    std::sort(&sortedDescriptors[0], &sortedDescriptors[0] + descriptorNum);
+
+    ExclusiveScope lock(m_Lock);
+
+    // Purged sets are not found anymore and become the first candidates for eviction (once the GPU is done with them)
+    for (uint32_t i = 0; i < (uint32_t)m_Sets.size(); i++) {
+        CachedDescriptorSet& cachedSet = m_Sets[i];
+        if (cachedSet.key.empty() || !References(cachedSet, sortedDescriptors, descriptorNum))
+            continue;
+
+        RemoveFromHashChain(i);
+        cachedSet.key.clear();
+
+        Unlink(i);
+        LinkAsLeastRecentlyUsed(i);
+    }
+}
+
+void HelperDescriptorSetCache::GetStats(DescriptorSetCacheStats& descriptorSetCacheStats) {
+    ExclusiveScope lock(m_Lock);
+
+    descriptorSetCacheStats.hitNum = m_HitNum;
+    descriptorSetCacheStats.missNum = m_MissNum;
+    descriptorSetCacheStats.evictionNum = m_EvictionNum;
+    descriptorSetCacheStats.setNum = (uint32_t)m_Sets.size();
+    descriptorSetCacheStats.descriptorPoolNum = (uint32_t)m_DescriptorPools.size();
+}
+
+void HelperDescriptorSetCache::BuildKey(const CachedDescriptorSetDesc& cachedDescriptorSetDesc) {
+    m_Key.clear();
+    m_Key.push_back((uint64_t)(size_t)cachedDescriptorSetDesc.pipelineLayout);
+    m_Key.push_back(((uint64_t)cachedDescriptorSetDesc.rangeNum << 32) | cachedDescriptorSetDesc.setIndex);
+    m_Key.push_back(cachedDescriptorSetDesc.dynamicConstantBufferNum);
+
+    for (uint32_t i = 0; i < cachedDescriptorSetDesc.rangeNum; i++) {
+        const DescriptorRangeUpdateDesc& range = cachedDescriptorSetDesc.ranges[i];
+        m_Key.push_back(((uint64_t)range.descriptorNum << 32) | range.baseDescriptor);
+
+        for (uint32_t j = 0; j < range.descriptorNum; j++)
+            m_Key.push_back((uint64_t)(size_t)range.descriptors[j]);
+    }
+
+    for (uint32_t i = 0; i < cachedDescriptorSetDesc.dynamicConstantBufferNum; i++)
+        m_Key.push_back((uint64_t)(size_t)cachedDescriptorSetDesc.dynamicConstantBuffers[i]);
+}
+
+bool HelperDescriptorSetCache::References(const CachedDescriptorSet& cachedSet, const Descriptor* const* sortedDescriptors, uint32_t descriptorNum) const {
+    // Walks the key layout (see "BuildKey"), only descriptor words are compared
+    const uint64_t* key = cachedSet.key.data();
+    uint32_t rangeNum = (uint32_t)(key[1] >> 32);
+    uint32_t dynamicConstantBufferNum = (uint32_t)key[2];
+    size_t offset = 3;
+
+    auto isPurged = [&](uint64_t word) {
+        return std::binary_search(sortedDescriptors, sortedDescriptors + descriptorNum, (const Descriptor*)(size_t)word);
+    };
+
+    for (uint32_t i = 0; i < rangeNum; i++) {
+        uint32_t rangeDescriptorNum = (uint32_t)(key[offset++] >> 32);
+        for (uint32_t j = 0; j < rangeDescriptorNum; j++) {
+            if (isPurged(key[offset++]))
+                return true;
+        }
+    }
+
+    for (uint32_t i = 0; i < dynamicConstantBufferNum; i++) {
+        if (isPurged(key[offset++]))
+            return true;
+    }
+
+    return false;
+}
+
+Result HelperDescriptorSetCache::AllocateSet(const CachedDescriptorSetDesc& cachedDescriptorSetDesc, DescriptorSet*& descriptorSet) {
+    descriptorSet = nullptr;
+
+    Result result = m_NRI.AllocateDescriptorSets(*m_DescriptorPools.back(), *cachedDescriptorSetDesc.pipelineLayout, cachedDescriptorSetDesc.setIndex, &descriptorSet, 1, 0);
+    if (result == Result::SUCCESS)
+        m_PoolSetNum++;
+    else
+        descriptorSet = nullptr;
+
+    // Descriptor maximums can run out before "descriptorSetMaxNum"
+    if (m_PoolSetNum == m_DescriptorPoolDesc.descriptorSetMaxNum || result == Result::OUT_OF_MEMORY)
+        m_IsPoolFull = true;
+
+    return result;
+}
+
+Result HelperDescriptorSetCache::AddDescriptorPool() {
+    DescriptorPool* descriptorPool = nullptr;
+    Result result = m_NRI.CreateDescriptorPool(m_Device, m_DescriptorPoolDesc, descriptorPool);
+    if (result != Result::SUCCESS)
+        return result;
+
+    m_DescriptorPools.push_back(descriptorPool);
+    m_PoolSetNum = 0;
+    m_IsPoolFull = false;
+
+    return Result::SUCCESS;
+}
+
+uint32_t HelperDescriptorSetCache::Find(uint64_t hash) const {
+    const auto it = m_SetIndices.find(hash);
+
+    return it == m_SetIndices.end() ? CACHED_DESCRIPTOR_SET_NONE : it->second;
+}
+
+uint32_t HelperDescriptorSetCache::GetGroup(const PipelineLayout& pipelineLayout, uint32_t setIndex) {
+    // Few groups are expected (one per pipeline layout and set index), a linear search is fine
+    for (uint32_t i = 0; i < (uint32_t)m_Groups.size(); i++) {
+        const CachedDescriptorSetGroup& group = m_Groups[i];
+        if (group.pipelineLayout == &pipelineLayout && group.setIndex == setIndex)
+            return i;
+    }
+
+    m_Groups.push_back({&pipelineLayout, setIndex, CACHED_DESCRIPTOR_SET_NONE, CACHED_DESCRIPTOR_SET_NONE});
+
+    return (uint32_t)m_Groups.size() - 1;
+}
+
+void HelperDescriptorSetCache::Link(uint32_t index) {
+    CachedDescriptorSet& cachedSet = m_Sets[index];
+    CachedDescriptorSetGroup& group = m_Groups[cachedSet.group];
+
+    cachedSet.prev = group.mostRecentlyUsed;
+    cachedSet.next = CACHED_DESCRIPTOR_SET_NONE;
+
+    if (group.mostRecentlyUsed != CACHED_DESCRIPTOR_SET_NONE)
+        m_Sets[group.mostRecentlyUsed].next = index;
+    else
+        group.leastRecentlyUsed = index;
+
+    group.mostRecentlyUsed = index;
+}
+
+void HelperDescriptorSetCache::LinkAsLeastRecentlyUsed(uint32_t index) {
+    CachedDescriptorSet& cachedSet = m_Sets[index];
+    CachedDescriptorSetGroup& group = m_Groups[cachedSet.group];
+
+    cachedSet.prev = CACHED_DESCRIPTOR_SET_NONE;
+    cachedSet.next = group.leastRecentlyUsed;
+
+    if (group.leastRecentlyUsed != CACHED_DESCRIPTOR_SET_NONE)
+        m_Sets[group.leastRecentlyUsed].prev = index;
+    else
+        group.mostRecentlyUsed = index;
+
+    group.leastRecentlyUsed = index;
+}
+
+void HelperDescriptorSetCache::Unlink(uint32_t index) {
+    CachedDescriptorSet& cachedSet = m_Sets[index];
+    CachedDescriptorSetGroup& group = m_Groups[cachedSet.group];
+
+    if (cachedSet.prev != CACHED_DESCRIPTOR_SET_NONE)
+        m_Sets[cachedSet.prev].next = cachedSet.next;
+    else
+        group.leastRecentlyUsed = cachedSet.next;
+
+    if (cachedSet.next != CACHED_DESCRIPTOR_SET_NONE)
+        m_Sets[cachedSet.next].prev = cachedSet.prev;
+    else
+        group.mostRecentlyUsed = cachedSet.prev;
+}
+
+void HelperDescriptorSetCache::RemoveFromHashChain(uint32_t index) {
+    const CachedDescriptorSet& cachedSet = m_Sets[index];
+
+    auto it = m_SetIndices.find(cachedSet.hash);
+    if (it->second == index) {
+        if (cachedSet.nextWithSameHash == CACHED_DESCRIPTOR_SET_NONE)
+            m_SetIndices.erase(it);
+        else
+            it->second = cachedSet.nextWithSameHash;
+
+        return;
+    }
+
+    uint32_t i = it->second;
+    while (m_Sets[i].nextWithSameHash != index)
+        i = m_Sets[i].nextWithSameHash;
+
+    m_Sets[i].nextWithSameHash = cachedSet.nextWithSameHash;
+}
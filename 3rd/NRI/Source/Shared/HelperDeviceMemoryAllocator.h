@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include <algorithm>
+
 template <typename U, typename T>
 using Map = std::map<U, T, std::less<U>, StdAllocator<std::pair<const U, T>>>;
 
@@ -13,6 +15,15 @@ struct HelperDeviceMemoryAllocator {
     uint32_t CalculateAllocationNumber(const ResourceGroupDesc& resourceGroupDesc);
     Result AllocateAndBindMemory(const ResourceGroupDesc& resourceGroupDesc, Memory** allocations);
 
+    // Placements of the last "AllocateAndBindMemory"
+    inline const Vector<BufferMemoryBindingDesc>& GetBufferBindingDescs() const {
+        return m_BufferBindingDescs;
+    }
+
+    inline const Vector<TextureMemoryBindingDesc>& GetTextureBindingDescs() const {
+        return m_TextureBindingDescs;
+    }
+
 private:
     struct MemoryHeap {
         MemoryHeap(MemoryType memoryType, const StdAllocator<uint8_t>& stdAllocator);
@@ -23,12 +34,20 @@ private:
         Vector<uint64_t> textureOffsets;
         uint64_t size;
         MemoryType type;
+        bool isLastTexture;
+    };
+
+    struct PackedResource {
+        MemoryDesc memoryDesc;
+        uint32_t index;
+        bool isTexture;
     };
 
     Result TryToAllocateAndBindMemory(const ResourceGroupDesc& resourceGroupDesc, Memory** allocations, size_t& allocationNum);
     Result ProcessDedicatedResources(MemoryLocation memoryLocation, Memory** allocations, size_t& allocationNum);
     MemoryHeap& FindOrCreateHeap(MemoryDesc& memoryDesc, uint64_t preferredMemorySize);
     void GroupByMemoryType(MemoryLocation memoryLocation, const ResourceGroupDesc& resourceGroupDesc);
+    void GroupByMemoryTypeBestFit(MemoryLocation memoryLocation, const ResourceGroupDesc& resourceGroupDesc);
     void FillMemoryBindingDescs(Buffer* const* buffers, const uint64_t* bufferOffsets, uint32_t bufferNum, Memory& memory);
     void FillMemoryBindingDescs(Texture* const* texture, const uint64_t* textureOffsets, uint32_t textureNum, Memory& memory);
 
@@ -40,6 +59,8 @@ private:
     Vector<Texture*> m_DedicatedTextures;
     Vector<BufferMemoryBindingDesc> m_BufferBindingDescs;
     Vector<TextureMemoryBindingDesc> m_TextureBindingDescs;
+    uint64_t m_PackedSize = 0; // sum of resource sizes placed by "GroupByMemoryTypeBestFit"
+    uint32_t m_PackedNum = 0;
 };
 
 }
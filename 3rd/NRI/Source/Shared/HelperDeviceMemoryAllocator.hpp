@@ -6,7 +6,8 @@ HelperDeviceMemoryAllocator::MemoryHeap::MemoryHeap(MemoryType memoryType, const
     , textures(stdAllocator)
     , textureOffsets(stdAllocator)
     , size(0)
-    , type(memoryType) {
+    , type(memoryType)
+    , isLastTexture(false) {
 }
 
 HelperDeviceMemoryAllocator::HelperDeviceMemoryAllocator(const CoreInterface& NRI, Device& device)
@@ -70,6 +71,19 @@ Result HelperDeviceMemoryAllocator::TryToAllocateAndBindMemory(const ResourceGro
         return result;
 
     result = m_NRI.BindTextureMemory(m_Device, m_TextureBindingDescs.data(), (uint32_t)m_TextureBindingDescs.size());
+    if (result != Result::SUCCESS)
+        return result;
+
+    // Reported here and not in "GroupByMemoryTypeBestFit", which also runs for "CalculateAllocationNumber"
+    uint64_t committedSize = 0;
+    for (const MemoryHeap& heap : m_Heaps)
+        committedSize += heap.size;
+
+    if (resourceGroupDesc.enableBestFitPacking && committedSize) {
+        double efficiency = 100.0 * double(m_PackedSize) / double(committedSize);
+        REPORT_INFO((DeviceBase*)&m_Device, "Best-fit packing: %u resources in %u heaps, %.1f%% efficiency (%llu of %llu bytes)",
+            m_PackedNum, (uint32_t)m_Heaps.size(), efficiency, (unsigned long long)m_PackedSize, (unsigned long long)committedSize);
+    }
 
     return result;
 }
@@ -139,6 +153,11 @@ HelperDeviceMemoryAllocator::MemoryHeap& HelperDeviceMemoryAllocator::FindOrCrea
 }
 
 void HelperDeviceMemoryAllocator::GroupByMemoryType(MemoryLocation memoryLocation, const ResourceGroupDesc& resourceGroupDesc) {
+    if (resourceGroupDesc.enableBestFitPacking) {
+        GroupByMemoryTypeBestFit(memoryLocation, resourceGroupDesc);
+        return;
+    }
+
     for (uint32_t i = 0; i < resourceGroupDesc.bufferNum; i++) {
         Buffer* buffer = resourceGroupDesc.buffers[i];
 
@@ -183,6 +202,99 @@ void HelperDeviceMemoryAllocator::GroupByMemoryType(MemoryLocation memoryLocatio
     }
 }
 
+void HelperDeviceMemoryAllocator::GroupByMemoryTypeBestFit(MemoryLocation memoryLocation, const ResourceGroupDesc& resourceGroupDesc) {
+    const DeviceDesc& deviceDesc = m_NRI.GetDeviceDesc(m_Device);
+    uint64_t preferredMemorySize = resourceGroupDesc.preferredMemorySize ? resourceGroupDesc.preferredMemorySize : 256 * 1024 * 1024;
+
+    Vector<PackedResource> resources(((DeviceBase&)m_Device).GetStdAllocator());
+    resources.reserve(resourceGroupDesc.bufferNum + resourceGroupDesc.textureNum);
+
+    for (uint32_t i = 0; i < resourceGroupDesc.bufferNum; i++) {
+        Buffer* buffer = resourceGroupDesc.buffers[i];
+
+        MemoryDesc memoryDesc = {};
+        m_NRI.GetBufferMemoryDesc(*buffer, memoryLocation, memoryDesc);
+
+        if (memoryDesc.mustBeDedicated)
+            m_DedicatedBuffers.push_back(buffer);
+        else
+            resources.push_back({memoryDesc, i, false});
+    }
+
+    for (uint32_t i = 0; i < resourceGroupDesc.textureNum; i++) {
+        Texture* texture = resourceGroupDesc.textures[i];
+
+        MemoryDesc memoryDesc = {};
+        m_NRI.GetTextureMemoryDesc(*texture, memoryLocation, memoryDesc);
+
+        if (memoryDesc.mustBeDedicated)
+            m_DedicatedTextures.push_back(texture);
+        else
+            resources.push_back({memoryDesc, i, true});
+    }
+
+    // Decreasing alignment first, then decreasing size: big aligned resources leave no padding for smaller ones to fall into
+    std::stable_sort(resources.begin(), resources.end(), [](const PackedResource& a, const PackedResource& b) {
+        if (a.memoryDesc.type != b.memoryDesc.type)
+            return a.memoryDesc.type < b.memoryDesc.type;
+
+        if (a.memoryDesc.alignment != b.memoryDesc.alignment)
+            return a.memoryDesc.alignment > b.memoryDesc.alignment;
+
+        return a.memoryDesc.size > b.memoryDesc.size;
+    });
+
+    for (const PackedResource& resource : resources) {
+        const MemoryDesc& memoryDesc = resource.memoryDesc;
+
+        // Best fit: the heap with the least room left after placement
+        size_t bestHeap = m_Heaps.size();
+        uint64_t bestOffset = 0;
+        uint64_t bestSize = 0;
+
+        for (size_t j = 0; j < m_Heaps.size(); j++) {
+            const MemoryHeap& heap = m_Heaps[j];
+            if (heap.type != memoryDesc.type)
+                continue;
+
+            uint64_t heapSize = heap.size;
+            if (heapSize && heap.isLastTexture != resource.isTexture)
+                heapSize = Align(heapSize, deviceDesc.bufferTextureGranularity);
+
+            uint64_t offset = Align(heapSize, memoryDesc.alignment);
+            uint64_t newSize = offset + memoryDesc.size;
+
+            if (newSize <= preferredMemorySize && newSize > bestSize) {
+                bestHeap = j;
+                bestOffset = offset;
+                bestSize = newSize;
+            }
+        }
+
+        if (bestHeap == m_Heaps.size()) {
+            m_Heaps.push_back(MemoryHeap(memoryDesc.type, ((DeviceBase&)m_Device).GetStdAllocator()));
+            bestOffset = 0;
+            bestSize = memoryDesc.size;
+        }
+
+        MemoryHeap& heap = m_Heaps[bestHeap];
+        if (resource.isTexture) {
+            heap.textures.push_back(resourceGroupDesc.textures[resource.index]);
+            heap.textureOffsets.push_back(bestOffset);
+        } else {
+            heap.buffers.push_back(resourceGroupDesc.buffers[resource.index]);
+            heap.bufferOffsets.push_back(bestOffset);
+        }
+
+        heap.size = bestSize;
+        heap.isLastTexture = resource.isTexture;
+
+        m_PackedSize += memoryDesc.size;
+    }
+
+    m_PackedNum = (uint32_t)resources.size();
+}
+
 void HelperDeviceMemoryAllocator::FillMemoryBindingDescs(Buffer* const* buffers, const uint64_t* bufferOffsets, uint32_t bufferNum, Memory& memory) {
     for (uint32_t i = 0; i < bufferNum; i++) {
         BufferMemoryBindingDesc desc = {};
@@ -0,0 +1,61 @@
+// © 2021 NVIDIA Corporation
+
+#pragma once
+
+namespace nri {
+
+constexpr uint32_t MEMORY_SEGMENT_NUM = 2; // local and non-local
+
+struct BudgetedMemory {
+    Memory* memory;
+    uint64_t size;
+    uint64_t lastUsedFrame;
+    float priority;
+    MemoryLocation memoryLocation;
+    bool isEvicting; // accepted by "EvictMemory", committed until "FreeBudgetedMemory"
+};
+
+struct BudgetedMemorySegment {
+    uint64_t budgetSize; // 0 if unknown
+    uint64_t queriedUsageSize;
+    uint64_t queriedCommittedSize; // "committedSize" at the moment of the query
+    uint64_t committedSize;
+    uint64_t overrideBudgetSize;
+};
+
+struct HelperMemoryBudget {
+    HelperMemoryBudget(const CoreInterface& NRI, Device& device);
+    ~HelperMemoryBudget();
+
+    inline Device& GetDevice() {
+        return m_Device;
+    }
+
+    Result Create(const MemoryBudgetDesc& memoryBudgetDesc);
+    Result AllocateMemory(const AllocateMemoryDesc& allocateMemoryDesc, MemoryLocation memoryLocation, Memory*& memory);
+    void FreeMemory(Memory& memory);
+    void TouchMemory(Memory* const* memories, uint32_t memoryNum);
+    void Update();
+    void GetStats(MemoryLocation memoryLocation, MemoryBudgetStats& memoryBudgetStats) const;
+
+private:
+    void QueryBudgets();
+    uint64_t GetUsageSize(const BudgetedMemorySegment& segment) const;
+    bool IsOverBudget(const BudgetedMemorySegment& segment, uint64_t size) const;
+    void Evict(uint32_t segment, uint64_t size, float maxPriority);
+
+    const CoreInterface& m_NRI;
+    Device& m_Device;
+    Vector<BudgetedMemory> m_Memories;
+    UnorderedMap<const Memory*, uint32_t> m_MemoryIndices;
+    std::array<BudgetedMemorySegment, MEMORY_SEGMENT_NUM> m_Segments = {};
+    std::array<uint64_t, (size_t)MemoryLocation::MAX_NUM> m_CommittedSizes = {};
+    std::array<uint64_t, (size_t)MemoryLocation::MAX_NUM> m_EvictedSizes = {};
+    std::array<uint32_t, (size_t)MemoryLocation::MAX_NUM> m_RejectedNums = {};
+    bool (*m_EvictMemory)(Memory* memory, void* userArg) = nullptr;
+    void* m_UserArg = nullptr;
+    Result(NRI_CALL* m_QueryVideoMemoryInfo)(const Device& device, MemoryLocation memoryLocation, VideoMemoryInfo& videoMemoryInfo) = nullptr;
+    uint64_t m_Frame = 0;
+};
+
+} // namespace nri
@@ -0,0 +1,195 @@
+// © 2021 NVIDIA Corporation
+
+static inline uint32_t GetMemorySegment(MemoryLocation memoryLocation) {
+    return (memoryLocation == MemoryLocation::DEVICE || memoryLocation == MemoryLocation::DEVICE_UPLOAD) ? 0 : 1;
+}
+
+HelperMemoryBudget::HelperMemoryBudget(const CoreInterface& NRI, Device& device)
+    : m_NRI(NRI)
+    , m_Device(device)
+    , m_Memories(((DeviceBase&)device).GetStdAllocator())
+    , m_MemoryIndices(((DeviceBase&)device).GetStdAllocator()) {
+}
+
+HelperMemoryBudget::~HelperMemoryBudget() {
+    for (const BudgetedMemory& budgetedMemory : m_Memories)
+        m_NRI.FreeMemory(*budgetedMemory.memory);
+}
+
+Result HelperMemoryBudget::Create(const MemoryBudgetDesc& memoryBudgetDesc) {
+    m_EvictMemory = memoryBudgetDesc.EvictMemory;
+    m_UserArg = memoryBudgetDesc.userArg;
+    m_Segments[0].overrideBudgetSize = memoryBudgetDesc.localBudgetSize;
+    m_Segments[1].overrideBudgetSize = memoryBudgetDesc.nonLocalBudgetSize;
+
+    // Budgets are queried via the device's own helper interface
+    HelperInterface helperInterface = {};
+    Result result = ((DeviceBase&)m_Device).FillFunctionTable(helperInterface);
+    if (result != Result::SUCCESS)
+        return result;
+
+    m_QueryVideoMemoryInfo = helperInterface.QueryVideoMemoryInfo;
+
+    QueryBudgets();
+
+    return Result::SUCCESS;
+}
+
+Result HelperMemoryBudget::AllocateMemory(const AllocateMemoryDesc& allocateMemoryDesc, MemoryLocation memoryLocation, Memory*& memory) {
+    memory = nullptr;
+
+    uint32_t segmentIndex = GetMemorySegment(memoryLocation);
+    BudgetedMemorySegment& segment = m_Segments[segmentIndex];
+
+    if (IsOverBudget(segment, allocateMemoryDesc.size)) {
+        Evict(segmentIndex, allocateMemoryDesc.size, allocateMemoryDesc.priority);
+
+        if (IsOverBudget(segment, allocateMemoryDesc.size)) {
+            m_RejectedNums[(size_t)memoryLocation]++;
+            return Result::OUT_OF_MEMORY;
+        }
+    }
+
+    Result result = m_NRI.AllocateMemory(m_Device, allocateMemoryDesc, memory);
+    if (result != Result::SUCCESS)
+        return result;
+
+    m_MemoryIndices[memory] = (uint32_t)m_Memories.size();
+    m_Memories.push_back({memory, allocateMemoryDesc.size, m_Frame, allocateMemoryDesc.priority, memoryLocation, false});
+
+    m_CommittedSizes[(size_t)memoryLocation] += allocateMemoryDesc.size;
+    segment.committedSize += allocateMemoryDesc.size;
+
+    return Result::SUCCESS;
+}
+
+void HelperMemoryBudget::FreeMemory(Memory& memory) {
+    auto it = m_MemoryIndices.find(&memory);
+    if (it == m_MemoryIndices.end())
+        return;
+
+    uint32_t index = it->second;
+    m_MemoryIndices.erase(it);
+
+    const BudgetedMemory& budgetedMemory = m_Memories[index];
+    m_CommittedSizes[(size_t)budgetedMemory.memoryLocation] -= budgetedMemory.size;
+    m_Segments[GetMemorySegment(budgetedMemory.memoryLocation)].committedSize -= budgetedMemory.size;
+
+    m_NRI.FreeMemory(memory);
+
+    // Swap with the last one
+    if (index != m_Memories.size() - 1) {
+        m_Memories[index] = m_Memories.back();
+        m_MemoryIndices[m_Memories[index].memory] = index;
+    }
+
+    m_Memories.pop_back();
+}
+
+void HelperMemoryBudget::TouchMemory(Memory* const* memories, uint32_t memoryNum) {
+    for (uint32_t i = 0; i < memoryNum; i++) {
+        auto it = m_MemoryIndices.find(memories[i]);
+        if (it != m_MemoryIndices.end())
+            m_Memories[it->second].lastUsedFrame = m_Frame;
+    }
+}
+
+void HelperMemoryBudget::Update() {
+    m_Frame++;
+
+    QueryBudgets();
+
+    for (uint32_t i = 0; i < MEMORY_SEGMENT_NUM; i++) {
+        if (IsOverBudget(m_Segments[i], 0))
+            Evict(i, 0, std::numeric_limits<float>::max());
+    }
+}
+
+void HelperMemoryBudget::GetStats(MemoryLocation memoryLocation, MemoryBudgetStats& memoryBudgetStats) const {
+    const BudgetedMemorySegment& segment = m_Segments[GetMemorySegment(memoryLocation)];
+
+    memoryBudgetStats = {};
+    memoryBudgetStats.committedSize = m_CommittedSizes[(size_t)memoryLocation];
+    memoryBudgetStats.budgetSize = segment.budgetSize;
+    memoryBudgetStats.usageSize = GetUsageSize(segment);
+    memoryBudgetStats.headroomSize = memoryBudgetStats.budgetSize > memoryBudgetStats.usageSize ? memoryBudgetStats.budgetSize - memoryBudgetStats.usageSize : 0;
+    memoryBudgetStats.evictedSize = m_EvictedSizes[(size_t)memoryLocation];
+    memoryBudgetStats.rejectedNum = m_RejectedNums[(size_t)memoryLocation];
+}
+
+void HelperMemoryBudget::QueryBudgets() {
+    for (uint32_t i = 0; i < MEMORY_SEGMENT_NUM; i++) {
+        BudgetedMemorySegment& segment = m_Segments[i];
+
+        VideoMemoryInfo videoMemoryInfo = {};
+        if (m_QueryVideoMemoryInfo)
+            m_QueryVideoMemoryInfo(m_Device, i == 0 ? MemoryLocation::DEVICE : MemoryLocation::HOST_UPLOAD, videoMemoryInfo);
+
+        segment.budgetSize = segment.overrideBudgetSize ? segment.overrideBudgetSize : videoMemoryInfo.budgetSize;
+        segment.queriedUsageSize = videoMemoryInfo.usageSize;
+        segment.queriedCommittedSize = segment.committedSize;
+    }
+}
+
+uint64_t HelperMemoryBudget::GetUsageSize(const BudgetedMemorySegment& segment) const {
+    // The queried usage is updated with own allocations and frees made since the query
+    int64_t usageSize = (int64_t)segment.queriedUsageSize + (int64_t)segment.committedSize - (int64_t)segment.queriedCommittedSize;
+
+    return std::max((uint64_t)std::max(usageSize, (int64_t)0), segment.committedSize);
+}
+
+bool HelperMemoryBudget::IsOverBudget(const BudgetedMemorySegment& segment, uint64_t size) const {
+    return segment.budgetSize && GetUsageSize(segment) + size > segment.budgetSize;
+}
+
+void HelperMemoryBudget::Evict(uint32_t segmentIndex, uint64_t size, float maxPriority) {
+    if (!m_EvictMemory)
+        return;
+
+    const BudgetedMemorySegment& segment = m_Segments[segmentIndex];
+
+    // Candidates: not used in the current frame, lowest priority first, then least recently used
+    Vector<const BudgetedMemory*> candidates(((DeviceBase&)m_Device).GetStdAllocator());
+    for (const BudgetedMemory& budgetedMemory : m_Memories) {
+        if (!budgetedMemory.isEvicting && budgetedMemory.lastUsedFrame < m_Frame && budgetedMemory.priority <= maxPriority && GetMemorySegment(budgetedMemory.memoryLocation) == segmentIndex)
+            candidates.push_back(&budgetedMemory);
+    }
+
+    std::stable_sort(candidates.begin(), candidates.end(), [](const BudgetedMemory* a, const BudgetedMemory* b) {
+        if (a->priority != b->priority)
+            return a->priority < b->priority;
+
+        return a->lastUsedFrame < b->lastUsedFrame;
+    });
+
+    // "EvictMemory" can free memory immediately, which reorders "m_Memories"
+    Vector<Memory*> victims(((DeviceBase&)m_Device).GetStdAllocator());
+    victims.reserve(candidates.size());
+    for (const BudgetedMemory* candidate : candidates)
+        victims.push_back(candidate->memory);
+
+    uint64_t pendingSize = 0;
+    for (Memory* victim : victims) {
+        uint64_t usageSize = GetUsageSize(segment);
+        if (usageSize < pendingSize || usageSize - pendingSize + size <= segment.budgetSize)
+            break;
+
+        auto it = m_MemoryIndices.find(victim);
+        if (it == m_MemoryIndices.end())
+            continue;
+
+        uint64_t victimSize = m_Memories[it->second].size;
+        MemoryLocation memoryLocation = m_Memories[it->second].memoryLocation;
+
+        if (!m_EvictMemory(victim, m_UserArg))
+            continue;
+
+        m_EvictedSizes[(size_t)memoryLocation] += victimSize;
+
+        it = m_MemoryIndices.find(victim);
+        if (it != m_MemoryIndices.end()) {
+            m_Memories[it->second].isEvicting = true;
+            pendingSize += victimSize;
+        }
+    }
+}
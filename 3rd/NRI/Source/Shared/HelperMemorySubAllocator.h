@@ -0,0 +1,91 @@
+// © 2021 NVIDIA Corporation
+
+#pragma once
+
+namespace nri {
+
+constexpr uint64_t SUB_ALLOCATOR_HEAP_SIZE = 64 * 1024 * 1024;
+constexpr uint32_t SUB_ALLOCATOR_HEAP_RESERVE_NUM = 1; // empty heaps kept alive per heap kind
+
+constexpr uint32_t TLSF_SL_LOG2 = 4; // second level: 16 linear subdivisions of a power-of-two range
+constexpr uint32_t TLSF_SL_NUM = 1 << TLSF_SL_LOG2;
+constexpr uint32_t TLSF_FL_NUM = 64 - TLSF_SL_LOG2 + 1;
+constexpr uint64_t TLSF_MIN_SPLIT_SIZE = 256; // smaller remainders stay in the allocated block
+constexpr uint32_t TLSF_NULL = uint32_t(-1);
+
+struct MemoryBlockTLSF {
+    uint64_t offset;
+    uint64_t size;
+    uint32_t prevPhysical;
+    uint32_t nextPhysical;
+    uint32_t prevFree;
+    uint32_t nextFree;
+    bool isFree;
+};
+
+// Two-level segregated fit allocator of offsets within a single heap: O(1) allocation and free with immediate coalescing
+struct MemoryHeapTLSF {
+    MemoryHeapTLSF(const StdAllocator<uint8_t>& stdAllocator);
+
+    inline bool IsEmpty() const {
+        return m_UsedNum == 0;
+    }
+
+    inline uint64_t GetSize() const {
+        return m_Size;
+    }
+
+    void Initialize(uint64_t size);
+    bool Allocate(uint64_t size, uint64_t alignment, uint64_t& offset, uint32_t& block);
+    void Free(uint32_t block);
+
+private:
+    uint32_t CreateBlock(uint64_t offset, uint64_t size);
+    void DestroyBlock(uint32_t block);
+    void InsertFreeBlock(uint32_t block);
+    void RemoveFreeBlock(uint32_t block);
+    uint32_t FindFreeBlock(uint64_t size) const;
+
+    Vector<MemoryBlockTLSF> m_Blocks;
+    Vector<uint32_t> m_UnusedBlocks;
+    uint32_t m_FreeHeads[TLSF_FL_NUM][TLSF_SL_NUM];
+    uint32_t m_SecondLevelBitmaps[TLSF_FL_NUM] = {};
+    uint64_t m_FirstLevelBitmap = 0;
+    uint64_t m_Size = 0;
+    uint32_t m_UsedNum = 0;
+};
+
+struct HelperMemoryAllocation {
+    Memory* memory; // "nullptr" if not allocated
+    uint64_t offset;
+    uint32_t heap;
+    uint32_t block;
+};
+
+struct HelperMemorySubHeap {
+    Memory* memory; // "nullptr" if the slot is unused
+    MemoryHeapTLSF* tlsf;
+    MemoryType type;
+    bool isTexture;
+    bool isDedicated;
+};
+
+// Long-lived sub-allocator on top of "AllocateMemory": resources can be allocated and freed individually, empty heaps are recycled
+struct HelperMemorySubAllocator {
+    HelperMemorySubAllocator(const CoreInterface& NRI, Device& device);
+    ~HelperMemorySubAllocator();
+
+    Result Allocate(const MemoryDesc& memoryDesc, bool isTexture, float priority, HelperMemoryAllocation& allocation);
+    void Free(HelperMemoryAllocation& allocation);
+
+private:
+    Result CreateHeap(MemoryType memoryType, bool isTexture, bool isDedicated, uint64_t size, float priority, uint32_t& heap);
+    void DestroyHeap(uint32_t heap);
+
+    const CoreInterface& m_NRI;
+    Device& m_Device;
+    Vector<HelperMemorySubHeap> m_Heaps;
+    Lock m_Lock;
+};
+
+} // namespace nri
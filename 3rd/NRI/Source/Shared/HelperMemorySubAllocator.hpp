@@ -0,0 +1,369 @@
+// © 2021 NVIDIA Corporation
+
+#if defined(_MSC_VER)
+#    include <intrin.h>
+#endif
+
+static inline uint32_t FindMostSignificantBit(uint64_t x) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, x);
+
+    return (uint32_t)index;
+#else
+    return 63 - (uint32_t)__builtin_clzll(x);
+#endif
+}
+
+static inline uint32_t FindLeastSignificantBit(uint64_t x) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+
+    return (uint32_t)index;
+#else
+    return (uint32_t)__builtin_ctzll(x);
+#endif
+}
+
+static inline void MapSizeTLSF(uint64_t size, uint32_t& fl, uint32_t& sl) {
+    if (size < TLSF_SL_NUM) {
+        fl = 0;
+        sl = (uint32_t)size;
+    } else {
+        uint32_t msb = FindMostSignificantBit(size);
+        fl = msb - TLSF_SL_LOG2 + 1;
+        sl = (uint32_t)(size >> (msb - TLSF_SL_LOG2)) - TLSF_SL_NUM;
+    }
+}
+
+MemoryHeapTLSF::MemoryHeapTLSF(const StdAllocator<uint8_t>& stdAllocator)
+    : m_Blocks(stdAllocator)
+    , m_UnusedBlocks(stdAllocator) {
+}
+
+void MemoryHeapTLSF::Initialize(uint64_t size) {
+    for (uint32_t i = 0; i < TLSF_FL_NUM; i++) {
+        for (uint32_t j = 0; j < TLSF_SL_NUM; j++)
+            m_FreeHeads[i][j] = TLSF_NULL;
+    }
+
+    m_Size = size;
+
+    uint32_t block = CreateBlock(0, size);
+    InsertFreeBlock(block);
+}
+
+bool MemoryHeapTLSF::Allocate(uint64_t size, uint64_t alignment, uint64_t& offset, uint32_t& block) {
+    size = std::max(size, (uint64_t)1);
+    alignment = std::max(alignment, (uint64_t)1);
+
+    // Any block from the found list fits the worst case padding
+    block = FindFreeBlock(size + alignment - 1);
+    if (block == TLSF_NULL)
+        return false;
+
+    RemoveFreeBlock(block);
+
+    // Return the alignment padding to the free lists ("prevPhysical" can't be free, because free blocks are always coalesced)
+    MemoryBlockTLSF* b = &m_Blocks[block];
+    uint64_t padding = Align(b->offset, alignment) - b->offset;
+    if (padding) {
+        uint32_t front = CreateBlock(b->offset, padding);
+        b = &m_Blocks[block];
+
+        MemoryBlockTLSF& f = m_Blocks[front];
+        f.prevPhysical = b->prevPhysical;
+        f.nextPhysical = block;
+        if (b->prevPhysical != TLSF_NULL)
+            m_Blocks[b->prevPhysical].nextPhysical = front;
+
+        b->prevPhysical = front;
+        b->offset += padding;
+        b->size -= padding;
+
+        InsertFreeBlock(front);
+        b = &m_Blocks[block];
+    }
+
+    // Return the tail to the free lists ("nextPhysical" can't be free)
+    if (b->size - size >= TLSF_MIN_SPLIT_SIZE) {
+        uint32_t tail = CreateBlock(b->offset + size, b->size - size);
+        b = &m_Blocks[block];
+
+        MemoryBlockTLSF& t = m_Blocks[tail];
+        t.prevPhysical = block;
+        t.nextPhysical = b->nextPhysical;
+        if (b->nextPhysical != TLSF_NULL)
+            m_Blocks[b->nextPhysical].prevPhysical = tail;
+
+        b->nextPhysical = tail;
+        b->size = size;
+
+        InsertFreeBlock(tail);
+        b = &m_Blocks[block];
+    }
+
+    b->isFree = false;
+    offset = b->offset;
+    m_UsedNum++;
+
+    return true;
+}
+
+void MemoryHeapTLSF::Free(uint32_t block) {
+    MemoryBlockTLSF& b = m_Blocks[block];
+    assert(!b.isFree);
+
+    m_UsedNum--;
+
+    // Coalesce with free neighbors
+    uint32_t prev = b.prevPhysical;
+    if (prev != TLSF_NULL && m_Blocks[prev].isFree) {
+        RemoveFreeBlock(prev);
+
+        MemoryBlockTLSF& p = m_Blocks[prev];
+        b.offset = p.offset;
+        b.size += p.size;
+        b.prevPhysical = p.prevPhysical;
+        if (p.prevPhysical != TLSF_NULL)
+            m_Blocks[p.prevPhysical].nextPhysical = block;
+
+        DestroyBlock(prev);
+    }
+
+    uint32_t next = b.nextPhysical;
+    if (next != TLSF_NULL && m_Blocks[next].isFree) {
+        RemoveFreeBlock(next);
+
+        MemoryBlockTLSF& n = m_Blocks[next];
+        b.size += n.size;
+        b.nextPhysical = n.nextPhysical;
+        if (n.nextPhysical != TLSF_NULL)
+            m_Blocks[n.nextPhysical].prevPhysical = block;
+
+        DestroyBlock(next);
+    }
+
+    InsertFreeBlock(block);
+}
+
+uint32_t MemoryHeapTLSF::CreateBlock(uint64_t offset, uint64_t size) {
+    uint32_t block;
+    if (!m_UnusedBlocks.empty()) {
+        block = m_UnusedBlocks.back();
+        m_UnusedBlocks.pop_back();
+    } else {
+        block = (uint32_t)m_Blocks.size();
+        m_Blocks.push_back({});
+    }
+
+    m_Blocks[block] = {offset, size, TLSF_NULL, TLSF_NULL, TLSF_NULL, TLSF_NULL, false};
+
+    return block;
+}
+
+void MemoryHeapTLSF::DestroyBlock(uint32_t block) {
+    m_UnusedBlocks.push_back(block);
+}
+
+void MemoryHeapTLSF::InsertFreeBlock(uint32_t block) {
+    MemoryBlockTLSF& b = m_Blocks[block];
+
+    uint32_t fl, sl;
+    MapSizeTLSF(b.size, fl, sl);
+
+    uint32_t head = m_FreeHeads[fl][sl];
+    if (head != TLSF_NULL)
+        m_Blocks[head].prevFree = block;
+
+    b.isFree = true;
+    b.prevFree = TLSF_NULL;
+    b.nextFree = head;
+
+    m_FreeHeads[fl][sl] = block;
+    m_FirstLevelBitmap |= 1ull << fl;
+    m_SecondLevelBitmaps[fl] |= 1u << sl;
+}
+
+void MemoryHeapTLSF::RemoveFreeBlock(uint32_t block) {
+    MemoryBlockTLSF& b = m_Blocks[block];
+
+    uint32_t fl, sl;
+    MapSizeTLSF(b.size, fl, sl);
+
+    if (b.prevFree != TLSF_NULL)
+        m_Blocks[b.prevFree].nextFree = b.nextFree;
+    else
+        m_FreeHeads[fl][sl] = b.nextFree;
+
+    if (b.nextFree != TLSF_NULL)
+        m_Blocks[b.nextFree].prevFree = b.prevFree;
+
+    if (m_FreeHeads[fl][sl] == TLSF_NULL) {
+        m_SecondLevelBitmaps[fl] &= ~(1u << sl);
+        if (!m_SecondLevelBitmaps[fl])
+            m_FirstLevelBitmap &= ~(1ull << fl);
+    }
+
+    b.isFree = false;
+    b.prevFree = TLSF_NULL;
+    b.nextFree = TLSF_NULL;
+}
+
+uint32_t MemoryHeapTLSF::FindFreeBlock(uint64_t size) const {
+    if (size > m_Size)
+        return TLSF_NULL;
+
+    // Round up to the next list, so any block in it fits
+    if (size >= TLSF_SL_NUM)
+        size += (1ull << (FindMostSignificantBit(size) - TLSF_SL_LOG2)) - 1;
+
+    uint32_t fl, sl;
+    MapSizeTLSF(size, fl, sl);
+
+    uint32_t slBitmap = m_SecondLevelBitmaps[fl] & (~0u << sl);
+    if (!slBitmap) {
+        uint64_t flBitmap = fl + 1 < 64 ? m_FirstLevelBitmap & (~0ull << (fl + 1)) : 0;
+        if (!flBitmap)
+            return TLSF_NULL;
+
+        fl = FindLeastSignificantBit(flBitmap);
+        slBitmap = m_SecondLevelBitmaps[fl];
+    }
+
+    sl = FindLeastSignificantBit(slBitmap);
+
+    return m_FreeHeads[fl][sl];
+}
+
+HelperMemorySubAllocator::HelperMemorySubAllocator(const CoreInterface& NRI, Device& device)
+    : m_NRI(NRI)
+    , m_Device(device)
+    , m_Heaps(((DeviceBase&)device).GetStdAllocator()) {
+}
+
+HelperMemorySubAllocator::~HelperMemorySubAllocator() {
+    for (uint32_t i = 0; i < (uint32_t)m_Heaps.size(); i++) {
+        if (m_Heaps[i].memory)
+            DestroyHeap(i);
+    }
+}
+
+Result HelperMemorySubAllocator::Allocate(const MemoryDesc& memoryDesc, bool isTexture, float priority, HelperMemoryAllocation& allocation) {
+    ExclusiveScope lock(m_Lock);
+
+    allocation = {};
+
+    // Linear and non-linear resources share heaps only if the device doesn't care
+    const DeviceDesc& deviceDesc = m_NRI.GetDeviceDesc(m_Device);
+    if (deviceDesc.bufferTextureGranularity <= 1)
+        isTexture = false;
+
+    uint64_t alignment = std::max(memoryDesc.alignment, 1u);
+    bool isDedicated = memoryDesc.mustBeDedicated || memoryDesc.size > SUB_ALLOCATOR_HEAP_SIZE / 2;
+
+    uint32_t heap = 0;
+    uint64_t offset = 0;
+    uint32_t block = TLSF_NULL;
+
+    if (!isDedicated) {
+        for (; heap < (uint32_t)m_Heaps.size(); heap++) {
+            HelperMemorySubHeap& subHeap = m_Heaps[heap];
+            if (subHeap.memory && !subHeap.isDedicated && subHeap.type == memoryDesc.type && subHeap.isTexture == isTexture) {
+                if (subHeap.tlsf->Allocate(memoryDesc.size, alignment, offset, block))
+                    break;
+            }
+        }
+    }
+
+    if (block == TLSF_NULL) {
+        uint64_t heapSize = isDedicated ? memoryDesc.size : SUB_ALLOCATOR_HEAP_SIZE;
+
+        Result result = CreateHeap(memoryDesc.type, isTexture, isDedicated, heapSize, priority, heap);
+        if (result != Result::SUCCESS)
+            return result;
+
+        // A fresh heap starts at offset 0, which satisfies any alignment
+        bool isAllocated = m_Heaps[heap].tlsf->Allocate(memoryDesc.size, 1, offset, block);
+        assert(isAllocated);
+        MaybeUnused(isAllocated);
+    }
+
+    allocation.memory = m_Heaps[heap].memory;
+    allocation.offset = offset;
+    allocation.heap = heap;
+    allocation.block = block;
+
+    return Result::SUCCESS;
+}
+
+void HelperMemorySubAllocator::Free(HelperMemoryAllocation& allocation) {
+    if (!allocation.memory)
+        return;
+
+    ExclusiveScope lock(m_Lock);
+
+    HelperMemorySubHeap& subHeap = m_Heaps[allocation.heap];
+    subHeap.tlsf->Free(allocation.block);
+
+    allocation = {};
+
+    if (!subHeap.tlsf->IsEmpty())
+        return;
+
+    // Recycle: keep a few empty heaps of each kind for future allocations
+    uint32_t emptyHeapNum = 0;
+    if (!subHeap.isDedicated) {
+        for (const HelperMemorySubHeap& other : m_Heaps) {
+            if (other.memory && !other.isDedicated && other.type == subHeap.type && other.isTexture == subHeap.isTexture && other.tlsf->IsEmpty())
+                emptyHeapNum++;
+        }
+    }
+
+    if (subHeap.isDedicated || emptyHeapNum > SUB_ALLOCATOR_HEAP_RESERVE_NUM)
+        DestroyHeap((uint32_t)(&subHeap - m_Heaps.data()));
+}
+
+Result HelperMemorySubAllocator::CreateHeap(MemoryType memoryType, bool isTexture, bool isDedicated, uint64_t size, float priority, uint32_t& heap) {
+    AllocateMemoryDesc allocateMemoryDesc = {};
+    allocateMemoryDesc.size = size;
+    allocateMemoryDesc.type = memoryType;
+    allocateMemoryDesc.priority = priority;
+
+    Memory* memory = nullptr;
+    Result result = m_NRI.AllocateMemory(m_Device, allocateMemoryDesc, memory);
+    if (result != Result::SUCCESS)
+        return result;
+
+    DeviceBase& deviceBase = (DeviceBase&)m_Device;
+    MemoryHeapTLSF* tlsf = ::Allocate<MemoryHeapTLSF>(deviceBase.GetAllocationCallbacks(), deviceBase.GetStdAllocator());
+    if (!tlsf) {
+        m_NRI.FreeMemory(*memory);
+        return Result::OUT_OF_MEMORY;
+    }
+
+    tlsf->Initialize(size);
+
+    // Reuse a slot, because allocations reference heaps by index
+    for (heap = 0; heap < (uint32_t)m_Heaps.size(); heap++) {
+        if (!m_Heaps[heap].memory)
+            break;
+    }
+
+    if (heap == (uint32_t)m_Heaps.size())
+        m_Heaps.push_back({});
+
+    m_Heaps[heap] = {memory, tlsf, memoryType, isTexture, isDedicated};
+
+    return Result::SUCCESS;
+}
+
+void HelperMemorySubAllocator::DestroyHeap(uint32_t heap) {
+    HelperMemorySubHeap& subHeap = m_Heaps[heap];
+
+    m_NRI.FreeMemory(*subHeap.memory);
+    Destroy(((DeviceBase&)m_Device).GetAllocationCallbacks(), subHeap.tlsf);
+
+    subHeap = {};
+}
@@ -0,0 +1,57 @@
+// © 2021 NVIDIA Corporation
+
+#pragma once
+
+namespace nri {
+
+constexpr uint32_t CACHED_PIPELINE_NONE = uint32_t(-1);
+
+struct CachedPipeline {
+    Vector<uint64_t> key; // pipeline type and layout, then all members of the desc (shaders are represented by size and bytecode hash)
+    Pipeline* pipeline;
+    uint64_t hash;
+    uint32_t nextWithSameHash;
+    uint32_t waiterNum; // threads waiting for the creation, the last one releases a failed entry
+    Result result;      // of the creation, valid if not pending
+    bool isPending;     // "in-flight": being created by another thread outside of the lock
+};
+
+struct HelperPipelineCache {
+    HelperPipelineCache(const CoreInterface& NRI, Device& device);
+    ~HelperPipelineCache();
+
+    inline Device& GetDevice() {
+        return m_Device;
+    }
+
+    Result Create(const PipelineCacheDesc& pipelineCacheDesc);
+    Result GetGraphicsPipeline(const GraphicsPipelineDesc& graphicsPipelineDesc, Pipeline*& pipeline);
+    Result GetComputePipeline(const ComputePipelineDesc& computePipelineDesc, Pipeline*& pipeline);
+    void Purge(const PipelineLayout& pipelineLayout);
+    void GetStats(PipelineCacheStats& pipelineCacheStats);
+
+private:
+    Result GetPipeline(Vector<uint64_t>& key, const GraphicsPipelineDesc* graphicsPipelineDesc, const ComputePipelineDesc* computePipelineDesc, Pipeline*& pipeline);
+    uint32_t Find(uint64_t hash, const Vector<uint64_t>& key) const;
+    uint32_t Add(Vector<uint64_t>& key, uint64_t hash);
+    void RemoveFromHashChain(uint32_t index);
+    void Release(uint32_t index);
+
+    static void BuildKey(const GraphicsPipelineDesc& graphicsPipelineDesc, Vector<uint64_t>& key);
+    static void BuildKey(const ComputePipelineDesc& computePipelineDesc, Vector<uint64_t>& key);
+    static void AddShader(const ShaderDesc& shaderDesc, Vector<uint64_t>& key);
+    static void AddString(const char* string, Vector<uint64_t>& key);
+
+    const CoreInterface& m_NRI;
+    Device& m_Device;
+    Vector<CachedPipeline> m_Pipelines;
+    Vector<uint32_t> m_FreeIndices; // of released entries (failed or purged), reused by "Add"
+    UnorderedMap<uint64_t, uint32_t> m_PipelineIndices; // hash => the first pipeline in the chain
+    std::atomic_uint64_t m_HitNum = 0;                  // updated under the shared lock
+    std::atomic_uint64_t m_MissNum = 0;
+    std::atomic_uint32_t m_CompletedNum = 0; // creations finished, waiters park on it
+    uint32_t m_PipelineNum = 0;
+    RwLock m_Lock;
+};
+
+} // namespace nri
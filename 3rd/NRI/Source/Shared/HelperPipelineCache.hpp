@@ -0,0 +1,405 @@
+// © 2021 NVIDIA Corporation
+
+constexpr uint64_t PIPELINE_CACHE_HASH_K0 = 0x9E3779B97F4A7C15ull;
+constexpr uint64_t PIPELINE_CACHE_HASH_K1 = 0xC2B2AE3D27D4EB4Full;
+
+// Graphics and compute keys never match
+constexpr uint64_t PIPELINE_CACHE_GRAPHICS = 0;
+constexpr uint64_t PIPELINE_CACHE_COMPUTE = 1;
+
+static inline uint64_t HashPipelineCacheWord(uint64_t hash, uint64_t word) {
+    hash ^= word * PIPELINE_CACHE_HASH_K1;
+
+    return ((hash << 31) | (hash >> 33)) * PIPELINE_CACHE_HASH_K0;
+}
+
+static inline uint64_t HashPipelineCacheBytes(const void* data, uint64_t size) {
+    const uint8_t* bytes = (const uint8_t*)data;
+
+    // Bytecode can be big, 4 independent lanes hide multiplication latency
+    uint64_t lanes[4] = {size * PIPELINE_CACHE_HASH_K0, size, PIPELINE_CACHE_HASH_K0, PIPELINE_CACHE_HASH_K1};
+
+    uint64_t i = 0;
+    for (; i + sizeof(lanes) <= size; i += sizeof(lanes)) {
+        uint64_t words[4];
+        memcpy(words, bytes + i, sizeof(words));
+
+        for (uint32_t j = 0; j < 4; j++)
+            lanes[j] = HashPipelineCacheWord(lanes[j], words[j]);
+    }
+
+    uint64_t hash = lanes[0];
+    for (uint32_t j = 1; j < 4; j++)
+        hash = HashPipelineCacheWord(hash, lanes[j]);
+
+    for (; i < size; i += sizeof(uint64_t)) {
+        uint64_t word = 0;
+        memcpy(&word, bytes + i, (size_t)std::min(size - i, (uint64_t)sizeof(uint64_t)));
+        hash = HashPipelineCacheWord(hash, word);
+    }
+
+    return hash ^ (hash >> 29);
+}
+
+static inline uint64_t HashPipelineCacheKey(const Vector<uint64_t>& key) {
+    uint64_t hash = key.size() * PIPELINE_CACHE_HASH_K0;
+    for (uint64_t word : key)
+        hash = HashPipelineCacheWord(hash, word);
+
+    return hash ^ (hash >> 29);
+}
+
+static inline uint64_t AsPipelineCacheWord(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    return bits;
+}
+
+HelperPipelineCache::HelperPipelineCache(const CoreInterface& NRI, Device& device)
+    : m_NRI(NRI)
+    , m_Device(device)
+    , m_Pipelines(((DeviceBase&)device).GetStdAllocator())
+    , m_FreeIndices(((DeviceBase&)device).GetStdAllocator())
+    , m_PipelineIndices(((DeviceBase&)device).GetStdAllocator()) {
+}
+
+HelperPipelineCache::~HelperPipelineCache() {
+    for (const CachedPipeline& cachedPipeline : m_Pipelines) {
+        if (cachedPipeline.pipeline)
+            m_NRI.DestroyPipeline(*cachedPipeline.pipeline);
+    }
+}
+
+Result HelperPipelineCache::Create(const PipelineCacheDesc& pipelineCacheDesc) {
+    if (!pipelineCacheDesc.data || !pipelineCacheDesc.dataSize)
+        return Result::SUCCESS;
+
+    // Previously saved data warms up the native pipeline cache of the device, which is used for all pipelines
+    HelperInterface helperInterface = {};
+    Result result = ((DeviceBase&)m_Device).FillFunctionTable(helperInterface);
+    if (result != Result::SUCCESS)
+        return result;
+
+    result = helperInterface.MergePipelineCacheData(m_Device, pipelineCacheDesc.data, pipelineCacheDesc.dataSize);
+
+    // Not an error, D3D drivers have their own caches
+    return result == Result::UNSUPPORTED ? Result::SUCCESS : result;
+}
+
+Result HelperPipelineCache::GetGraphicsPipeline(const GraphicsPipelineDesc& graphicsPipelineDesc, Pipeline*& pipeline) {
+    // Key building and bytecode hashing don't need the lock
+    Vector<uint64_t> key(((DeviceBase&)m_Device).GetStdAllocator());
+    BuildKey(graphicsPipelineDesc, key);
+
+    return GetPipeline(key, &graphicsPipelineDesc, nullptr, pipeline);
+}
+
+Result HelperPipelineCache::GetComputePipeline(const ComputePipelineDesc& computePipelineDesc, Pipeline*& pipeline) {
+    Vector<uint64_t> key(((DeviceBase&)m_Device).GetStdAllocator());
+    BuildKey(computePipelineDesc, key);
+
+    return GetPipeline(key, nullptr, &computePipelineDesc, pipeline);
+}
+
+void HelperPipelineCache::Purge(const PipelineLayout& pipelineLayout) {
+    ExclusiveScope lock(m_Lock);
+
+    // Pipelines being created are skipped, requests with the layout must not run concurrently
+    uint64_t layoutWord = (uint64_t)(size_t)&pipelineLayout;
+    for (uint32_t i = 0; i < (uint32_t)m_Pipelines.size(); i++) {
+        CachedPipeline& cachedPipeline = m_Pipelines[i];
+        if (!cachedPipeline.pipeline || cachedPipeline.isPending || cachedPipeline.key[1] != layoutWord)
+            continue;
+
+        m_NRI.DestroyPipeline(*cachedPipeline.pipeline);
+        m_PipelineNum--;
+
+        RemoveFromHashChain(i);
+        Release(i);
+    }
+}
+
+void HelperPipelineCache::GetStats(PipelineCacheStats& pipelineCacheStats) {
+    SharedScope lock(m_Lock);
+
+    pipelineCacheStats.hitNum = m_HitNum.load(std::memory_order_relaxed);
+    pipelineCacheStats.missNum = m_MissNum.load(std::memory_order_relaxed);
+    pipelineCacheStats.pipelineNum = m_PipelineNum;
+}
+
+Result HelperPipelineCache::GetPipeline(Vector<uint64_t>& key, const GraphicsPipelineDesc* graphicsPipelineDesc, const ComputePipelineDesc* computePipelineDesc, Pipeline*& pipeline) {
+    uint64_t hash = HashPipelineCacheKey(key);
+    pipeline = nullptr;
+
+    // Hit on a created pipeline
+    uint32_t index = CACHED_PIPELINE_NONE;
+    {
+        SharedScope lock(m_Lock);
+
+        index = Find(hash, key);
+        if (index != CACHED_PIPELINE_NONE && !m_Pipelines[index].isPending) {
+            m_HitNum.fetch_add(1, std::memory_order_relaxed);
+            pipeline = m_Pipelines[index].pipeline;
+
+            return Result::SUCCESS;
+        }
+    }
+
+    // Miss: add an "in-flight" entry, concurrent requests of the same pipeline wait for it. Checked again, since another thread could add it meanwhile
+    bool isCreator = false;
+    {
+        ExclusiveScope lock(m_Lock);
+
+        index = Find(hash, key);
+        if (index == CACHED_PIPELINE_NONE) {
+            index = Add(key, hash);
+            isCreator = true;
+
+            m_MissNum.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            m_HitNum.fetch_add(1, std::memory_order_relaxed);
+
+            CachedPipeline& cachedPipeline = m_Pipelines[index];
+            if (!cachedPipeline.isPending) {
+                pipeline = cachedPipeline.pipeline;
+
+                return Result::SUCCESS;
+            }
+
+            cachedPipeline.waiterNum++;
+        }
+    }
+
+    if (isCreator) {
+        // Created outside of the lock, so different pipelines are created in parallel
+        Pipeline* newPipeline = nullptr;
+        Result result = graphicsPipelineDesc ? m_NRI.CreateGraphicsPipeline(m_Device, *graphicsPipelineDesc, newPipeline) : m_NRI.CreateComputePipeline(m_Device, *computePipelineDesc, newPipeline);
+        {
+            ExclusiveScope lock(m_Lock);
+
+            CachedPipeline& cachedPipeline = m_Pipelines[index];
+            cachedPipeline.pipeline = result == Result::SUCCESS ? newPipeline : nullptr;
+            cachedPipeline.result = result;
+            cachedPipeline.isPending = false;
+
+            // A failed entry is not found anymore, the next request retries (waiters get the error, the last one releases the entry)
+            if (result == Result::SUCCESS)
+                m_PipelineNum++;
+            else {
+                RemoveFromHashChain(index);
+
+                if (!cachedPipeline.waiterNum)
+                    Release(index);
+            }
+        }
+
+        m_CompletedNum.fetch_add(1, std::memory_order_release);
+        UnparkThreads(m_CompletedNum, true);
+
+        pipeline = result == Result::SUCCESS ? newPipeline : nullptr;
+
+        return result;
+    }
+
+    // Wait for the creator. "m_CompletedNum" is read before checking, so a completion in between doesn't let the thread sleep
+    for (;;) {
+        uint32_t completedNum = m_CompletedNum.load(std::memory_order_acquire);
+        {
+            SharedScope lock(m_Lock);
+
+            if (!m_Pipelines[index].isPending)
+                break;
+        }
+
+        ParkThread(m_CompletedNum, completedNum);
+    }
+
+    ExclusiveScope lock(m_Lock);
+
+    CachedPipeline& cachedPipeline = m_Pipelines[index];
+    pipeline = cachedPipeline.pipeline;
+    Result result = cachedPipeline.result;
+
+    if (--cachedPipeline.waiterNum == 0 && result != Result::SUCCESS)
+        Release(index);
+
+    return result;
+}
+
+void HelperPipelineCache::BuildKey(const GraphicsPipelineDesc& graphicsPipelineDesc, Vector<uint64_t>& key) {
+    // Member by member, since structs have padding
+    key.clear();
+    key.push_back(PIPELINE_CACHE_GRAPHICS);
+    key.push_back((uint64_t)(size_t)graphicsPipelineDesc.pipelineLayout);
+    key.push_back((uint64_t)graphicsPipelineDesc.robustness);
+
+    const VertexInputDesc* vertexInput = graphicsPipelineDesc.vertexInput;
+    if (vertexInput) {
+        key.push_back(((uint64_t)vertexInput->streamNum << 8) | vertexInput->attributeNum);
+
+        for (uint32_t i = 0; i < vertexInput->attributeNum; i++) {
+            const VertexAttributeDesc& attribute = vertexInput->attributes[i];
+            AddString(attribute.d3d.semanticName, key);
+            key.push_back(((uint64_t)attribute.d3d.semanticIndex << 32) | attribute.vk.location);
+            key.push_back(((uint64_t)attribute.offset << 32) | ((uint64_t)attribute.format << 16) | attribute.streamIndex);
+        }
+
+        for (uint32_t i = 0; i < vertexInput->streamNum; i++) {
+            const VertexStreamDesc& stream = vertexInput->streams[i];
+            key.push_back(((uint64_t)stream.stride << 32) | ((uint64_t)stream.bindingSlot << 16) | (uint64_t)stream.stepRate);
+        }
+    } else
+        key.push_back(uint64_t(-1));
+
+    const InputAssemblyDesc& inputAssembly = graphicsPipelineDesc.inputAssembly;
+    key.push_back(((uint64_t)inputAssembly.topology << 16) | ((uint64_t)inputAssembly.tessControlPointNum << 8) | (uint64_t)inputAssembly.primitiveRestart);
+
+    const RasterizationDesc& rasterization = graphicsPipelineDesc.rasterization;
+    key.push_back((AsPipelineCacheWord(rasterization.depthBias.constant) << 32) | AsPipelineCacheWord(rasterization.depthBias.clamp));
+    key.push_back(AsPipelineCacheWord(rasterization.depthBias.slope));
+    key.push_back(((uint64_t)rasterization.fillMode << 56) | ((uint64_t)rasterization.cullMode << 48) | ((uint64_t)rasterization.frontCounterClockwise << 40)
+        | ((uint64_t)rasterization.depthClamp << 32) | ((uint64_t)rasterization.lineSmoothing << 24) | ((uint64_t)rasterization.conservativeRaster << 16)
+        | (uint64_t)rasterization.shadingRate);
+
+    const MultisampleDesc* multisample = graphicsPipelineDesc.multisample;
+    if (multisample) {
+        key.push_back(multisample->sampleMask);
+        key.push_back(((uint64_t)multisample->sampleNum << 16) | ((uint64_t)multisample->alphaToCoverage << 8) | (uint64_t)multisample->sampleLocations);
+    } else
+        key.push_back(uint64_t(-1));
+
+    const OutputMergerDesc& outputMerger = graphicsPipelineDesc.outputMerger;
+    key.push_back(outputMerger.colorNum);
+
+    for (uint32_t i = 0; i < outputMerger.colorNum; i++) {
+        const ColorAttachmentDesc& color = outputMerger.colors[i];
+        key.push_back(((uint64_t)color.format << 32) | ((uint64_t)color.colorWriteMask << 8) | (uint64_t)color.blendEnabled);
+        key.push_back(((uint64_t)color.colorBlend.srcFactor << 40) | ((uint64_t)color.colorBlend.dstFactor << 32) | ((uint64_t)color.colorBlend.func << 24)
+            | ((uint64_t)color.alphaBlend.srcFactor << 16) | ((uint64_t)color.alphaBlend.dstFactor << 8) | (uint64_t)color.alphaBlend.func);
+    }
+
+    const DepthAttachmentDesc& depth = outputMerger.depth;
+    key.push_back(((uint64_t)depth.compareFunc << 16) | ((uint64_t)depth.write << 8) | (uint64_t)depth.boundsTest);
+
+    for (const StencilDesc* stencil : {&outputMerger.stencil.front, &outputMerger.stencil.back}) {
+        key.push_back(((uint64_t)stencil->compareFunc << 40) | ((uint64_t)stencil->fail << 32) | ((uint64_t)stencil->pass << 24)
+            | ((uint64_t)stencil->depthFail << 16) | ((uint64_t)stencil->writeMask << 8) | (uint64_t)stencil->compareMask);
+    }
+
+    key.push_back(((uint64_t)outputMerger.depthStencilFormat << 16) | ((uint64_t)outputMerger.logicFunc << 8) | (uint64_t)outputMerger.multiview);
+    key.push_back(outputMerger.viewMask);
+
+    key.push_back(graphicsPipelineDesc.shaderNum);
+    for (uint32_t i = 0; i < graphicsPipelineDesc.shaderNum; i++)
+        AddShader(graphicsPipelineDesc.shaders[i], key);
+}
+
+void HelperPipelineCache::BuildKey(const ComputePipelineDesc& computePipelineDesc, Vector<uint64_t>& key) {
+    key.clear();
+    key.push_back(PIPELINE_CACHE_COMPUTE);
+    key.push_back((uint64_t)(size_t)computePipelineDesc.pipelineLayout);
+    key.push_back((uint64_t)computePipelineDesc.robustness);
+
+    AddShader(computePipelineDesc.shader, key);
+}
+
+void HelperPipelineCache::AddShader(const ShaderDesc& shaderDesc, Vector<uint64_t>& key) {
+    // Bytecode is represented by its hash to keep keys small
+    key.push_back((uint64_t)shaderDesc.stage);
+    key.push_back(shaderDesc.size);
+    key.push_back(HashPipelineCacheBytes(shaderDesc.bytecode, shaderDesc.size));
+
+    AddString(shaderDesc.entryPointName, key);
+}
+
+void HelperPipelineCache::AddString(const char* string, Vector<uint64_t>& key) {
+    // Stored verbatim, "nullptr" and "" are different
+    if (!string) {
+        key.push_back(uint64_t(-1));
+        return;
+    }
+
+    size_t length = strlen(string);
+    key.push_back(length);
+
+    for (size_t i = 0; i < length; i += sizeof(uint64_t)) {
+        uint64_t word = 0;
+        memcpy(&word, string + i, std::min(length - i, sizeof(uint64_t)));
+        key.push_back(word);
+    }
+}
+
+uint32_t HelperPipelineCache::Find(uint64_t hash, const Vector<uint64_t>& key) const {
+    const auto it = m_PipelineIndices.find(hash);
+    if (it == m_PipelineIndices.end())
+        return CACHED_PIPELINE_NONE;
+
+    for (uint32_t i = it->second; i != CACHED_PIPELINE_NONE; i = m_Pipelines[i].nextWithSameHash) {
+        if (m_Pipelines[i].key == key)
+            return i;
+    }
+
+    return CACHED_PIPELINE_NONE;
+}
+
+uint32_t HelperPipelineCache::Add(Vector<uint64_t>& key, uint64_t hash) {
+    uint32_t index = (uint32_t)m_Pipelines.size();
+    if (!m_FreeIndices.empty()) {
+        index = m_FreeIndices.back();
+        m_FreeIndices.pop_back();
+    }
+
+    uint32_t nextWithSameHash = CACHED_PIPELINE_NONE;
+
+    auto it = m_PipelineIndices.find(hash);
+    if (it != m_PipelineIndices.end()) {
+        nextWithSameHash = it->second;
+        it->second = index;
+    } else
+        m_PipelineIndices.emplace(hash, index);
+
+    if (index == m_Pipelines.size())
+        m_Pipelines.push_back({std::move(key), nullptr, hash, nextWithSameHash, 0, Result::SUCCESS, true});
+    else {
+        CachedPipeline& cachedPipeline = m_Pipelines[index];
+        cachedPipeline.key.swap(key);
+        cachedPipeline.hash = hash;
+        cachedPipeline.nextWithSameHash = nextWithSameHash;
+        cachedPipeline.waiterNum = 0;
+        cachedPipeline.result = Result::SUCCESS;
+        cachedPipeline.isPending = true;
+    }
+
+    return index;
+}
+
+void HelperPipelineCache::RemoveFromHashChain(uint32_t index) {
+    const CachedPipeline& cachedPipeline = m_Pipelines[index];
+
+    auto it = m_PipelineIndices.find(cachedPipeline.hash);
+    if (it->second == index) {
+        if (cachedPipeline.nextWithSameHash == CACHED_PIPELINE_NONE)
+            m_PipelineIndices.erase(it);
+        else
+            it->second = cachedPipeline.nextWithSameHash;
+
+        return;
+    }
+
+    uint32_t i = it->second;
+    while (m_Pipelines[i].nextWithSameHash != index)
+        i = m_Pipelines[i].nextWithSameHash;
+
+    m_Pipelines[i].nextWithSameHash = cachedPipeline.nextWithSameHash;
+}
+
+void HelperPipelineCache::Release(uint32_t index) {
+    // The key memory is freed, an empty key never matches
+    CachedPipeline& cachedPipeline = m_Pipelines[index];
+    cachedPipeline.key.clear();
+    cachedPipeline.key.shrink_to_fit();
+    cachedPipeline.pipeline = nullptr;
+
+    m_FreeIndices.push_back(index);
+}
@@ -0,0 +1,67 @@
+// © 2021 NVIDIA Corporation
+
+#pragma once
+
+namespace nri {
+
+struct TransientPlacement {
+    uint64_t offset;
+    uint64_t size;
+    uint32_t alignment;
+    uint32_t memory;
+    MemoryType type;
+    bool isDedicated;
+};
+
+struct TransientMemory {
+    Memory* memory;
+    uint64_t size;
+    MemoryType type;
+};
+
+// Barriers of resources starting at "pass"
+struct TransientBarrierRange {
+    uint32_t pass;
+    uint32_t bufferOffset;
+    uint32_t bufferNum;
+    uint32_t textureOffset;
+    uint32_t textureNum;
+};
+
+// Lifetime-based aliasing: resources are placed into one memory per memory type, bytes are shared only by resources with disjoint pass ranges
+struct HelperTransientPool {
+    HelperTransientPool(const CoreInterface& NRI, Device& device);
+    ~HelperTransientPool();
+
+    inline Device& GetDevice() {
+        return m_Device;
+    }
+
+    inline const TransientPoolStats& GetStats() const {
+        return m_Stats;
+    }
+
+    Result Create(const TransientPoolDesc& transientPoolDesc);
+    void GetBarriers(uint32_t pass, BarrierGroupDesc& barrierGroupDesc) const;
+
+private:
+    void Solve(const Vector<uint32_t>& order, uint32_t begin, uint32_t end);
+    void GetRange(uint32_t i, bool isNeighborTexture, uint64_t& begin, uint64_t& end) const;
+    bool IsMemoryOverlapped(uint32_t i, uint32_t j) const;
+    Result AllocateAndBindMemory();
+    void FillBarriers();
+
+    const CoreInterface& m_NRI;
+    Device& m_Device;
+    Vector<TransientResourceDesc> m_Resources;
+    Vector<TransientPlacement> m_Placements;
+    Vector<TransientMemory> m_Memories;
+    Vector<BufferBarrierDesc> m_BufferBarriers;
+    Vector<TextureBarrierDesc> m_TextureBarriers;
+    Vector<TransientBarrierRange> m_BarrierRanges;
+    TransientPoolStats m_Stats = {};
+    uint64_t m_Granularity = 1;
+    MemoryLocation m_MemoryLocation = MemoryLocation::DEVICE;
+};
+
+} // namespace nri
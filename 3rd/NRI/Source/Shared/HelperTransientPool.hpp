@@ -0,0 +1,290 @@
+// © 2021 NVIDIA Corporation
+
+static inline bool IsLifetimeOverlapped(const TransientResourceDesc& a, const TransientResourceDesc& b) {
+    return a.firstPass <= b.lastPass && b.firstPass <= a.lastPass;
+}
+
+HelperTransientPool::HelperTransientPool(const CoreInterface& NRI, Device& device)
+    : m_NRI(NRI)
+    , m_Device(device)
+    , m_Resources(((DeviceBase&)device).GetStdAllocator())
+    , m_Placements(((DeviceBase&)device).GetStdAllocator())
+    , m_Memories(((DeviceBase&)device).GetStdAllocator())
+    , m_BufferBarriers(((DeviceBase&)device).GetStdAllocator())
+    , m_TextureBarriers(((DeviceBase&)device).GetStdAllocator())
+    , m_BarrierRanges(((DeviceBase&)device).GetStdAllocator()) {
+}
+
+HelperTransientPool::~HelperTransientPool() {
+    for (const TransientMemory& memory : m_Memories) {
+        if (memory.memory)
+            m_NRI.FreeMemory(*memory.memory);
+    }
+}
+
+Result HelperTransientPool::Create(const TransientPoolDesc& transientPoolDesc) {
+    m_MemoryLocation = transientPoolDesc.memoryLocation;
+
+    const DeviceDesc& deviceDesc = m_NRI.GetDeviceDesc(m_Device);
+    m_Granularity = std::max(deviceDesc.bufferTextureGranularity, 1u);
+
+    m_Resources.assign(transientPoolDesc.resources, transientPoolDesc.resources + transientPoolDesc.resourceNum);
+    m_Placements.resize(m_Resources.size());
+
+    for (size_t i = 0; i < m_Resources.size(); i++) {
+        const TransientResourceDesc& resource = m_Resources[i];
+
+        MemoryDesc memoryDesc = {};
+        if (resource.buffer)
+            m_NRI.GetBufferMemoryDesc(*resource.buffer, m_MemoryLocation, memoryDesc);
+        else
+            m_NRI.GetTextureMemoryDesc(*resource.texture, m_MemoryLocation, memoryDesc);
+
+        m_Placements[i] = {0, memoryDesc.size, memoryDesc.alignment, 0, memoryDesc.type, memoryDesc.mustBeDedicated};
+        m_Stats.unaliasedSize += memoryDesc.size;
+    }
+
+    { // The lower bound
+        Vector<std::pair<uint64_t, int64_t>> events(((DeviceBase&)m_Device).GetStdAllocator());
+        events.reserve(m_Resources.size() * 2);
+
+        for (size_t i = 0; i < m_Resources.size(); i++) {
+            events.push_back({m_Resources[i].firstPass, (int64_t)m_Placements[i].size});
+            events.push_back({(uint64_t)m_Resources[i].lastPass + 1, -(int64_t)m_Placements[i].size});
+        }
+
+        std::sort(events.begin(), events.end());
+
+        int64_t liveSize = 0;
+        for (size_t i = 0; i < events.size(); i++) {
+            liveSize += events[i].second;
+
+            if (i + 1 == events.size() || events[i + 1].first != events[i].first)
+                m_Stats.livePeakSize = std::max(m_Stats.livePeakSize, (uint64_t)liveSize);
+        }
+    }
+
+    // Sort by memory type (dedicated resources last), then by size and lifetime length (longest first)
+    Vector<uint32_t> order(m_Resources.size(), 0, ((DeviceBase&)m_Device).GetStdAllocator());
+    for (uint32_t i = 0; i < (uint32_t)order.size(); i++)
+        order[i] = i;
+
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        const TransientPlacement& pa = m_Placements[a];
+        const TransientPlacement& pb = m_Placements[b];
+
+        if (pa.type != pb.type)
+            return pa.type < pb.type;
+
+        if (pa.isDedicated != pb.isDedicated)
+            return pb.isDedicated;
+
+        if (pa.size != pb.size)
+            return pa.size > pb.size;
+
+        uint32_t lifetimeA = m_Resources[a].lastPass - m_Resources[a].firstPass;
+        uint32_t lifetimeB = m_Resources[b].lastPass - m_Resources[b].firstPass;
+        if (lifetimeA != lifetimeB)
+            return lifetimeA > lifetimeB;
+
+        return a < b;
+    });
+
+    for (uint32_t begin = 0; begin < (uint32_t)order.size();) {
+        const TransientPlacement& first = m_Placements[order[begin]];
+
+        uint32_t end = begin + 1;
+        while (end < (uint32_t)order.size() && m_Placements[order[end]].type == first.type && m_Placements[order[end]].isDedicated == first.isDedicated)
+            end++;
+
+        if (first.isDedicated) {
+            for (uint32_t i = begin; i < end; i++) {
+                TransientPlacement& placement = m_Placements[order[i]];
+                placement.memory = (uint32_t)m_Memories.size();
+
+                m_Memories.push_back({nullptr, placement.size, placement.type});
+            }
+        } else
+            Solve(order, begin, end);
+
+        begin = end;
+    }
+
+    Result result = AllocateAndBindMemory();
+    if (result != Result::SUCCESS)
+        return result;
+
+    FillBarriers();
+
+    m_Stats.memoryNum = (uint32_t)m_Memories.size();
+    for (const TransientMemory& memory : m_Memories)
+        m_Stats.memorySize += memory.size;
+
+    if (m_Stats.memorySize) {
+        REPORT_INFO((DeviceBase*)&m_Device, "Transient pool: %u resources in %u allocations, %llu bytes (%llu at least, %llu without aliasing)",
+            (uint32_t)m_Resources.size(), m_Stats.memoryNum, (unsigned long long)m_Stats.memorySize, (unsigned long long)m_Stats.livePeakSize, (unsigned long long)m_Stats.unaliasedSize);
+    }
+
+    return Result::SUCCESS;
+}
+
+void HelperTransientPool::GetBarriers(uint32_t pass, BarrierGroupDesc& barrierGroupDesc) const {
+    barrierGroupDesc = {};
+
+    auto it = std::lower_bound(m_BarrierRanges.begin(), m_BarrierRanges.end(), pass, [](const TransientBarrierRange& range, uint32_t pass) {
+        return range.pass < pass;
+    });
+
+    if (it == m_BarrierRanges.end() || it->pass != pass)
+        return;
+
+    barrierGroupDesc.buffers = m_BufferBarriers.data() + it->bufferOffset;
+    barrierGroupDesc.bufferNum = it->bufferNum;
+    barrierGroupDesc.textures = m_TextureBarriers.data() + it->textureOffset;
+    barrierGroupDesc.textureNum = it->textureNum;
+}
+
+void HelperTransientPool::Solve(const Vector<uint32_t>& order, uint32_t begin, uint32_t end) {
+    uint32_t memoryIndex = (uint32_t)m_Memories.size();
+    m_Memories.push_back({nullptr, 0, m_Placements[order[begin]].type});
+
+    TransientMemory& memory = m_Memories.back();
+    Vector<std::pair<uint64_t, uint64_t>> ranges(((DeviceBase&)m_Device).GetStdAllocator());
+
+    // First fit decreasing: the lowest offset not overlapping bytes of already placed resources alive at the same time
+    for (uint32_t i = begin; i < end; i++) {
+        uint32_t resource = order[i];
+        TransientPlacement& placement = m_Placements[resource];
+        bool isTexture = m_Resources[resource].texture != nullptr;
+
+        ranges.clear();
+        for (uint32_t j = begin; j < i; j++) {
+            uint32_t neighbor = order[j];
+            if (!IsLifetimeOverlapped(m_Resources[resource], m_Resources[neighbor]))
+                continue;
+
+            uint64_t rangeBegin = 0;
+            uint64_t rangeEnd = 0;
+            GetRange(neighbor, isTexture, rangeBegin, rangeEnd);
+
+            ranges.push_back({rangeBegin, rangeEnd});
+        }
+
+        std::sort(ranges.begin(), ranges.end());
+
+        uint64_t offset = 0;
+        for (const auto& range : ranges) {
+            if (offset + placement.size <= range.first)
+                break;
+
+            offset = std::max(offset, Align(range.second, placement.alignment));
+        }
+
+        placement.offset = offset;
+        placement.memory = memoryIndex;
+
+        memory.size = std::max(memory.size, offset + placement.size);
+    }
+}
+
+void HelperTransientPool::GetRange(uint32_t i, bool isNeighborTexture, uint64_t& begin, uint64_t& end) const {
+    const TransientPlacement& placement = m_Placements[i];
+    begin = placement.offset;
+    end = placement.offset + placement.size;
+
+    // Linear and non-linear resources don't share a granularity page
+    bool isTexture = m_Resources[i].texture != nullptr;
+    if (isTexture != isNeighborTexture) {
+        begin = begin / m_Granularity * m_Granularity;
+        end = Align(end, m_Granularity);
+    }
+}
+
+bool HelperTransientPool::IsMemoryOverlapped(uint32_t i, uint32_t j) const {
+    if (m_Placements[i].memory != m_Placements[j].memory)
+        return false;
+
+    uint64_t begin = 0;
+    uint64_t end = 0;
+    GetRange(j, m_Resources[i].texture != nullptr, begin, end);
+
+    return m_Placements[i].offset < end && begin < m_Placements[i].offset + m_Placements[i].size;
+}
+
+Result HelperTransientPool::AllocateAndBindMemory() {
+    for (TransientMemory& memory : m_Memories) {
+        AllocateMemoryDesc allocateMemoryDesc = {};
+        allocateMemoryDesc.size = memory.size;
+        allocateMemoryDesc.type = memory.type;
+
+        Result result = m_NRI.AllocateMemory(m_Device, allocateMemoryDesc, memory.memory);
+        if (result != Result::SUCCESS)
+            return result;
+    }
+
+    Vector<BufferMemoryBindingDesc> bufferBindingDescs(((DeviceBase&)m_Device).GetStdAllocator());
+    Vector<TextureMemoryBindingDesc> textureBindingDescs(((DeviceBase&)m_Device).GetStdAllocator());
+
+    for (size_t i = 0; i < m_Resources.size(); i++) {
+        const TransientResourceDesc& resource = m_Resources[i];
+        const TransientPlacement& placement = m_Placements[i];
+        Memory* memory = m_Memories[placement.memory].memory;
+
+        if (resource.buffer)
+            bufferBindingDescs.push_back({memory, resource.buffer, placement.offset});
+        else
+            textureBindingDescs.push_back({memory, resource.texture, placement.offset});
+    }
+
+    Result result = m_NRI.BindBufferMemory(m_Device, bufferBindingDescs.data(), (uint32_t)bufferBindingDescs.size());
+    if (result != Result::SUCCESS)
+        return result;
+
+    return m_NRI.BindTextureMemory(m_Device, textureBindingDescs.data(), (uint32_t)textureBindingDescs.size());
+}
+
+void HelperTransientPool::FillBarriers() {
+    Vector<uint32_t> order(m_Resources.size(), 0, ((DeviceBase&)m_Device).GetStdAllocator());
+    for (uint32_t i = 0; i < (uint32_t)order.size(); i++)
+        order[i] = i;
+
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return m_Resources[a].firstPass < m_Resources[b].firstPass;
+    });
+
+    for (uint32_t i : order) {
+        const TransientResourceDesc& resource = m_Resources[i];
+
+        // Wait for all previous users of the bytes, including ones from the previous frame
+        StageBits stages = StageBits::NONE;
+        for (uint32_t j = 0; j < (uint32_t)m_Resources.size(); j++) {
+            if (j != i && IsMemoryOverlapped(i, j))
+                stages |= m_Resources[j].lastUse.stages;
+        }
+
+        if (m_BarrierRanges.empty() || m_BarrierRanges.back().pass != resource.firstPass)
+            m_BarrierRanges.push_back({resource.firstPass, (uint32_t)m_BufferBarriers.size(), 0, (uint32_t)m_TextureBarriers.size(), 0});
+
+        TransientBarrierRange& range = m_BarrierRanges.back();
+        if (resource.buffer) {
+            BufferBarrierDesc barrier = {};
+            barrier.buffer = resource.buffer;
+            barrier.before = {AccessBits::UNKNOWN, stages};
+            barrier.after = {resource.firstUse.access, resource.firstUse.stages};
+
+            m_BufferBarriers.push_back(barrier);
+            range.bufferNum++;
+        } else {
+            TextureBarrierDesc barrier = {};
+            barrier.texture = resource.texture;
+            barrier.before = {AccessBits::UNKNOWN, Layout::UNKNOWN, stages};
+            barrier.after = resource.firstUse;
+            barrier.mipNum = REMAINING_MIPS;
+            barrier.layerNum = REMAINING_LAYERS;
+            barrier.planes = PlaneBits::ALL;
+
+            m_TextureBarriers.push_back(barrier);
+            range.textureNum++;
+        }
+    }
+}
@@ -5,6 +5,7 @@
 #include <atomic>
 
 constexpr size_t LOCK_CACHELINE_SIZE = 64;
+constexpr uint32_t LOCK_SPIN_MAX = 1024; // "pause"s with exponential backoff before parking the thread
 
 // Found in sse2neon
 #if (defined(__arm__) || defined(__aarch64__) || defined(_M_ARM64) || defined(_M_ARM))
@@ -19,27 +20,220 @@ inline void _mm_pause() {
 #    include <xmmintrin.h>
 #endif
 
-// Very lightweight exclusive lock
+// Sleeps while "atomic == value" ("std::atomic::wait" in C++20, otherwise futex on Linux, "WaitOnAddress" on Windows, yield elsewhere), can wake up spuriously
+void ParkThread(std::atomic_uint32_t& atomic, uint32_t value);
+void UnparkThreads(std::atomic_uint32_t& atomic, bool all);
+
+struct LockStats {
+    uint64_t acquisitionNum;
+    uint64_t sharedAcquisitionNum;    // included in "acquisitionNum"
+    uint64_t contendedAcquisitionNum; // the lock was not free at the first attempt
+    uint64_t spinNum;                 // "pause"s executed while waiting
+    uint64_t parkNum;                 // the thread was put to sleep
+};
+
+// Collected only if "NRI_ENABLE_LOCK_STATS" is set. Readers update them concurrently, so RMW is needed (only non-zero values are added)
+struct LockCounters {
+#if NRI_ENABLE_LOCK_STATS
+    inline void Add(bool isShared, uint32_t contendedAcquisitionNum, uint32_t spinNum, uint32_t parkNum) {
+        m_AcquisitionNum.fetch_add(1, std::memory_order_relaxed);
+
+        if (isShared)
+            m_SharedAcquisitionNum.fetch_add(1, std::memory_order_relaxed);
+        if (contendedAcquisitionNum)
+            m_ContendedAcquisitionNum.fetch_add(contendedAcquisitionNum, std::memory_order_relaxed);
+        if (spinNum)
+            m_SpinNum.fetch_add(spinNum, std::memory_order_relaxed);
+        if (parkNum)
+            m_ParkNum.fetch_add(parkNum, std::memory_order_relaxed);
+    }
+
+    inline LockStats Get() const {
+        return {m_AcquisitionNum.load(std::memory_order_relaxed), m_SharedAcquisitionNum.load(std::memory_order_relaxed), m_ContendedAcquisitionNum.load(std::memory_order_relaxed),
+            m_SpinNum.load(std::memory_order_relaxed), m_ParkNum.load(std::memory_order_relaxed)};
+    }
+
+private:
+    std::atomic_uint64_t m_AcquisitionNum = 0;
+    std::atomic_uint64_t m_SharedAcquisitionNum = 0;
+    std::atomic_uint64_t m_ContendedAcquisitionNum = 0;
+    std::atomic_uint64_t m_SpinNum = 0;
+    std::atomic_uint64_t m_ParkNum = 0;
+#else
+    inline void Add(bool, uint32_t, uint32_t, uint32_t) {
+    }
+
+    inline LockStats Get() const {
+        return {};
+    }
+#endif
+};
+
+// Lightweight exclusive lock: spins with exponential backoff, then parks the thread
 struct alignas(LOCK_CACHELINE_SIZE) Lock {
     inline Lock() {
-        m_Atomic.store(0, std::memory_order_relaxed);
+        m_State.store(UNLOCKED, std::memory_order_relaxed);
     }
 
     inline void Acquire() {
-        while (m_Atomic.exchange(1, std::memory_order_acquire))
-            _mm_pause();
+        uint32_t state = UNLOCKED;
+        if (m_State.compare_exchange_strong(state, LOCKED, std::memory_order_acquire, std::memory_order_relaxed))
+            m_Counters.Add(false, 0, 0, 0);
+        else
+            AcquireContended();
     }
 
     inline void Release() {
-        m_Atomic.store(0, std::memory_order_release);
+        if (m_State.exchange(UNLOCKED, std::memory_order_release) == LOCKED_WITH_WAITERS)
+            UnparkThreads(m_State, false);
+    }
+
+    inline LockStats GetStats() const {
+        return m_Counters.Get();
     }
 
 private:
-    std::atomic_uint32_t m_Atomic;
+    enum : uint32_t {
+        UNLOCKED,
+        LOCKED,
+        LOCKED_WITH_WAITERS,
+    };
+
+    inline void AcquireContended() {
+        uint32_t spinNum = 0;
+        for (uint32_t backoff = 1; spinNum < LOCK_SPIN_MAX; backoff <<= 1) {
+            for (uint32_t i = 0; i < backoff; i++)
+                _mm_pause();
+
+            spinNum += backoff;
+
+            uint32_t state = UNLOCKED;
+            if (m_State.load(std::memory_order_relaxed) == UNLOCKED && m_State.compare_exchange_strong(state, LOCKED, std::memory_order_acquire, std::memory_order_relaxed)) {
+                m_Counters.Add(false, 1, spinNum, 0);
+                return;
+            }
+        }
+
+        // Mark as "with waiters" to get an "unpark" on release (conservatively kept after wake up)
+        uint32_t parkNum = 0;
+        while (m_State.exchange(LOCKED_WITH_WAITERS, std::memory_order_acquire) != UNLOCKED) {
+            ParkThread(m_State, LOCKED_WITH_WAITERS);
+            parkNum++;
+        }
+
+        m_Counters.Add(false, 1, spinNum, parkNum);
+    }
+
+    std::atomic_uint32_t m_State;
+    LockCounters m_Counters;
 };
 
+// Reader/writer lock with the same spin-then-park policy. Pending writers block new readers
+struct alignas(LOCK_CACHELINE_SIZE) RwLock {
+    inline RwLock() {
+        m_State.store(0, std::memory_order_relaxed);
+        m_WaiterNum.store(0, std::memory_order_relaxed);
+    }
+
+    inline void Acquire() {
+        uint32_t state = 0;
+        if (m_State.compare_exchange_strong(state, WRITER, std::memory_order_acquire, std::memory_order_relaxed))
+            m_Counters.Add(false, 0, 0, 0);
+        else
+            AcquireContended(false);
+    }
+
+    inline void Release() {
+        // Not "release": the "m_WaiterNum" load could be reordered before the state change and miss a parking waiter (see "AcquireContended")
+        m_State.fetch_and(~WRITER, std::memory_order_seq_cst);
+
+        if (m_WaiterNum.load(std::memory_order_seq_cst))
+            UnparkThreads(m_State, true);
+    }
+
+    inline void AcquireShared() {
+        uint32_t state = m_State.load(std::memory_order_relaxed);
+        if (!(state & (WRITER | WRITER_PENDING)) && m_State.compare_exchange_strong(state, state + 1, std::memory_order_acquire, std::memory_order_relaxed))
+            m_Counters.Add(true, 0, 0, 0);
+        else
+            AcquireContended(true);
+    }
+
+    inline void ReleaseShared() {
+        uint32_t state = m_State.fetch_sub(1, std::memory_order_seq_cst) - 1;
+
+        if (!(state & READER_MASK) && m_WaiterNum.load(std::memory_order_seq_cst))
+            UnparkThreads(m_State, true);
+    }
+
+    inline LockStats GetStats() const {
+        return m_Counters.Get();
+    }
+
+private:
+    enum : uint32_t {
+        WRITER = 1u << 31,
+        WRITER_PENDING = 1u << 30,
+        READER_MASK = WRITER_PENDING - 1,
+    };
+
+    inline bool TryAcquire(bool isShared, uint32_t& state) {
+        state = m_State.load(std::memory_order_relaxed);
+
+        if (isShared)
+            return !(state & (WRITER | WRITER_PENDING)) && m_State.compare_exchange_weak(state, state + 1, std::memory_order_acquire, std::memory_order_relaxed);
+
+        if (state & (WRITER | READER_MASK)) {
+            if (!(state & WRITER_PENDING))
+                state = m_State.fetch_or(WRITER_PENDING, std::memory_order_relaxed) | WRITER_PENDING;
+
+            return false;
+        }
+
+        // Clears "WRITER_PENDING", other pending writers set it again
+        return m_State.compare_exchange_weak(state, WRITER, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    inline void AcquireContended(bool isShared) {
+        uint32_t state = 0;
+        uint32_t spinNum = 0;
+        for (uint32_t backoff = 1; spinNum < LOCK_SPIN_MAX; backoff <<= 1) {
+            for (uint32_t i = 0; i < backoff; i++)
+                _mm_pause();
+
+            spinNum += backoff;
+
+            if (TryAcquire(isShared, state)) {
+                m_Counters.Add(isShared, 1, spinNum, 0);
+                return;
+            }
+        }
+
+        uint32_t parkNum = 0;
+        while (!TryAcquire(isShared, state)) {
+            // Store-buffer handshake with releases: both sides change their variable, then read the other one, all "seq_cst". So either
+            // this load sees the released state or the release sees "m_WaiterNum != 0" and unparks
+            m_WaiterNum.fetch_add(1, std::memory_order_seq_cst);
+
+            uint32_t current = m_State.load(std::memory_order_seq_cst);
+            if (current == state)
+                ParkThread(m_State, state);
+
+            m_WaiterNum.fetch_sub(1, std::memory_order_relaxed);
+            parkNum++;
+        }
+
+        m_Counters.Add(isShared, 1, spinNum, parkNum);
+    }
+
+    std::atomic_uint32_t m_State;
+    std::atomic_uint32_t m_WaiterNum;
+    LockCounters m_Counters;
+};
+
+template <typename LockT>
 struct ExclusiveScope {
-    inline ExclusiveScope(Lock& lock)
+    inline ExclusiveScope(LockT& lock)
         : m_Lock(lock) {
         m_Lock.Acquire();
     }
@@ -49,5 +243,19 @@ struct ExclusiveScope {
     }
 
 private:
-    Lock& m_Lock;
+    LockT& m_Lock;
+};
+
+struct SharedScope {
+    inline SharedScope(RwLock& lock)
+        : m_Lock(lock) {
+        m_Lock.AcquireShared();
+    }
+
+    inline ~SharedScope() {
+        m_Lock.ReleaseShared();
+    }
+
+private:
+    RwLock& m_Lock;
 };
@@ -0,0 +1,56 @@
+// © 2021 NVIDIA Corporation
+
+#if defined(__cpp_lib_atomic_wait)
+
+// C++20: the standard library picks the best primitive (futex, "WaitOnAddress", ...)
+void ParkThread(std::atomic_uint32_t& atomic, uint32_t value) {
+    atomic.wait(value, std::memory_order_relaxed);
+}
+
+void UnparkThreads(std::atomic_uint32_t& atomic, bool all) {
+    if (all)
+        atomic.notify_all();
+    else
+        atomic.notify_one();
+}
+
+#elif defined(_WIN32)
+
+void ParkThread(std::atomic_uint32_t& atomic, uint32_t value) {
+    WaitOnAddress(&atomic, &value, sizeof(value), INFINITE);
+}
+
+void UnparkThreads(std::atomic_uint32_t& atomic, bool all) {
+    if (all)
+        WakeByAddressAll(&atomic);
+    else
+        WakeByAddressSingle(&atomic);
+}
+
+#elif defined(__linux__)
+#    include <linux/futex.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+
+static_assert(sizeof(std::atomic_uint32_t) == sizeof(uint32_t), "Futex expects a plain 32-bit word");
+
+void ParkThread(std::atomic_uint32_t& atomic, uint32_t value) {
+    syscall(SYS_futex, &atomic, FUTEX_WAIT_PRIVATE, value, nullptr, nullptr, 0);
+}
+
+void UnparkThreads(std::atomic_uint32_t& atomic, bool all) {
+    syscall(SYS_futex, &atomic, FUTEX_WAKE_PRIVATE, all ? INT32_MAX : 1, nullptr, nullptr, 0);
+}
+
+#else
+#    include <thread>
+
+void ParkThread(std::atomic_uint32_t& atomic, uint32_t value) {
+    if (atomic.load(std::memory_order_relaxed) == value)
+        std::this_thread::yield();
+}
+
+void UnparkThreads(std::atomic_uint32_t&, bool) {
+}
+
+#endif
@@ -0,0 +1,121 @@
+// © 2021 NVIDIA Corporation
+
+#pragma once
+
+constexpr size_t OBJECT_POOL_SLAB_SIZE = 64 * 1024;
+constexpr size_t OBJECT_POOL_GRANULARITY = LOCK_CACHELINE_SIZE; // objects never share a cache line
+constexpr uint32_t OBJECT_POOL_SIZE_CLASS_NUM = 16;            // up to 1 KB, bigger objects go to the allocator
+constexpr uint32_t OBJECT_POOL_BATCH_SIZE = 32;                // blocks moved between a thread cache and the pool at once
+
+struct ObjectPoolBlock {
+    ObjectPoolBlock* next;
+};
+
+// Placed at the beginning of a slab, which is aligned to its size. Blocks of a slab have the same size class
+struct alignas(OBJECT_POOL_GRANULARITY) ObjectPoolSlab {
+    ObjectPoolSlab* next;
+    void* memory; // "nullptr" if the allocator respected the alignment, otherwise an over-allocated memory
+    uint32_t sizeClass;
+};
+
+// Insert-only hash set of slab addresses, "0" marks an empty entry. Lookups don't lock, a table with a load factor above 1/2
+// is replaced by a 2x bigger copy (replaced tables are released with the pool, since lookups may still use them)
+struct ObjectPoolSlabTable {
+    ObjectPoolSlabTable* prev;
+    std::atomic<uintptr_t>* slabs; // placed after the header
+    size_t mask;
+};
+
+struct ObjectPoolSizeClass {
+    Lock lock;
+    ObjectPoolBlock* blocks;
+    ObjectPoolSlab* slabs;
+};
+
+struct ObjectPoolThreadCache {
+    std::array<ObjectPoolBlock*, OBJECT_POOL_SIZE_CLASS_NUM> blocks;
+    std::array<uint32_t, OBJECT_POOL_SIZE_CLASS_NUM> blockNums;
+    std::thread::id thread;
+    ObjectPoolThreadCache* next;
+};
+
+// Slab allocator for objects: size classes are multiples of a cache line, blocks are cached per thread.
+// Freed blocks go to the cache of the calling thread. Slabs and caches are released with the pool
+class ObjectPool {
+public:
+    ObjectPool(const AllocationCallbacks& allocationCallbacks, uint64_t id);
+    ~ObjectPool();
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    static constexpr bool IsPooled(size_t size, size_t alignment) {
+        return size <= OBJECT_POOL_GRANULARITY * OBJECT_POOL_SIZE_CLASS_NUM && alignment <= OBJECT_POOL_GRANULARITY;
+    }
+
+    inline const AllocationCallbacks& GetAllocationCallbacks() const {
+        return m_AllocationCallbacks;
+    }
+
+    // Memory of the pool is recognized by its slab, regardless of the type used to allocate or destroy an object
+    bool Owns(const void* memory) const;
+
+    inline void* Allocate(size_t size) {
+        uint32_t sizeClass = (uint32_t)((size - 1) / OBJECT_POOL_GRANULARITY);
+        ObjectPoolThreadCache& cache = GetThreadCache();
+
+        ObjectPoolBlock* block = cache.blocks[sizeClass];
+        if (!block) {
+            block = Refill(cache, sizeClass);
+            if (!block)
+                return nullptr;
+        }
+
+        cache.blocks[sizeClass] = block->next;
+        cache.blockNums[sizeClass]--;
+
+        return block;
+    }
+
+    inline void Free(void* memory) {
+        const ObjectPoolSlab* slab = (ObjectPoolSlab*)((uintptr_t)memory & ~(uintptr_t)(OBJECT_POOL_SLAB_SIZE - 1));
+        uint32_t sizeClass = slab->sizeClass;
+        ObjectPoolThreadCache& cache = GetThreadCache();
+
+        ObjectPoolBlock* block = (ObjectPoolBlock*)memory;
+        block->next = cache.blocks[sizeClass];
+
+        cache.blocks[sizeClass] = block;
+        if (++cache.blockNums[sizeClass] > OBJECT_POOL_BATCH_SIZE * 2)
+            Flush(cache, sizeClass);
+    }
+
+private:
+    inline ObjectPoolThreadCache& GetThreadCache() {
+        static thread_local ThreadCacheEntries<ObjectPoolThreadCache> t_Caches = {};
+
+        ThreadCacheEntries<ObjectPoolThreadCache>& caches = t_Caches;
+        ObjectPoolThreadCache* cache = caches.Find(m_Id);
+        if (!cache) {
+            cache = &AcquireThreadCache();
+            caches.Add(m_Id, cache);
+        }
+
+        return *cache;
+    }
+
+    ObjectPoolThreadCache& AcquireThreadCache();
+    ObjectPoolBlock* Refill(ObjectPoolThreadCache& cache, uint32_t sizeClass);
+    void Flush(ObjectPoolThreadCache& cache, uint32_t sizeClass);
+    bool AllocateSlab(ObjectPoolSizeClass& sizeClass, uint32_t sizeClassIndex);
+    bool AddToSlabTable(uintptr_t slab);
+
+    std::array<ObjectPoolSizeClass, OBJECT_POOL_SIZE_CLASS_NUM> m_SizeClasses = {};
+    const AllocationCallbacks& m_AllocationCallbacks;
+    std::atomic<ObjectPoolSlabTable*> m_SlabTable = nullptr;
+    Lock m_SlabTableLock; // writers
+    size_t m_SlabNum = 0;
+    uint64_t m_Id = 0;
+    Lock m_ThreadCacheLock;
+    ObjectPoolThreadCache* m_ThreadCaches = nullptr;
+};
@@ -0,0 +1,195 @@
+// © 2021 NVIDIA Corporation
+
+ObjectPool::ObjectPool(const AllocationCallbacks& allocationCallbacks, uint64_t id)
+    : m_AllocationCallbacks(allocationCallbacks)
+    , m_Id(id) {
+}
+
+ObjectPool::~ObjectPool() {
+    for (ObjectPoolSizeClass& sizeClass : m_SizeClasses) {
+        while (sizeClass.slabs) {
+            ObjectPoolSlab* next = sizeClass.slabs->next;
+            void* memory = sizeClass.slabs->memory ? sizeClass.slabs->memory : sizeClass.slabs;
+            m_AllocationCallbacks.Free(m_AllocationCallbacks.userArg, memory);
+            sizeClass.slabs = next;
+        }
+    }
+
+    while (m_ThreadCaches) {
+        ObjectPoolThreadCache* next = m_ThreadCaches->next;
+        Destroy(m_AllocationCallbacks, m_ThreadCaches);
+        m_ThreadCaches = next;
+    }
+
+    ObjectPoolSlabTable* slabTable = m_SlabTable.load(std::memory_order_relaxed);
+    while (slabTable) {
+        ObjectPoolSlabTable* prev = slabTable->prev;
+        m_AllocationCallbacks.Free(m_AllocationCallbacks.userArg, slabTable);
+        slabTable = prev;
+    }
+}
+
+static inline size_t GetSlabHash(uintptr_t slab) {
+    return (size_t)((uint64_t)(slab / OBJECT_POOL_SLAB_SIZE) * 0x9E3779B97F4A7C15ull);
+}
+
+static void InsertSlab(ObjectPoolSlabTable& slabTable, uintptr_t slab) {
+    size_t i = GetSlabHash(slab) & slabTable.mask;
+    while (slabTable.slabs[i].load(std::memory_order_relaxed))
+        i = (i + 1) & slabTable.mask;
+
+    slabTable.slabs[i].store(slab, std::memory_order_relaxed);
+}
+
+bool ObjectPool::Owns(const void* memory) const {
+    // A slab spans "OBJECT_POOL_SLAB_SIZE" bytes from its aligned address, other allocations can't overlap it. The slab of a live object
+    // has been added before the object was handed out, so the lookup sees it
+    uintptr_t slab = (uintptr_t)memory & ~(uintptr_t)(OBJECT_POOL_SLAB_SIZE - 1);
+
+    const ObjectPoolSlabTable* slabTable = m_SlabTable.load(std::memory_order_acquire);
+    if (!slabTable)
+        return false;
+
+    for (size_t i = GetSlabHash(slab) & slabTable->mask;; i = (i + 1) & slabTable->mask) {
+        uintptr_t entry = slabTable->slabs[i].load(std::memory_order_relaxed);
+        if (entry == slab)
+            return true;
+        if (!entry)
+            return false;
+    }
+}
+
+ObjectPoolThreadCache& ObjectPool::AcquireThreadCache() {
+    ExclusiveScope lock(m_ThreadCacheLock);
+
+    std::thread::id thread = std::this_thread::get_id();
+    for (ObjectPoolThreadCache* cache = m_ThreadCaches; cache; cache = cache->next) {
+        if (cache->thread == thread)
+            return *cache;
+    }
+
+    // Blocks of finished threads stay in their caches (up to "2 * OBJECT_POOL_BATCH_SIZE" per size class)
+    ObjectPoolThreadCache* cache = ::Allocate<ObjectPoolThreadCache>(m_AllocationCallbacks, ObjectPoolThreadCache{{}, {}, thread, m_ThreadCaches});
+    m_ThreadCaches = cache;
+
+    return *cache;
+}
+
+ObjectPoolBlock* ObjectPool::Refill(ObjectPoolThreadCache& cache, uint32_t sizeClassIndex) {
+    ObjectPoolSizeClass& sizeClass = m_SizeClasses[sizeClassIndex];
+    ExclusiveScope lock(sizeClass.lock);
+
+    if (!sizeClass.blocks && !AllocateSlab(sizeClass, sizeClassIndex))
+        return nullptr;
+
+    ObjectPoolBlock* first = sizeClass.blocks;
+    ObjectPoolBlock* last = first;
+
+    uint32_t blockNum = 1;
+    while (blockNum < OBJECT_POOL_BATCH_SIZE && last->next) {
+        last = last->next;
+        blockNum++;
+    }
+
+    sizeClass.blocks = last->next;
+    last->next = nullptr;
+
+    cache.blocks[sizeClassIndex] = first;
+    cache.blockNums[sizeClassIndex] = blockNum;
+
+    return first;
+}
+
+void ObjectPool::Flush(ObjectPoolThreadCache& cache, uint32_t sizeClassIndex) {
+    ObjectPoolBlock* first = cache.blocks[sizeClassIndex];
+    ObjectPoolBlock* last = first;
+
+    for (uint32_t i = 1; i < OBJECT_POOL_BATCH_SIZE; i++)
+        last = last->next;
+
+    cache.blocks[sizeClassIndex] = last->next;
+    cache.blockNums[sizeClassIndex] -= OBJECT_POOL_BATCH_SIZE;
+
+    ObjectPoolSizeClass& sizeClass = m_SizeClasses[sizeClassIndex];
+    ExclusiveScope lock(sizeClass.lock);
+
+    last->next = sizeClass.blocks;
+    sizeClass.blocks = first;
+}
+
+bool ObjectPool::AllocateSlab(ObjectPoolSizeClass& sizeClass, uint32_t sizeClassIndex) {
+    uint8_t* base = (uint8_t*)m_AllocationCallbacks.Allocate(m_AllocationCallbacks.userArg, OBJECT_POOL_SLAB_SIZE, OBJECT_POOL_SLAB_SIZE);
+    if (!base)
+        return false;
+
+    // The slab header is found by aligning a block address down, over-allocate if the allocator ignores big alignments
+    void* memory = nullptr;
+    if ((uintptr_t)base & (OBJECT_POOL_SLAB_SIZE - 1)) {
+        m_AllocationCallbacks.Free(m_AllocationCallbacks.userArg, base);
+
+        memory = m_AllocationCallbacks.Allocate(m_AllocationCallbacks.userArg, OBJECT_POOL_SLAB_SIZE * 2, OBJECT_POOL_GRANULARITY);
+        if (!memory)
+            return false;
+
+        base = Align((uint8_t*)memory, OBJECT_POOL_SLAB_SIZE);
+    }
+
+    if (!AddToSlabTable((uintptr_t)base)) {
+        m_AllocationCallbacks.Free(m_AllocationCallbacks.userArg, memory ? memory : base);
+        return false;
+    }
+
+    ObjectPoolSlab* slab = (ObjectPoolSlab*)base;
+    slab->next = sizeClass.slabs;
+    slab->memory = memory;
+    slab->sizeClass = sizeClassIndex;
+    sizeClass.slabs = slab;
+
+    // Blocks in address order
+    size_t blockSize = (sizeClassIndex + 1) * OBJECT_POOL_GRANULARITY;
+    uint8_t* end = base + OBJECT_POOL_SLAB_SIZE;
+
+    ObjectPoolBlock** tail = &sizeClass.blocks;
+    for (uint8_t* block = base + sizeof(ObjectPoolSlab); block + blockSize <= end; block += blockSize) {
+        *tail = (ObjectPoolBlock*)block;
+        tail = &(*tail)->next;
+    }
+    *tail = nullptr;
+
+    return true;
+}
+
+bool ObjectPool::AddToSlabTable(uintptr_t slab) {
+    ExclusiveScope lock(m_SlabTableLock);
+
+    ObjectPoolSlabTable* slabTable = m_SlabTable.load(std::memory_order_relaxed);
+    if (!slabTable || (m_SlabNum + 1) * 2 > slabTable->mask + 1) {
+        size_t capacity = slabTable ? (slabTable->mask + 1) * 2 : 64;
+
+        ObjectPoolSlabTable* newSlabTable = (ObjectPoolSlabTable*)m_AllocationCallbacks.Allocate(m_AllocationCallbacks.userArg,
+            sizeof(ObjectPoolSlabTable) + capacity * sizeof(std::atomic<uintptr_t>), alignof(ObjectPoolSlabTable));
+        if (!newSlabTable)
+            return false;
+
+        newSlabTable->prev = slabTable;
+        newSlabTable->slabs = (std::atomic<uintptr_t>*)(newSlabTable + 1);
+        newSlabTable->mask = capacity - 1;
+        Construct(newSlabTable->slabs, capacity, 0);
+
+        if (slabTable) {
+            for (size_t i = 0; i <= slabTable->mask; i++) {
+                uintptr_t entry = slabTable->slabs[i].load(std::memory_order_relaxed);
+                if (entry)
+                    InsertSlab(*newSlabTable, entry);
+            }
+        }
+
+        m_SlabTable.store(newSlabTable, std::memory_order_release);
+        slabTable = newSlabTable;
+    }
+
+    InsertSlab(*slabTable, slab);
+    m_SlabNum++;
+
+    return true;
+}
@@ -7,19 +7,36 @@
 
 #include "SharedExternal.h"
 
+#include "HelperBindlessTable.h"
 #include "HelperDataUpload.h"
+#include "HelperDefragmenter.h"
+#include "HelperDescriptorSetCache.h"
 #include "HelperDeviceMemoryAllocator.h"
+#include "HelperMemoryBudget.h"
+#include "HelperMemorySubAllocator.h"
+#include "HelperPipelineCache.h"
+#include "HelperTransientPool.h"
 #include "HelperWaitIdle.h"
 #include "Streamer.h"
 #include "Upscaler.h"
 
 using namespace nri;
 
+#include "HelperBindlessTable.hpp"
 #include "HelperDataUpload.hpp"
+#include "HelperDefragmenter.hpp"
+#include "HelperDescriptorSetCache.hpp"
 #include "HelperDeviceMemoryAllocator.hpp"
+#include "HelperMemoryBudget.hpp"
+#include "HelperMemorySubAllocator.hpp"
+#include "HelperPipelineCache.hpp"
+#include "HelperTransientPool.hpp"
 #include "HelperWaitIdle.hpp"
 #include "Streamer.hpp"
 #include "Upscaler.hpp"
 
+#include "DescriptorSlotAllocator.hpp"
+#include "Lock.hpp"
+#include "ObjectPool.hpp"
 #include "SharedExternal.hpp"
 #include "SharedLibrary.hpp"
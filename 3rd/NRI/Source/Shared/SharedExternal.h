@@ -6,6 +6,7 @@
 #include <cassert>
 #include <cstring>
 #include <map>
+#include <thread>
 
 #if (NRI_ENABLE_D3D11_SUPPORT || NRI_ENABLE_D3D12_SUPPORT)
 #    include <dxgi1_6.h>
@@ -42,6 +43,10 @@ constexpr void MaybeUnused([[maybe_unused]] const Args&... args) {
 typedef nri::AllocationCallbacks AllocationCallbacks;
 #include "StdAllocator.h"
 
+#include "ThreadCache.h"
+#include "ObjectPool.h"
+#include "DescriptorSlotAllocator.h"
+
 // Base classes
 #include "DeviceBase.h"
 
@@ -87,6 +92,38 @@ inline T* Allocate(const AllocationCallbacks& allocationCallbacks, Args&&... arg
     return object;
 }
 
+// Objects from a pool must be destroyed via the pool
+template <typename T, typename... Args>
+inline T* Allocate(ObjectPool& objectPool, Args&&... args) {
+    T* object = nullptr;
+    if constexpr (ObjectPool::IsPooled(sizeof(T), alignof(T)))
+        object = (T*)objectPool.Allocate(sizeof(T));
+    else {
+        const AllocationCallbacks& allocationCallbacks = objectPool.GetAllocationCallbacks();
+        object = (T*)allocationCallbacks.Allocate(allocationCallbacks.userArg, sizeof(T), alignof(T));
+    }
+
+    if (object)
+        new (object) T(std::forward<Args>(args)...);
+
+    return object;
+}
+
+// The allocation decides where memory goes, "T" can be a base of the allocated type (with a virtual destructor)
+template <typename T>
+inline void Destroy(ObjectPool& objectPool, T* object) {
+    if (object) {
+        object->~T();
+
+        if (objectPool.Owns(object))
+            objectPool.Free(object);
+        else {
+            const AllocationCallbacks& allocationCallbacks = objectPool.GetAllocationCallbacks();
+            allocationCallbacks.Free(allocationCallbacks.userArg, object);
+        }
+    }
+}
+
 template <typename T>
 inline void Destroy(const AllocationCallbacks& allocationCallbacks, T* object) {
     if (object) {
@@ -852,6 +852,82 @@ void nri::DeviceBase::ReportMessage(nri::Message messageType, const char* file,
         m_CallbackInterface.AbortExecution(m_CallbackInterface.userArg);
 }
 
+nri::DeviceBase::~DeviceBase() {
+    while (m_ScratchArenaSlots) {
+        ScratchArenaSlot* next = m_ScratchArenaSlots->next;
+        ReleaseThreadToken(m_ScratchArenaSlots->threadToken);
+        Destroy(m_AllocationCallbacks, m_ScratchArenaSlots);
+        m_ScratchArenaSlots = next;
+    }
+}
+
+struct ThreadTokenHolder {
+    ~ThreadTokenHolder() {
+        if (threadToken) {
+            threadToken->isAlive.store(false, std::memory_order_release);
+            ReleaseThreadToken(threadToken);
+        }
+    }
+
+    ThreadToken* threadToken = nullptr;
+};
+
+ThreadToken* AcquireThreadToken() {
+    static thread_local ThreadTokenHolder t_Holder;
+
+    if (!t_Holder.threadToken) {
+        t_Holder.threadToken = new (std::nothrow) ThreadToken{{1}, {true}};
+        if (!t_Holder.threadToken)
+            return nullptr;
+    }
+
+    t_Holder.threadToken->refNum.fetch_add(1, std::memory_order_relaxed);
+
+    return t_Holder.threadToken;
+}
+
+void ReleaseThreadToken(ThreadToken* threadToken) {
+    if (threadToken->refNum.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        delete threadToken;
+}
+
+uint64_t nri::DeviceBase::GenerateId() {
+    static std::atomic_uint64_t idNum = 0;
+
+    return idNum.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+ScratchArena& nri::DeviceBase::AcquireScratchArena() const {
+    ThreadToken* threadToken = AcquireThreadToken();
+
+    ExclusiveScope lock(m_ScratchArenaLock);
+
+    // Evicted from "thread_local" entries
+    ScratchArenaSlot* abandonedSlot = nullptr;
+    for (ScratchArenaSlot* slot = m_ScratchArenaSlots; slot; slot = slot->next) {
+        if (slot->threadToken == threadToken) {
+            ReleaseThreadToken(threadToken);
+            return slot->arena;
+        }
+
+        if (!abandonedSlot && !slot->threadToken->isAlive.load(std::memory_order_acquire))
+            abandonedSlot = slot;
+    }
+
+    // Adopt the arena of a finished thread (all its scopes are closed)
+    if (abandonedSlot) {
+        ReleaseThreadToken(abandonedSlot->threadToken);
+        abandonedSlot->threadToken = threadToken;
+
+        return abandonedSlot->arena;
+    }
+
+    ScratchArenaSlot* slot = Allocate<ScratchArenaSlot>(m_AllocationCallbacks, m_AllocationCallbacks, threadToken, m_ScratchArenaSlots);
+    m_ScratchArenaSlots = slot;
+
+    return slot->arena;
+}
+
 void ConvertCharToWchar(const char* in, wchar_t* out, size_t outLength) {
     if (outLength == 0)
         return;
@@ -144,7 +144,7 @@ private:
 
 template <typename T>
 bool operator==(const StdAllocator<T>& left, const StdAllocator<T>& right) {
-    return left.GetInterface() == right.GetInterface();
+    return &left.GetInterface() == &right.GetInterface();
 }
 
 template <typename T>
@@ -165,20 +165,123 @@ using String = std::basic_string<char, std::char_traits<char>, StdAllocator<char
 //================================================================================================================
 
 constexpr size_t MAX_STACK_ALLOC_SIZE = 32 * 1024;
+constexpr size_t MAX_STACK_SCRATCH_SIZE = 4 * 1024; // nested calls (validation => implementation) add up
+constexpr size_t SCRATCH_CHUNK_SIZE = 64 * 1024;
+constexpr size_t SCRATCH_CHUNK_ALIGNMENT = 16;
+
+struct alignas(SCRATCH_CHUNK_ALIGNMENT) ScratchChunk {
+    ScratchChunk* next;
+    size_t size;
+};
+
+struct ScratchMarker {
+    ScratchChunk* chunk;
+    size_t offset;
+};
+
+// Per-thread bump allocator serving "Scratch". Memory is returned in LIFO order (scopes), chunks are retained for reuse
+class ScratchArena {
+public:
+    ScratchArena(const AllocationCallbacks& allocator)
+        : m_Allocator(allocator) {
+    }
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    ~ScratchArena() {
+        while (m_Head) {
+            ScratchChunk* next = m_Head->next;
+            m_Allocator.Free(m_Allocator.userArg, m_Head);
+            m_Head = next;
+        }
+    }
+
+    inline void* Allocate(size_t size, size_t alignment, ScratchMarker& marker) {
+        marker = {m_Chunk, m_Offset};
+
+        if (m_Chunk) {
+            size_t offset = GetAlignedOffset(m_Chunk, m_Offset, alignment);
+            if (offset + size <= m_Chunk->size) {
+                m_Offset = offset + size;
+                return (uint8_t*)(m_Chunk + 1) + offset;
+            }
+        }
+
+        return AllocateSlow(size, alignment);
+    }
+
+    inline void Free(const ScratchMarker& marker) {
+        m_Chunk = marker.chunk;
+        m_Offset = marker.offset;
+    }
+
+    inline uint32_t GetChunkNum() const {
+        return m_ChunkNum;
+    }
+
+private:
+    static inline size_t GetAlignedOffset(const ScratchChunk* chunk, size_t offset, size_t alignment) {
+        uintptr_t base = (uintptr_t)(chunk + 1);
+
+        return (size_t)(((base + offset + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base);
+    }
+
+    void* AllocateSlow(size_t size, size_t alignment) {
+        size_t requiredSize = size + (alignment > SCRATCH_CHUNK_ALIGNMENT ? alignment : 0);
+
+        // The next retained chunk or a new one inserted in front of it
+        ScratchChunk* next = m_Chunk ? m_Chunk->next : m_Head;
+        if (!next || next->size < requiredSize) {
+            size_t chunkSize = requiredSize > SCRATCH_CHUNK_SIZE ? requiredSize : SCRATCH_CHUNK_SIZE;
+
+            ScratchChunk* chunk = (ScratchChunk*)m_Allocator.Allocate(m_Allocator.userArg, sizeof(ScratchChunk) + chunkSize, SCRATCH_CHUNK_ALIGNMENT);
+            if (!chunk)
+                return nullptr;
+
+            chunk->next = next;
+            chunk->size = chunkSize;
+
+            if (m_Chunk)
+                m_Chunk->next = chunk;
+            else
+                m_Head = chunk;
+
+            next = chunk;
+            m_ChunkNum++;
+        }
+
+        size_t offset = GetAlignedOffset(next, 0, alignment);
+
+        m_Chunk = next;
+        m_Offset = offset + size;
+
+        return (uint8_t*)(next + 1) + offset;
+    }
+
+    const AllocationCallbacks& m_Allocator;
+    ScratchChunk* m_Head = nullptr;
+    ScratchChunk* m_Chunk = nullptr; // current, "nullptr" if nothing is allocated
+    size_t m_Offset = 0;
+    uint32_t m_ChunkNum = 0;
+};
 
 template <typename T>
 class Scratch {
 public:
-    Scratch(const AllocationCallbacks& allocator, T* mem, size_t num)
-        : m_Allocator(allocator)
-        , m_Mem(mem)
+    template <typename DeviceT>
+    Scratch(const DeviceT& device, T* stackMem, size_t num)
+        : m_Mem(stackMem)
         , m_Num(num) {
-        m_IsHeap = (num * sizeof(T) + alignof(T)) > MAX_STACK_ALLOC_SIZE;
+        if (!m_Mem && num) {
+            m_Arena = &device.GetScratchArena();
+            m_Mem = (T*)m_Arena->Allocate(num * sizeof(T), alignof(T), m_Marker);
+        }
     }
 
     ~Scratch() {
-        if (m_IsHeap)
-            m_Allocator.Free(m_Allocator.userArg, m_Mem);
+        if (m_Arena)
+            m_Arena->Free(m_Marker);
     }
 
     inline operator T*() const {
@@ -191,15 +294,17 @@ public:
     }
 
 private:
-    const AllocationCallbacks& m_Allocator;
+    ScratchArena* m_Arena = nullptr;
+    ScratchMarker m_Marker = {};
     T* m_Mem = nullptr;
     size_t m_Num = 0;
-    bool m_IsHeap = false;
 };
 
+// Small scratches live on the stack, bigger ones in the per-thread arena of the device (no allocator traffic after warm up).
+// Must live in a scope, since arena memory is freed in reverse order
 #define AllocateScratch(device, T, elementNum) \
-    {(device).GetAllocationCallbacks(), \
-        ((elementNum) * sizeof(T) + alignof(T)) > MAX_STACK_ALLOC_SIZE \
-            ? (T*)(device).GetAllocationCallbacks().Allocate((device).GetAllocationCallbacks().userArg, (elementNum) * sizeof(T), alignof(T)) \
+    {(device), \
+        ((elementNum) * sizeof(T) + alignof(T)) > MAX_STACK_SCRATCH_SIZE \
+            ? nullptr \
             : (T*)Align((elementNum) ? (T*)alloca(((elementNum) * sizeof(T) + alignof(T))) : nullptr, alignof(T)), \
-        (elementNum)}
+        (size_t)(elementNum)}
@@ -2,33 +2,125 @@
 
 #pragma once
 
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#if !(defined(__arm__) || defined(__aarch64__) || defined(_M_ARM64) || defined(_M_ARM))
+#    include <emmintrin.h>
+#    define NRI_STREAMER_NON_TEMPORAL_COPY 1
+#endif
+
 namespace nri {
 
 struct BufferUpdateRequest {
     BufferUpdateRequestDesc desc;
     uint64_t offset;
+    uint8_t* stagingMemory; // owned copy of the data, if a reservation can't be served by the mapped dynamic buffer
+    uint64_t hash;          // content hash (0 - unknown)
 };
 
 struct TextureUpdateRequest {
     TextureUpdateRequestDesc desc;
     uint64_t offset;
+    uint32_t rowNum; // per slice, in blocks
+    uint32_t sliceNum;
+    uint32_t alignedRowPitch;
+    uint32_t alignedSlicePitch;
+};
+
+// A strided copy of "rowNum" rows ("CopyUpdateRequests" merges contiguous rows and slices into a single row)
+struct StreamerCopyJob {
+    uint8_t* dst;
+    const uint8_t* src;
+    uint64_t size; // per row
+    uint64_t dstRowPitch;
+    uint64_t srcRowPitch;
+    uint32_t rowNum;
+};
+
+// Big payloads are split into pieces of this size and spread across copy threads
+constexpr uint64_t STREAMER_COPY_JOB_MAX_SIZE = 256 * 1024;
+
+// Copy threads are not woken up for less data
+constexpr uint64_t STREAMER_PARALLEL_COPY_MIN_SIZE = 1024 * 1024;
+
+// Persistent worker threads executing copy jobs. The calling thread participates too
+struct StreamerCopyPool {
+    StreamerCopyPool(const StdAllocator<uint8_t>& stdAllocator, uint32_t threadNum);
+    ~StreamerCopyPool();
+
+    void Execute(const StreamerCopyJob* jobs, uint32_t jobNum);
+
+private:
+    void WorkerThread();
+    void ExecuteJobs(const StreamerCopyJob* jobs, uint32_t jobNum);
+
+    Vector<std::thread> m_Threads;
+    std::mutex m_Mutex;
+    std::condition_variable m_WorkerCondition;
+    std::condition_variable m_OwnerCondition;
+    const StreamerCopyJob* m_Jobs = nullptr; // protected by "m_Mutex"
+    uint32_t m_JobNum = 0;                   // protected by "m_Mutex"
+    uint32_t m_Generation = 0;               // protected by "m_Mutex"
+    uint32_t m_ActiveWorkerNum = 0;          // protected by "m_Mutex"
+    bool m_IsShuttingDown = false;           // protected by "m_Mutex"
+    std::atomic_uint32_t m_NextJob = 0;
+};
+
+// Producers are spread across locked lists (as many as hardware threads) to avoid contention, "CopyUpdateRequests" merges them
+struct StreamerRequestList {
+    inline StreamerRequestList(const StdAllocator<uint8_t>& stdAllocator)
+        : buffers(stdAllocator)
+        , textures(stdAllocator) {
+    }
+
+    Lock lock;
+    Vector<BufferUpdateRequest> buffers;
+    Vector<TextureUpdateRequest> textures;
 };
 
 struct GarbageInFlight {
     Buffer* buffer;
     Memory* memory;
+    uint64_t fenceValue;
     uint32_t frameNum;
 };
 
+// A destination range updated in a frame, used to skip updates with unchanged content
+struct StreamerUploadRecord {
+    const Buffer* dstBuffer;
+    uint64_t begin;
+    uint64_t end;
+    uint64_t hash;    // 0 - unknown
+    bool isExclusive; // not overlapped by other updates in the same frame
+};
+
+// A region of a ring buffer used by a frame, the ring tail moves forward once it's retired
+struct StreamerRingSegment {
+    uint64_t begin;
+    uint64_t end;
+    uint64_t fenceValue;
+    uint32_t frameNum;
+};
+
+// The frame, which used the segment, is not finished yet ("CopyUpdateRequests" stamps it)
+constexpr uint64_t STREAMER_OPEN_SEGMENT = uint64_t(-1);
+
 struct StreamerImpl : public DebugNameBase {
     inline StreamerImpl(Device& device, const CoreInterface& NRI)
         : m_Device(device)
         , m_NRI(NRI)
-        , m_BufferRequests(((DeviceBase&)device).GetStdAllocator())
         , m_BufferRequestsWithDst(((DeviceBase&)device).GetStdAllocator())
-        , m_TextureRequests(((DeviceBase&)device).GetStdAllocator())
         , m_TextureRequestsWithDst(((DeviceBase&)device).GetStdAllocator())
-        , m_GarbageInFlight(((DeviceBase&)device).GetStdAllocator()) {
+        , m_GarbageInFlight(((DeviceBase&)device).GetStdAllocator())
+        , m_RingSegments(((DeviceBase&)device).GetStdAllocator())
+        , m_ConstantRingSegments(((DeviceBase&)device).GetStdAllocator())
+        , m_FrameSizes(((DeviceBase&)device).GetStdAllocator())
+        , m_UploadRecords(((DeviceBase&)device).GetStdAllocator())
+        , m_PrevUploadRecords(((DeviceBase&)device).GetStdAllocator())
+        , m_CopyJobs(((DeviceBase&)device).GetStdAllocator()) {
     }
 
     inline Buffer* GetDynamicBuffer() {
@@ -47,8 +139,12 @@ struct StreamerImpl : public DebugNameBase {
 
     Result Create(const StreamerDesc& desc);
     uint32_t UpdateConstantBuffer(const void* data, uint32_t dataSize);
+    void UpdateConstantBuffers(const ConstantBufferUpdateRequestDesc* constantBufferUpdateRequestDescs, uint32_t constantBufferUpdateRequestDescNum, uint32_t* offsets);
     uint64_t AddBufferUpdateRequest(const BufferUpdateRequestDesc& bufferUpdateRequestDesc);
     uint64_t AddTextureUpdateRequest(const TextureUpdateRequestDesc& textureUpdateRequestDesc);
+    void* ReserveBufferUpdateRequest(const BufferUpdateRequestDesc& bufferUpdateRequestDesc, uint64_t& offset);
+    void SetFenceValue(uint64_t fenceValue);
+    void GetStats(StreamerStats& streamerStats) const;
     Result CopyUpdateRequests();
     void CmdUploadUpdateRequests(CommandBuffer& commandBuffer);
 
@@ -64,23 +160,49 @@ struct StreamerImpl : public DebugNameBase {
     }
 
 private:
+    void FreeStagingMemory(BufferUpdateRequest& request);
+    bool IsRetired(uint64_t fenceValue, uint32_t frameNum, uint64_t completedFenceValue) const;
+    void RetireRingSegments(Vector<StreamerRingSegment>& ringSegments, uint64_t completedFenceValue);
+    void AgeRingSegments(Vector<StreamerRingSegment>& ringSegments);
+    uint32_t AllocateConstants(uint32_t alignedSize);
+    uint64_t GetRingFreeRegionEnd(uint64_t offset) const;
+    Result CreateDynamicBuffer(uint64_t size);
+    void CoalesceBufferUploads();
+    void AddCopyJobs(uint8_t* dst, const uint8_t* src, uint64_t size, uint64_t dstRowPitch, uint64_t srcRowPitch, uint32_t rowNum);
+
     Device& m_Device;
     const CoreInterface& m_NRI;
     StreamerDesc m_Desc = {};
-    Vector<BufferUpdateRequest> m_BufferRequests;
+    StreamerStats m_Stats = {};
+    StreamerRequestList* m_RequestLists = nullptr;
+    uint32_t m_RequestListNum = 0;
     Vector<BufferUpdateRequest> m_BufferRequestsWithDst;
-    Vector<TextureUpdateRequest> m_TextureRequests;
     Vector<TextureUpdateRequest> m_TextureRequestsWithDst;
     Vector<GarbageInFlight> m_GarbageInFlight;
+    Vector<StreamerRingSegment> m_RingSegments;         // oldest first
+    Vector<StreamerRingSegment> m_ConstantRingSegments; // oldest first
+    Vector<uint64_t> m_FrameSizes;                      // sizes of the last "frameInFlightNum + 1" frames
+    Vector<StreamerUploadRecord> m_UploadRecords;       // sorted by destination
+    Vector<StreamerUploadRecord> m_PrevUploadRecords;   // sorted by destination
+    Vector<StreamerCopyJob> m_CopyJobs;
+    StreamerCopyPool* m_CopyPool = nullptr;
     Buffer* m_ConstantBuffer = nullptr;
     Memory* m_ConstantBufferMemory = nullptr;
+    uint8_t* m_ConstantBufferData = nullptr; // persistently mapped (if allowed)
     Buffer* m_DynamicBuffer = nullptr;
     Memory* m_DynamicBufferMemory = nullptr;
+    uint8_t* m_DynamicBufferData = nullptr; // persistently mapped (if allowed)
+    Lock m_ConstantLock;
     uint32_t m_ConstantDataOffset = 0;
-    uint64_t m_DynamicDataOffset = 0;
+    uint32_t m_ConstantFrameBegin = 0;
+    std::atomic_uint64_t m_DynamicDataOffset = 0;
     uint64_t m_DynamicDataOffsetBase = 0;
     uint64_t m_DynamicBufferSize = 0;
+    uint64_t m_DirectWriteLimit = 0;  // reservations below this offset can be written directly to "m_DynamicBufferData"
+    uint64_t m_PendingResizeSize = 0; // the dynamic buffer gets recreated with this size (if not 0) in the next "CopyUpdateRequests"
+    uint64_t m_FenceValue = 0;
     uint32_t m_FrameIndex = 0;
+    uint32_t m_CalmFrameNum = 0;
 };
 
 }
\ No newline at end of file
@@ -1,6 +1,206 @@
 // © 2024 NVIDIA Corporation
 
 constexpr uint64_t CHUNK_SIZE = 65536;
+constexpr uint64_t NON_TEMPORAL_COPY_MIN_SIZE = 16 * 1024;
+
+// Each producer thread sticks to its own request list (round-robin assignment on first use)
+static inline uint32_t GetProducerIndex() {
+    static std::atomic_uint32_t threadCounter = 0;
+    static thread_local uint32_t producerIndex = threadCounter.fetch_add(1, std::memory_order_relaxed);
+
+    return producerIndex;
+}
+
+// The dynamic buffer lives in write-combined memory: streaming stores don't pollute caches and don't read destination lines
+static inline void CopyToUploadHeap(uint8_t* dst, const uint8_t* src, uint64_t size) {
+#ifdef NRI_STREAMER_NON_TEMPORAL_COPY
+    if (size >= NON_TEMPORAL_COPY_MIN_SIZE) {
+        size_t headSize = Align((size_t)dst, 16) - (size_t)dst;
+        memcpy(dst, src, headSize);
+
+        dst += headSize;
+        src += headSize;
+        size -= headSize;
+
+        uint8_t* dstEnd = dst + (size & ~63ull);
+        for (; dst != dstEnd; dst += 64, src += 64) {
+            __m128i v0 = _mm_loadu_si128((const __m128i*)src + 0);
+            __m128i v1 = _mm_loadu_si128((const __m128i*)src + 1);
+            __m128i v2 = _mm_loadu_si128((const __m128i*)src + 2);
+            __m128i v3 = _mm_loadu_si128((const __m128i*)src + 3);
+
+            _mm_stream_si128((__m128i*)dst + 0, v0);
+            _mm_stream_si128((__m128i*)dst + 1, v1);
+            _mm_stream_si128((__m128i*)dst + 2, v2);
+            _mm_stream_si128((__m128i*)dst + 3, v3);
+        }
+
+        size &= 63;
+    }
+#endif
+
+    memcpy(dst, src, (size_t)size);
+}
+
+// Streaming stores are weakly ordered, must be called by each copying thread when done
+static inline void FinishCopyToUploadHeap() {
+#ifdef NRI_STREAMER_NON_TEMPORAL_COPY
+    _mm_sfence();
+#endif
+}
+
+// A fast 64-bit content hash (4 independent lanes to hide multiplication latency)
+static inline uint64_t HashUpdateData(const uint8_t* data, uint64_t size) {
+    constexpr uint64_t K0 = 0x9E3779B97F4A7C15ull;
+    constexpr uint64_t K1 = 0xC2B2AE3D27D4EB4Full;
+
+    uint64_t lanes[4] = {K0, K1, ~K0, ~K1};
+    uint64_t words[4];
+
+    const uint8_t* end = data + (size & ~31ull);
+    for (; data != end; data += 32) {
+        memcpy(words, data, sizeof(words));
+
+        for (uint32_t i = 0; i < 4; i++) {
+            uint64_t lane = lanes[i] ^ (words[i] * K1);
+            lanes[i] = ((lane << 31) | (lane >> 33)) * K0;
+        }
+    }
+
+    uint64_t tail[4] = {};
+    memcpy(tail, data, (size_t)(size & 31));
+
+    uint64_t hash = size * K0;
+    for (uint32_t i = 0; i < 4; i++) {
+        hash ^= lanes[i] ^ (tail[i] * K1);
+        hash = ((hash << 27) | (hash >> 37)) * K0;
+    }
+
+    // Final avalanche
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ull;
+    hash ^= hash >> 33;
+
+    return hash ? hash : 1;
+}
+
+// Records must be sorted by destination
+static inline void MarkExclusiveUploadRecords(Vector<StreamerUploadRecord>& uploadRecords) {
+    uint64_t maxEnd = 0;
+    for (size_t i = 0; i < uploadRecords.size(); i++) {
+        StreamerUploadRecord& uploadRecord = uploadRecords[i];
+
+        bool isFirst = i == 0 || uploadRecords[i - 1].dstBuffer != uploadRecord.dstBuffer;
+        if (isFirst)
+            maxEnd = 0;
+
+        bool overlapsNext = i + 1 < uploadRecords.size() && uploadRecords[i + 1].dstBuffer == uploadRecord.dstBuffer && uploadRecords[i + 1].begin < uploadRecord.end;
+        uploadRecord.isExclusive = maxEnd <= uploadRecord.begin && !overlapsNext;
+
+        maxEnd = std::max(maxEnd, uploadRecord.end);
+    }
+}
+
+static inline bool IsUploadRecordLess(const StreamerUploadRecord& a, const StreamerUploadRecord& b) {
+    if (a.dstBuffer != b.dstBuffer)
+        return (size_t)a.dstBuffer < (size_t)b.dstBuffer;
+
+    return a.begin < b.begin;
+}
+
+static inline void ExecuteCopyJob(const StreamerCopyJob& job) {
+    uint8_t* dst = job.dst;
+    const uint8_t* src = job.src;
+
+    for (uint32_t i = 0; i < job.rowNum; i++) {
+        CopyToUploadHeap(dst, src, job.size);
+
+        dst += job.dstRowPitch;
+        src += job.srcRowPitch;
+    }
+}
+
+StreamerCopyPool::StreamerCopyPool(const StdAllocator<uint8_t>& stdAllocator, uint32_t threadNum)
+    : m_Threads(stdAllocator) {
+    m_Threads.reserve(threadNum);
+    for (uint32_t i = 0; i < threadNum; i++)
+        m_Threads.emplace_back(&StreamerCopyPool::WorkerThread, this);
+}
+
+StreamerCopyPool::~StreamerCopyPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_IsShuttingDown = true;
+    }
+
+    m_WorkerCondition.notify_all();
+
+    for (std::thread& thread : m_Threads)
+        thread.join();
+}
+
+void StreamerCopyPool::Execute(const StreamerCopyJob* jobs, uint32_t jobNum) {
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+
+        // A worker woken up too late for the previous batch may still be touching "m_NextJob"
+        m_OwnerCondition.wait(lock, [this] { return m_ActiveWorkerNum == 0; });
+
+        m_Jobs = jobs;
+        m_JobNum = jobNum;
+        m_Generation++;
+        m_NextJob.store(0, std::memory_order_relaxed);
+    }
+
+    m_WorkerCondition.notify_all();
+
+    ExecuteJobs(jobs, jobNum);
+
+    // All jobs are taken, wait for the ones still in flight
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_OwnerCondition.wait(lock, [this] { return m_ActiveWorkerNum == 0; });
+}
+
+void StreamerCopyPool::WorkerThread() {
+    uint32_t generation = 0;
+
+    while (true) {
+        const StreamerCopyJob* jobs = nullptr;
+        uint32_t jobNum = 0;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_WorkerCondition.wait(lock, [this, generation] { return m_IsShuttingDown || m_Generation != generation; });
+
+            if (m_IsShuttingDown)
+                return;
+
+            generation = m_Generation;
+            jobs = m_Jobs;
+            jobNum = m_JobNum;
+            m_ActiveWorkerNum++;
+        }
+
+        ExecuteJobs(jobs, jobNum);
+
+        bool isLast = false;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            isLast = --m_ActiveWorkerNum == 0;
+        }
+
+        if (isLast)
+            m_OwnerCondition.notify_one();
+    }
+}
+
+void StreamerCopyPool::ExecuteJobs(const StreamerCopyJob* jobs, uint32_t jobNum) {
+    for (uint32_t i = m_NextJob.fetch_add(1, std::memory_order_relaxed); i < jobNum; i = m_NextJob.fetch_add(1, std::memory_order_relaxed))
+        ExecuteCopyJob(jobs[i]);
+
+    FinishCopyToUploadHeap();
+}
 
 StreamerImpl::~StreamerImpl() {
     for (GarbageInFlight& garbageInFlight : m_GarbageInFlight) {
@@ -8,14 +208,58 @@ StreamerImpl::~StreamerImpl() {
         m_NRI.FreeMemory(*garbageInFlight.memory);
     }
 
-    m_NRI.DestroyBuffer(*m_ConstantBuffer);
-    m_NRI.DestroyBuffer(*m_DynamicBuffer);
+    if (m_RequestLists) {
+        for (uint32_t i = 0; i < m_RequestListNum; i++) {
+            for (BufferUpdateRequest& request : m_RequestLists[i].buffers)
+                FreeStagingMemory(request);
+
+            m_RequestLists[i].~StreamerRequestList();
+        }
+
+        const AllocationCallbacks& allocationCallbacks = ((DeviceBase&)m_Device).GetAllocationCallbacks();
+        allocationCallbacks.Free(allocationCallbacks.userArg, m_RequestLists);
+    }
+
+    if (m_DynamicBufferData)
+        m_NRI.UnmapBuffer(*m_DynamicBuffer);
+
+    if (m_ConstantBufferData)
+        m_NRI.UnmapBuffer(*m_ConstantBuffer);
+
+    if (m_CopyPool)
+        Destroy(((DeviceBase&)m_Device).GetAllocationCallbacks(), m_CopyPool);
 
-    m_NRI.FreeMemory(*m_ConstantBufferMemory);
-    m_NRI.FreeMemory(*m_DynamicBufferMemory);
+    // Not created if not requested or if creation failed
+    if (m_ConstantBuffer)
+        m_NRI.DestroyBuffer(*m_ConstantBuffer);
+    if (m_DynamicBuffer)
+        m_NRI.DestroyBuffer(*m_DynamicBuffer);
+
+    if (m_ConstantBufferMemory)
+        m_NRI.FreeMemory(*m_ConstantBufferMemory);
+    if (m_DynamicBufferMemory)
+        m_NRI.FreeMemory(*m_DynamicBufferMemory);
 }
 
 Result StreamerImpl::Create(const StreamerDesc& desc) {
+    { // Create request lists
+        const AllocationCallbacks& allocationCallbacks = ((DeviceBase&)m_Device).GetAllocationCallbacks();
+        uint32_t requestListNum = std::max(std::thread::hardware_concurrency(), 1u);
+
+        m_RequestLists = (StreamerRequestList*)allocationCallbacks.Allocate(allocationCallbacks.userArg, sizeof(StreamerRequestList) * requestListNum, alignof(StreamerRequestList));
+        if (!m_RequestLists)
+            return Result::OUT_OF_MEMORY;
+
+        Construct(m_RequestLists, requestListNum, ((DeviceBase&)m_Device).GetStdAllocator());
+        m_RequestListNum = requestListNum;
+
+        if (desc.copyThreadNum) {
+            m_CopyPool = Allocate<StreamerCopyPool>(allocationCallbacks, ((DeviceBase&)m_Device).GetStdAllocator(), desc.copyThreadNum);
+            if (!m_CopyPool)
+                return Result::OUT_OF_MEMORY;
+        }
+    }
+
     if (desc.constantBufferSize) {
         // Create constant buffer
         BufferDesc bufferDesc = {};
@@ -46,42 +290,137 @@ Result StreamerImpl::Create(const StreamerDesc& desc) {
         result = m_NRI.BindBufferMemory(m_Device, &memoryBindingDesc, 1);
         if (result != Result::SUCCESS)
             return result;
+
+        // Keep mapped, unless D3D11 (can't use mapped buffers) or the memory is non-coherent. In these cases written ranges get mapped
+        // and unmapped, since "UnmapBuffer" flushes the mapped range
+        const DeviceDesc& deviceDesc = m_NRI.GetDeviceDesc(m_Device);
+        if (deviceDesc.graphicsAPI != GraphicsAPI::D3D11 && !memoryDesc.isHostNonCoherent)
+            m_ConstantBufferData = (uint8_t*)m_NRI.MapBuffer(*m_ConstantBuffer, 0, WHOLE_SIZE);
     }
 
     m_Desc = desc;
+    m_FrameSizes.resize(desc.frameInFlightNum + 1, 0);
 
     return Result::SUCCESS;
 }
 
+uint32_t StreamerImpl::AllocateConstants(uint32_t alignedSize) {
+    if (alignedSize > m_Desc.constantBufferSize) {
+        REPORT_ERROR(&(DeviceBase&)m_Device, "%u bytes of constants don't fit into 'constantBufferSize'", alignedSize);
+        return INVALID_CONSTANT_OFFSET;
+    }
+
+    // Wrap around, the part used by the current frame stays live
+    bool isWrapped = m_ConstantDataOffset + alignedSize > m_Desc.constantBufferSize;
+    uint32_t offset = isWrapped ? 0 : m_ConstantDataOffset;
+    uint32_t end = offset + alignedSize;
+
+    // The region must be free. Segments of the current frame (not submitted yet) can't be waited for, as well as segments without
+    // a fence (they retire by frame counting in "CopyUpdateRequests")
+    bool isAvailable = !isWrapped || m_ConstantDataOffset == m_ConstantFrameBegin || m_ConstantFrameBegin >= end;
+    size_t retiredSegmentNum = 0;
+
+    for (size_t i = 0; i < m_ConstantRingSegments.size() && isAvailable; i++) {
+        const StreamerRingSegment& ringSegment = m_ConstantRingSegments[i];
+        if (ringSegment.begin >= end || ringSegment.end <= offset)
+            continue;
+
+        isAvailable = m_Desc.fence && ringSegment.fenceValue != STREAMER_OPEN_SEGMENT;
+        retiredSegmentNum = i + 1;
+    }
+
+    if (!isAvailable) {
+        REPORT_ERROR(&(DeviceBase&)m_Device, "'constantBufferSize' is too small, the ring is full of constants in use by the GPU");
+        return INVALID_CONSTANT_OFFSET;
+    }
+
+    // Older segments are retired too
+    if (retiredSegmentNum) {
+        m_NRI.Wait(*m_Desc.fence, m_ConstantRingSegments[retiredSegmentNum - 1].fenceValue);
+        m_ConstantRingSegments.erase(m_ConstantRingSegments.begin(), m_ConstantRingSegments.begin() + retiredSegmentNum);
+    }
+
+    if (isWrapped) {
+        if (m_ConstantDataOffset != m_ConstantFrameBegin)
+            m_ConstantRingSegments.push_back({m_ConstantFrameBegin, m_ConstantDataOffset, STREAMER_OPEN_SEGMENT, 0});
+
+        m_ConstantFrameBegin = 0;
+    }
+
+    m_ConstantDataOffset = end;
+
+    return offset;
+}
+
 uint32_t StreamerImpl::UpdateConstantBuffer(const void* data, uint32_t dataSize) {
+    ConstantBufferUpdateRequestDesc constantBufferUpdateRequestDesc = {data, dataSize};
+
+    uint32_t offset = 0;
+    UpdateConstantBuffers(&constantBufferUpdateRequestDesc, 1, &offset);
+
+    return offset;
+}
+
+void StreamerImpl::UpdateConstantBuffers(const ConstantBufferUpdateRequestDesc* constantBufferUpdateRequestDescs, uint32_t constantBufferUpdateRequestDescNum, uint32_t* offsets) {
     const DeviceDesc& deviceDesc = m_NRI.GetDeviceDesc(m_Device);
-    uint32_t alignedSize = Align(dataSize, deviceDesc.constantBufferOffsetAlignment);
 
-    // Update
-    if (m_ConstantDataOffset + alignedSize > m_Desc.constantBufferSize)
-        m_ConstantDataOffset = 0;
+    ExclusiveScope lock(m_ConstantLock);
 
-    uint32_t offset = m_ConstantDataOffset;
-    m_ConstantDataOffset += alignedSize;
+    for (uint32_t i = 0; i < constantBufferUpdateRequestDescNum; i++) {
+        uint32_t alignedSize = Align(constantBufferUpdateRequestDescs[i].dataSize, deviceDesc.constantBufferOffsetAlignment);
+        offsets[i] = AllocateConstants(alignedSize);
+    }
 
     // Copy
-    uint8_t* dest = (uint8_t*)m_NRI.MapBuffer(*m_ConstantBuffer, offset, alignedSize);
-    if (dest) {
-        memcpy(dest, data, dataSize);
-        m_NRI.UnmapBuffer(*m_ConstantBuffer);
+    if (m_ConstantBufferData) {
+        for (uint32_t i = 0; i < constantBufferUpdateRequestDescNum; i++) {
+            const ConstantBufferUpdateRequestDesc& constantBufferUpdateRequestDesc = constantBufferUpdateRequestDescs[i];
+            if (offsets[i] != INVALID_CONSTANT_OFFSET)
+                memcpy(m_ConstantBufferData + offsets[i], constantBufferUpdateRequestDesc.data, constantBufferUpdateRequestDesc.dataSize);
+        }
+
+        return;
     }
 
-    return offset;
+    // Map contiguous runs (offsets restart only if the ring wraps around), unmapping flushes exactly the written range
+    uint32_t i = 0;
+    while (i < constantBufferUpdateRequestDescNum) {
+        if (offsets[i] == INVALID_CONSTANT_OFFSET) {
+            i++;
+            continue;
+        }
+
+        uint32_t runBegin = offsets[i];
+        uint32_t runEnd = offsets[i] + constantBufferUpdateRequestDescs[i].dataSize;
+
+        uint32_t j = i + 1;
+        for (; j < constantBufferUpdateRequestDescNum && offsets[j] != INVALID_CONSTANT_OFFSET && offsets[j] >= runEnd; j++)
+            runEnd = offsets[j] + constantBufferUpdateRequestDescs[j].dataSize;
+
+        uint8_t* data = (uint8_t*)m_NRI.MapBuffer(*m_ConstantBuffer, runBegin, runEnd - runBegin);
+        if (!data)
+            return;
+
+        for (; i < j; i++) {
+            const ConstantBufferUpdateRequestDesc& constantBufferUpdateRequestDesc = constantBufferUpdateRequestDescs[i];
+            memcpy(data + offsets[i] - runBegin, constantBufferUpdateRequestDesc.data, constantBufferUpdateRequestDesc.dataSize);
+        }
+
+        m_NRI.UnmapBuffer(*m_ConstantBuffer);
+    }
 }
 
 uint64_t StreamerImpl::AddBufferUpdateRequest(const BufferUpdateRequestDesc& bufferUpdateRequestDesc) {
     uint64_t alignedSize = Align(bufferUpdateRequestDesc.dataSize, 16);
+    uint64_t localOffset = m_DynamicDataOffset.fetch_add(alignedSize, std::memory_order_relaxed);
 
-    uint64_t offset = m_DynamicDataOffsetBase + m_DynamicDataOffset;
-    m_BufferRequests.push_back({bufferUpdateRequestDesc, m_DynamicDataOffset}); // store local offset
-    m_DynamicDataOffset += alignedSize;
+    StreamerRequestList& requestList = m_RequestLists[GetProducerIndex() % m_RequestListNum];
+    {
+        ExclusiveScope lock(requestList.lock);
+        requestList.buffers.push_back({bufferUpdateRequestDesc, localOffset, nullptr, 0}); // store local offset
+    }
 
-    return offset;
+    return m_DynamicDataOffsetBase + localOffset;
 }
 
 uint64_t StreamerImpl::AddTextureUpdateRequest(const TextureUpdateRequestDesc& textureUpdateRequestDesc) {
@@ -94,27 +433,311 @@ uint64_t StreamerImpl::AddTextureUpdateRequest(const TextureUpdateRequestDesc& t
     Dim_t d = textureUpdateRequestDesc.dstRegionDesc.depth;
     d = d == WHOLE_SIZE ? GetDimension(deviceDesc.graphicsAPI, textureDesc, 2, textureUpdateRequestDesc.dstRegionDesc.mipOffset) : d;
 
+    // Data is stored in rows of blocks
+    uint32_t blockWidth = GetFormatProps(textureDesc.format).blockWidth;
+
+    uint32_t rowNum = (h + blockWidth - 1) / blockWidth;
     uint32_t alignedRowPitch = Align(textureUpdateRequestDesc.dataRowPitch, deviceDesc.uploadBufferTextureRowAlignment);
-    uint32_t alignedSlicePitch = Align(alignedRowPitch * h, deviceDesc.uploadBufferTextureSliceAlignment);
-    uint64_t alignedSize = alignedSlicePitch * d;
+    uint32_t alignedSlicePitch = Align(alignedRowPitch * rowNum, deviceDesc.uploadBufferTextureSliceAlignment);
 
-    uint64_t offset = m_DynamicDataOffsetBase + m_DynamicDataOffset;
-    m_TextureRequests.push_back({textureUpdateRequestDesc, m_DynamicDataOffset}); // store local offset
-    m_DynamicDataOffset += alignedSize;
+    uint64_t alignedSize = (uint64_t)alignedSlicePitch * d;
+    uint64_t localOffset = m_DynamicDataOffset.fetch_add(alignedSize, std::memory_order_relaxed);
 
-    return offset;
+    TextureUpdateRequest request = {textureUpdateRequestDesc, localOffset, rowNum, d, alignedRowPitch, alignedSlicePitch}; // store local offset
+
+    StreamerRequestList& requestList = m_RequestLists[GetProducerIndex() % m_RequestListNum];
+    {
+        ExclusiveScope lock(requestList.lock);
+        requestList.textures.push_back(request);
+    }
+
+    return m_DynamicDataOffsetBase + localOffset;
+}
+
+void* StreamerImpl::ReserveBufferUpdateRequest(const BufferUpdateRequestDesc& bufferUpdateRequestDesc, uint64_t& offset) {
+    uint64_t alignedSize = Align(bufferUpdateRequestDesc.dataSize, 16);
+    uint64_t localOffset = m_DynamicDataOffset.fetch_add(alignedSize, std::memory_order_relaxed);
+
+    offset = m_DynamicDataOffsetBase + localOffset;
+
+    BufferUpdateRequest request = {bufferUpdateRequestDesc, localOffset, nullptr, 0}; // store local offset
+    request.desc.data = nullptr;
+
+    // Write directly to the dynamic buffer if it's mapped and the region fits, otherwise use a temporary copy
+    uint8_t* data = nullptr;
+    if (m_DynamicBufferData && offset + alignedSize <= m_DirectWriteLimit)
+        data = m_DynamicBufferData + offset;
+    else {
+        const AllocationCallbacks& allocationCallbacks = ((DeviceBase&)m_Device).GetAllocationCallbacks();
+
+        request.stagingMemory = (uint8_t*)allocationCallbacks.Allocate(allocationCallbacks.userArg, (size_t)alignedSize, 16);
+        if (!request.stagingMemory)
+            return nullptr;
+
+        request.desc.data = request.stagingMemory;
+        data = request.stagingMemory;
+    }
+
+    StreamerRequestList& requestList = m_RequestLists[GetProducerIndex() % m_RequestListNum];
+    {
+        ExclusiveScope lock(requestList.lock);
+        requestList.buffers.push_back(request);
+    }
+
+    return data;
+}
+
+void StreamerImpl::SetFenceValue(uint64_t fenceValue) {
+    m_FenceValue = fenceValue;
+}
+
+void StreamerImpl::GetStats(StreamerStats& streamerStats) const {
+    streamerStats = m_Stats;
+    streamerStats.dynamicBufferSize = m_DynamicBufferSize;
+    streamerStats.garbageBufferNum = (uint32_t)m_GarbageInFlight.size();
+}
+
+void StreamerImpl::FreeStagingMemory(BufferUpdateRequest& request) {
+    if (!request.stagingMemory)
+        return;
+
+    const AllocationCallbacks& allocationCallbacks = ((DeviceBase&)m_Device).GetAllocationCallbacks();
+    allocationCallbacks.Free(allocationCallbacks.userArg, request.stagingMemory);
+
+    request.stagingMemory = nullptr;
+    request.desc.data = nullptr;
+}
+
+void StreamerImpl::AddCopyJobs(uint8_t* dst, const uint8_t* src, uint64_t size, uint64_t dstRowPitch, uint64_t srcRowPitch, uint32_t rowNum) {
+    if (!size || !rowNum)
+        return;
+
+    // Merge contiguous rows
+    if (size == dstRowPitch && size == srcRowPitch) {
+        size *= rowNum;
+        rowNum = 1;
+    }
+
+    if (rowNum == 1) {
+        // Split a big row into pieces to let copy threads share the work
+        for (uint64_t offset = 0; offset < size; offset += STREAMER_COPY_JOB_MAX_SIZE) {
+            uint64_t pieceSize = std::min(size - offset, STREAMER_COPY_JOB_MAX_SIZE);
+            m_CopyJobs.push_back({dst + offset, src + offset, pieceSize, 0, 0, 1});
+        }
+    } else {
+        // Group small rows
+        uint32_t jobRowNum = (uint32_t)std::max(STREAMER_COPY_JOB_MAX_SIZE / size, (uint64_t)1);
+        for (uint32_t row = 0; row < rowNum; row += jobRowNum) {
+            uint32_t pieceRowNum = std::min(rowNum - row, jobRowNum);
+            m_CopyJobs.push_back({dst + row * dstRowPitch, src + row * srcRowPitch, size, dstRowPitch, srcRowPitch, pieceRowNum});
+        }
+    }
+}
+
+void StreamerImpl::CoalesceBufferUploads() {
+    // Sort by destination (to find overlapping and contiguous updates)
+    std::stable_sort(m_BufferRequestsWithDst.begin(), m_BufferRequestsWithDst.end(), [](const BufferUpdateRequest& a, const BufferUpdateRequest& b) {
+        if (a.desc.dstBuffer != b.desc.dstBuffer)
+            return (size_t)a.desc.dstBuffer < (size_t)b.desc.dstBuffer;
+
+        return a.desc.dstBufferOffset < b.desc.dstBufferOffset;
+    });
+
+    // Skip updates with content identical to what the destination received in the previous frame. Only ranges not overlapped
+    // by other updates (in both frames) qualify, otherwise the content of the destination is not known
+    if (m_Desc.skipUnchangedBufferUpdates) {
+        m_UploadRecords.clear();
+        for (const BufferUpdateRequest& request : m_BufferRequestsWithDst)
+            m_UploadRecords.push_back({request.desc.dstBuffer, request.desc.dstBufferOffset, request.desc.dstBufferOffset + request.desc.dataSize, request.hash, false});
+
+        MarkExclusiveUploadRecords(m_UploadRecords);
+
+        for (size_t i = 0; i < m_UploadRecords.size(); i++) {
+            const StreamerUploadRecord& uploadRecord = m_UploadRecords[i];
+            if (!uploadRecord.hash || !uploadRecord.isExclusive)
+                continue;
+
+            auto prevUploadRecord = std::lower_bound(m_PrevUploadRecords.begin(), m_PrevUploadRecords.end(), uploadRecord, IsUploadRecordLess);
+            if (prevUploadRecord == m_PrevUploadRecords.end() || prevUploadRecord->dstBuffer != uploadRecord.dstBuffer)
+                continue;
+
+            if (prevUploadRecord->begin == uploadRecord.begin && prevUploadRecord->end == uploadRecord.end && prevUploadRecord->hash == uploadRecord.hash && prevUploadRecord->isExclusive)
+                m_BufferRequestsWithDst[i].desc.dataSize = 0; // skip
+        }
+
+        m_PrevUploadRecords.assign(m_UploadRecords.begin(), m_UploadRecords.end());
+    }
+
+    // Overlapping updates must be applied in submission order, which the dynamic buffer offset (handed out by an atomic counter)
+    // reflects. Restore it within each group of transitively overlapping destination ranges
+    size_t groupBegin = 0;
+    uint64_t groupEnd = 0;
+    for (size_t i = 0; i <= m_BufferRequestsWithDst.size(); i++) {
+        bool isNewGroup = i == 0 || i == m_BufferRequestsWithDst.size();
+        if (!isNewGroup) {
+            const BufferUpdateRequest& request = m_BufferRequestsWithDst[i];
+            isNewGroup = request.desc.dstBuffer != m_BufferRequestsWithDst[i - 1].desc.dstBuffer || request.desc.dstBufferOffset >= groupEnd;
+        }
+
+        if (isNewGroup) {
+            if (i - groupBegin > 1) {
+                std::sort(m_BufferRequestsWithDst.begin() + groupBegin, m_BufferRequestsWithDst.begin() + i, [](const BufferUpdateRequest& a, const BufferUpdateRequest& b) {
+                    return a.offset < b.offset;
+                });
+            }
+
+            groupBegin = i;
+            groupEnd = 0;
+        }
+
+        if (i < m_BufferRequestsWithDst.size()) {
+            const BufferUpdateRequest& request = m_BufferRequestsWithDst[i];
+            groupEnd = std::max(groupEnd, request.desc.dstBufferOffset + request.desc.dataSize);
+        }
+    }
+
+    // Merge updates contiguous in both the destination and the dynamic buffer (consecutive in the command list, thus not reordered)
+    size_t n = 0;
+    for (const BufferUpdateRequest& request : m_BufferRequestsWithDst) {
+        if (!request.desc.dataSize) {
+            m_Stats.skippedRequestNum++;
+            continue;
+        }
+
+        if (n) {
+            BufferUpdateRequest& last = m_BufferRequestsWithDst[n - 1];
+            if (last.desc.dstBuffer == request.desc.dstBuffer && last.desc.dstBufferOffset + last.desc.dataSize == request.desc.dstBufferOffset && last.offset + last.desc.dataSize == request.offset) {
+                last.desc.dataSize += request.desc.dataSize;
+                continue;
+            }
+        }
+
+        m_BufferRequestsWithDst[n++] = request;
+    }
+
+    m_BufferRequestsWithDst.resize(n);
+}
+
+bool StreamerImpl::IsRetired(uint64_t fenceValue, uint32_t frameNum, uint64_t completedFenceValue) const {
+    if (m_Desc.fence)
+        return completedFenceValue >= fenceValue;
+
+    // "CopyUpdateRequests" for a frame can precede waiting for the oldest frame in flight
+    return frameNum > m_Desc.frameInFlightNum;
+}
+
+uint64_t StreamerImpl::GetRingFreeRegionEnd(uint64_t offset) const {
+    if (m_RingSegments.empty())
+        return m_DynamicBufferSize;
+
+    uint64_t tail = m_RingSegments.front().begin;
+    uint64_t head = m_RingSegments.back().end;
+
+    if (tail < head) {
+        // Not wrapped: live data is "[tail, head)"
+        if (offset >= head)
+            return m_DynamicBufferSize;
+        if (offset <= tail)
+            return tail;
+    } else {
+        // Wrapped: live data is "[tail, end)" and "[0, head)"
+        if (offset >= head && offset <= tail)
+            return tail;
+    }
+
+    return offset; // inside live data
+}
+
+void StreamerImpl::RetireRingSegments(Vector<StreamerRingSegment>& ringSegments, uint64_t completedFenceValue) {
+    // The tail moves only forward
+    size_t retiredSegmentNum = 0;
+    while (retiredSegmentNum < ringSegments.size()) {
+        const StreamerRingSegment& ringSegment = ringSegments[retiredSegmentNum];
+        if (!IsRetired(ringSegment.fenceValue, ringSegment.frameNum, completedFenceValue))
+            break;
+
+        retiredSegmentNum++;
+    }
+
+    ringSegments.erase(ringSegments.begin(), ringSegments.begin() + retiredSegmentNum);
+}
+
+void StreamerImpl::AgeRingSegments(Vector<StreamerRingSegment>& ringSegments) {
+    for (StreamerRingSegment& ringSegment : ringSegments)
+        ringSegment.frameNum++;
+}
+
+Result StreamerImpl::CreateDynamicBuffer(uint64_t size) {
+    const DeviceDesc& deviceDesc = m_NRI.GetDeviceDesc(m_Device);
+
+    // The current buffer stays in use until the new one is ready
+    Buffer* buffer = nullptr;
+    Memory* memory = nullptr;
+
+    Result result = Result::SUCCESS;
+    MemoryDesc memoryDesc = {};
+    { // Create new dynamic buffer & allocate memory
+        BufferDesc bufferDesc = {};
+        bufferDesc.size = size;
+        bufferDesc.usage = m_Desc.dynamicBufferUsageBits;
+
+        result = m_NRI.CreateBuffer(m_Device, bufferDesc, buffer);
+        if (result == Result::SUCCESS) {
+            m_NRI.GetBufferMemoryDesc(*buffer, m_Desc.dynamicBufferMemoryLocation, memoryDesc);
+
+            AllocateMemoryDesc allocateMemoryDesc = {};
+            allocateMemoryDesc.type = memoryDesc.type;
+            allocateMemoryDesc.size = memoryDesc.size;
+
+            result = m_NRI.AllocateMemory(m_Device, allocateMemoryDesc, memory);
+        }
+    }
+
+    if (result == Result::SUCCESS) { // Bind to memory
+        BufferMemoryBindingDesc memoryBindingDesc = {};
+        memoryBindingDesc.buffer = buffer;
+        memoryBindingDesc.memory = memory;
+
+        result = m_NRI.BindBufferMemory(m_Device, &memoryBindingDesc, 1);
+    }
+
+    if (result != Result::SUCCESS) {
+        if (buffer)
+            m_NRI.DestroyBuffer(*buffer);
+        if (memory)
+            m_NRI.FreeMemory(*memory);
+
+        return result;
+    }
+
+    // Add the current buffer to the garbage collector immediately, but keep it alive until the GPU is done with it
+    if (m_DynamicBuffer)
+        m_GarbageInFlight.push_back({m_DynamicBuffer, m_DynamicBufferMemory, m_FenceValue, 0});
+
+    m_DynamicBuffer = buffer;
+    m_DynamicBufferMemory = memory;
+    m_DynamicBufferData = nullptr;
+    m_DynamicBufferSize = size;
+    m_RingSegments.clear();
+
+    // Keep mapped to allow writing reservations directly, unless D3D11 (can't use mapped buffers) or the memory is non-coherent. In these cases
+    // the region of a frame gets mapped and unmapped in "CopyUpdateRequests", since "UnmapBuffer" flushes the mapped range
+    if (deviceDesc.graphicsAPI != GraphicsAPI::D3D11 && !memoryDesc.isHostNonCoherent)
+        m_DynamicBufferData = (uint8_t*)m_NRI.MapBuffer(*m_DynamicBuffer, 0, WHOLE_SIZE);
+
+    return Result::SUCCESS;
 }
 
 Result StreamerImpl::CopyUpdateRequests() {
-    if (!m_DynamicDataOffset)
-        return Result::SUCCESS;
+    // All producers must be done at this point
+    uint64_t dynamicDataSize = m_DynamicDataOffset.load(std::memory_order_acquire);
+
+    // Reclaim memory the GPU is done with. Frames are counted only once the call can't fail anymore, a retry doesn't count the frame twice
+    uint64_t completedFenceValue = m_Desc.fence ? m_NRI.GetFenceValue(*m_Desc.fence) : 0;
 
-    // Process garbage
     for (size_t i = 0; i < m_GarbageInFlight.size(); i++) {
         GarbageInFlight& garbageInFlight = m_GarbageInFlight[i];
-        if (garbageInFlight.frameNum < m_Desc.frameInFlightNum)
-            garbageInFlight.frameNum++;
-        else {
+        if (IsRetired(garbageInFlight.fenceValue, garbageInFlight.frameNum, completedFenceValue)) {
             m_NRI.DestroyBuffer(*garbageInFlight.buffer);
             m_NRI.FreeMemory(*garbageInFlight.memory);
 
@@ -123,106 +746,217 @@ Result StreamerImpl::CopyUpdateRequests() {
         }
     }
 
-    // Grow
-    if (m_DynamicDataOffsetBase + m_DynamicDataOffset > m_DynamicBufferSize) {
-        m_DynamicBufferSize = Align(m_DynamicDataOffset, CHUNK_SIZE) * (m_Desc.frameInFlightNum + 1);
+    size_t agedGarbageNum = m_GarbageInFlight.size(); // not including the buffer replaced below
 
-        // Add the current buffer to the garbage collector immediately, but keep it alive for some frames
-        if (m_DynamicBuffer)
-            m_GarbageInFlight.push_back({m_DynamicBuffer, m_DynamicBufferMemory, 0});
+    RetireRingSegments(m_RingSegments, completedFenceValue);
 
-        { // Create new dynamic buffer & allocate memory
-            BufferDesc bufferDesc = {};
-            bufferDesc.size = m_DynamicBufferSize;
-            bufferDesc.usage = m_Desc.dynamicBufferUsageBits;
+    // Memory footprint of the frames in flight (including this one, which replaces the oldest one)
+    uint64_t peakFrameSize = dynamicDataSize;
+    uint64_t footprint = dynamicDataSize;
+    for (uint32_t i = 0; i < m_FrameSizes.size(); i++) {
+        if (i != m_FrameIndex) {
+            peakFrameSize = std::max(peakFrameSize, m_FrameSizes[i]);
+            footprint += m_FrameSizes[i];
+        }
+    }
 
-            Result result = m_NRI.CreateBuffer(m_Device, bufferDesc, m_DynamicBuffer);
-            if (result != Result::SUCCESS)
-                return result;
+    // Grow (or shrink) if the region, already handed out to producers, is not available
+    Buffer* prevDynamicBuffer = nullptr;
+    uint8_t* prevDynamicBufferData = m_DynamicBufferData; // reserved regions written before growing live there
+    bool isResized = false;
 
-            MemoryDesc memoryDesc = {};
-            m_NRI.GetBufferMemoryDesc(*m_DynamicBuffer, m_Desc.dynamicBufferMemoryLocation, memoryDesc);
+    if (dynamicDataSize && (m_PendingResizeSize || m_DynamicDataOffsetBase + dynamicDataSize > GetRingFreeRegionEnd(m_DynamicDataOffsetBase))) {
+        uint64_t size = m_PendingResizeSize ? m_PendingResizeSize : footprint + footprint / 2;
+        size = std::max(size, m_DynamicDataOffsetBase + dynamicDataSize);
 
-            AllocateMemoryDesc allocateMemoryDesc = {};
-            allocateMemoryDesc.type = memoryDesc.type;
-            allocateMemoryDesc.size = memoryDesc.size;
+        // On failure requests stay queued (and the current buffer stays valid), "CopyUpdateRequests" can be retried
+        prevDynamicBuffer = m_DynamicBuffer;
 
-            result = m_NRI.AllocateMemory(m_Device, allocateMemoryDesc, m_DynamicBufferMemory);
-            if (result != Result::SUCCESS)
-                return result;
-        }
+        Result result = CreateDynamicBuffer(Align(size, CHUNK_SIZE));
+        if (result != Result::SUCCESS)
+            return result;
 
-        { // Bind to memory
-            BufferMemoryBindingDesc memoryBindingDesc = {};
-            memoryBindingDesc.buffer = m_DynamicBuffer;
-            memoryBindingDesc.memory = m_DynamicBufferMemory;
+        isResized = true;
+    }
 
-            Result result = m_NRI.BindBufferMemory(m_Device, &memoryBindingDesc, 1);
-            if (result != Result::SUCCESS)
-                return result;
+    // Map the region of this frame
+    uint8_t* data = nullptr;
+    if (dynamicDataSize) {
+        data = m_DynamicBufferData ? m_DynamicBufferData + m_DynamicDataOffsetBase : (uint8_t*)m_NRI.MapBuffer(*m_DynamicBuffer, m_DynamicDataOffsetBase, dynamicDataSize);
+        if (!data)
+            return Result::FAILURE;
+    }
+
+    // Nothing can fail from here, account for the frame
+    for (size_t i = 0; i < agedGarbageNum; i++)
+        m_GarbageInFlight[i].frameNum++;
+
+    AgeRingSegments(m_RingSegments);
+
+    { // Constants gathered since the previous call belong to this frame
+        ExclusiveScope lock(m_ConstantLock);
+
+        if (m_ConstantDataOffset != m_ConstantFrameBegin)
+            m_ConstantRingSegments.push_back({m_ConstantFrameBegin, m_ConstantDataOffset, STREAMER_OPEN_SEGMENT, 0});
+
+        m_ConstantFrameBegin = m_ConstantDataOffset;
+
+        for (StreamerRingSegment& ringSegment : m_ConstantRingSegments) {
+            if (ringSegment.fenceValue == STREAMER_OPEN_SEGMENT)
+                ringSegment.fenceValue = m_FenceValue;
         }
+
+        RetireRingSegments(m_ConstantRingSegments, completedFenceValue);
+        AgeRingSegments(m_ConstantRingSegments);
     }
 
+    m_FrameSizes[m_FrameIndex] = dynamicDataSize;
+    m_FrameIndex = (m_FrameIndex + 1) % (uint32_t)m_FrameSizes.size();
+
+    m_Stats.requestedSize = dynamicDataSize;
+    m_Stats.copiedSize = 0;
+    m_Stats.bufferRequestNum = 0;
+    m_Stats.textureRequestNum = 0;
+    m_Stats.uploadCommandNum = 0;
+    m_Stats.skippedRequestNum = 0;
+    m_Stats.peakRequestedSize = std::max(m_Stats.peakRequestedSize, dynamicDataSize);
+
+    if (isResized) {
+        if (m_PendingResizeSize)
+            m_Stats.shrinkNum++;
+        else
+            m_Stats.growNum++;
+
+        m_PendingResizeSize = 0;
+    }
+
+    if (!dynamicDataSize)
+        return Result::SUCCESS;
+
     // Concatenate & copy to the internal buffer, gather requests with destinations
-    uint8_t* data = (uint8_t*)m_NRI.MapBuffer(*m_DynamicBuffer, m_DynamicDataOffsetBase, m_DynamicDataOffset);
-    if (data) {
-        const DeviceDesc& deviceDesc = m_NRI.GetDeviceDesc(m_Device);
+    uint64_t copySize = 0;
+    for (uint32_t i = 0; i < m_RequestListNum; i++) {
+        StreamerRequestList& requestList = m_RequestLists[i];
+
+        m_Stats.bufferRequestNum += (uint32_t)requestList.buffers.size();
+        m_Stats.textureRequestNum += (uint32_t)requestList.textures.size();
 
         // Buffers
-        for (BufferUpdateRequest& request : m_BufferRequests) {
+        for (const BufferUpdateRequest& request : requestList.buffers) {
             uint8_t* dst = data + request.offset;
-            memcpy(dst, request.desc.data, request.desc.dataSize);
+            const uint8_t* src = (const uint8_t*)request.desc.data;
+            if (!src && prevDynamicBufferData && prevDynamicBuffer) // a reservation, already written, but to the previous buffer
+                src = prevDynamicBufferData + m_DynamicDataOffsetBase + request.offset;
+
+            if (src) {
+                AddCopyJobs(dst, src, request.desc.dataSize, 0, 0, 1);
+                copySize += request.desc.dataSize;
+            }
 
             if (request.desc.dstBuffer) {
-                request.offset += m_DynamicDataOffsetBase; // convert to global offset
-                m_BufferRequestsWithDst.push_back(request);
+                BufferUpdateRequest requestWithDst = request;
+                requestWithDst.offset += m_DynamicDataOffsetBase; // convert to global offset
+                requestWithDst.stagingMemory = nullptr;
+
+                // Data written directly to the dynamic buffer is not hashed, since reading from write-combined memory is slow
+                if (m_Desc.skipUnchangedBufferUpdates && request.desc.data)
+                    requestWithDst.hash = HashUpdateData((const uint8_t*)request.desc.data, request.desc.dataSize);
+
+                m_BufferRequestsWithDst.push_back(requestWithDst);
             }
         }
 
         // Textures
-        for (TextureUpdateRequest& request : m_TextureRequests) {
+        for (const TextureUpdateRequest& request : requestList.textures) {
             uint8_t* dst = data + request.offset;
-            const TextureDesc& textureDesc = m_NRI.GetTextureDesc(*request.desc.dstTexture);
-
-            Dim_t h = request.desc.dstRegionDesc.height;
-            h = h == WHOLE_SIZE ? GetDimension(deviceDesc.graphicsAPI, textureDesc, 1, request.desc.dstRegionDesc.mipOffset) : h;
-
-            Dim_t d = request.desc.dstRegionDesc.depth;
-            d = d == WHOLE_SIZE ? GetDimension(deviceDesc.graphicsAPI, textureDesc, 2, request.desc.dstRegionDesc.mipOffset) : d;
-
-            uint32_t alignedRowPitch = Align(request.desc.dataRowPitch, deviceDesc.uploadBufferTextureRowAlignment);
-            uint32_t alignedSlicePitch = Align(alignedRowPitch * h, deviceDesc.uploadBufferTextureSliceAlignment);
-
-            for (uint32_t z = 0; z < d; z++) {
-                for (uint32_t y = 0; y < h; y++) {
-                    uint8_t* dstRow = dst + z * alignedSlicePitch + y * alignedRowPitch;
-                    const uint8_t* srcRow = (uint8_t*)request.desc.data + z * request.desc.dataSlicePitch + y * request.desc.dataRowPitch;
-                    memcpy(dstRow, srcRow, request.desc.dataRowPitch);
+            const uint8_t* src = (const uint8_t*)request.desc.data;
+
+            // Slices are contiguous if there is no padding between them (both in the source and in the destination)
+            bool areSlicesContiguous = request.desc.dataSlicePitch == (uint64_t)request.desc.dataRowPitch * request.rowNum
+                && request.alignedSlicePitch == (uint64_t)request.alignedRowPitch * request.rowNum;
+
+            if (request.sliceNum == 1 || areSlicesContiguous)
+                AddCopyJobs(dst, src, request.desc.dataRowPitch, request.alignedRowPitch, request.desc.dataRowPitch, request.rowNum * request.sliceNum);
+            else {
+                for (uint32_t z = 0; z < request.sliceNum; z++) {
+                    uint8_t* dstSlice = dst + (uint64_t)z * request.alignedSlicePitch;
+                    const uint8_t* srcSlice = src + (uint64_t)z * request.desc.dataSlicePitch;
+                    AddCopyJobs(dstSlice, srcSlice, request.desc.dataRowPitch, request.alignedRowPitch, request.desc.dataRowPitch, request.rowNum);
                 }
             }
 
+            copySize += (uint64_t)request.desc.dataRowPitch * request.rowNum * request.sliceNum;
+
             if (request.desc.dstTexture) {
-                request.offset += m_DynamicDataOffsetBase; // convert to global offset
-                m_TextureRequestsWithDst.push_back(request);
+                TextureUpdateRequest requestWithDst = request;
+                requestWithDst.offset += m_DynamicDataOffsetBase; // convert to global offset
+                m_TextureRequestsWithDst.push_back(requestWithDst);
             }
         }
+    }
+
+    // Copy, spreading the work across copy threads if it's worth it
+    if (m_CopyPool && copySize >= STREAMER_PARALLEL_COPY_MIN_SIZE)
+        m_CopyPool->Execute(m_CopyJobs.data(), (uint32_t)m_CopyJobs.size());
+    else {
+        for (const StreamerCopyJob& copyJob : m_CopyJobs)
+            ExecuteCopyJob(copyJob);
+
+        FinishCopyToUploadHeap();
+    }
+
+    m_CopyJobs.clear();
+    m_Stats.copiedSize = copySize;
 
+    CoalesceBufferUploads();
+    m_Stats.uploadCommandNum = (uint32_t)(m_BufferRequestsWithDst.size() + m_TextureRequestsWithDst.size());
+
+    // Source data is not needed anymore
+    for (uint32_t i = 0; i < m_RequestListNum; i++) {
+        StreamerRequestList& requestList = m_RequestLists[i];
+
+        for (BufferUpdateRequest& request : requestList.buffers)
+            FreeStagingMemory(request);
+
+        requestList.buffers.clear();
+        requestList.textures.clear();
+    }
+
+    // Flush "[m_DynamicDataOffsetBase, head)" (a persistently mapped buffer is coherent)
+    if (!m_DynamicBufferData)
         m_NRI.UnmapBuffer(*m_DynamicBuffer);
-    } else
-        return Result::FAILURE;
 
-    // Cleanup
-    m_BufferRequests.clear();
-    m_TextureRequests.clear();
+    if (prevDynamicBufferData && prevDynamicBuffer)
+        m_NRI.UnmapBuffer(*prevDynamicBuffer);
+
+    // The region is in use until the GPU is done with this frame
+    uint64_t head = m_DynamicDataOffsetBase + dynamicDataSize;
+    m_RingSegments.push_back({m_DynamicDataOffsetBase, head, m_FenceValue, 0});
+
+    // Choose the next region: continue if a frame like the heaviest recent one fits, otherwise wrap around (if not wrapped yet)
+    bool isWrapped = m_RingSegments.front().begin >= head;
+    m_DynamicDataOffsetBase = (head + peakFrameSize <= m_DynamicBufferSize || isWrapped) ? head : 0;
+
+    // Shrink after some calm frames (the new buffer is created in the next "CopyUpdateRequests", since this frame's data lives in the current one)
+    if (m_Desc.shrinkFrameNum) {
+        uint64_t shrunkSize = std::max(Align(footprint + footprint / 2, CHUNK_SIZE), CHUNK_SIZE);
+        m_CalmFrameNum = shrunkSize * 2 <= m_DynamicBufferSize ? m_CalmFrameNum + 1 : 0;
+
+        if (m_CalmFrameNum >= m_Desc.shrinkFrameNum) {
+            m_PendingResizeSize = shrunkSize;
+            m_DynamicDataOffsetBase = 0;
+            m_CalmFrameNum = 0;
+        }
+    }
 
-    m_FrameIndex = (m_FrameIndex + 1) % (m_Desc.frameInFlightNum + 1);
+    // Reservations can't be written directly to the region occupied by live data or to a buffer which is going to be replaced
+    m_DirectWriteLimit = m_PendingResizeSize ? 0 : GetRingFreeRegionEnd(m_DynamicDataOffsetBase);
 
-    if (m_FrameIndex == 0)
-        m_DynamicDataOffsetBase = 0;
-    else
-        m_DynamicDataOffsetBase += m_DynamicDataOffset;
+    m_Stats.inFlightSize = 0;
+    for (const StreamerRingSegment& ringSegment : m_RingSegments)
+        m_Stats.inFlightSize += ringSegment.end - ringSegment.begin;
 
-    m_DynamicDataOffset = 0;
+    m_DynamicDataOffset.store(0, std::memory_order_relaxed);
 
     return Result::SUCCESS;
 }
@@ -236,8 +970,8 @@ void StreamerImpl::CmdUploadUpdateRequests(CommandBuffer& commandBuffer) {
     for (const TextureUpdateRequest& request : m_TextureRequestsWithDst) {
         TextureDataLayoutDesc dataLayout = {};
         dataLayout.offset = request.offset;
-        dataLayout.rowPitch = request.desc.dataRowPitch;
-        dataLayout.slicePitch = request.desc.dataSlicePitch;
+        dataLayout.rowPitch = request.alignedRowPitch;
+        dataLayout.slicePitch = request.alignedSlicePitch;
 
         m_NRI.CmdUploadBufferToTexture(commandBuffer, *request.desc.dstTexture, request.desc.dstRegionDesc, *m_DynamicBuffer, dataLayout);
     }
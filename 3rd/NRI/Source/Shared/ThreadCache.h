@@ -0,0 +1,54 @@
+// © 2021 NVIDIA Corporation
+
+#pragma once
+
+constexpr uint32_t THREAD_CACHE_ENTRY_NUM = 4; // Validation + backend, several devices or allocators used alternately on a thread
+
+// Liveness of a thread, referenced by the thread and by owners of caches created for it. The thread clears "isAlive" on exit,
+// letting owners recycle its caches. The last reference frees the token (not owned by a device, so not via "AllocationCallbacks")
+struct ThreadToken {
+    std::atomic_uint32_t refNum;
+    std::atomic_bool isAlive;
+};
+
+ThreadToken* AcquireThreadToken(); // of the calling thread, "nullptr" if out of memory
+void ReleaseThreadToken(ThreadToken* threadToken);
+
+// Per-thread list of caches of different owners, the most recently used first. Owner ids are unique and never "0",
+// so entries of destroyed owners never match and get replaced as the least recently used
+template <typename T>
+struct ThreadCacheEntries {
+    std::array<uint64_t, THREAD_CACHE_ENTRY_NUM> ids;
+    std::array<T*, THREAD_CACHE_ENTRY_NUM> caches;
+
+    inline T* Find(uint64_t id) {
+        if (ids[0] == id)
+            return caches[0];
+
+        for (uint32_t i = 1; i < THREAD_CACHE_ENTRY_NUM; i++) {
+            if (ids[i] == id) {
+                T* cache = caches[i];
+                MoveToFront(i, id, cache);
+
+                return cache;
+            }
+        }
+
+        return nullptr;
+    }
+
+    inline void Add(uint64_t id, T* cache) {
+        MoveToFront(THREAD_CACHE_ENTRY_NUM - 1, id, cache);
+    }
+
+private:
+    inline void MoveToFront(uint32_t i, uint64_t id, T* cache) {
+        for (; i > 0; i--) {
+            ids[i] = ids[i - 1];
+            caches[i] = caches[i - 1];
+        }
+
+        ids[0] = id;
+        caches[0] = cache;
+    }
+};
@@ -84,6 +84,7 @@ void BufferVK::GetMemoryDesc(MemoryLocation memoryLocation, MemoryDesc& memoryDe
         memoryDesc.alignment = (uint32_t)requirements.memoryRequirements.alignment;
         memoryDesc.type = Pack(memoryTypeInfo);
         memoryDesc.mustBeDedicated = memoryTypeInfo.mustBeDedicated;
+        memoryDesc.isHostNonCoherent = m_Device.IsHostNonCoherentMemory(memoryTypeInfo.index);
     }
 }
 
@@ -38,12 +38,18 @@ struct DescriptorPoolVK final : public DebugNameBase {
 
     void Reset();
     Result AllocateDescriptorSets(const PipelineLayout& pipelineLayout, uint32_t setIndex, DescriptorSet** descriptorSets, uint32_t instanceNum, uint32_t variableDescriptorNum);
+    void GetStats(DescriptorPoolStats& descriptorPoolStats);
 
 private:
     DeviceVK& m_Device;
     Vector<DescriptorSetVK*> m_AllocatedSets;
     VkDescriptorPool m_Handle = VK_NULL_HANDLE;
     uint32_t m_UsedSets = 0;
+    uint32_t m_SetMaxNum = 0;
+    uint32_t m_DescriptorNum = 0;
+    uint32_t m_DescriptorMaxNum = 0;
+    uint32_t m_PeakSetNum = 0;
+    uint32_t m_PeakDescriptorNum = 0;
     bool m_OwnsNativeObjects = true;
 };
 
@@ -38,7 +38,12 @@ Result DescriptorPoolVK::Create(const DescriptorPoolDesc& descriptorPoolDesc) {
     AddDescriptorPoolSize(descriptorPoolSizeArray, poolSizeCount, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, descriptorPoolDesc.structuredBufferMaxNum + descriptorPoolDesc.storageStructuredBufferMaxNum);
     AddDescriptorPoolSize(descriptorPoolSizeArray, poolSizeCount, VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR, descriptorPoolDesc.accelerationStructureMaxNum);
 
-    const VkDescriptorPoolCreateInfo info = {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO, nullptr, VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT,
+    m_SetMaxNum = descriptorPoolDesc.descriptorSetMaxNum;
+    for (uint32_t i = 0; i < poolSizeCount; i++)
+        m_DescriptorMaxNum += descriptorPoolSizeArray[i].descriptorCount;
+
+    // No "VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT": sets are never freed individually, which allows drivers to allocate linearly
+    const VkDescriptorPoolCreateInfo info = {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO, nullptr, (VkDescriptorPoolCreateFlags)0,
         descriptorPoolDesc.descriptorSetMaxNum, poolSizeCount, descriptorPoolSizeArray};
 
     const auto& vk = m_Device.GetDispatchTable();
@@ -83,33 +88,66 @@ NRI_INLINE Result DescriptorPoolVK::AllocateDescriptorSets(const PipelineLayout&
     const DescriptorSetDesc& setDesc = bindingInfo.descriptorSetDescs[setIndex];
     bool hasVariableDescriptorNum = bindingInfo.hasVariableDescriptorNum[setIndex];
 
+    // All sets in one call
+    Scratch<VkDescriptorSetLayout> setLayouts = AllocateScratch(m_Device, VkDescriptorSetLayout, instanceNum);
+    Scratch<uint32_t> variableDescriptorNums = AllocateScratch(m_Device, uint32_t, instanceNum);
+    Scratch<VkDescriptorSet> handles = AllocateScratch(m_Device, VkDescriptorSet, instanceNum);
+
+    for (uint32_t i = 0; i < instanceNum; i++) {
+        setLayouts[i] = setLayout;
+        variableDescriptorNums[i] = variableDescriptorNum;
+    }
+
     VkDescriptorSetVariableDescriptorCountAllocateInfo variableDescriptorCountInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO};
-    variableDescriptorCountInfo.descriptorSetCount = 1;
-    variableDescriptorCountInfo.pDescriptorCounts = &variableDescriptorNum;
+    variableDescriptorCountInfo.descriptorSetCount = instanceNum;
+    variableDescriptorCountInfo.pDescriptorCounts = variableDescriptorNums;
 
     VkDescriptorSetAllocateInfo info = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
     info.pNext = hasVariableDescriptorNum ? &variableDescriptorCountInfo : nullptr;
     info.descriptorPool = m_Handle;
-    info.descriptorSetCount = 1;
-    info.pSetLayouts = &setLayout;
+    info.descriptorSetCount = instanceNum;
+    info.pSetLayouts = setLayouts;
 
     const auto& vk = m_Device.GetDispatchTable();
-    for (uint32_t i = 0; i < instanceNum; i++) {
-        VkDescriptorSet handle = VK_NULL_HANDLE;
-        VkResult result = vk.AllocateDescriptorSets(m_Device, &info, &handle);
-        RETURN_ON_FAILURE(&m_Device, result == VK_SUCCESS, GetReturnCode(result), "vkAllocateDescriptorSets returned %d", (int32_t)result);
+    VkResult result = vk.AllocateDescriptorSets(m_Device, &info, handles);
+    RETURN_ON_FAILURE(&m_Device, result == VK_SUCCESS, GetReturnCode(result), "vkAllocateDescriptorSets returned %d", (int32_t)result);
+
+    uint32_t descriptorNum = setDesc.dynamicConstantBufferNum;
+    for (uint32_t i = 0; i < setDesc.rangeNum; i++) {
+        const DescriptorRangeDesc& rangeDesc = setDesc.ranges[i];
+        descriptorNum += (rangeDesc.flags & DescriptorRangeBits::VARIABLE_SIZED_ARRAY) ? variableDescriptorNum : rangeDesc.descriptorNum;
+    }
+
+    m_DescriptorNum += descriptorNum * instanceNum;
 
+    for (uint32_t i = 0; i < instanceNum; i++) {
         descriptorSets[i] = (DescriptorSet*)m_AllocatedSets[m_UsedSets++];
-        ((DescriptorSetVK*)descriptorSets[i])->Create(handle, setDesc);
+        ((DescriptorSetVK*)descriptorSets[i])->Create(handles[i], setDesc);
     }
 
     return Result::SUCCESS;
 }
 
 NRI_INLINE void DescriptorPoolVK::Reset() {
+    m_PeakSetNum = std::max(m_PeakSetNum, m_UsedSets);
+    m_PeakDescriptorNum = std::max(m_PeakDescriptorNum, m_DescriptorNum);
+
     m_UsedSets = 0;
+    m_DescriptorNum = 0;
 
     const auto& vk = m_Device.GetDispatchTable();
     VkResult result = vk.ResetDescriptorPool(m_Device, m_Handle, (VkDescriptorPoolResetFlags)0);
     RETURN_ON_FAILURE(&m_Device, result == VK_SUCCESS, ReturnVoid(), "vkResetDescriptorPool returned %d", (int32_t)result);
 }
+
+NRI_INLINE void DescriptorPoolVK::GetStats(DescriptorPoolStats& descriptorPoolStats) {
+    m_PeakSetNum = std::max(m_PeakSetNum, m_UsedSets);
+    m_PeakDescriptorNum = std::max(m_PeakDescriptorNum, m_DescriptorNum);
+
+    descriptorPoolStats.descriptorSetNum = m_UsedSets;
+    descriptorPoolStats.descriptorSetMaxNum = m_SetMaxNum;
+    descriptorPoolStats.descriptorNum = m_DescriptorNum;
+    descriptorPoolStats.descriptorMaxNum = m_DescriptorMaxNum;
+    descriptorPoolStats.peakDescriptorSetNum = m_PeakSetNum;
+    descriptorPoolStats.peakDescriptorNum = m_PeakDescriptorNum;
+}
@@ -59,10 +59,19 @@ struct DeviceVK final : public DeviceBase {
         return (m_MemoryProps.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
     }
 
+    inline bool IsHostNonCoherentMemory(MemoryTypeIndex memoryTypeIndex) const {
+        VkMemoryPropertyFlags flags = m_MemoryProps.memoryTypes[memoryTypeIndex].propertyFlags & (VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        return flags == VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+    }
+
     inline VmaAllocator_T* GetVma() const {
         return m_Vma;
     }
 
+    inline VkPipelineCache GetPipelineCache() const {
+        return m_PipelineCache;
+    }
+
     template <typename Implementation, typename Interface, typename... Args>
     inline Result CreateImplementation(Interface*& entity, const Args&... args) {
         Implementation* impl = Allocate<Implementation>(GetAllocationCallbacks(), *this);
@@ -127,6 +136,8 @@ struct DeviceVK final : public DeviceBase {
     Result BindBufferMemory(const BufferMemoryBindingDesc* memoryBindingDescs, uint32_t memoryBindingDescNum);
     Result BindTextureMemory(const TextureMemoryBindingDesc* memoryBindingDescs, uint32_t memoryBindingDescNum);
     Result QueryVideoMemoryInfo(MemoryLocation memoryLocation, VideoMemoryInfo& videoMemoryInfo) const;
+    Result MergePipelineCacheData(const void* data, uint64_t dataSize);
+    Result GetPipelineCacheData(void* data, uint64_t& dataSize) const;
     Result BindAccelerationStructureMemory(const AccelerationStructureMemoryBindingDesc* memoryBindingDescs, uint32_t memoryBindingDescNum);
     FormatSupportBits GetFormatSupport(Format format) const;
 
@@ -161,6 +172,7 @@ private:
     VkInstance m_Instance = VK_NULL_HANDLE;
     VkAllocationCallbacks* m_AllocationCallbackPtr = nullptr;
     VkDebugUtilsMessengerEXT m_Messenger = VK_NULL_HANDLE;
+    VkPipelineCache m_PipelineCache = VK_NULL_HANDLE;
     VmaAllocator_T* m_Vma = nullptr;
     uint32_t m_NumActiveFamilyIndices = 0;
     uint32_t m_MinorVersion = 0;
@@ -326,6 +326,9 @@ DeviceVK::~DeviceVK() {
         destroyCallback(m_Instance, m_Messenger, m_AllocationCallbackPtr);
     }
 
+    if (m_PipelineCache)
+        m_VK.DestroyPipelineCache(m_Device, m_PipelineCache, m_AllocationCallbackPtr);
+
     if (m_OwnsNativeObjects) {
         if (m_Device)
             m_VK.DestroyDevice(m_Device, m_AllocationCallbackPtr);
@@ -1096,6 +1099,12 @@ Result DeviceVK::Create(const DeviceCreationDesc& desc, const DeviceCreationVKDe
             m_Desc.shaderModel = 67;
     }
 
+    { // Native pipeline cache, used by all pipelines
+        VkPipelineCacheCreateInfo pipelineCacheCreateInfo = {VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO};
+        VkResult result = m_VK.CreatePipelineCache(m_Device, &pipelineCacheCreateInfo, m_AllocationCallbackPtr, &m_PipelineCache);
+        RETURN_ON_FAILURE(this, result == VK_SUCCESS, GetReturnCode(result), "vkCreatePipelineCache returned %d", (int32_t)result);
+    }
+
     ReportDeviceGroupInfo();
 
     return FillFunctionTable(m_iCore);
@@ -1164,6 +1173,7 @@ void DeviceVK::GetMemoryDesc2(const BufferDesc& bufferDesc, MemoryLocation memor
         memoryDesc.alignment = (uint32_t)requirements.memoryRequirements.alignment;
         memoryDesc.type = Pack(memoryTypeInfo);
         memoryDesc.mustBeDedicated = memoryTypeInfo.mustBeDedicated;
+        memoryDesc.isHostNonCoherent = IsHostNonCoherentMemory(memoryTypeInfo.index);
     }
 }
 
@@ -1191,6 +1201,7 @@ void DeviceVK::GetMemoryDesc2(const TextureDesc& textureDesc, MemoryLocation mem
         memoryDesc.alignment = (uint32_t)requirements.memoryRequirements.alignment;
         memoryDesc.type = Pack(memoryTypeInfo);
         memoryDesc.mustBeDedicated = memoryTypeInfo.mustBeDedicated;
+        memoryDesc.isHostNonCoherent = IsHostNonCoherentMemory(memoryTypeInfo.index);
     }
 }
 
@@ -1655,6 +1666,10 @@ Result DeviceVK::ResolveDispatchTable(const Vector<const char*>& desiredDeviceEx
     GET_DEVICE_CORE_PROC(CreateDescriptorSetLayout);
     GET_DEVICE_CORE_PROC(CreateShaderModule);
     GET_DEVICE_CORE_PROC(CreateGraphicsPipelines);
+    GET_DEVICE_CORE_PROC(CreatePipelineCache);
+    GET_DEVICE_CORE_PROC(DestroyPipelineCache);
+    GET_DEVICE_CORE_PROC(GetPipelineCacheData);
+    GET_DEVICE_CORE_PROC(MergePipelineCaches);
     GET_DEVICE_CORE_PROC(CreateComputePipelines);
     GET_DEVICE_CORE_PROC(DestroyBuffer);
     GET_DEVICE_CORE_PROC(DestroyImage);
@@ -1963,6 +1978,33 @@ NRI_INLINE FormatSupportBits DeviceVK::GetFormatSupport(Format format) const {
     return mask;
 }
 
+NRI_INLINE Result DeviceVK::MergePipelineCacheData(const void* data, uint64_t dataSize) {
+    // Incompatible data (another driver or device) is ignored by "vkCreatePipelineCache"
+    VkPipelineCacheCreateInfo pipelineCacheCreateInfo = {VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO};
+    pipelineCacheCreateInfo.initialDataSize = (size_t)dataSize;
+    pipelineCacheCreateInfo.pInitialData = data;
+
+    VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+    VkResult result = m_VK.CreatePipelineCache(m_Device, &pipelineCacheCreateInfo, m_AllocationCallbackPtr, &pipelineCache);
+    RETURN_ON_FAILURE(this, result == VK_SUCCESS, GetReturnCode(result), "vkCreatePipelineCache returned %d", (int32_t)result);
+
+    result = m_VK.MergePipelineCaches(m_Device, m_PipelineCache, 1, &pipelineCache);
+    m_VK.DestroyPipelineCache(m_Device, pipelineCache, m_AllocationCallbackPtr);
+    RETURN_ON_FAILURE(this, result == VK_SUCCESS, GetReturnCode(result), "vkMergePipelineCaches returned %d", (int32_t)result);
+
+    return Result::SUCCESS;
+}
+
+NRI_INLINE Result DeviceVK::GetPipelineCacheData(void* data, uint64_t& dataSize) const {
+    size_t size = data ? (size_t)dataSize : 0;
+    VkResult result = m_VK.GetPipelineCacheData(m_Device, m_PipelineCache, &size, data);
+    dataSize = size;
+
+    RETURN_ON_FAILURE(this, result == VK_SUCCESS || (!data && result == VK_INCOMPLETE), GetReturnCode(result), "vkGetPipelineCacheData returned %d", (int32_t)result);
+
+    return Result::SUCCESS;
+}
+
 NRI_INLINE Result DeviceVK::QueryVideoMemoryInfo(MemoryLocation memoryLocation, VideoMemoryInfo& videoMemoryInfo) const {
     videoMemoryInfo = {};
 
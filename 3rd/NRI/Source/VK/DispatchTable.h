@@ -75,6 +75,10 @@ struct DispatchTable {
     VULKAN_FUNCTION(CreateDescriptorSetLayout);
     VULKAN_FUNCTION(CreateShaderModule);
     VULKAN_FUNCTION(CreateGraphicsPipelines);
+    VULKAN_FUNCTION(CreatePipelineCache);
+    VULKAN_FUNCTION(DestroyPipelineCache);
+    VULKAN_FUNCTION(GetPipelineCacheData);
+    VULKAN_FUNCTION(MergePipelineCaches);
     VULKAN_FUNCTION(CreateComputePipelines);
     VULKAN_FUNCTION(DestroyBuffer);
     VULKAN_FUNCTION(DestroyImage);
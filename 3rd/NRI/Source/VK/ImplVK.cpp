@@ -19,8 +19,14 @@
 #include "SwapChainVK.h"
 #include "TextureVK.h"
 
+#include "HelperBindlessTable.h"
 #include "HelperDataUpload.h"
+#include "HelperDefragmenter.h"
+#include "HelperDescriptorSetCache.h"
 #include "HelperDeviceMemoryAllocator.h"
+#include "HelperMemoryBudget.h"
+#include "HelperPipelineCache.h"
+#include "HelperTransientPool.h"
 #include "Streamer.h"
 #include "Upscaler.h"
 
@@ -456,6 +462,10 @@ static void NRI_CALL ResetDescriptorPool(DescriptorPool& descriptorPool) {
     ((DescriptorPoolVK&)descriptorPool).Reset();
 }
 
+static void NRI_CALL GetDescriptorPoolStats(const DescriptorPool& descriptorPool, DescriptorPoolStats& descriptorPoolStats) {
+    ((DescriptorPoolVK&)descriptorPool).GetStats(descriptorPoolStats);
+}
+
 static void NRI_CALL ResetCommandAllocator(CommandAllocator& commandAllocator) {
     ((CommandAllocatorVK&)commandAllocator).Reset();
 }
@@ -634,6 +644,7 @@ Result DeviceVK::FillFunctionTable(CoreInterface& table) const {
     table.GetBufferNativeObject = ::GetBufferNativeObject;
     table.GetTextureNativeObject = ::GetTextureNativeObject;
     table.GetDescriptorNativeObject = ::GetDescriptorNativeObject;
+    table.GetDescriptorPoolStats = ::GetDescriptorPoolStats;
 
     return Result::SUCCESS;
 }
@@ -651,6 +662,231 @@ static Result NRI_CALL UploadData(Queue& queue, const TextureUploadDesc* texture
     return helperDataUpload.UploadData(textureUploadDescs, textureUploadDescNum, bufferUploadDescs, bufferUploadDescNum);
 }
 
+static Result NRI_CALL CreateDataUploader(Queue& queue, const DataUploaderDesc& dataUploaderDesc, DataUploader*& dataUploader) {
+    QueueVK& queueVK = (QueueVK&)queue;
+    DeviceVK& deviceVK = queueVK.GetDevice();
+    HelperDataUpload* impl = Allocate<HelperDataUpload>(deviceVK.GetAllocationCallbacks(), deviceVK.GetCoreInterface(), (Device&)deviceVK, queue);
+    Result result = impl->Create(dataUploaderDesc);
+
+    if (result != Result::SUCCESS) {
+        Destroy(deviceVK.GetAllocationCallbacks(), impl);
+        dataUploader = nullptr;
+    } else
+        dataUploader = (DataUploader*)impl;
+
+    return result;
+}
+
+static void NRI_CALL DestroyDataUploader(DataUploader& dataUploader) {
+    Destroy(((DeviceBase&)((HelperDataUpload&)dataUploader).GetDevice()).GetAllocationCallbacks(), (HelperDataUpload*)&dataUploader);
+}
+
+static Result NRI_CALL UploadDataAsync(DataUploader& dataUploader, const TextureUploadDesc* textureUploadDescs, uint32_t textureUploadDescNum, const BufferUploadDesc* bufferUploadDescs, uint32_t bufferUploadDescNum, UploadTicket& uploadTicket) {
+    return ((HelperDataUpload&)dataUploader).UploadData(textureUploadDescs, textureUploadDescNum, bufferUploadDescs, bufferUploadDescNum, uploadTicket);
+}
+
+static Result NRI_CALL CreateDefragmenter(Device& device, const DefragmenterDesc& defragmenterDesc, Defragmenter*& defragmenter) {
+    DeviceVK& deviceVK = (DeviceVK&)device;
+    HelperDefragmenter* impl = Allocate<HelperDefragmenter>(deviceVK.GetAllocationCallbacks(), deviceVK.GetCoreInterface(), device);
+    Result result = impl->Create(defragmenterDesc);
+
+    if (result != Result::SUCCESS) {
+        Destroy(deviceVK.GetAllocationCallbacks(), impl);
+        defragmenter = nullptr;
+    } else
+        defragmenter = (Defragmenter*)impl;
+
+    return result;
+}
+
+static void NRI_CALL DestroyDefragmenter(Defragmenter& defragmenter) {
+    Destroy(((DeviceBase&)((HelperDefragmenter&)defragmenter).GetDevice()).GetAllocationCallbacks(), (HelperDefragmenter*)&defragmenter);
+}
+
+static Result NRI_CALL AllocateAndBindDefragmentableMemory(Defragmenter& defragmenter, const ResourceGroupDesc& resourceGroupDesc) {
+    return ((HelperDefragmenter&)defragmenter).AllocateAndBindMemory(resourceGroupDesc);
+}
+
+static void NRI_CALL ReleaseDefragmentableResources(Defragmenter& defragmenter, Buffer* const* buffers, uint32_t bufferNum, Texture* const* textures, uint32_t textureNum) {
+    ((HelperDefragmenter&)defragmenter).ReleaseResources(buffers, bufferNum, textures, textureNum);
+}
+
+static const DefragmentationMove* NRI_CALL BeginDefragmentation(Defragmenter& defragmenter, uint64_t byteBudget, uint64_t fenceValue, uint32_t& moveNum) {
+    return ((HelperDefragmenter&)defragmenter).BeginDefragmentation(byteBudget, fenceValue, moveNum);
+}
+
+static void NRI_CALL CmdDefragment(CommandBuffer& commandBuffer, Defragmenter& defragmenter) {
+    ((HelperDefragmenter&)defragmenter).CmdDefragment(commandBuffer);
+}
+
+static Result NRI_CALL CreateTransientPool(Device& device, const TransientPoolDesc& transientPoolDesc, TransientPool*& transientPool) {
+    DeviceVK& deviceVK = (DeviceVK&)device;
+    HelperTransientPool* impl = Allocate<HelperTransientPool>(deviceVK.GetAllocationCallbacks(), deviceVK.GetCoreInterface(), device);
+    Result result = impl->Create(transientPoolDesc);
+
+    if (result != Result::SUCCESS) {
+        Destroy(deviceVK.GetAllocationCallbacks(), impl);
+        transientPool = nullptr;
+    } else
+        transientPool = (TransientPool*)impl;
+
+    return result;
+}
+
+static void NRI_CALL DestroyTransientPool(TransientPool& transientPool) {
+    Destroy(((DeviceBase&)((HelperTransientPool&)transientPool).GetDevice()).GetAllocationCallbacks(), (HelperTransientPool*)&transientPool);
+}
+
+static void NRI_CALL GetTransientPoolBarriers(const TransientPool& transientPool, uint32_t pass, BarrierGroupDesc& barrierGroupDesc) {
+    ((HelperTransientPool&)transientPool).GetBarriers(pass, barrierGroupDesc);
+}
+
+static void NRI_CALL GetTransientPoolStats(const TransientPool& transientPool, TransientPoolStats& transientPoolStats) {
+    transientPoolStats = ((HelperTransientPool&)transientPool).GetStats();
+}
+
+static Result NRI_CALL CreateMemoryBudget(Device& device, const MemoryBudgetDesc& memoryBudgetDesc, MemoryBudget*& memoryBudget) {
+    DeviceVK& deviceVK = (DeviceVK&)device;
+    HelperMemoryBudget* impl = Allocate<HelperMemoryBudget>(deviceVK.GetAllocationCallbacks(), deviceVK.GetCoreInterface(), device);
+    Result result = impl->Create(memoryBudgetDesc);
+
+    if (result != Result::SUCCESS) {
+        Destroy(deviceVK.GetAllocationCallbacks(), impl);
+        memoryBudget = nullptr;
+    } else
+        memoryBudget = (MemoryBudget*)impl;
+
+    return result;
+}
+
+static void NRI_CALL DestroyMemoryBudget(MemoryBudget& memoryBudget) {
+    Destroy(((DeviceBase&)((HelperMemoryBudget&)memoryBudget).GetDevice()).GetAllocationCallbacks(), (HelperMemoryBudget*)&memoryBudget);
+}
+
+static Result NRI_CALL AllocateBudgetedMemory(MemoryBudget& memoryBudget, const AllocateMemoryDesc& allocateMemoryDesc, MemoryLocation memoryLocation, Memory*& memory) {
+    return ((HelperMemoryBudget&)memoryBudget).AllocateMemory(allocateMemoryDesc, memoryLocation, memory);
+}
+
+static void NRI_CALL FreeBudgetedMemory(MemoryBudget& memoryBudget, Memory& memory) {
+    ((HelperMemoryBudget&)memoryBudget).FreeMemory(memory);
+}
+
+static void NRI_CALL TouchBudgetedMemory(MemoryBudget& memoryBudget, Memory* const* memories, uint32_t memoryNum) {
+    ((HelperMemoryBudget&)memoryBudget).TouchMemory(memories, memoryNum);
+}
+
+static void NRI_CALL UpdateMemoryBudget(MemoryBudget& memoryBudget) {
+    ((HelperMemoryBudget&)memoryBudget).Update();
+}
+
+static void NRI_CALL GetMemoryBudgetStats(const MemoryBudget& memoryBudget, MemoryLocation memoryLocation, MemoryBudgetStats& memoryBudgetStats) {
+    ((HelperMemoryBudget&)memoryBudget).GetStats(memoryLocation, memoryBudgetStats);
+}
+
+static Result NRI_CALL CreateBindlessTable(Device& device, const BindlessTableDesc& bindlessTableDesc, BindlessTable*& bindlessTable) {
+    DeviceVK& deviceVK = (DeviceVK&)device;
+    HelperBindlessTable* impl = Allocate<HelperBindlessTable>(deviceVK.GetAllocationCallbacks(), deviceVK.GetCoreInterface(), device);
+    Result result = impl->Create(bindlessTableDesc);
+
+    if (result != Result::SUCCESS) {
+        Destroy(deviceVK.GetAllocationCallbacks(), impl);
+        bindlessTable = nullptr;
+    } else
+        bindlessTable = (BindlessTable*)impl;
+
+    return result;
+}
+
+static void NRI_CALL DestroyBindlessTable(BindlessTable& bindlessTable) {
+    Destroy(((DeviceBase&)((HelperBindlessTable&)bindlessTable).GetDevice()).GetAllocationCallbacks(), (HelperBindlessTable*)&bindlessTable);
+}
+
+static Result NRI_CALL AllocateBindlessIndices(BindlessTable& bindlessTable, uint32_t* indices, uint32_t indexNum) {
+    return ((HelperBindlessTable&)bindlessTable).AllocateIndices(indices, indexNum);
+}
+
+static void NRI_CALL FreeBindlessIndices(BindlessTable& bindlessTable, const uint32_t* indices, uint32_t indexNum, uint64_t fenceValue) {
+    ((HelperBindlessTable&)bindlessTable).FreeIndices(indices, indexNum, fenceValue);
+}
+
+static void NRI_CALL WriteBindlessDescriptors(BindlessTable& bindlessTable, const BindlessWriteDesc* bindlessWriteDescs, uint32_t bindlessWriteDescNum) {
+    ((HelperBindlessTable&)bindlessTable).WriteDescriptors(bindlessWriteDescs, bindlessWriteDescNum);
+}
+
+static void NRI_CALL UpdateBindlessTable(BindlessTable& bindlessTable) {
+    ((HelperBindlessTable&)bindlessTable).Update();
+}
+
+static DescriptorSet* NRI_CALL GetBindlessTableDescriptorSet(const BindlessTable& bindlessTable) {
+    return ((HelperBindlessTable&)bindlessTable).GetDescriptorSet();
+}
+
+static Result NRI_CALL CreateDescriptorSetCache(Device& device, const DescriptorSetCacheDesc& descriptorSetCacheDesc, DescriptorSetCache*& descriptorSetCache) {
+    DeviceVK& deviceVK = (DeviceVK&)device;
+
+    HelperDescriptorSetCache* impl = Allocate<HelperDescriptorSetCache>(deviceVK.GetAllocationCallbacks(), deviceVK.GetCoreInterface(), device);
+    Result result = impl->Create(descriptorSetCacheDesc);
+
+    if (result != Result::SUCCESS) {
+        Destroy(deviceVK.GetAllocationCallbacks(), impl);
+        descriptorSetCache = nullptr;
+    } else
+        descriptorSetCache = (DescriptorSetCache*)impl;
+
+    return result;
+}
+
+static void NRI_CALL DestroyDescriptorSetCache(DescriptorSetCache& descriptorSetCache) {
+    Destroy(((DeviceBase&)((HelperDescriptorSetCache&)descriptorSetCache).GetDevice()).GetAllocationCallbacks(), (HelperDescriptorSetCache*)&descriptorSetCache);
+}
+
+static Result NRI_CALL GetCachedDescriptorSet(DescriptorSetCache& descriptorSetCache, const CachedDescriptorSetDesc& cachedDescriptorSetDesc, uint64_t fenceValue, DescriptorSet*& descriptorSet) {
+    return ((HelperDescriptorSetCache&)descriptorSetCache).GetDescriptorSet(cachedDescriptorSetDesc, fenceValue, descriptorSet);
+}
+
+static void NRI_CALL PurgeCachedDescriptorSets(DescriptorSetCache& descriptorSetCache, const Descriptor* const* descriptors, uint32_t descriptorNum) {
+    ((HelperDescriptorSetCache&)descriptorSetCache).Purge(descriptors, descriptorNum);
+}
+
+static void NRI_CALL GetDescriptorSetCacheStats(const DescriptorSetCache& descriptorSetCache, DescriptorSetCacheStats& descriptorSetCacheStats) {
+    ((HelperDescriptorSetCache&)descriptorSetCache).GetStats(descriptorSetCacheStats);
+}
+
+static Result NRI_CALL CreatePipelineCache(Device& device, const PipelineCacheDesc& pipelineCacheDesc, PipelineCache*& pipelineCache) {
+    DeviceVK& deviceVK = (DeviceVK&)device;
+
+    HelperPipelineCache* impl = Allocate<HelperPipelineCache>(deviceVK.GetAllocationCallbacks(), deviceVK.GetCoreInterface(), device);
+    Result result = impl->Create(pipelineCacheDesc);
+
+    if (result != Result::SUCCESS) {
+        Destroy(deviceVK.GetAllocationCallbacks(), impl);
+        pipelineCache = nullptr;
+    } else
+        pipelineCache = (PipelineCache*)impl;
+
+    return result;
+}
+
+static void NRI_CALL DestroyPipelineCache(PipelineCache& pipelineCache) {
+    Destroy(((DeviceBase&)((HelperPipelineCache&)pipelineCache).GetDevice()).GetAllocationCallbacks(), (HelperPipelineCache*)&pipelineCache);
+}
+
+static Result NRI_CALL GetCachedGraphicsPipeline(PipelineCache& pipelineCache, const GraphicsPipelineDesc& graphicsPipelineDesc, Pipeline*& pipeline) {
+    return ((HelperPipelineCache&)pipelineCache).GetGraphicsPipeline(graphicsPipelineDesc, pipeline);
+}
+
+static Result NRI_CALL GetCachedComputePipeline(PipelineCache& pipelineCache, const ComputePipelineDesc& computePipelineDesc, Pipeline*& pipeline) {
+    return ((HelperPipelineCache&)pipelineCache).GetComputePipeline(computePipelineDesc, pipeline);
+}
+
+static void NRI_CALL PurgeCachedPipelines(PipelineCache& pipelineCache, const PipelineLayout& pipelineLayout) {
+    ((HelperPipelineCache&)pipelineCache).Purge(pipelineLayout);
+}
+
+static void NRI_CALL GetPipelineCacheStats(const PipelineCache& pipelineCache, PipelineCacheStats& pipelineCacheStats) {
+    ((HelperPipelineCache&)pipelineCache).GetStats(pipelineCacheStats);
+}
+
 static Result NRI_CALL WaitForIdle(Queue& queue) {
     if (!(&queue))
         return Result::SUCCESS;
@@ -676,12 +912,60 @@ static Result NRI_CALL QueryVideoMemoryInfo(const Device& device, MemoryLocation
     return ((DeviceVK&)device).QueryVideoMemoryInfo(memoryLocation, videoMemoryInfo);
 }
 
+static Result NRI_CALL MergePipelineCacheData(Device& device, const void* data, uint64_t dataSize) {
+    return ((DeviceVK&)device).MergePipelineCacheData(data, dataSize);
+}
+
+static Result NRI_CALL GetPipelineCacheData(const Device& device, void* data, uint64_t& dataSize) {
+    return ((DeviceVK&)device).GetPipelineCacheData(data, dataSize);
+}
+
 Result DeviceVK::FillFunctionTable(HelperInterface& table) const {
     table.CalculateAllocationNumber = ::CalculateAllocationNumber;
     table.AllocateAndBindMemory = ::AllocateAndBindMemory;
     table.UploadData = ::UploadData;
+    table.CreateDataUploader = ::CreateDataUploader;
+    table.DestroyDataUploader = ::DestroyDataUploader;
+    table.UploadDataAsync = ::UploadDataAsync;
+    table.CreateDefragmenter = ::CreateDefragmenter;
+    table.DestroyDefragmenter = ::DestroyDefragmenter;
+    table.AllocateAndBindDefragmentableMemory = ::AllocateAndBindDefragmentableMemory;
+    table.ReleaseDefragmentableResources = ::ReleaseDefragmentableResources;
+    table.BeginDefragmentation = ::BeginDefragmentation;
+    table.CmdDefragment = ::CmdDefragment;
+    table.CreateTransientPool = ::CreateTransientPool;
+    table.DestroyTransientPool = ::DestroyTransientPool;
+    table.GetTransientPoolBarriers = ::GetTransientPoolBarriers;
+    table.GetTransientPoolStats = ::GetTransientPoolStats;
+    table.CreateMemoryBudget = ::CreateMemoryBudget;
+    table.DestroyMemoryBudget = ::DestroyMemoryBudget;
+    table.AllocateBudgetedMemory = ::AllocateBudgetedMemory;
+    table.FreeBudgetedMemory = ::FreeBudgetedMemory;
+    table.TouchBudgetedMemory = ::TouchBudgetedMemory;
+    table.UpdateMemoryBudget = ::UpdateMemoryBudget;
+    table.GetMemoryBudgetStats = ::GetMemoryBudgetStats;
+    table.CreateBindlessTable = ::CreateBindlessTable;
+    table.DestroyBindlessTable = ::DestroyBindlessTable;
+    table.AllocateBindlessIndices = ::AllocateBindlessIndices;
+    table.FreeBindlessIndices = ::FreeBindlessIndices;
+    table.WriteBindlessDescriptors = ::WriteBindlessDescriptors;
+    table.UpdateBindlessTable = ::UpdateBindlessTable;
+    table.GetBindlessTableDescriptorSet = ::GetBindlessTableDescriptorSet;
+    table.CreateDescriptorSetCache = ::CreateDescriptorSetCache;
+    table.DestroyDescriptorSetCache = ::DestroyDescriptorSetCache;
+    table.GetCachedDescriptorSet = ::GetCachedDescriptorSet;
+    table.PurgeCachedDescriptorSets = ::PurgeCachedDescriptorSets;
+    table.GetDescriptorSetCacheStats = ::GetDescriptorSetCacheStats;
+    table.CreatePipelineCache = ::CreatePipelineCache;
+    table.DestroyPipelineCache = ::DestroyPipelineCache;
+    table.GetCachedGraphicsPipeline = ::GetCachedGraphicsPipeline;
+    table.GetCachedComputePipeline = ::GetCachedComputePipeline;
+    table.PurgeCachedPipelines = ::PurgeCachedPipelines;
+    table.GetPipelineCacheStats = ::GetPipelineCacheStats;
     table.WaitForIdle = ::WaitForIdle;
     table.QueryVideoMemoryInfo = ::QueryVideoMemoryInfo;
+    table.MergePipelineCacheData = ::MergePipelineCacheData;
+    table.GetPipelineCacheData = ::GetPipelineCacheData;
 
     return Result::SUCCESS;
 }
@@ -922,6 +1206,10 @@ static uint32_t UpdateStreamerConstantBuffer(Streamer& streamer, const void* dat
     return ((StreamerImpl&)streamer).UpdateConstantBuffer(data, dataSize);
 }
 
+static void UpdateStreamerConstantBuffers(Streamer& streamer, const ConstantBufferUpdateRequestDesc* constantBufferUpdateRequestDescs, uint32_t constantBufferUpdateRequestDescNum, uint32_t* offsets) {
+    ((StreamerImpl&)streamer).UpdateConstantBuffers(constantBufferUpdateRequestDescs, constantBufferUpdateRequestDescNum, offsets);
+}
+
 static uint64_t AddStreamerBufferUpdateRequest(Streamer& streamer, const BufferUpdateRequestDesc& bufferUpdateRequestDesc) {
     return ((StreamerImpl&)streamer).AddBufferUpdateRequest(bufferUpdateRequestDesc);
 }
@@ -930,10 +1218,22 @@ static uint64_t AddStreamerTextureUpdateRequest(Streamer& streamer, const Textur
     return ((StreamerImpl&)streamer).AddTextureUpdateRequest(textureUpdateRequestDesc);
 }
 
+static void* ReserveStreamerBufferUpdateRequest(Streamer& streamer, const BufferUpdateRequestDesc& bufferUpdateRequestDesc, uint64_t& offset) {
+    return ((StreamerImpl&)streamer).ReserveBufferUpdateRequest(bufferUpdateRequestDesc, offset);
+}
+
+static void SetStreamerFenceValue(Streamer& streamer, uint64_t fenceValue) {
+    ((StreamerImpl&)streamer).SetFenceValue(fenceValue);
+}
+
 static Result CopyStreamerUpdateRequests(Streamer& streamer) {
     return ((StreamerImpl&)streamer).CopyUpdateRequests();
 }
 
+static void GetStreamerStats(const Streamer& streamer, StreamerStats& streamerStats) {
+    ((StreamerImpl&)streamer).GetStats(streamerStats);
+}
+
 static Buffer* GetStreamerDynamicBuffer(Streamer& streamer) {
     return ((StreamerImpl&)streamer).GetDynamicBuffer();
 }
@@ -949,8 +1249,12 @@ Result DeviceVK::FillFunctionTable(StreamerInterface& table) const {
     table.GetStreamerDynamicBuffer = ::GetStreamerDynamicBuffer;
     table.AddStreamerBufferUpdateRequest = ::AddStreamerBufferUpdateRequest;
     table.AddStreamerTextureUpdateRequest = ::AddStreamerTextureUpdateRequest;
+    table.ReserveStreamerBufferUpdateRequest = ::ReserveStreamerBufferUpdateRequest;
     table.UpdateStreamerConstantBuffer = ::UpdateStreamerConstantBuffer;
+    table.UpdateStreamerConstantBuffers = ::UpdateStreamerConstantBuffers;
+    table.SetStreamerFenceValue = ::SetStreamerFenceValue;
     table.CopyStreamerUpdateRequests = ::CopyStreamerUpdateRequests;
+    table.GetStreamerStats = ::GetStreamerStats;
     table.CmdUploadStreamerUpdateRequests = ::CmdUploadStreamerUpdateRequests;
 
     return Result::SUCCESS;
@@ -301,7 +301,7 @@ Result PipelineVK::Create(const GraphicsPipelineDesc& graphicsPipelineDesc) {
         pipelineRenderingCreateInfo.pNext = &robustnessInfo;
 
     const auto& vk = m_Device.GetDispatchTable();
-    const VkResult vkResult = vk.CreateGraphicsPipelines(m_Device, VK_NULL_HANDLE, 1, &info, m_Device.GetVkAllocationCallbacks(), &m_Handle);
+    const VkResult vkResult = vk.CreateGraphicsPipelines(m_Device, m_Device.GetPipelineCache(), 1, &info, m_Device.GetVkAllocationCallbacks(), &m_Handle);
     RETURN_ON_FAILURE(&m_Device, vkResult == VK_SUCCESS, GetReturnCode(vkResult), "vkCreateGraphicsPipelines returned %d", (int32_t)vkResult);
 
     for (size_t i = 0; i < graphicsPipelineDesc.shaderNum; i++)
@@ -352,7 +352,7 @@ Result PipelineVK::Create(const ComputePipelineDesc& computePipelineDesc) {
     if (FillPipelineRobustness(m_Device, computePipelineDesc.robustness, robustnessInfo))
         info.pNext = &robustnessInfo;
 
-    result = vk.CreateComputePipelines(m_Device, VK_NULL_HANDLE, 1, &info, m_Device.GetVkAllocationCallbacks(), &m_Handle);
+    result = vk.CreateComputePipelines(m_Device, m_Device.GetPipelineCache(), 1, &info, m_Device.GetVkAllocationCallbacks(), &m_Handle);
     RETURN_ON_FAILURE(&m_Device, result == VK_SUCCESS, GetReturnCode(result), "vkCreateComputePipelines returned %d", (int32_t)result);
 
     vk.DestroyShaderModule(m_Device, module, m_Device.GetVkAllocationCallbacks());
@@ -442,7 +442,7 @@ Result PipelineVK::Create(const RayTracingPipelineDesc& rayTracingPipelineDesc)
         createInfo.pNext = &robustnessInfo;
 
     const auto& vk = m_Device.GetDispatchTable();
-    const VkResult vkResult = vk.CreateRayTracingPipelinesKHR(m_Device, VK_NULL_HANDLE, VK_NULL_HANDLE, 1, &createInfo, m_Device.GetVkAllocationCallbacks(), &m_Handle);
+    const VkResult vkResult = vk.CreateRayTracingPipelinesKHR(m_Device, VK_NULL_HANDLE, m_Device.GetPipelineCache(), 1, &createInfo, m_Device.GetVkAllocationCallbacks(), &m_Handle);
     RETURN_ON_FAILURE(&m_Device, vkResult == VK_SUCCESS, GetReturnCode(vkResult), "vkCreateRayTracingPipelinesKHR returned %d", (int32_t)vkResult);
 
     for (size_t i = 0; i < stageNum; i++)
@@ -69,6 +69,7 @@ void TextureVK::GetMemoryDesc(MemoryLocation memoryLocation, MemoryDesc& memoryD
         memoryDesc.alignment = (uint32_t)requirements.memoryRequirements.alignment;
         memoryDesc.type = Pack(memoryTypeInfo);
         memoryDesc.mustBeDedicated = memoryTypeInfo.mustBeDedicated;
+        memoryDesc.isHostNonCoherent = m_Device.IsHostNonCoherentMemory(memoryTypeInfo.index);
     }
 }
 
@@ -28,6 +28,10 @@ struct AccelerationStructureVal final : public ObjectVal {
         m_IsBoundToMemory = true;
     }
 
+    inline MemoryBindingVal& GetMemoryBinding() {
+        return m_MemoryBinding;
+    }
+
     inline const MemoryDesc& GetMemoryDesc() const {
         return m_MemoryDesc;
     }
@@ -45,6 +49,7 @@ struct AccelerationStructureVal final : public ObjectVal {
 
 private:
     MemoryVal* m_Memory = nullptr;
+    MemoryBindingVal m_MemoryBinding = {};
     MemoryDesc m_MemoryDesc = {};
     bool m_IsBoundToMemory = false;
 };
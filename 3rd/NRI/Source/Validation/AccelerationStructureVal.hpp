@@ -38,7 +38,7 @@ NRI_INLINE Result AccelerationStructureVal::CreateDescriptor(Descriptor*& descri
     const Result result = GetRayTracingInterface().CreateAccelerationStructureDescriptor(*GetImpl(), descriptorImpl);
 
     if (result == Result::SUCCESS)
-        descriptor = (Descriptor*)Allocate<DescriptorVal>(m_Device.GetAllocationCallbacks(), m_Device, descriptorImpl, ResourceType::ACCELERATION_STRUCTURE);
+        descriptor = (Descriptor*)Allocate<DescriptorVal>(m_Device.GetObjectPool(), m_Device, descriptorImpl, ResourceType::ACCELERATION_STRUCTURE);
 
     return result;
 }
@@ -36,6 +36,10 @@ struct BufferVal final : public ObjectVal {
         m_IsBoundToMemory = true;
     }
 
+    inline MemoryBindingVal& GetMemoryBinding() {
+        return m_MemoryBinding;
+    }
+
     //================================================================================================================
     // NRI
     //================================================================================================================
@@ -46,6 +50,7 @@ struct BufferVal final : public ObjectVal {
 private:
     BufferDesc m_Desc = {}; // (only for) .natvis
     MemoryVal* m_Memory = nullptr;
+    MemoryBindingVal m_MemoryBinding = {};
     bool m_IsBoundToMemory = false;
     bool m_IsMapped = false;
 };
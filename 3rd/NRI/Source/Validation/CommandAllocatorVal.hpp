@@ -5,7 +5,7 @@ NRI_INLINE Result CommandAllocatorVal::CreateCommandBuffer(CommandBuffer*& comma
     const Result result = GetCoreInterface().CreateCommandBuffer(*GetImpl(), commandBufferImpl);
 
     if (result == Result::SUCCESS)
-        commandBuffer = (CommandBuffer*)Allocate<CommandBufferVal>(m_Device.GetAllocationCallbacks(), m_Device, commandBufferImpl, false);
+        commandBuffer = (CommandBuffer*)Allocate<CommandBufferVal>(m_Device.GetObjectPool(), m_Device, commandBufferImpl, false);
 
     return result;
 }
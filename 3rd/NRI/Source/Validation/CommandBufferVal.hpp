@@ -422,14 +422,16 @@ NRI_INLINE void CommandBufferVal::Barrier(const BarrierGroupDesc& barrierGroupDe
     RETURN_ON_FAILURE(&m_Device, m_IsRecordingStarted, ReturnVoid(), "the command buffer must be in the recording state");
     RETURN_ON_FAILURE(&m_Device, !m_IsRenderPass, ReturnVoid(), "must be called outside of 'CmdBeginRendering/CmdEndRendering'");
 
-    for (uint32_t i = 0; i < barrierGroupDesc.bufferNum; i++) {
-        if (!ValidateBufferBarrierDesc(m_Device, i, barrierGroupDesc.buffers[i]))
-            return;
-    }
+    if (m_Device.IsExpensiveCheckEnabled(ValidationBits::BARRIERS)) {
+        for (uint32_t i = 0; i < barrierGroupDesc.bufferNum; i++) {
+            if (!ValidateBufferBarrierDesc(m_Device, i, barrierGroupDesc.buffers[i]))
+                return;
+        }
 
-    for (uint32_t i = 0; i < barrierGroupDesc.textureNum; i++) {
-        if (!ValidateTextureBarrierDesc(m_Device, i, barrierGroupDesc.textures[i]))
-            return;
+        for (uint32_t i = 0; i < barrierGroupDesc.textureNum; i++) {
+            if (!ValidateTextureBarrierDesc(m_Device, i, barrierGroupDesc.textures[i]))
+                return;
+        }
     }
 
     Scratch<BufferBarrierDesc> buffers = AllocateScratch(m_Device, BufferBarrierDesc, barrierGroupDesc.bufferNum);
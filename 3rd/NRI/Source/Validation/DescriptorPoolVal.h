@@ -37,6 +37,7 @@ struct DescriptorPoolVal final : public ObjectVal {
 
     void Reset();
     Result AllocateDescriptorSets(const PipelineLayout& pipelineLayout, uint32_t setIndex, DescriptorSet** descriptorSets, uint32_t instanceNum, uint32_t variableDescriptorNum);
+    void GetStats(DescriptorPoolStats& descriptorPoolStats) const;
 
 private:
     DescriptorPoolDesc m_Desc = {}; // .natvis
@@ -18,69 +18,46 @@ NRI_INLINE void DescriptorPoolVal::Reset() {
 
 NRI_INLINE Result DescriptorPoolVal::AllocateDescriptorSets(const PipelineLayout& pipelineLayout, uint32_t setIndex, DescriptorSet** descriptorSets, uint32_t instanceNum, uint32_t variableDescriptorNum) {
     RETURN_ON_FAILURE(&m_Device, instanceNum != 0, Result::INVALID_ARGUMENT, "'instanceNum' is 0");
-    RETURN_ON_FAILURE(&m_Device, m_DescriptorSetsNum + instanceNum <= m_Desc.descriptorSetMaxNum, Result::INVALID_ARGUMENT, "the maximum number of descriptor sets exceeded");
+    RETURN_ON_FAILURE(&m_Device, m_DescriptorSetsNum + instanceNum <= m_Desc.descriptorSetMaxNum, Result::OUT_OF_MEMORY, "the maximum number of descriptor sets exceeded");
 
     const PipelineLayoutVal& pipelineLayoutVal = (const PipelineLayoutVal&)pipelineLayout;
     const PipelineLayoutDesc& pipelineLayoutDesc = pipelineLayoutVal.GetPipelineLayoutDesc();
     RETURN_ON_FAILURE(&m_Device, m_SkipValidation || setIndex < pipelineLayoutDesc.descriptorSetNum, Result::INVALID_ARGUMENT, "'setIndex' is invalid");
 
     const DescriptorSetDesc& descriptorSetDesc = pipelineLayoutDesc.descriptorSets[setIndex];
+
+    // Counted per instance, committed only if the allocation succeeds
+    std::array<uint32_t, (size_t)DescriptorType::MAX_NUM> descriptorNums = {};
     if (!m_SkipValidation) {
-        for (uint32_t i = 0; i < instanceNum; i++) {
-            for (uint32_t j = 0; j < descriptorSetDesc.rangeNum; j++) {
-                const DescriptorRangeDesc& rangeDesc = descriptorSetDesc.ranges[j];
-                RETURN_ON_FAILURE(&m_Device, (uint32_t)rangeDesc.descriptorType < (uint32_t)nri::DescriptorType::MAX_NUM, Result::INVALID_ARGUMENT, "Invalid DescriptorType=%u", (uint32_t)rangeDesc.descriptorType);
-
-                uint32_t descriptorNum = (rangeDesc.flags & DescriptorRangeBits::VARIABLE_SIZED_ARRAY) ? variableDescriptorNum : rangeDesc.descriptorNum;
-                RETURN_ON_FAILURE(&m_Device, descriptorNum <= rangeDesc.descriptorNum, Result::INVALID_ARGUMENT, "'variableDescriptorNum=%u' is greater than 'descriptorNum=%u'", variableDescriptorNum, rangeDesc.descriptorNum);
-
-                bool enoughDescriptors = false;
-                switch (rangeDesc.descriptorType) {
-                    case DescriptorType::SAMPLER:
-                        m_SamplerNum += descriptorNum;
-                        enoughDescriptors = m_SamplerNum <= m_Desc.samplerMaxNum;
-                        break;
-                    case DescriptorType::CONSTANT_BUFFER:
-                        m_ConstantBufferNum += descriptorNum;
-                        enoughDescriptors = m_ConstantBufferNum <= m_Desc.constantBufferMaxNum;
-                        break;
-                    case DescriptorType::TEXTURE:
-                        m_TextureNum += descriptorNum;
-                        enoughDescriptors = m_TextureNum <= m_Desc.textureMaxNum;
-                        break;
-                    case DescriptorType::STORAGE_TEXTURE:
-                        m_StorageTextureNum += descriptorNum;
-                        enoughDescriptors = m_StorageTextureNum <= m_Desc.storageTextureMaxNum;
-                        break;
-                    case DescriptorType::BUFFER:
-                        m_BufferNum += descriptorNum;
-                        enoughDescriptors = m_BufferNum <= m_Desc.bufferMaxNum;
-                        break;
-                    case DescriptorType::STORAGE_BUFFER:
-                        m_StorageBufferNum += descriptorNum;
-                        enoughDescriptors = m_StorageBufferNum <= m_Desc.storageBufferMaxNum;
-                        break;
-                    case DescriptorType::STRUCTURED_BUFFER:
-                        m_StructuredBufferNum += descriptorNum;
-                        enoughDescriptors = m_StructuredBufferNum <= m_Desc.structuredBufferMaxNum;
-                        break;
-                    case DescriptorType::STORAGE_STRUCTURED_BUFFER:
-                        m_StorageStructuredBufferNum += descriptorNum;
-                        enoughDescriptors = m_StorageStructuredBufferNum <= m_Desc.storageStructuredBufferMaxNum;
-                        break;
-                    case DescriptorType::ACCELERATION_STRUCTURE:
-                        m_AccelerationStructureNum += descriptorNum;
-                        enoughDescriptors = m_AccelerationStructureNum <= m_Desc.accelerationStructureMaxNum;
-                        break;
-                }
-
-                RETURN_ON_FAILURE(&m_Device, enoughDescriptors, Result::INVALID_ARGUMENT, "the maximum number of '%s' descriptors in DescriptorPool exceeded at DescriptorSet instance #%u", GetDescriptorTypeName(rangeDesc.descriptorType), i);
-            }
-
-            m_DynamicConstantBufferNum += descriptorSetDesc.dynamicConstantBufferNum;
-            RETURN_ON_FAILURE(&m_Device, m_DynamicConstantBufferNum <= m_Desc.dynamicConstantBufferMaxNum, Result::INVALID_ARGUMENT,
-                "the maximum number of 'DYNAMIC_CONSTANT_BUFFER' descriptors in DescriptorPool exceeded at DescriptorSet instance #%u", i);
+        for (uint32_t j = 0; j < descriptorSetDesc.rangeNum; j++) {
+            const DescriptorRangeDesc& rangeDesc = descriptorSetDesc.ranges[j];
+            RETURN_ON_FAILURE(&m_Device, (uint32_t)rangeDesc.descriptorType < (uint32_t)nri::DescriptorType::MAX_NUM, Result::INVALID_ARGUMENT, "Invalid DescriptorType=%u", (uint32_t)rangeDesc.descriptorType);
+
+            uint32_t descriptorNum = (rangeDesc.flags & DescriptorRangeBits::VARIABLE_SIZED_ARRAY) ? variableDescriptorNum : rangeDesc.descriptorNum;
+            RETURN_ON_FAILURE(&m_Device, descriptorNum <= rangeDesc.descriptorNum, Result::INVALID_ARGUMENT, "'variableDescriptorNum=%u' is greater than 'descriptorNum=%u'", variableDescriptorNum, rangeDesc.descriptorNum);
+
+            descriptorNums[(size_t)rangeDesc.descriptorType] += descriptorNum;
+        }
+
+        const std::array<std::pair<uint32_t, uint32_t>, (size_t)DescriptorType::MAX_NUM> usedAndMaxNums = {{
+            {m_SamplerNum, m_Desc.samplerMaxNum},
+            {m_ConstantBufferNum, m_Desc.constantBufferMaxNum},
+            {m_TextureNum, m_Desc.textureMaxNum},
+            {m_StorageTextureNum, m_Desc.storageTextureMaxNum},
+            {m_BufferNum, m_Desc.bufferMaxNum},
+            {m_StorageBufferNum, m_Desc.storageBufferMaxNum},
+            {m_StructuredBufferNum, m_Desc.structuredBufferMaxNum},
+            {m_StorageStructuredBufferNum, m_Desc.storageStructuredBufferMaxNum},
+            {m_AccelerationStructureNum, m_Desc.accelerationStructureMaxNum},
+        }};
+
+        for (uint32_t i = 0; i < (uint32_t)DescriptorType::MAX_NUM; i++) {
+            bool enoughDescriptors = usedAndMaxNums[i].first + (uint64_t)descriptorNums[i] * instanceNum <= usedAndMaxNums[i].second;
+            RETURN_ON_FAILURE(&m_Device, enoughDescriptors, Result::OUT_OF_MEMORY, "the maximum number of '%s' descriptors in DescriptorPool exceeded", GetDescriptorTypeName((DescriptorType)i));
         }
+
+        bool enoughDynamicConstantBuffers = m_DynamicConstantBufferNum + (uint64_t)descriptorSetDesc.dynamicConstantBufferNum * instanceNum <= m_Desc.dynamicConstantBufferMaxNum;
+        RETURN_ON_FAILURE(&m_Device, enoughDynamicConstantBuffers, Result::OUT_OF_MEMORY, "the maximum number of 'DYNAMIC_CONSTANT_BUFFER' descriptors in DescriptorPool exceeded");
     }
 
     PipelineLayout* pipelineLayoutImpl = NRI_GET_IMPL(PipelineLayout, &pipelineLayout);
@@ -89,6 +66,19 @@ NRI_INLINE Result DescriptorPoolVal::AllocateDescriptorSets(const PipelineLayout
     if (result != Result::SUCCESS)
         return result;
 
+    m_SamplerNum += descriptorNums[(size_t)DescriptorType::SAMPLER] * instanceNum;
+    m_ConstantBufferNum += descriptorNums[(size_t)DescriptorType::CONSTANT_BUFFER] * instanceNum;
+    m_TextureNum += descriptorNums[(size_t)DescriptorType::TEXTURE] * instanceNum;
+    m_StorageTextureNum += descriptorNums[(size_t)DescriptorType::STORAGE_TEXTURE] * instanceNum;
+    m_BufferNum += descriptorNums[(size_t)DescriptorType::BUFFER] * instanceNum;
+    m_StorageBufferNum += descriptorNums[(size_t)DescriptorType::STORAGE_BUFFER] * instanceNum;
+    m_StructuredBufferNum += descriptorNums[(size_t)DescriptorType::STRUCTURED_BUFFER] * instanceNum;
+    m_StorageStructuredBufferNum += descriptorNums[(size_t)DescriptorType::STORAGE_STRUCTURED_BUFFER] * instanceNum;
+    m_AccelerationStructureNum += descriptorNums[(size_t)DescriptorType::ACCELERATION_STRUCTURE] * instanceNum;
+
+    if (!m_SkipValidation)
+        m_DynamicConstantBufferNum += descriptorSetDesc.dynamicConstantBufferNum * instanceNum;
+
     for (uint32_t i = 0; i < instanceNum; i++) {
         DescriptorSetVal* descriptorSetVal = &m_DescriptorSets[m_DescriptorSetsNum++];
         descriptorSetVal->SetImpl(descriptorSets[i], &descriptorSetDesc);
@@ -97,3 +87,7 @@ NRI_INLINE Result DescriptorPoolVal::AllocateDescriptorSets(const PipelineLayout
 
     return result;
 }
+
+NRI_INLINE void DescriptorPoolVal::GetStats(DescriptorPoolStats& descriptorPoolStats) const {
+    GetCoreInterface().GetDescriptorPoolStats(*GetImpl(), descriptorPoolStats);
+}
@@ -9,25 +9,30 @@ NRI_INLINE void DescriptorSetVal::UpdateDescriptorRanges(uint32_t rangeOffset, u
     for (uint32_t i = 0; i < rangeNum; i++)
         descriptorNum += rangeUpdateDescs[i].descriptorNum;
 
+    bool isCheckEnabled = m_Device.IsExpensiveCheckEnabled(ValidationBits::DESCRIPTORS);
+
     Scratch<DescriptorRangeUpdateDesc> rangeUpdateDescsImpl = AllocateScratch(m_Device, DescriptorRangeUpdateDesc, rangeNum);
     Scratch<Descriptor*> descriptorsImpl = AllocateScratch(m_Device, Descriptor*, descriptorNum);
     for (uint32_t i = 0; i < rangeNum; i++) {
         const DescriptorRangeUpdateDesc& updateDesc = rangeUpdateDescs[i];
         const DescriptorRangeDesc& rangeDesc = GetDesc().ranges[rangeOffset + i];
 
-        RETURN_ON_FAILURE(&m_Device, updateDesc.descriptorNum != 0, ReturnVoid(), "'[%u].descriptorNum' is 0", i);
-        RETURN_ON_FAILURE(&m_Device, updateDesc.descriptors != nullptr, ReturnVoid(), "'[%u].descriptors' is NULL", i);
+        if (isCheckEnabled) {
+            RETURN_ON_FAILURE(&m_Device, updateDesc.descriptorNum != 0, ReturnVoid(), "'[%u].descriptorNum' is 0", i);
+            RETURN_ON_FAILURE(&m_Device, updateDesc.descriptors != nullptr, ReturnVoid(), "'[%u].descriptors' is NULL", i);
 
-        RETURN_ON_FAILURE(&m_Device, updateDesc.baseDescriptor + updateDesc.descriptorNum <= rangeDesc.descriptorNum, ReturnVoid(),
-            "[%u]: 'baseDescriptor=%u' + 'descriptorNum=%u' is greater than 'descriptorNum=%u' in the range (descriptorType=%s)",
-            i, updateDesc.baseDescriptor, updateDesc.descriptorNum, rangeDesc.descriptorNum, GetDescriptorTypeName(rangeDesc.descriptorType));
+            RETURN_ON_FAILURE(&m_Device, updateDesc.baseDescriptor + updateDesc.descriptorNum <= rangeDesc.descriptorNum, ReturnVoid(),
+                "[%u]: 'baseDescriptor=%u' + 'descriptorNum=%u' is greater than 'descriptorNum=%u' in the range (descriptorType=%s)",
+                i, updateDesc.baseDescriptor, updateDesc.descriptorNum, rangeDesc.descriptorNum, GetDescriptorTypeName(rangeDesc.descriptorType));
+        }
 
         rangeUpdateDescsImpl[i] = updateDesc;
         rangeUpdateDescsImpl[i].descriptors = descriptorsImpl + descriptorOffset;
 
         Descriptor** descriptors = (Descriptor**)rangeUpdateDescsImpl[i].descriptors;
         for (uint32_t j = 0; j < updateDesc.descriptorNum; j++) {
-            RETURN_ON_FAILURE(&m_Device, updateDesc.descriptors[j] != nullptr, ReturnVoid(), "'[%u].descriptors[%u]' is NULL", i, j);
+            if (isCheckEnabled)
+                RETURN_ON_FAILURE(&m_Device, updateDesc.descriptors[j] != nullptr, ReturnVoid(), "'[%u].descriptors[%u]' is NULL", i, j);
 
             descriptors[j] = NRI_GET_IMPL(Descriptor, updateDesc.descriptors[j]);
         }
@@ -48,9 +53,12 @@ NRI_INLINE void DescriptorSetVal::UpdateDynamicConstantBuffers(uint32_t baseDyna
 
     RETURN_ON_FAILURE(&m_Device, descriptors != nullptr, ReturnVoid(), "'descriptors' is NULL");
 
+    bool isCheckEnabled = m_Device.IsExpensiveCheckEnabled(ValidationBits::DESCRIPTORS);
+
     Scratch<Descriptor*> descriptorsImpl = AllocateScratch(m_Device, Descriptor*, dynamicConstantBufferNum);
     for (uint32_t i = 0; i < dynamicConstantBufferNum; i++) {
-        RETURN_ON_FAILURE(&m_Device, descriptors[i] != nullptr, ReturnVoid(), "'descriptors[%u]' is NULL", i);
+        if (isCheckEnabled)
+            RETURN_ON_FAILURE(&m_Device, descriptors[i] != nullptr, ReturnVoid(), "'descriptors[%u]' is NULL", i);
 
         descriptorsImpl[i] = NRI_GET_IMPL(Descriptor, descriptors[i]);
     }
@@ -6,6 +6,9 @@ namespace nri {
 
 struct QueueVal;
 
+constexpr uint32_t VALIDATION_CATEGORY_NUM = 3; // see "ValidationBits"
+constexpr uint32_t MEMORY_TYPE_TABLE_SIZE = 256;  // power of 2, way more than memory types of any device
+
 struct IsExtSupported {
     uint32_t lowLatency : 1;
     uint32_t meshShader : 1;
@@ -68,12 +71,20 @@ struct DeviceVal final : public DeviceBase {
         return m_iCore.GetDeviceNativeObject(m_Impl);
     }
 
-    inline Lock& GetLock() {
-        return m_Lock;
+    // Cheap state-machine checks are not affected
+    inline bool IsExpensiveCheckEnabled(ValidationBits validationBits) {
+        if (m_ValidationDesc.disabledChecks & validationBits)
+            return false;
+
+        if (m_ValidationDesc.expensiveCheckPeriod <= 1)
+            return true;
+
+        return SampleExpensiveCheck(validationBits);
     }
 
-    bool Create();
+    bool Create(const ValidationDesc& validationDesc);
     void RegisterMemoryType(MemoryType memoryType, MemoryLocation memoryLocation);
+    bool GetMemoryLocation(MemoryType memoryType, MemoryLocation& memoryLocation) const;
 
     //================================================================================================================
     // DebugNameBase
@@ -179,11 +190,15 @@ struct DeviceVal final : public DeviceBase {
     FormatSupportBits GetFormatSupport(Format format) const;
 
 private:
+    bool SampleExpensiveCheck(ValidationBits validationBits);
+
     char* m_Name = nullptr; // .natvis
     DeviceDesc m_Desc = {}; // .natvis
     Device& m_Impl;
     std::array<QueueVal*, (size_t)QueueType::MAX_NUM> m_Queues = {};
-    UnorderedMap<MemoryType, MemoryLocation> m_MemoryTypeMap;
+    std::array<std::atomic_uint64_t, MEMORY_TYPE_TABLE_SIZE> m_MemoryTypes = {}; // insert-only, lock-free: "location + 1" in high bits, "type" in low bits
+    ValidationDesc m_ValidationDesc = {};
+    std::array<std::atomic_uint32_t, VALIDATION_CATEGORY_NUM> m_ExpensiveCheckCounters = {};
 
     // Validation interfaces
     CoreInterface m_iCoreVal = {};
@@ -204,8 +219,6 @@ private:
         uint32_t m_IsExtSupportedStorage = 0;
         IsExtSupported m_IsExtSupported;
     };
-
-    Lock m_Lock;
 };
 
 } // namespace nri
@@ -39,13 +39,12 @@ QueryType GetQueryTypeVK(uint32_t queryTypeVK);
 
 DeviceVal::DeviceVal(const CallbackInterface& callbacks, const AllocationCallbacks& allocationCallbacks, DeviceBase& device)
     : DeviceBase(callbacks, allocationCallbacks, NRI_OBJECT_SIGNATURE)
-    , m_Impl(*(Device*)&device)
-    , m_MemoryTypeMap(GetStdAllocator()) {
+    , m_Impl(*(Device*)&device) {
 }
 
 DeviceVal::~DeviceVal() {
     for (size_t i = 0; i < m_Queues.size(); i++)
-        Destroy(GetAllocationCallbacks(), m_Queues[i]);
+        Destroy(GetObjectPool(), m_Queues[i]);
 
     if (m_Name) {
         const auto& allocationCallbacks = GetAllocationCallbacks();
@@ -55,9 +54,11 @@ DeviceVal::~DeviceVal() {
     ((DeviceBase*)&m_Impl)->Destruct();
 }
 
-bool DeviceVal::Create() {
+bool DeviceVal::Create(const ValidationDesc& validationDesc) {
     const DeviceBase& deviceBaseImpl = (DeviceBase&)m_Impl;
 
+    m_ValidationDesc = validationDesc;
+
     if (deviceBaseImpl.FillFunctionTable(m_iCore) != Result::SUCCESS) {
         REPORT_ERROR(this, "Failed to get 'CoreInterface' interface");
         return false;
@@ -86,9 +87,60 @@ bool DeviceVal::Create() {
     return FillFunctionTable(m_iCoreVal) == Result::SUCCESS;
 }
 
+static inline uint32_t GetMemoryTypeSlot(MemoryType memoryType) {
+    return (uint32_t)(((uint64_t)memoryType * 0x9E3779B97F4A7C15ull) >> 56);
+}
+
+// Registered on every "Get[Buffer/Texture]MemoryDesc" call, but the set of memory types is tiny and stabilizes quickly, so lookups and
+// re-registrations don't write and don't lock
 void DeviceVal::RegisterMemoryType(MemoryType memoryType, MemoryLocation memoryLocation) {
-    ExclusiveScope lockScope(m_Lock);
-    m_MemoryTypeMap[memoryType] = memoryLocation;
+    uint64_t entry = ((uint64_t)memoryLocation + 1) << 32 | memoryType;
+    uint32_t slot = GetMemoryTypeSlot(memoryType);
+
+    for (uint32_t i = 0; i < MEMORY_TYPE_TABLE_SIZE; i++) {
+        std::atomic_uint64_t& value = m_MemoryTypes[(slot + i) & (MEMORY_TYPE_TABLE_SIZE - 1)];
+
+        uint64_t current = value.load(std::memory_order_acquire);
+        if (!current && value.compare_exchange_strong(current, entry, std::memory_order_acq_rel))
+            return;
+
+        if ((MemoryType)current == memoryType) {
+            if (current != entry)
+                value.store(entry, std::memory_order_release); // the latest location wins
+
+            return;
+        }
+    }
+
+    REPORT_ERROR(this, "Too many memory types");
+}
+
+bool DeviceVal::GetMemoryLocation(MemoryType memoryType, MemoryLocation& memoryLocation) const {
+    uint32_t slot = GetMemoryTypeSlot(memoryType);
+
+    for (uint32_t i = 0; i < MEMORY_TYPE_TABLE_SIZE; i++) {
+        uint64_t current = m_MemoryTypes[(slot + i) & (MEMORY_TYPE_TABLE_SIZE - 1)].load(std::memory_order_acquire);
+        if (!current)
+            return false;
+
+        if ((MemoryType)current == memoryType) {
+            memoryLocation = (MemoryLocation)((current >> 32) - 1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool DeviceVal::SampleExpensiveCheck(ValidationBits validationBits) {
+    uint32_t category = 0;
+    while (category < VALIDATION_CATEGORY_NUM - 1 && !(validationBits & (ValidationBits)(1 << category)))
+        category++;
+
+    // Relaxed is enough: the counter only spreads checks over calls
+    uint32_t callIndex = m_ExpensiveCheckCounters[category].fetch_add(1, std::memory_order_relaxed);
+
+    return callIndex % m_ValidationDesc.expensiveCheckPeriod == 0;
 }
 
 void DeviceVal::Destruct() {
@@ -109,14 +161,14 @@ NRI_INLINE Result DeviceVal::CreateSwapChain(const SwapChainDesc& swapChainDesc,
     Result result = m_iSwapChain.CreateSwapChain(m_Impl, swapChainDescImpl, swapChainImpl);
 
     if (result == Result::SUCCESS)
-        swapChain = (SwapChain*)Allocate<SwapChainVal>(GetAllocationCallbacks(), *this, swapChainImpl, swapChainDesc);
+        swapChain = (SwapChain*)Allocate<SwapChainVal>(GetObjectPool(), *this, swapChainImpl, swapChainDesc);
 
     return result;
 }
 
 NRI_INLINE void DeviceVal::DestroySwapChain(SwapChain& swapChain) {
     m_iSwapChain.DestroySwapChain(*NRI_GET_IMPL(SwapChain, &swapChain));
-    Destroy(GetAllocationCallbacks(), (SwapChainVal*)&swapChain);
+    Destroy(GetObjectPool(), (SwapChainVal*)&swapChain);
 }
 
 NRI_INLINE Result DeviceVal::GetQueue(QueueType queueType, uint32_t queueIndex, Queue*& queue) {
@@ -128,7 +180,7 @@ NRI_INLINE Result DeviceVal::GetQueue(QueueType queueType, uint32_t queueIndex,
     if (result == Result::SUCCESS) {
         const uint32_t index = (uint32_t)queueType;
         if (!m_Queues[index])
-            m_Queues[index] = Allocate<QueueVal>(GetAllocationCallbacks(), *this, queueImpl);
+            m_Queues[index] = Allocate<QueueVal>(GetObjectPool(), *this, queueImpl);
 
         queue = (Queue*)m_Queues[index];
     }
@@ -143,7 +195,7 @@ NRI_INLINE Result DeviceVal::CreateCommandAllocator(const Queue& queue, CommandA
     Result result = m_iCore.CreateCommandAllocator(*queueImpl, commandAllocatorImpl);
 
     if (result == Result::SUCCESS)
-        commandAllocator = (CommandAllocator*)Allocate<CommandAllocatorVal>(GetAllocationCallbacks(), *this, commandAllocatorImpl);
+        commandAllocator = (CommandAllocator*)Allocate<CommandAllocatorVal>(GetObjectPool(), *this, commandAllocatorImpl);
 
     return result;
 }
@@ -153,7 +205,7 @@ NRI_INLINE Result DeviceVal::CreateDescriptorPool(const DescriptorPoolDesc& desc
     Result result = m_iCore.CreateDescriptorPool(m_Impl, descriptorPoolDesc, descriptorPoolImpl);
 
     if (result == Result::SUCCESS)
-        descriptorPool = (DescriptorPool*)Allocate<DescriptorPoolVal>(GetAllocationCallbacks(), *this, descriptorPoolImpl, descriptorPoolDesc);
+        descriptorPool = (DescriptorPool*)Allocate<DescriptorPoolVal>(GetObjectPool(), *this, descriptorPoolImpl, descriptorPoolDesc);
 
     return result;
 }
@@ -165,7 +217,7 @@ NRI_INLINE Result DeviceVal::CreateBuffer(const BufferDesc& bufferDesc, Buffer*&
     Result result = m_iCore.CreateBuffer(m_Impl, bufferDesc, bufferImpl);
 
     if (result == Result::SUCCESS)
-        buffer = (Buffer*)Allocate<BufferVal>(GetAllocationCallbacks(), *this, bufferImpl, false);
+        buffer = (Buffer*)Allocate<BufferVal>(GetObjectPool(), *this, bufferImpl, false);
 
     return result;
 }
@@ -177,7 +229,7 @@ NRI_INLINE Result DeviceVal::AllocateBuffer(const AllocateBufferDesc& bufferDesc
     Result result = m_iResourceAllocator.AllocateBuffer(m_Impl, bufferDesc, bufferImpl);
 
     if (result == Result::SUCCESS)
-        buffer = (Buffer*)Allocate<BufferVal>(GetAllocationCallbacks(), *this, bufferImpl, true);
+        buffer = (Buffer*)Allocate<BufferVal>(GetObjectPool(), *this, bufferImpl, true);
 
     return result;
 }
@@ -193,7 +245,7 @@ NRI_INLINE Result DeviceVal::CreateTexture(const TextureDesc& textureDesc, Textu
     Result result = m_iCore.CreateTexture(m_Impl, textureDesc, textureImpl);
 
     if (result == Result::SUCCESS)
-        texture = (Texture*)Allocate<TextureVal>(GetAllocationCallbacks(), *this, textureImpl, false);
+        texture = (Texture*)Allocate<TextureVal>(GetObjectPool(), *this, textureImpl, false);
 
     return result;
 }
@@ -209,7 +261,7 @@ NRI_INLINE Result DeviceVal::AllocateTexture(const AllocateTextureDesc& textureD
     Result result = m_iResourceAllocator.AllocateTexture(m_Impl, textureDesc, textureImpl);
 
     if (result == Result::SUCCESS)
-        texture = (Texture*)Allocate<TextureVal>(GetAllocationCallbacks(), *this, textureImpl, true);
+        texture = (Texture*)Allocate<TextureVal>(GetObjectPool(), *this, textureImpl, true);
 
     return result;
 }
@@ -229,7 +281,7 @@ NRI_INLINE Result DeviceVal::CreateDescriptor(const BufferViewDesc& bufferViewDe
     Result result = m_iCore.CreateBufferView(bufferViewDescImpl, descriptorImpl);
 
     if (result == Result::SUCCESS)
-        bufferView = (Descriptor*)Allocate<DescriptorVal>(GetAllocationCallbacks(), *this, descriptorImpl, bufferViewDesc);
+        bufferView = (Descriptor*)Allocate<DescriptorVal>(GetObjectPool(), *this, descriptorImpl, bufferViewDesc);
 
     return result;
 }
@@ -254,7 +306,7 @@ NRI_INLINE Result DeviceVal::CreateDescriptor(const Texture1DViewDesc& textureVi
     Result result = m_iCore.CreateTexture1DView(textureViewDescImpl, descriptorImpl);
 
     if (result == Result::SUCCESS)
-        textureView = (Descriptor*)Allocate<DescriptorVal>(GetAllocationCallbacks(), *this, descriptorImpl, textureViewDesc);
+        textureView = (Descriptor*)Allocate<DescriptorVal>(GetObjectPool(), *this, descriptorImpl, textureViewDesc);
 
     return result;
 }
@@ -279,7 +331,7 @@ NRI_INLINE Result DeviceVal::CreateDescriptor(const Texture2DViewDesc& textureVi
     Result result = m_iCore.CreateTexture2DView(textureViewDescImpl, descriptorImpl);
 
     if (result == Result::SUCCESS)
-        textureView = (Descriptor*)Allocate<DescriptorVal>(GetAllocationCallbacks(), *this, descriptorImpl, textureViewDesc);
+        textureView = (Descriptor*)Allocate<DescriptorVal>(GetObjectPool(), *this, descriptorImpl, textureViewDesc);
 
     return result;
 }
@@ -304,7 +356,7 @@ NRI_INLINE Result DeviceVal::CreateDescriptor(const Texture3DViewDesc& textureVi
     Result result = m_iCore.CreateTexture3DView(textureViewDescImpl, descriptorImpl);
 
     if (result == Result::SUCCESS)
-        textureView = (Descriptor*)Allocate<DescriptorVal>(GetAllocationCallbacks(), *this, descriptorImpl, textureViewDesc);
+        textureView = (Descriptor*)Allocate<DescriptorVal>(GetObjectPool(), *this, descriptorImpl, textureViewDesc);
 
     return result;
 }
@@ -329,7 +381,7 @@ NRI_INLINE Result DeviceVal::CreateDescriptor(const SamplerDesc& samplerDesc, De
     Result result = m_iCore.CreateSampler(m_Impl, samplerDesc, samplerImpl);
 
     if (result == Result::SUCCESS)
-        sampler = (Descriptor*)Allocate<DescriptorVal>(GetAllocationCallbacks(), *this, samplerImpl);
+        sampler = (Descriptor*)Allocate<DescriptorVal>(GetObjectPool(), *this, samplerImpl);
 
     return result;
 }
@@ -411,7 +463,7 @@ NRI_INLINE Result DeviceVal::CreatePipelineLayout(const PipelineLayoutDesc& pipe
     Result result = m_iCore.CreatePipelineLayout(m_Impl, pipelineLayoutDesc, pipelineLayoutImpl);
 
     if (result == Result::SUCCESS)
-        pipelineLayout = (PipelineLayout*)Allocate<PipelineLayoutVal>(GetAllocationCallbacks(), *this, pipelineLayoutImpl, pipelineLayoutDesc);
+        pipelineLayout = (PipelineLayout*)Allocate<PipelineLayoutVal>(GetObjectPool(), *this, pipelineLayoutImpl, pipelineLayoutDesc);
 
     return result;
 }
@@ -477,7 +529,7 @@ NRI_INLINE Result DeviceVal::CreatePipeline(const GraphicsPipelineDesc& graphics
     Result result = m_iCore.CreateGraphicsPipeline(m_Impl, graphicsPipelineDescImpl, pipelineImpl);
 
     if (result == Result::SUCCESS)
-        pipeline = (Pipeline*)Allocate<PipelineVal>(GetAllocationCallbacks(), *this, pipelineImpl, graphicsPipelineDesc);
+        pipeline = (Pipeline*)Allocate<PipelineVal>(GetObjectPool(), *this, pipelineImpl, graphicsPipelineDesc);
 
     return result;
 }
@@ -495,7 +547,7 @@ NRI_INLINE Result DeviceVal::CreatePipeline(const ComputePipelineDesc& computePi
     Result result = m_iCore.CreateComputePipeline(m_Impl, computePipelineDescImpl, pipelineImpl);
 
     if (result == Result::SUCCESS)
-        pipeline = (Pipeline*)Allocate<PipelineVal>(GetAllocationCallbacks(), *this, pipelineImpl, computePipelineDesc);
+        pipeline = (Pipeline*)Allocate<PipelineVal>(GetObjectPool(), *this, pipelineImpl, computePipelineDesc);
 
     return result;
 }
@@ -511,7 +563,7 @@ NRI_INLINE Result DeviceVal::CreateQueryPool(const QueryPoolDesc& queryPoolDesc,
     Result result = m_iCore.CreateQueryPool(m_Impl, queryPoolDesc, queryPoolImpl);
 
     if (result == Result::SUCCESS)
-        queryPool = (QueryPool*)Allocate<QueryPoolVal>(GetAllocationCallbacks(), *this, queryPoolImpl, queryPoolDesc.queryType, queryPoolDesc.capacity);
+        queryPool = (QueryPool*)Allocate<QueryPoolVal>(GetObjectPool(), *this, queryPoolImpl, queryPoolDesc.queryType, queryPoolDesc.capacity);
 
     return result;
 }
@@ -521,85 +573,80 @@ NRI_INLINE Result DeviceVal::CreateFence(uint64_t initialValue, Fence*& fence) {
     Result result = m_iCore.CreateFence(m_Impl, initialValue, fenceImpl);
 
     if (result == Result::SUCCESS)
-        fence = (Fence*)Allocate<FenceVal>(GetAllocationCallbacks(), *this, fenceImpl);
+        fence = (Fence*)Allocate<FenceVal>(GetObjectPool(), *this, fenceImpl);
 
     return result;
 }
 
 NRI_INLINE void DeviceVal::DestroyCommandBuffer(CommandBuffer& commandBuffer) {
     m_iCore.DestroyCommandBuffer(*NRI_GET_IMPL(CommandBuffer, &commandBuffer));
-    Destroy(GetAllocationCallbacks(), (CommandBufferVal*)&commandBuffer);
+    Destroy(GetObjectPool(), (CommandBufferVal*)&commandBuffer);
 }
 
 NRI_INLINE void DeviceVal::DestroyCommandAllocator(CommandAllocator& commandAllocator) {
     m_iCore.DestroyCommandAllocator(*NRI_GET_IMPL(CommandAllocator, &commandAllocator));
-    Destroy(GetAllocationCallbacks(), (CommandAllocatorVal*)&commandAllocator);
+    Destroy(GetObjectPool(), (CommandAllocatorVal*)&commandAllocator);
 }
 
 NRI_INLINE void DeviceVal::DestroyDescriptorPool(DescriptorPool& descriptorPool) {
     m_iCore.DestroyDescriptorPool(*NRI_GET_IMPL(DescriptorPool, &descriptorPool));
-    Destroy(GetAllocationCallbacks(), (DescriptorPoolVal*)&descriptorPool);
+    Destroy(GetObjectPool(), (DescriptorPoolVal*)&descriptorPool);
 }
 
 NRI_INLINE void DeviceVal::DestroyBuffer(Buffer& buffer) {
     m_iCore.DestroyBuffer(*NRI_GET_IMPL(Buffer, &buffer));
-    Destroy(GetAllocationCallbacks(), (BufferVal*)&buffer);
+    Destroy(GetObjectPool(), (BufferVal*)&buffer);
 }
 
 NRI_INLINE void DeviceVal::DestroyTexture(Texture& texture) {
     m_iCore.DestroyTexture(*NRI_GET_IMPL(Texture, &texture));
-    Destroy(GetAllocationCallbacks(), (TextureVal*)&texture);
+    Destroy(GetObjectPool(), (TextureVal*)&texture);
 }
 
 NRI_INLINE void DeviceVal::DestroyDescriptor(Descriptor& descriptor) {
     m_iCore.DestroyDescriptor(*NRI_GET_IMPL(Descriptor, &descriptor));
-    Destroy(GetAllocationCallbacks(), (DescriptorVal*)&descriptor);
+    Destroy(GetObjectPool(), (DescriptorVal*)&descriptor);
 }
 
 NRI_INLINE void DeviceVal::DestroyPipelineLayout(PipelineLayout& pipelineLayout) {
     m_iCore.DestroyPipelineLayout(*NRI_GET_IMPL(PipelineLayout, &pipelineLayout));
-    Destroy(GetAllocationCallbacks(), (PipelineLayoutVal*)&pipelineLayout);
+    Destroy(GetObjectPool(), (PipelineLayoutVal*)&pipelineLayout);
 }
 
 NRI_INLINE void DeviceVal::DestroyPipeline(Pipeline& pipeline) {
     m_iCore.DestroyPipeline(*NRI_GET_IMPL(Pipeline, &pipeline));
-    Destroy(GetAllocationCallbacks(), (PipelineVal*)&pipeline);
+    Destroy(GetObjectPool(), (PipelineVal*)&pipeline);
 }
 
 NRI_INLINE void DeviceVal::DestroyQueryPool(QueryPool& queryPool) {
     m_iCore.DestroyQueryPool(*NRI_GET_IMPL(QueryPool, &queryPool));
-    Destroy(GetAllocationCallbacks(), (QueryPoolVal*)&queryPool);
+    Destroy(GetObjectPool(), (QueryPoolVal*)&queryPool);
 }
 
 NRI_INLINE void DeviceVal::DestroyFence(Fence& fence) {
     m_iCore.DestroyFence(*NRI_GET_IMPL(Fence, &fence));
-    Destroy(GetAllocationCallbacks(), (FenceVal*)&fence);
+    Destroy(GetObjectPool(), (FenceVal*)&fence);
 }
 
 NRI_INLINE Result DeviceVal::AllocateMemory(const AllocateMemoryDesc& allocateMemoryDesc, Memory*& memory) {
     RETURN_ON_FAILURE(this, allocateMemoryDesc.size > 0, Result::INVALID_ARGUMENT, "'size' is 0");
     RETURN_ON_FAILURE(this, allocateMemoryDesc.priority >= -1.0f && allocateMemoryDesc.priority <= 1.0f, Result::INVALID_ARGUMENT, "'priority' outside of [-1; 1] range");
 
-    std::unordered_map<MemoryType, MemoryLocation>::iterator it;
-    std::unordered_map<MemoryType, MemoryLocation>::iterator end;
-    {
-        ExclusiveScope lockScope(m_Lock);
-        it = m_MemoryTypeMap.find(allocateMemoryDesc.type);
-        end = m_MemoryTypeMap.end();
-    }
-
-    RETURN_ON_FAILURE(this, it != end, Result::FAILURE, "'memoryType' is invalid");
+    MemoryLocation memoryLocation = MemoryLocation::MAX_NUM;
+    RETURN_ON_FAILURE(this, GetMemoryLocation(allocateMemoryDesc.type, memoryLocation), Result::FAILURE, "'memoryType' is invalid");
 
     Memory* memoryImpl;
     Result result = m_iCore.AllocateMemory(m_Impl, allocateMemoryDesc, memoryImpl);
 
     if (result == Result::SUCCESS)
-        memory = (Memory*)Allocate<MemoryVal>(GetAllocationCallbacks(), *this, memoryImpl, allocateMemoryDesc.size, it->second);
+        memory = (Memory*)Allocate<MemoryVal>(GetObjectPool(), *this, memoryImpl, allocateMemoryDesc.size, memoryLocation);
 
     return result;
 }
 
 NRI_INLINE Result DeviceVal::BindBufferMemory(const BufferMemoryBindingDesc* memoryBindingDescs, uint32_t memoryBindingDescNum) {
+    bool isCheckEnabled = IsExpensiveCheckEnabled(ValidationBits::MEMORY_BINDINGS);
+
     Scratch<BufferMemoryBindingDesc> memoryBindingDescsImpl = AllocateScratch(*this, BufferMemoryBindingDesc, memoryBindingDescNum);
     for (uint32_t i = 0; i < memoryBindingDescNum; i++) {
         BufferMemoryBindingDesc& destDesc = memoryBindingDescsImpl[i];
@@ -618,7 +665,7 @@ NRI_INLINE Result DeviceVal::BindBufferMemory(const BufferMemoryBindingDesc* mem
         destDesc.buffer = buffer.GetImpl();
 
         // Skip validation if memory has been created from GAPI object using a wrapper extension
-        if (memory.GetMemoryLocation() == MemoryLocation::MAX_NUM)
+        if (memory.GetMemoryLocation() == MemoryLocation::MAX_NUM || !isCheckEnabled)
             continue;
 
         MemoryDesc memoryDesc = {};
@@ -647,6 +694,8 @@ NRI_INLINE Result DeviceVal::BindBufferMemory(const BufferMemoryBindingDesc* mem
 }
 
 NRI_INLINE Result DeviceVal::BindTextureMemory(const TextureMemoryBindingDesc* memoryBindingDescs, uint32_t memoryBindingDescNum) {
+    bool isCheckEnabled = IsExpensiveCheckEnabled(ValidationBits::MEMORY_BINDINGS);
+
     Scratch<TextureMemoryBindingDesc> memoryBindingDescsImpl = AllocateScratch(*this, TextureMemoryBindingDesc, memoryBindingDescNum);
     for (uint32_t i = 0; i < memoryBindingDescNum; i++) {
         TextureMemoryBindingDesc& destDesc = memoryBindingDescsImpl[i];
@@ -665,7 +714,7 @@ NRI_INLINE Result DeviceVal::BindTextureMemory(const TextureMemoryBindingDesc* m
         destDesc.texture = texture.GetImpl();
 
         // Skip validation if memory has been created from GAPI object using a wrapper extension
-        if (memory.GetMemoryLocation() == MemoryLocation::MAX_NUM)
+        if (memory.GetMemoryLocation() == MemoryLocation::MAX_NUM || !isCheckEnabled)
             continue;
 
         MemoryDesc memoryDesc = {};
@@ -703,7 +752,7 @@ NRI_INLINE void DeviceVal::FreeMemory(Memory& memory) {
     }
 
     m_iCore.FreeMemory(*NRI_GET_IMPL(Memory, &memory));
-    Destroy(GetAllocationCallbacks(), &memoryVal);
+    Destroy(GetObjectPool(), &memoryVal);
 }
 
 NRI_INLINE FormatSupportBits DeviceVal::GetFormatSupport(Format format) const {
@@ -720,7 +769,7 @@ NRI_INLINE Result DeviceVal::CreateCommandAllocator(const CommandAllocatorVKDesc
     Result result = m_iWrapperVK.CreateCommandAllocatorVK(m_Impl, commandAllocatorVKDesc, commandAllocatorImpl);
 
     if (result == Result::SUCCESS)
-        commandAllocator = (CommandAllocator*)Allocate<CommandAllocatorVal>(GetAllocationCallbacks(), *this, commandAllocatorImpl);
+        commandAllocator = (CommandAllocator*)Allocate<CommandAllocatorVal>(GetObjectPool(), *this, commandAllocatorImpl);
 
     return result;
 }
@@ -733,7 +782,7 @@ NRI_INLINE Result DeviceVal::CreateCommandBuffer(const CommandBufferVKDesc& comm
     Result result = m_iWrapperVK.CreateCommandBufferVK(m_Impl, commandBufferVKDesc, commandBufferImpl);
 
     if (result == Result::SUCCESS)
-        commandBuffer = (CommandBuffer*)Allocate<CommandBufferVal>(GetAllocationCallbacks(), *this, commandBufferImpl, true);
+        commandBuffer = (CommandBuffer*)Allocate<CommandBufferVal>(GetObjectPool(), *this, commandBufferImpl, true);
 
     return result;
 }
@@ -746,7 +795,7 @@ NRI_INLINE Result DeviceVal::CreateDescriptorPool(const DescriptorPoolVKDesc& de
     Result result = m_iWrapperVK.CreateDescriptorPoolVK(m_Impl, descriptorPoolVKDesc, descriptorPoolImpl);
 
     if (result == Result::SUCCESS)
-        descriptorPool = (DescriptorPool*)Allocate<DescriptorPoolVal>(GetAllocationCallbacks(), *this, descriptorPoolImpl, descriptorPoolVKDesc.descriptorSetMaxNum);
+        descriptorPool = (DescriptorPool*)Allocate<DescriptorPoolVal>(GetObjectPool(), *this, descriptorPoolImpl, descriptorPoolVKDesc.descriptorSetMaxNum);
 
     return result;
 }
@@ -759,7 +808,7 @@ NRI_INLINE Result DeviceVal::CreateBuffer(const BufferVKDesc& bufferDesc, Buffer
     Result result = m_iWrapperVK.CreateBufferVK(m_Impl, bufferDesc, bufferImpl);
 
     if (result == Result::SUCCESS)
-        buffer = (Buffer*)Allocate<BufferVal>(GetAllocationCallbacks(), *this, bufferImpl, true);
+        buffer = (Buffer*)Allocate<BufferVal>(GetObjectPool(), *this, bufferImpl, true);
 
     return result;
 }
@@ -775,7 +824,7 @@ NRI_INLINE Result DeviceVal::CreateTexture(const TextureVKDesc& textureVKDesc, T
     Result result = m_iWrapperVK.CreateTextureVK(m_Impl, textureVKDesc, textureImpl);
 
     if (result == Result::SUCCESS)
-        texture = (Texture*)Allocate<TextureVal>(GetAllocationCallbacks(), *this, textureImpl, true);
+        texture = (Texture*)Allocate<TextureVal>(GetObjectPool(), *this, textureImpl, true);
 
     return result;
 }
@@ -788,7 +837,7 @@ NRI_INLINE Result DeviceVal::CreateMemory(const MemoryVKDesc& memoryVKDesc, Memo
     Result result = m_iWrapperVK.CreateMemoryVK(m_Impl, memoryVKDesc, memoryImpl);
 
     if (result == Result::SUCCESS)
-        memory = (Memory*)Allocate<MemoryVal>(GetAllocationCallbacks(), *this, memoryImpl, memoryVKDesc.size, MemoryLocation::MAX_NUM);
+        memory = (Memory*)Allocate<MemoryVal>(GetObjectPool(), *this, memoryImpl, memoryVKDesc.size, MemoryLocation::MAX_NUM);
 
     return result;
 }
@@ -800,7 +849,7 @@ NRI_INLINE Result DeviceVal::CreateGraphicsPipeline(VKNonDispatchableHandle vkPi
     Result result = m_iWrapperVK.CreateGraphicsPipelineVK(m_Impl, vkPipeline, pipelineImpl);
 
     if (result == Result::SUCCESS)
-        pipeline = (Pipeline*)Allocate<PipelineVal>(GetAllocationCallbacks(), *this, pipelineImpl);
+        pipeline = (Pipeline*)Allocate<PipelineVal>(GetObjectPool(), *this, pipelineImpl);
 
     return result;
 }
@@ -812,7 +861,7 @@ NRI_INLINE Result DeviceVal::CreateComputePipeline(VKNonDispatchableHandle vkPip
     Result result = m_iWrapperVK.CreateComputePipelineVK(m_Impl, vkPipeline, pipelineImpl);
 
     if (result == Result::SUCCESS)
-        pipeline = (Pipeline*)Allocate<PipelineVal>(GetAllocationCallbacks(), *this, pipelineImpl);
+        pipeline = (Pipeline*)Allocate<PipelineVal>(GetObjectPool(), *this, pipelineImpl);
 
     return result;
 }
@@ -825,7 +874,7 @@ NRI_INLINE Result DeviceVal::CreateQueryPool(const QueryPoolVKDesc& queryPoolVKD
 
     if (result == Result::SUCCESS) {
         QueryType queryType = GetQueryTypeVK(queryPoolVKDesc.vkQueryType);
-        queryPool = (QueryPool*)Allocate<QueryPoolVal>(GetAllocationCallbacks(), *this, queryPoolImpl, queryType, 0);
+        queryPool = (QueryPool*)Allocate<QueryPoolVal>(GetObjectPool(), *this, queryPoolImpl, queryType, 0);
     }
 
     return result;
@@ -839,7 +888,7 @@ NRI_INLINE Result DeviceVal::CreateAccelerationStructure(const AccelerationStruc
 
     if (result == Result::SUCCESS) {
         MemoryDesc memoryDesc = {};
-        accelerationStructure = (AccelerationStructure*)Allocate<AccelerationStructureVal>(GetAllocationCallbacks(), *this, accelerationStructureImpl, true, memoryDesc);
+        accelerationStructure = (AccelerationStructure*)Allocate<AccelerationStructureVal>(GetObjectPool(), *this, accelerationStructureImpl, true, memoryDesc);
     }
 
     return result;
@@ -856,7 +905,7 @@ NRI_INLINE Result DeviceVal::CreateCommandBuffer(const CommandBufferD3D11Desc& c
     Result result = m_iWrapperD3D11.CreateCommandBufferD3D11(m_Impl, commandBufferDesc, commandBufferImpl);
 
     if (result == Result::SUCCESS)
-        commandBuffer = (CommandBuffer*)Allocate<CommandBufferVal>(GetAllocationCallbacks(), *this, commandBufferImpl, true);
+        commandBuffer = (CommandBuffer*)Allocate<CommandBufferVal>(GetObjectPool(), *this, commandBufferImpl, true);
 
     return result;
 }
@@ -868,7 +917,7 @@ NRI_INLINE Result DeviceVal::CreateBuffer(const BufferD3D11Desc& bufferDesc, Buf
     Result result = m_iWrapperD3D11.CreateBufferD3D11(m_Impl, bufferDesc, bufferImpl);
 
     if (result == Result::SUCCESS)
-        buffer = (Buffer*)Allocate<BufferVal>(GetAllocationCallbacks(), *this, bufferImpl, true);
+        buffer = (Buffer*)Allocate<BufferVal>(GetObjectPool(), *this, bufferImpl, true);
 
     return result;
 }
@@ -880,7 +929,7 @@ NRI_INLINE Result DeviceVal::CreateTexture(const TextureD3D11Desc& textureDesc,
     Result result = m_iWrapperD3D11.CreateTextureD3D11(m_Impl, textureDesc, textureImpl);
 
     if (result == Result::SUCCESS)
-        texture = (Texture*)Allocate<TextureVal>(GetAllocationCallbacks(), *this, textureImpl, true);
+        texture = (Texture*)Allocate<TextureVal>(GetObjectPool(), *this, textureImpl, true);
 
     return result;
 }
@@ -897,7 +946,7 @@ NRI_INLINE Result DeviceVal::CreateCommandBuffer(const CommandBufferD3D12Desc& c
     Result result = m_iWrapperD3D12.CreateCommandBufferD3D12(m_Impl, commandBufferDesc, commandBufferImpl);
 
     if (result == Result::SUCCESS)
-        commandBuffer = (CommandBuffer*)Allocate<CommandBufferVal>(GetAllocationCallbacks(), *this, commandBufferImpl, true);
+        commandBuffer = (CommandBuffer*)Allocate<CommandBufferVal>(GetObjectPool(), *this, commandBufferImpl, true);
 
     return result;
 }
@@ -909,7 +958,7 @@ NRI_INLINE Result DeviceVal::CreateDescriptorPool(const DescriptorPoolD3D12Desc&
     Result result = m_iWrapperD3D12.CreateDescriptorPoolD3D12(m_Impl, descriptorPoolD3D12Desc, descriptorPoolImpl);
 
     if (result == Result::SUCCESS)
-        descriptorPool = (DescriptorPool*)Allocate<DescriptorPoolVal>(GetAllocationCallbacks(), *this, descriptorPoolImpl, descriptorPoolD3D12Desc.descriptorSetMaxNum);
+        descriptorPool = (DescriptorPool*)Allocate<DescriptorPoolVal>(GetObjectPool(), *this, descriptorPoolImpl, descriptorPoolD3D12Desc.descriptorSetMaxNum);
 
     return result;
 }
@@ -921,7 +970,7 @@ NRI_INLINE Result DeviceVal::CreateBuffer(const BufferD3D12Desc& bufferDesc, Buf
     Result result = m_iWrapperD3D12.CreateBufferD3D12(m_Impl, bufferDesc, bufferImpl);
 
     if (result == Result::SUCCESS)
-        buffer = (Buffer*)Allocate<BufferVal>(GetAllocationCallbacks(), *this, bufferImpl, true);
+        buffer = (Buffer*)Allocate<BufferVal>(GetObjectPool(), *this, bufferImpl, true);
 
     return result;
 }
@@ -933,7 +982,7 @@ NRI_INLINE Result DeviceVal::CreateTexture(const TextureD3D12Desc& textureDesc,
     Result result = m_iWrapperD3D12.CreateTextureD3D12(m_Impl, textureDesc, textureImpl);
 
     if (result == Result::SUCCESS)
-        texture = (Texture*)Allocate<TextureVal>(GetAllocationCallbacks(), *this, textureImpl, true);
+        texture = (Texture*)Allocate<TextureVal>(GetObjectPool(), *this, textureImpl, true);
 
     return result;
 }
@@ -947,7 +996,7 @@ NRI_INLINE Result DeviceVal::CreateMemory(const MemoryD3D12Desc& memoryDesc, Mem
     const uint64_t size = GetMemorySizeD3D12(memoryDesc);
 
     if (result == Result::SUCCESS)
-        memory = (Memory*)Allocate<MemoryVal>(GetAllocationCallbacks(), *this, memoryImpl, size, MemoryLocation::MAX_NUM);
+        memory = (Memory*)Allocate<MemoryVal>(GetObjectPool(), *this, memoryImpl, size, MemoryLocation::MAX_NUM);
 
     return result;
 }
@@ -960,7 +1009,7 @@ NRI_INLINE Result DeviceVal::CreateAccelerationStructure(const AccelerationStruc
 
     if (result == Result::SUCCESS) {
         MemoryDesc memoryDesc = {};
-        accelerationStructure = (AccelerationStructure*)Allocate<AccelerationStructureVal>(GetAllocationCallbacks(), *this, accelerationStructureImpl, true, memoryDesc);
+        accelerationStructure = (AccelerationStructure*)Allocate<AccelerationStructureVal>(GetObjectPool(), *this, accelerationStructureImpl, true, memoryDesc);
     }
 
     return result;
@@ -992,7 +1041,7 @@ NRI_INLINE Result DeviceVal::CreatePipeline(const RayTracingPipelineDesc& pipeli
     Result result = m_iRayTracing.CreateRayTracingPipeline(m_Impl, pipelineDescImpl, pipelineImpl);
 
     if (result == Result::SUCCESS)
-        pipeline = (Pipeline*)Allocate<PipelineVal>(GetAllocationCallbacks(), *this, pipelineImpl);
+        pipeline = (Pipeline*)Allocate<PipelineVal>(GetObjectPool(), *this, pipelineImpl);
 
     return result;
 }
@@ -1017,7 +1066,7 @@ NRI_INLINE Result DeviceVal::CreateAccelerationStructure(const AccelerationStruc
         MemoryDesc memoryDesc = {};
         m_iRayTracing.GetAccelerationStructureMemoryDesc(*accelerationStructureImpl, MemoryLocation::DEVICE, memoryDesc);
 
-        accelerationStructure = (AccelerationStructure*)Allocate<AccelerationStructureVal>(GetAllocationCallbacks(), *this, accelerationStructureImpl, false, memoryDesc);
+        accelerationStructure = (AccelerationStructure*)Allocate<AccelerationStructureVal>(GetObjectPool(), *this, accelerationStructureImpl, false, memoryDesc);
     }
 
     return result;
@@ -1043,7 +1092,7 @@ NRI_INLINE Result DeviceVal::AllocateAccelerationStructure(const AllocateAcceler
         MemoryDesc memoryDesc = {};
         m_iRayTracing.GetAccelerationStructureMemoryDesc(*accelerationStructureImpl, MemoryLocation::DEVICE, memoryDesc);
 
-        accelerationStructure = (AccelerationStructure*)Allocate<AccelerationStructureVal>(GetAllocationCallbacks(), *this, accelerationStructureImpl, true, memoryDesc);
+        accelerationStructure = (AccelerationStructure*)Allocate<AccelerationStructureVal>(GetObjectPool(), *this, accelerationStructureImpl, true, memoryDesc);
     }
 
     return result;
@@ -1052,6 +1101,8 @@ NRI_INLINE Result DeviceVal::AllocateAccelerationStructure(const AllocateAcceler
 NRI_INLINE Result DeviceVal::BindAccelerationStructureMemory(const AccelerationStructureMemoryBindingDesc* memoryBindingDescs, uint32_t memoryBindingDescNum) {
     RETURN_ON_FAILURE(this, memoryBindingDescs != nullptr, Result::INVALID_ARGUMENT, "'' is NULL");
 
+    bool isCheckEnabled = IsExpensiveCheckEnabled(ValidationBits::MEMORY_BINDINGS);
+
     Scratch<AccelerationStructureMemoryBindingDesc> memoryBindingDescsImpl = AllocateScratch(*this, AccelerationStructureMemoryBindingDesc, memoryBindingDescNum);
     for (uint32_t i = 0; i < memoryBindingDescNum; i++) {
         AccelerationStructureMemoryBindingDesc& destDesc = memoryBindingDescsImpl[i];
@@ -1062,14 +1113,17 @@ NRI_INLINE Result DeviceVal::BindAccelerationStructureMemory(const AccelerationS
         const MemoryDesc& memoryDesc = accelerationStructure.GetMemoryDesc();
 
         RETURN_ON_FAILURE(this, !accelerationStructure.IsBoundToMemory(), Result::INVALID_ARGUMENT, "'[%u].accelerationStructure' is already bound to memory", i);
-        RETURN_ON_FAILURE(this, !memoryDesc.mustBeDedicated || srcDesc.offset == 0, Result::INVALID_ARGUMENT, "'[%u].offset' must be 0 for dedicated allocation", i);
-        RETURN_ON_FAILURE(this, memoryDesc.alignment != 0, Result::INVALID_ARGUMENT, "'[%u].alignment' is 0", i);
-        RETURN_ON_FAILURE(this, srcDesc.offset % memoryDesc.alignment == 0, Result::INVALID_ARGUMENT, "'[%u].offset' is misaligned", i);
 
-        const uint64_t rangeMax = srcDesc.offset + memoryDesc.size;
-        const bool memorySizeIsUnknown = memory.GetSize() == 0;
+        if (isCheckEnabled) {
+            RETURN_ON_FAILURE(this, !memoryDesc.mustBeDedicated || srcDesc.offset == 0, Result::INVALID_ARGUMENT, "'[%u].offset' must be 0 for dedicated allocation", i);
+            RETURN_ON_FAILURE(this, memoryDesc.alignment != 0, Result::INVALID_ARGUMENT, "'[%u].alignment' is 0", i);
+            RETURN_ON_FAILURE(this, srcDesc.offset % memoryDesc.alignment == 0, Result::INVALID_ARGUMENT, "'[%u].offset' is misaligned", i);
 
-        RETURN_ON_FAILURE(this, memorySizeIsUnknown || rangeMax <= memory.GetSize(), Result::INVALID_ARGUMENT, "'[%u].offset' is invalid", i);
+            const uint64_t rangeMax = srcDesc.offset + memoryDesc.size;
+            const bool memorySizeIsUnknown = memory.GetSize() == 0;
+
+            RETURN_ON_FAILURE(this, memorySizeIsUnknown || rangeMax <= memory.GetSize(), Result::INVALID_ARGUMENT, "'[%u].offset' is invalid", i);
+        }
 
         destDesc = srcDesc;
         destDesc.memory = memory.GetImpl();
@@ -1089,5 +1143,5 @@ NRI_INLINE Result DeviceVal::BindAccelerationStructureMemory(const AccelerationS
 }
 
 NRI_INLINE void DeviceVal::DestroyAccelerationStructure(AccelerationStructure& accelerationStructure) {
-    Destroy(GetAllocationCallbacks(), (AccelerationStructureVal*)&accelerationStructure);
+    Destroy(GetObjectPool(), (AccelerationStructureVal*)&accelerationStructure);
 }
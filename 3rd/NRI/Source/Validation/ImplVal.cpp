@@ -19,8 +19,14 @@
 #include "SwapChainVal.h"
 #include "TextureVal.h"
 
+#include "HelperBindlessTable.h"
 #include "HelperDataUpload.h"
+#include "HelperDefragmenter.h"
+#include "HelperDescriptorSetCache.h"
 #include "HelperDeviceMemoryAllocator.h"
+#include "HelperMemoryBudget.h"
+#include "HelperPipelineCache.h"
+#include "HelperTransientPool.h"
 #include "HelperWaitIdle.h"
 #include "Streamer.h"
 #include "Upscaler.h"
@@ -48,7 +54,7 @@ using namespace nri;
 DeviceBase* CreateDeviceValidation(const DeviceCreationDesc& desc, DeviceBase& device) {
     DeviceVal* deviceVal = Allocate<DeviceVal>(desc.allocationCallbacks, desc.callbackInterface, desc.allocationCallbacks, device);
 
-    if (!deviceVal->Create()) {
+    if (!deviceVal->Create(desc.validationDesc)) {
         Destroy(desc.allocationCallbacks, deviceVal);
         return nullptr;
     }
@@ -484,6 +490,10 @@ static void NRI_CALL ResetDescriptorPool(DescriptorPool& descriptorPool) {
     ((DescriptorPoolVal&)descriptorPool).Reset();
 }
 
+static void NRI_CALL GetDescriptorPoolStats(const DescriptorPool& descriptorPool, DescriptorPoolStats& descriptorPoolStats) {
+    ((DescriptorPoolVal&)descriptorPool).GetStats(descriptorPoolStats);
+}
+
 static void NRI_CALL ResetCommandAllocator(CommandAllocator& commandAllocator) {
     ((CommandAllocatorVal&)commandAllocator).Reset();
 }
@@ -649,6 +659,7 @@ Result DeviceVal::FillFunctionTable(CoreInterface& table) const {
     table.GetBufferNativeObject = ::GetBufferNativeObject;
     table.GetTextureNativeObject = ::GetTextureNativeObject;
     table.GetDescriptorNativeObject = ::GetDescriptorNativeObject;
+    table.GetDescriptorPoolStats = ::GetDescriptorPoolStats;
 
     return Result::SUCCESS;
 }
@@ -727,6 +738,368 @@ static Result NRI_CALL UploadData(Queue& queue, const TextureUploadDesc* texture
     return helperDataUpload.UploadData(textureUploadDescs, textureUploadDescNum, bufferUploadDescs, bufferUploadDescNum);
 }
 
+static Result NRI_CALL CreateDataUploader(Queue& queue, const DataUploaderDesc& dataUploaderDesc, DataUploader*& dataUploader) {
+    QueueVal& queueVal = (QueueVal&)queue;
+    DeviceVal& deviceVal = queueVal.GetDevice();
+
+    dataUploader = nullptr;
+
+    HelperDataUpload* impl = Allocate<HelperDataUpload>(deviceVal.GetAllocationCallbacks(), deviceVal.GetCoreInterfaceVal(), (Device&)deviceVal, queue);
+    Result result = impl->Create(dataUploaderDesc);
+
+    if (result != Result::SUCCESS)
+        Destroy(deviceVal.GetAllocationCallbacks(), impl);
+    else
+        dataUploader = (DataUploader*)impl;
+
+    return result;
+}
+
+static void NRI_CALL DestroyDataUploader(DataUploader& dataUploader) {
+    Destroy(((DeviceBase&)((HelperDataUpload&)dataUploader).GetDevice()).GetAllocationCallbacks(), (HelperDataUpload*)&dataUploader);
+}
+
+static Result NRI_CALL UploadDataAsync(DataUploader& dataUploader, const TextureUploadDesc* textureUploadDescs, uint32_t textureUploadDescNum, const BufferUploadDesc* bufferUploadDescs, uint32_t bufferUploadDescNum, UploadTicket& uploadTicket) {
+    HelperDataUpload& helperDataUpload = (HelperDataUpload&)dataUploader;
+    DeviceVal& deviceVal = (DeviceVal&)helperDataUpload.GetDevice();
+
+    uploadTicket = {};
+
+    RETURN_ON_FAILURE(&deviceVal, textureUploadDescNum == 0 || textureUploadDescs != nullptr, Result::INVALID_ARGUMENT, "'textureUploadDescs' is NULL");
+    RETURN_ON_FAILURE(&deviceVal, bufferUploadDescNum == 0 || bufferUploadDescs != nullptr, Result::INVALID_ARGUMENT, "'bufferUploadDescs' is NULL");
+
+    for (uint32_t i = 0; i < textureUploadDescNum; i++) {
+        if (!ValidateTextureUploadDesc(deviceVal, i, textureUploadDescs[i]))
+            return Result::INVALID_ARGUMENT;
+    }
+
+    for (uint32_t i = 0; i < bufferUploadDescNum; i++) {
+        if (!ValidateBufferUploadDesc(deviceVal, i, bufferUploadDescs[i]))
+            return Result::INVALID_ARGUMENT;
+    }
+
+    return helperDataUpload.UploadData(textureUploadDescs, textureUploadDescNum, bufferUploadDescs, bufferUploadDescNum, uploadTicket);
+}
+
+static Result NRI_CALL CreateDefragmenter(Device& device, const DefragmenterDesc& defragmenterDesc, Defragmenter*& defragmenter) {
+    DeviceVal& deviceVal = (DeviceVal&)device;
+
+    defragmenter = nullptr;
+
+    RETURN_ON_FAILURE(&deviceVal, defragmenterDesc.fence != nullptr, Result::INVALID_ARGUMENT, "'fence' is NULL");
+
+    HelperDefragmenter* impl = Allocate<HelperDefragmenter>(deviceVal.GetAllocationCallbacks(), deviceVal.GetCoreInterfaceVal(), device);
+    Result result = impl->Create(defragmenterDesc);
+
+    if (result != Result::SUCCESS)
+        Destroy(deviceVal.GetAllocationCallbacks(), impl);
+    else
+        defragmenter = (Defragmenter*)impl;
+
+    return result;
+}
+
+static void NRI_CALL DestroyDefragmenter(Defragmenter& defragmenter) {
+    Destroy(((DeviceBase&)((HelperDefragmenter&)defragmenter).GetDevice()).GetAllocationCallbacks(), (HelperDefragmenter*)&defragmenter);
+}
+
+static Result NRI_CALL AllocateAndBindDefragmentableMemory(Defragmenter& defragmenter, const ResourceGroupDesc& resourceGroupDesc) {
+    HelperDefragmenter& helperDefragmenter = (HelperDefragmenter&)defragmenter;
+    DeviceVal& deviceVal = (DeviceVal&)helperDefragmenter.GetDevice();
+
+    RETURN_ON_FAILURE(&deviceVal, resourceGroupDesc.memoryLocation < MemoryLocation::MAX_NUM, Result::INVALID_ARGUMENT, "'memoryLocation' is invalid");
+    RETURN_ON_FAILURE(&deviceVal, resourceGroupDesc.bufferNum == 0 || resourceGroupDesc.buffers != nullptr, Result::INVALID_ARGUMENT, "'buffers' is NULL");
+    RETURN_ON_FAILURE(&deviceVal, resourceGroupDesc.textureNum == 0 || resourceGroupDesc.textures != nullptr, Result::INVALID_ARGUMENT, "'textures' is NULL");
+
+    for (uint32_t i = 0; i < resourceGroupDesc.bufferNum; i++) {
+        RETURN_ON_FAILURE(&deviceVal, resourceGroupDesc.buffers[i] != nullptr, Result::INVALID_ARGUMENT, "'buffers[%u]' is NULL", i);
+    }
+
+    for (uint32_t i = 0; i < resourceGroupDesc.textureNum; i++) {
+        RETURN_ON_FAILURE(&deviceVal, resourceGroupDesc.textures[i] != nullptr, Result::INVALID_ARGUMENT, "'textures[%u]' is NULL", i);
+    }
+
+    return helperDefragmenter.AllocateAndBindMemory(resourceGroupDesc);
+}
+
+static void NRI_CALL ReleaseDefragmentableResources(Defragmenter& defragmenter, Buffer* const* buffers, uint32_t bufferNum, Texture* const* textures, uint32_t textureNum) {
+    HelperDefragmenter& helperDefragmenter = (HelperDefragmenter&)defragmenter;
+    DeviceVal& deviceVal = (DeviceVal&)helperDefragmenter.GetDevice();
+
+    RETURN_ON_FAILURE(&deviceVal, bufferNum == 0 || buffers != nullptr, ReturnVoid(), "'buffers' is NULL");
+    RETURN_ON_FAILURE(&deviceVal, textureNum == 0 || textures != nullptr, ReturnVoid(), "'textures' is NULL");
+
+    helperDefragmenter.ReleaseResources(buffers, bufferNum, textures, textureNum);
+}
+
+static const DefragmentationMove* NRI_CALL BeginDefragmentation(Defragmenter& defragmenter, uint64_t byteBudget, uint64_t fenceValue, uint32_t& moveNum) {
+    return ((HelperDefragmenter&)defragmenter).BeginDefragmentation(byteBudget, fenceValue, moveNum);
+}
+
+static void NRI_CALL CmdDefragment(CommandBuffer& commandBuffer, Defragmenter& defragmenter) {
+    ((HelperDefragmenter&)defragmenter).CmdDefragment(commandBuffer);
+}
+
+static Result NRI_CALL CreateTransientPool(Device& device, const TransientPoolDesc& transientPoolDesc, TransientPool*& transientPool) {
+    DeviceVal& deviceVal = (DeviceVal&)device;
+
+    transientPool = nullptr;
+
+    RETURN_ON_FAILURE(&deviceVal, transientPoolDesc.memoryLocation < MemoryLocation::MAX_NUM, Result::INVALID_ARGUMENT, "'memoryLocation' is invalid");
+    RETURN_ON_FAILURE(&deviceVal, transientPoolDesc.resourceNum == 0 || transientPoolDesc.resources != nullptr, Result::INVALID_ARGUMENT, "'resources' is NULL");
+
+    for (uint32_t i = 0; i < transientPoolDesc.resourceNum; i++) {
+        const TransientResourceDesc& resource = transientPoolDesc.resources[i];
+
+        RETURN_ON_FAILURE(&deviceVal, (resource.buffer != nullptr) != (resource.texture != nullptr), Result::INVALID_ARGUMENT, "'resources[%u]' must have either 'buffer' or 'texture'", i);
+        RETURN_ON_FAILURE(&deviceVal, resource.firstPass <= resource.lastPass, Result::INVALID_ARGUMENT, "'resources[%u].firstPass' is greater than 'lastPass'", i);
+    }
+
+    HelperTransientPool* impl = Allocate<HelperTransientPool>(deviceVal.GetAllocationCallbacks(), deviceVal.GetCoreInterfaceVal(), device);
+    Result result = impl->Create(transientPoolDesc);
+
+    if (result != Result::SUCCESS)
+        Destroy(deviceVal.GetAllocationCallbacks(), impl);
+    else
+        transientPool = (TransientPool*)impl;
+
+    return result;
+}
+
+static void NRI_CALL DestroyTransientPool(TransientPool& transientPool) {
+    Destroy(((DeviceBase&)((HelperTransientPool&)transientPool).GetDevice()).GetAllocationCallbacks(), (HelperTransientPool*)&transientPool);
+}
+
+static void NRI_CALL GetTransientPoolBarriers(const TransientPool& transientPool, uint32_t pass, BarrierGroupDesc& barrierGroupDesc) {
+    ((HelperTransientPool&)transientPool).GetBarriers(pass, barrierGroupDesc);
+}
+
+static void NRI_CALL GetTransientPoolStats(const TransientPool& transientPool, TransientPoolStats& transientPoolStats) {
+    transientPoolStats = ((HelperTransientPool&)transientPool).GetStats();
+}
+
+static Result NRI_CALL CreateMemoryBudget(Device& device, const MemoryBudgetDesc& memoryBudgetDesc, MemoryBudget*& memoryBudget) {
+    DeviceVal& deviceVal = (DeviceVal&)device;
+
+    memoryBudget = nullptr;
+
+    HelperMemoryBudget* impl = Allocate<HelperMemoryBudget>(deviceVal.GetAllocationCallbacks(), deviceVal.GetCoreInterfaceVal(), device);
+    Result result = impl->Create(memoryBudgetDesc);
+
+    if (result != Result::SUCCESS)
+        Destroy(deviceVal.GetAllocationCallbacks(), impl);
+    else
+        memoryBudget = (MemoryBudget*)impl;
+
+    return result;
+}
+
+static void NRI_CALL DestroyMemoryBudget(MemoryBudget& memoryBudget) {
+    Destroy(((DeviceBase&)((HelperMemoryBudget&)memoryBudget).GetDevice()).GetAllocationCallbacks(), (HelperMemoryBudget*)&memoryBudget);
+}
+
+static Result NRI_CALL AllocateBudgetedMemory(MemoryBudget& memoryBudget, const AllocateMemoryDesc& allocateMemoryDesc, MemoryLocation memoryLocation, Memory*& memory) {
+    DeviceVal& deviceVal = (DeviceVal&)((HelperMemoryBudget&)memoryBudget).GetDevice();
+
+    memory = nullptr;
+
+    RETURN_ON_FAILURE(&deviceVal, allocateMemoryDesc.size != 0, Result::INVALID_ARGUMENT, "'size' is 0");
+    RETURN_ON_FAILURE(&deviceVal, memoryLocation < MemoryLocation::MAX_NUM, Result::INVALID_ARGUMENT, "'memoryLocation' is invalid");
+
+    return ((HelperMemoryBudget&)memoryBudget).AllocateMemory(allocateMemoryDesc, memoryLocation, memory);
+}
+
+static void NRI_CALL FreeBudgetedMemory(MemoryBudget& memoryBudget, Memory& memory) {
+    ((HelperMemoryBudget&)memoryBudget).FreeMemory(memory);
+}
+
+static void NRI_CALL TouchBudgetedMemory(MemoryBudget& memoryBudget, Memory* const* memories, uint32_t memoryNum) {
+    ((HelperMemoryBudget&)memoryBudget).TouchMemory(memories, memoryNum);
+}
+
+static void NRI_CALL UpdateMemoryBudget(MemoryBudget& memoryBudget) {
+    ((HelperMemoryBudget&)memoryBudget).Update();
+}
+
+static void NRI_CALL GetMemoryBudgetStats(const MemoryBudget& memoryBudget, MemoryLocation memoryLocation, MemoryBudgetStats& memoryBudgetStats) {
+    DeviceVal& deviceVal = (DeviceVal&)((HelperMemoryBudget&)memoryBudget).GetDevice();
+
+    memoryBudgetStats = {};
+
+    RETURN_ON_FAILURE(&deviceVal, memoryLocation < MemoryLocation::MAX_NUM, ReturnVoid(), "'memoryLocation' is invalid");
+
+    ((HelperMemoryBudget&)memoryBudget).GetStats(memoryLocation, memoryBudgetStats);
+}
+
+static Result NRI_CALL CreateBindlessTable(Device& device, const BindlessTableDesc& bindlessTableDesc, BindlessTable*& bindlessTable) {
+    DeviceVal& deviceVal = (DeviceVal&)device;
+
+    bindlessTable = nullptr;
+
+    RETURN_ON_FAILURE(&deviceVal, bindlessTableDesc.pipelineLayout != nullptr, Result::INVALID_ARGUMENT, "'pipelineLayout' is NULL");
+    RETURN_ON_FAILURE(&deviceVal, bindlessTableDesc.fence != nullptr, Result::INVALID_ARGUMENT, "'fence' is NULL");
+    RETURN_ON_FAILURE(&deviceVal, bindlessTableDesc.descriptorNum != 0, Result::INVALID_ARGUMENT, "'descriptorNum' is 0");
+    RETURN_ON_FAILURE(&deviceVal, bindlessTableDesc.descriptorType < DescriptorType::MAX_NUM, Result::INVALID_ARGUMENT, "'descriptorType' is invalid");
+
+    const PipelineLayoutDesc& pipelineLayoutDesc = ((PipelineLayoutVal*)bindlessTableDesc.pipelineLayout)->GetPipelineLayoutDesc();
+    RETURN_ON_FAILURE(&deviceVal, bindlessTableDesc.setIndex < pipelineLayoutDesc.descriptorSetNum, Result::INVALID_ARGUMENT, "'setIndex' is invalid");
+
+    const DescriptorSetDesc& descriptorSetDesc = pipelineLayoutDesc.descriptorSets[bindlessTableDesc.setIndex];
+    RETURN_ON_FAILURE(&deviceVal, descriptorSetDesc.rangeNum == 1, Result::INVALID_ARGUMENT, "the set must have a single range");
+    RETURN_ON_FAILURE(&deviceVal, descriptorSetDesc.ranges[0].descriptorType == bindlessTableDesc.descriptorType, Result::INVALID_ARGUMENT, "'descriptorType' doesn't match the range");
+    RETURN_ON_FAILURE(&deviceVal, bindlessTableDesc.descriptorNum <= descriptorSetDesc.ranges[0].descriptorNum, Result::INVALID_ARGUMENT, "'descriptorNum' is greater than 'descriptorNum' of the range");
+
+    HelperBindlessTable* impl = Allocate<HelperBindlessTable>(deviceVal.GetAllocationCallbacks(), deviceVal.GetCoreInterfaceVal(), device);
+    Result result = impl->Create(bindlessTableDesc);
+
+    if (result != Result::SUCCESS)
+        Destroy(deviceVal.GetAllocationCallbacks(), impl);
+    else
+        bindlessTable = (BindlessTable*)impl;
+
+    return result;
+}
+
+static void NRI_CALL DestroyBindlessTable(BindlessTable& bindlessTable) {
+    Destroy(((DeviceBase&)((HelperBindlessTable&)bindlessTable).GetDevice()).GetAllocationCallbacks(), (HelperBindlessTable*)&bindlessTable);
+}
+
+static Result NRI_CALL AllocateBindlessIndices(BindlessTable& bindlessTable, uint32_t* indices, uint32_t indexNum) {
+    return ((HelperBindlessTable&)bindlessTable).AllocateIndices(indices, indexNum);
+}
+
+static void NRI_CALL FreeBindlessIndices(BindlessTable& bindlessTable, const uint32_t* indices, uint32_t indexNum, uint64_t fenceValue) {
+    ((HelperBindlessTable&)bindlessTable).FreeIndices(indices, indexNum, fenceValue);
+}
+
+static void NRI_CALL WriteBindlessDescriptors(BindlessTable& bindlessTable, const BindlessWriteDesc* bindlessWriteDescs, uint32_t bindlessWriteDescNum) {
+    ((HelperBindlessTable&)bindlessTable).WriteDescriptors(bindlessWriteDescs, bindlessWriteDescNum);
+}
+
+static void NRI_CALL UpdateBindlessTable(BindlessTable& bindlessTable) {
+    ((HelperBindlessTable&)bindlessTable).Update();
+}
+
+static DescriptorSet* NRI_CALL GetBindlessTableDescriptorSet(const BindlessTable& bindlessTable) {
+    return ((HelperBindlessTable&)bindlessTable).GetDescriptorSet();
+}
+
+static Result NRI_CALL CreateDescriptorSetCache(Device& device, const DescriptorSetCacheDesc& descriptorSetCacheDesc, DescriptorSetCache*& descriptorSetCache) {
+    DeviceVal& deviceVal = (DeviceVal&)device;
+
+    descriptorSetCache = nullptr;
+
+    RETURN_ON_FAILURE(&deviceVal, descriptorSetCacheDesc.fence != nullptr, Result::INVALID_ARGUMENT, "'fence' is NULL");
+    RETURN_ON_FAILURE(&deviceVal, descriptorSetCacheDesc.descriptorPoolDesc.descriptorSetMaxNum != 0, Result::INVALID_ARGUMENT, "'descriptorPoolDesc.descriptorSetMaxNum' is 0");
+
+    HelperDescriptorSetCache* impl = Allocate<HelperDescriptorSetCache>(deviceVal.GetAllocationCallbacks(), deviceVal.GetCoreInterfaceVal(), device);
+    Result result = impl->Create(descriptorSetCacheDesc);
+
+    if (result != Result::SUCCESS)
+        Destroy(deviceVal.GetAllocationCallbacks(), impl);
+    else
+        descriptorSetCache = (DescriptorSetCache*)impl;
+
+    return result;
+}
+
+static void NRI_CALL DestroyDescriptorSetCache(DescriptorSetCache& descriptorSetCache) {
+    Destroy(((DeviceBase&)((HelperDescriptorSetCache&)descriptorSetCache).GetDevice()).GetAllocationCallbacks(), (HelperDescriptorSetCache*)&descriptorSetCache);
+}
+
+static Result NRI_CALL GetCachedDescriptorSet(DescriptorSetCache& descriptorSetCache, const CachedDescriptorSetDesc& cachedDescriptorSetDesc, uint64_t fenceValue, DescriptorSet*& descriptorSet) {
+    DeviceVal& deviceVal = (DeviceVal&)((HelperDescriptorSetCache&)descriptorSetCache).GetDevice();
+
+    descriptorSet = nullptr;
+
+    RETURN_ON_FAILURE(&deviceVal, cachedDescriptorSetDesc.pipelineLayout != nullptr, Result::INVALID_ARGUMENT, "'pipelineLayout' is NULL");
+    RETURN_ON_FAILURE(&deviceVal, cachedDescriptorSetDesc.rangeNum == 0 || cachedDescriptorSetDesc.ranges != nullptr, Result::INVALID_ARGUMENT, "'ranges' is NULL");
+    RETURN_ON_FAILURE(&deviceVal, cachedDescriptorSetDesc.dynamicConstantBufferNum == 0 || cachedDescriptorSetDesc.dynamicConstantBuffers != nullptr, Result::INVALID_ARGUMENT, "'dynamicConstantBuffers' is NULL");
+
+    const PipelineLayoutDesc& pipelineLayoutDesc = ((PipelineLayoutVal*)cachedDescriptorSetDesc.pipelineLayout)->GetPipelineLayoutDesc();
+    RETURN_ON_FAILURE(&deviceVal, cachedDescriptorSetDesc.setIndex < pipelineLayoutDesc.descriptorSetNum, Result::INVALID_ARGUMENT, "'setIndex' is invalid");
+
+    const DescriptorSetDesc& descriptorSetDesc = pipelineLayoutDesc.descriptorSets[cachedDescriptorSetDesc.setIndex];
+    RETURN_ON_FAILURE(&deviceVal, cachedDescriptorSetDesc.rangeNum <= descriptorSetDesc.rangeNum, Result::INVALID_ARGUMENT, "'rangeNum' is greater than 'rangeNum' of the set");
+    RETURN_ON_FAILURE(&deviceVal, cachedDescriptorSetDesc.dynamicConstantBufferNum <= descriptorSetDesc.dynamicConstantBufferNum, Result::INVALID_ARGUMENT, "'dynamicConstantBufferNum' is greater than 'dynamicConstantBufferNum' of the set");
+
+    for (uint32_t i = 0; i < descriptorSetDesc.rangeNum; i++)
+        RETURN_ON_FAILURE(&deviceVal, !(descriptorSetDesc.ranges[i].flags & DescriptorRangeBits::VARIABLE_SIZED_ARRAY), Result::INVALID_ARGUMENT, "sets with 'VARIABLE_SIZED_ARRAY' ranges can't be cached");
+
+    return ((HelperDescriptorSetCache&)descriptorSetCache).GetDescriptorSet(cachedDescriptorSetDesc, fenceValue, descriptorSet);
+}
+
+static void NRI_CALL PurgeCachedDescriptorSets(DescriptorSetCache& descriptorSetCache, const Descriptor* const* descriptors, uint32_t descriptorNum) {
+    DeviceVal& deviceVal = (DeviceVal&)((HelperDescriptorSetCache&)descriptorSetCache).GetDevice();
+
+    RETURN_ON_FAILURE(&deviceVal, descriptorNum == 0 || descriptors != nullptr, ReturnVoid(), "'descriptors' is NULL");
+
+    ((HelperDescriptorSetCache&)descriptorSetCache).Purge(descriptors, descriptorNum);
+}
+
+static void NRI_CALL GetDescriptorSetCacheStats(const DescriptorSetCache& descriptorSetCache, DescriptorSetCacheStats& descriptorSetCacheStats) {
+    ((HelperDescriptorSetCache&)descriptorSetCache).GetStats(descriptorSetCacheStats);
+}
+
+static Result NRI_CALL CreatePipelineCache(Device& device, const PipelineCacheDesc& pipelineCacheDesc, PipelineCache*& pipelineCache) {
+    DeviceVal& deviceVal = (DeviceVal&)device;
+
+    RETURN_ON_FAILURE(&deviceVal, pipelineCacheDesc.dataSize == 0 || pipelineCacheDesc.data != nullptr, Result::INVALID_ARGUMENT, "'data' is NULL");
+
+    HelperPipelineCache* impl = Allocate<HelperPipelineCache>(deviceVal.GetAllocationCallbacks(), deviceVal.GetCoreInterfaceVal(), device);
+    Result result = impl->Create(pipelineCacheDesc);
+
+    if (result != Result::SUCCESS) {
+        Destroy(deviceVal.GetAllocationCallbacks(), impl);
+        pipelineCache = nullptr;
+    } else
+        pipelineCache = (PipelineCache*)impl;
+
+    return result;
+}
+
+static void NRI_CALL DestroyPipelineCache(PipelineCache& pipelineCache) {
+    Destroy(((DeviceBase&)((HelperPipelineCache&)pipelineCache).GetDevice()).GetAllocationCallbacks(), (HelperPipelineCache*)&pipelineCache);
+}
+
+static Result NRI_CALL GetCachedGraphicsPipeline(PipelineCache& pipelineCache, const GraphicsPipelineDesc& graphicsPipelineDesc, Pipeline*& pipeline) {
+    DeviceVal& deviceVal = (DeviceVal&)((HelperPipelineCache&)pipelineCache).GetDevice();
+
+    RETURN_ON_FAILURE(&deviceVal, graphicsPipelineDesc.pipelineLayout != nullptr, Result::INVALID_ARGUMENT, "'pipelineLayout' is NULL");
+    RETURN_ON_FAILURE(&deviceVal, graphicsPipelineDesc.shaders != nullptr, Result::INVALID_ARGUMENT, "'shaders' is NULL");
+    RETURN_ON_FAILURE(&deviceVal, graphicsPipelineDesc.outputMerger.colorNum == 0 || graphicsPipelineDesc.outputMerger.colors != nullptr, Result::INVALID_ARGUMENT, "'outputMerger.colors' is NULL");
+
+    const VertexInputDesc* vertexInput = graphicsPipelineDesc.vertexInput;
+    if (vertexInput) {
+        RETURN_ON_FAILURE(&deviceVal, vertexInput->attributeNum == 0 || vertexInput->attributes != nullptr, Result::INVALID_ARGUMENT, "'vertexInput->attributes' is NULL");
+        RETURN_ON_FAILURE(&deviceVal, vertexInput->streamNum == 0 || vertexInput->streams != nullptr, Result::INVALID_ARGUMENT, "'vertexInput->streams' is NULL");
+    }
+
+    for (uint32_t i = 0; i < graphicsPipelineDesc.shaderNum; i++) {
+        const ShaderDesc& shaderDesc = graphicsPipelineDesc.shaders[i];
+        RETURN_ON_FAILURE(&deviceVal, shaderDesc.bytecode != nullptr && shaderDesc.size != 0, Result::INVALID_ARGUMENT, "'shaders[%u]' has no bytecode", i);
+    }
+
+    return ((HelperPipelineCache&)pipelineCache).GetGraphicsPipeline(graphicsPipelineDesc, pipeline);
+}
+
+static Result NRI_CALL GetCachedComputePipeline(PipelineCache& pipelineCache, const ComputePipelineDesc& computePipelineDesc, Pipeline*& pipeline) {
+    DeviceVal& deviceVal = (DeviceVal&)((HelperPipelineCache&)pipelineCache).GetDevice();
+
+    RETURN_ON_FAILURE(&deviceVal, computePipelineDesc.pipelineLayout != nullptr, Result::INVALID_ARGUMENT, "'pipelineLayout' is NULL");
+    RETURN_ON_FAILURE(&deviceVal, computePipelineDesc.shader.bytecode != nullptr && computePipelineDesc.shader.size != 0, Result::INVALID_ARGUMENT, "'shader' has no bytecode");
+
+    return ((HelperPipelineCache&)pipelineCache).GetComputePipeline(computePipelineDesc, pipeline);
+}
+
+static void NRI_CALL PurgeCachedPipelines(PipelineCache& pipelineCache, const PipelineLayout& pipelineLayout) {
+    ((HelperPipelineCache&)pipelineCache).Purge(pipelineLayout);
+}
+
+static void NRI_CALL GetPipelineCacheStats(const PipelineCache& pipelineCache, PipelineCacheStats& pipelineCacheStats) {
+    ((HelperPipelineCache&)pipelineCache).GetStats(pipelineCacheStats);
+}
+
 static Result NRI_CALL WaitForIdle(Queue& queue) {
     if (!(&queue))
         return Result::SUCCESS;
@@ -785,12 +1158,67 @@ static Result NRI_CALL QueryVideoMemoryInfo(const Device& device, MemoryLocation
     return deviceVal.GetHelperInterface().QueryVideoMemoryInfo(deviceVal.GetImpl(), memoryLocation, videoMemoryInfo);
 }
 
+static Result NRI_CALL MergePipelineCacheData(Device& device, const void* data, uint64_t dataSize) {
+    DeviceVal& deviceVal = (DeviceVal&)device;
+
+    RETURN_ON_FAILURE(&deviceVal, data != nullptr, Result::INVALID_ARGUMENT, "'data' is NULL");
+    RETURN_ON_FAILURE(&deviceVal, dataSize != 0, Result::INVALID_ARGUMENT, "'dataSize' is 0");
+
+    return deviceVal.GetHelperInterface().MergePipelineCacheData(deviceVal.GetImpl(), data, dataSize);
+}
+
+static Result NRI_CALL GetPipelineCacheData(const Device& device, void* data, uint64_t& dataSize) {
+    DeviceVal& deviceVal = (DeviceVal&)device;
+
+    return deviceVal.GetHelperInterface().GetPipelineCacheData(deviceVal.GetImpl(), data, dataSize);
+}
+
 Result DeviceVal::FillFunctionTable(HelperInterface& table) const {
     table.CalculateAllocationNumber = ::CalculateAllocationNumber;
     table.AllocateAndBindMemory = ::AllocateAndBindMemory;
     table.UploadData = ::UploadData;
+    table.CreateDataUploader = ::CreateDataUploader;
+    table.DestroyDataUploader = ::DestroyDataUploader;
+    table.UploadDataAsync = ::UploadDataAsync;
+    table.CreateDefragmenter = ::CreateDefragmenter;
+    table.DestroyDefragmenter = ::DestroyDefragmenter;
+    table.AllocateAndBindDefragmentableMemory = ::AllocateAndBindDefragmentableMemory;
+    table.ReleaseDefragmentableResources = ::ReleaseDefragmentableResources;
+    table.BeginDefragmentation = ::BeginDefragmentation;
+    table.CmdDefragment = ::CmdDefragment;
+    table.CreateTransientPool = ::CreateTransientPool;
+    table.DestroyTransientPool = ::DestroyTransientPool;
+    table.GetTransientPoolBarriers = ::GetTransientPoolBarriers;
+    table.GetTransientPoolStats = ::GetTransientPoolStats;
+    table.CreateMemoryBudget = ::CreateMemoryBudget;
+    table.DestroyMemoryBudget = ::DestroyMemoryBudget;
+    table.AllocateBudgetedMemory = ::AllocateBudgetedMemory;
+    table.FreeBudgetedMemory = ::FreeBudgetedMemory;
+    table.TouchBudgetedMemory = ::TouchBudgetedMemory;
+    table.UpdateMemoryBudget = ::UpdateMemoryBudget;
+    table.GetMemoryBudgetStats = ::GetMemoryBudgetStats;
+    table.CreateBindlessTable = ::CreateBindlessTable;
+    table.DestroyBindlessTable = ::DestroyBindlessTable;
+    table.AllocateBindlessIndices = ::AllocateBindlessIndices;
+    table.FreeBindlessIndices = ::FreeBindlessIndices;
+    table.WriteBindlessDescriptors = ::WriteBindlessDescriptors;
+    table.UpdateBindlessTable = ::UpdateBindlessTable;
+    table.GetBindlessTableDescriptorSet = ::GetBindlessTableDescriptorSet;
+    table.CreateDescriptorSetCache = ::CreateDescriptorSetCache;
+    table.DestroyDescriptorSetCache = ::DestroyDescriptorSetCache;
+    table.GetCachedDescriptorSet = ::GetCachedDescriptorSet;
+    table.PurgeCachedDescriptorSets = ::PurgeCachedDescriptorSets;
+    table.GetDescriptorSetCacheStats = ::GetDescriptorSetCacheStats;
+    table.CreatePipelineCache = ::CreatePipelineCache;
+    table.DestroyPipelineCache = ::DestroyPipelineCache;
+    table.GetCachedGraphicsPipeline = ::GetCachedGraphicsPipeline;
+    table.GetCachedComputePipeline = ::GetCachedComputePipeline;
+    table.PurgeCachedPipelines = ::PurgeCachedPipelines;
+    table.GetPipelineCacheStats = ::GetPipelineCacheStats;
     table.WaitForIdle = ::WaitForIdle;
     table.QueryVideoMemoryInfo = ::QueryVideoMemoryInfo;
+    table.MergePipelineCacheData = ::MergePipelineCacheData;
+    table.GetPipelineCacheData = ::GetPipelineCacheData;
 
     return Result::SUCCESS;
 }
@@ -1035,7 +1463,9 @@ struct StreamerVal : public ObjectVal {
     }
 
     StreamerDesc m_Desc = {}; // only for .natvis
-    bool isDynamicBufferValid = false;
+    std::atomic_bool isDynamicBufferValid = false; // producers can live on different threads
+    uint64_t fenceValue = 0;
+    bool isFenceValueSet = false;
 };
 
 static Result CreateStreamer(Device& device, const StreamerDesc& streamerDesc, Streamer*& streamer) {
@@ -1089,6 +1519,25 @@ static uint32_t UpdateStreamerConstantBuffer(Streamer& streamer, const void* dat
     return streamerImpl->UpdateConstantBuffer(data, dataSize);
 }
 
+static void UpdateStreamerConstantBuffers(Streamer& streamer, const ConstantBufferUpdateRequestDesc* constantBufferUpdateRequestDescs, uint32_t constantBufferUpdateRequestDescNum, uint32_t* offsets) {
+    DeviceVal& deviceVal = GetDeviceVal(streamer);
+    StreamerVal& streamerVal = (StreamerVal&)streamer;
+    StreamerImpl* streamerImpl = streamerVal.GetImpl();
+
+    if (!constantBufferUpdateRequestDescNum)
+        return;
+
+    RETURN_ON_FAILURE(&deviceVal, constantBufferUpdateRequestDescs != nullptr, ReturnVoid(), "'constantBufferUpdateRequestDescs' is NULL");
+    RETURN_ON_FAILURE(&deviceVal, offsets != nullptr, ReturnVoid(), "'offsets' is NULL");
+
+    for (uint32_t i = 0; i < constantBufferUpdateRequestDescNum; i++) {
+        if (!constantBufferUpdateRequestDescs[i].dataSize)
+            REPORT_WARNING(&deviceVal, "'constantBufferUpdateRequestDescs[%u].dataSize = 0'", i);
+    }
+
+    streamerImpl->UpdateConstantBuffers(constantBufferUpdateRequestDescs, constantBufferUpdateRequestDescNum, offsets);
+}
+
 static uint64_t AddStreamerBufferUpdateRequest(Streamer& streamer, const BufferUpdateRequestDesc& bufferUpdateRequestDesc) {
     DeviceVal& deviceVal = GetDeviceVal(streamer);
     StreamerVal& streamerVal = (StreamerVal&)streamer;
@@ -1119,15 +1568,58 @@ static uint64_t AddStreamerTextureUpdateRequest(Streamer& streamer, const Textur
     return streamerImpl->AddTextureUpdateRequest(textureUpdateRequestDesc);
 }
 
+static void* ReserveStreamerBufferUpdateRequest(Streamer& streamer, const BufferUpdateRequestDesc& bufferUpdateRequestDesc, uint64_t& offset) {
+    DeviceVal& deviceVal = GetDeviceVal(streamer);
+    StreamerVal& streamerVal = (StreamerVal&)streamer;
+    StreamerImpl* streamerImpl = streamerVal.GetImpl();
+
+    streamerVal.isDynamicBufferValid = false;
+
+    if (!bufferUpdateRequestDesc.dataSize)
+        REPORT_WARNING(&deviceVal, "'bufferUpdateRequestDesc.dataSize = 0'");
+    if (bufferUpdateRequestDesc.data)
+        REPORT_WARNING(&deviceVal, "'bufferUpdateRequestDesc.data' is ignored");
+
+    return streamerImpl->ReserveBufferUpdateRequest(bufferUpdateRequestDesc, offset);
+}
+
+static void SetStreamerFenceValue(Streamer& streamer, uint64_t fenceValue) {
+    DeviceVal& deviceVal = GetDeviceVal(streamer);
+    StreamerVal& streamerVal = (StreamerVal&)streamer;
+    StreamerImpl* streamerImpl = streamerVal.GetImpl();
+
+    if (!streamerVal.m_Desc.fence)
+        REPORT_WARNING(&deviceVal, "'StreamerDesc::fence' is not provided, 'fenceValue' is ignored");
+    else if (fenceValue <= streamerVal.fenceValue)
+        REPORT_ERROR(&deviceVal, "'fenceValue' must increase monotonically");
+
+    streamerVal.fenceValue = fenceValue;
+    streamerVal.isFenceValueSet = true;
+
+    streamerImpl->SetFenceValue(fenceValue);
+}
+
 static Result CopyStreamerUpdateRequests(Streamer& streamer) {
+    DeviceVal& deviceVal = GetDeviceVal(streamer);
     StreamerVal& streamerVal = (StreamerVal&)streamer;
     StreamerImpl* streamerImpl = streamerVal.GetImpl();
 
+    if (streamerVal.m_Desc.fence && !streamerVal.isFenceValueSet)
+        REPORT_ERROR(&deviceVal, "'SetStreamerFenceValue' must be called before 'CopyStreamerUpdateRequests'");
+
     streamerVal.isDynamicBufferValid = true;
+    streamerVal.isFenceValueSet = false;
 
     return streamerImpl->CopyUpdateRequests();
 }
 
+static void GetStreamerStats(const Streamer& streamer, StreamerStats& streamerStats) {
+    const StreamerVal& streamerVal = (StreamerVal&)streamer;
+    const StreamerImpl* streamerImpl = streamerVal.GetImpl();
+
+    streamerImpl->GetStats(streamerStats);
+}
+
 static Buffer* GetStreamerDynamicBuffer(Streamer& streamer) {
     DeviceVal& deviceVal = GetDeviceVal(streamer);
     StreamerVal& streamerVal = (StreamerVal&)streamer;
@@ -1153,8 +1645,12 @@ Result DeviceVal::FillFunctionTable(StreamerInterface& table) const {
     table.GetStreamerDynamicBuffer = ::GetStreamerDynamicBuffer;
     table.AddStreamerBufferUpdateRequest = ::AddStreamerBufferUpdateRequest;
     table.AddStreamerTextureUpdateRequest = ::AddStreamerTextureUpdateRequest;
+    table.ReserveStreamerBufferUpdateRequest = ::ReserveStreamerBufferUpdateRequest;
     table.UpdateStreamerConstantBuffer = ::UpdateStreamerConstantBuffer;
+    table.UpdateStreamerConstantBuffers = ::UpdateStreamerConstantBuffers;
+    table.SetStreamerFenceValue = ::SetStreamerFenceValue;
     table.CopyStreamerUpdateRequests = ::CopyStreamerUpdateRequests;
+    table.GetStreamerStats = ::GetStreamerStats;
     table.CmdUploadStreamerUpdateRequests = ::CmdUploadStreamerUpdateRequests;
 
     return Result::SUCCESS;
@@ -33,9 +33,10 @@ struct MemoryVal final : public ObjectVal {
     void BindAccelerationStructure(AccelerationStructureVal& accelerationStructure);
 
 private:
-    Vector<BufferVal*> m_Buffers;
-    Vector<TextureVal*> m_Textures;
-    Vector<AccelerationStructureVal*> m_AccelerationStructures;
+    void Link(MemoryBindingVal& binding, ObjectVal& resource, const char* resourceType);
+    void Unlink(MemoryBindingVal& binding);
+
+    MemoryBindingVal* m_Bindings = nullptr;
     uint64_t m_Size = 0;
     MemoryLocation m_MemoryLocation = MemoryLocation::MAX_NUM; // wrapped object
     Lock m_Lock;
@@ -1,90 +1,80 @@
 // © 2021 NVIDIA Corporation
 
-#include <algorithm>
-
 MemoryVal::MemoryVal(DeviceVal& device, Memory* memory, uint64_t size, MemoryLocation memoryLocation)
     : ObjectVal(device, memory)
-    , m_Buffers(device.GetStdAllocator())
-    , m_Textures(device.GetStdAllocator())
-    , m_AccelerationStructures(device.GetStdAllocator())
     , m_Size(size)
     , m_MemoryLocation(memoryLocation) {
 }
 
 bool MemoryVal::HasBoundResources() {
     ExclusiveScope lockScope(m_Lock);
-    return !m_Buffers.empty() || !m_Textures.empty() || !m_AccelerationStructures.empty();
+    return m_Bindings != nullptr;
 }
 
 void MemoryVal::ReportBoundResources() {
     ExclusiveScope lockScope(m_Lock);
 
-    for (size_t i = 0; i < m_Buffers.size(); i++) {
-        BufferVal& buffer = *m_Buffers[i];
-        REPORT_ERROR(&m_Device, "Buffer (%p '%s') is still bound to the memory", &buffer, buffer.GetDebugName());
-    }
-
-    for (size_t i = 0; i < m_Textures.size(); i++) {
-        TextureVal& texture = *m_Textures[i];
-        REPORT_ERROR(&m_Device, "Texture (%p '%s') is still bound to the memory", &texture, texture.GetDebugName());
-    }
-
-    for (size_t i = 0; i < m_AccelerationStructures.size(); i++) {
-        AccelerationStructureVal& accelerationStructure = *m_AccelerationStructures[i];
-        REPORT_ERROR(&m_Device, "AccelerationStructure (%p '%s') is still bound to the memory", &accelerationStructure, accelerationStructure.GetDebugName());
-    }
+    for (const MemoryBindingVal* binding = m_Bindings; binding; binding = binding->next)
+        REPORT_ERROR(&m_Device, "%s (%p '%s') is still bound to the memory", binding->resourceType, binding->resource, binding->resource->GetDebugName());
 }
 
 void MemoryVal::UnbindBuffer(BufferVal& buffer) {
-    ExclusiveScope lockScope(m_Lock);
-
-    const auto it = std::find(m_Buffers.begin(), m_Buffers.end(), &buffer);
-    if (it == m_Buffers.end()) {
-        REPORT_ERROR(&m_Device, "Unexpected error: Can't find the buffer in the list of bound resources");
-        return;
-    }
-
-    m_Buffers.erase(it);
+    Unlink(buffer.GetMemoryBinding());
 }
 
 void MemoryVal::UnbindTexture(TextureVal& texture) {
-    ExclusiveScope lockScope(m_Lock);
-
-    const auto it = std::find(m_Textures.begin(), m_Textures.end(), &texture);
-    if (it == m_Textures.end()) {
-        REPORT_ERROR(&m_Device, "Unexpected error: Can't find the texture in the list of bound resources");
-        return;
-    }
-
-    m_Textures.erase(it);
+    Unlink(texture.GetMemoryBinding());
 }
 
 void MemoryVal::UnbindAccelerationStructure(AccelerationStructureVal& accelerationStructure) {
-    ExclusiveScope lockScope(m_Lock);
-
-    const auto it = std::find(m_AccelerationStructures.begin(), m_AccelerationStructures.end(), &accelerationStructure);
-    if (it == m_AccelerationStructures.end()) {
-        REPORT_ERROR(&m_Device, "Unexpected error: Can't find the acceleration structure in the list of bound resources");
-        return;
-    }
-
-    m_AccelerationStructures.erase(it);
+    Unlink(accelerationStructure.GetMemoryBinding());
 }
 
 void MemoryVal::BindBuffer(BufferVal& buffer) {
-    ExclusiveScope lockScope(m_Lock);
-    m_Buffers.push_back(&buffer);
+    Link(buffer.GetMemoryBinding(), buffer, "Buffer");
     buffer.SetBoundToMemory(this);
 }
 
 void MemoryVal::BindTexture(TextureVal& texture) {
-    ExclusiveScope lockScope(m_Lock);
-    m_Textures.push_back(&texture);
+    Link(texture.GetMemoryBinding(), texture, "Texture");
     texture.SetBoundToMemory(this);
 }
 
 void MemoryVal::BindAccelerationStructure(AccelerationStructureVal& accelerationStructure) {
-    ExclusiveScope lockScope(m_Lock);
-    m_AccelerationStructures.push_back(&accelerationStructure);
+    Link(accelerationStructure.GetMemoryBinding(), accelerationStructure, "AccelerationStructure");
     accelerationStructure.SetBoundToMemory(*this);
 }
+
+void MemoryVal::Link(MemoryBindingVal& binding, ObjectVal& resource, const char* resourceType) {
+    binding.resource = &resource;
+    binding.resourceType = resourceType;
+    binding.prev = nullptr;
+
+    ExclusiveScope lockScope(m_Lock);
+
+    binding.next = m_Bindings;
+    if (m_Bindings)
+        m_Bindings->prev = &binding;
+
+    m_Bindings = &binding;
+}
+
+void MemoryVal::Unlink(MemoryBindingVal& binding) {
+    ExclusiveScope lockScope(m_Lock);
+
+    if (!binding.prev && m_Bindings != &binding) {
+        REPORT_ERROR(&m_Device, "Unexpected error: Can't find the resource in the list of bound resources");
+        return;
+    }
+
+    if (binding.prev)
+        binding.prev->next = binding.next;
+    else
+        m_Bindings = binding.next;
+
+    if (binding.next)
+        binding.next->prev = binding.prev;
+
+    binding.prev = nullptr;
+    binding.next = nullptr;
+}
@@ -92,6 +92,14 @@ protected:
     DeviceVal& m_Device;
 };
 
+// Intrusive node of the list of resources bound to a memory, unlinking is O(1)
+struct MemoryBindingVal {
+    ObjectVal* resource;
+    const char* resourceType;
+    MemoryBindingVal* prev;
+    MemoryBindingVal* next;
+};
+
 #define NRI_GET_IMPL(className, object) (object ? ((className##Val*)object)->GetImpl() : nullptr)
 
 template <typename T>
@@ -36,9 +36,14 @@ struct TextureVal final : public ObjectVal {
         m_IsBoundToMemory = true;
     }
 
+    inline MemoryBindingVal& GetMemoryBinding() {
+        return m_MemoryBinding;
+    }
+
 private:
     TextureDesc m_Desc = {}; // (only for) .natvis
     MemoryVal* m_Memory = nullptr;
+    MemoryBindingVal m_MemoryBinding = {};
     bool m_IsBoundToMemory = false;
 };
 
@@ -0,0 +1,150 @@
+// © 2021 NVIDIA Corporation
+
+#include "Tests.h"
+
+// Streamer
+bool TestStreamerProducers();
+bool TestStreamerReservations();
+bool TestStreamerCoalescing();
+bool TestStreamerOverlappingUpdates();
+bool TestStreamerTextures();
+bool TestStreamerFailedGrow();
+bool TestStreamerRing();
+bool TestStreamerConstantRing();
+
+// Data upload
+bool TestDataUploadPipelining();
+bool TestDataUploadHost();
+bool TestDataUploadHostBlockCompressed();
+
+// Memory allocator
+bool TestMemoryAllocatorTLSF();
+bool TestMemoryAllocatorResources();
+bool TestMemoryAllocatorBestFit();
+
+// Defragmenter
+bool TestDefragmenter();
+bool TestDefragmenterRetirement();
+bool TestDefragmenterInFlightPasses();
+
+// Transient pool
+bool TestTransientPoolAliasing();
+bool TestTransientPoolSolver();
+
+// Memory budget
+bool TestMemoryBudgetEviction();
+bool TestMemoryBudgetDeferredEviction();
+
+// Validation
+bool TestValidationSampling();
+bool TestMemoryBindingsStress();
+
+// Scratch arena
+bool TestScratchArena();
+
+// Locks
+bool TestLockStress();
+bool TestRwLockStress();
+
+// Object pool
+bool TestObjectPoolBlocks();
+bool TestObjectPoolChurn();
+bool TestObjectPoolDestroyViaBase();
+
+// Descriptor slot allocator
+bool TestDescriptorSlotAllocatorBasics();
+bool TestDescriptorSlotAllocatorChurn();
+bool TestDescriptorSlotAllocatorThroughput();
+bool TestDescriptorSlotAllocatorThreadExit();
+
+// Bindless table
+bool TestBindlessTableIndices();
+bool TestBindlessTableThreads();
+bool TestBindlessTableStreaming();
+
+// Descriptor pool
+bool TestDescriptorPoolOccupancy();
+bool TestDescriptorPoolFrames();
+
+// Descriptor set cache
+bool TestDescriptorSetCache();
+
+// Pipeline cache
+bool TestPipelineCacheConcurrency();
+bool TestPipelineCacheFailures();
+bool TestPipelineCachePurge();
+
+struct Test {
+    const char* name;
+    bool (*func)();
+};
+
+static const Test g_Tests[] = {
+    {"StreamerProducers", TestStreamerProducers},
+    {"StreamerReservations", TestStreamerReservations},
+    {"StreamerCoalescing", TestStreamerCoalescing},
+    {"StreamerOverlappingUpdates", TestStreamerOverlappingUpdates},
+    {"StreamerTextures", TestStreamerTextures},
+    {"StreamerFailedGrow", TestStreamerFailedGrow},
+    {"StreamerRing", TestStreamerRing},
+    {"StreamerConstantRing", TestStreamerConstantRing},
+    {"DataUploadPipelining", TestDataUploadPipelining},
+    {"DataUploadHost", TestDataUploadHost},
+    {"DataUploadHostBlockCompressed", TestDataUploadHostBlockCompressed},
+    {"MemoryAllocatorTLSF", TestMemoryAllocatorTLSF},
+    {"MemoryAllocatorResources", TestMemoryAllocatorResources},
+    {"MemoryAllocatorBestFit", TestMemoryAllocatorBestFit},
+    {"Defragmenter", TestDefragmenter},
+    {"DefragmenterRetirement", TestDefragmenterRetirement},
+    {"DefragmenterInFlightPasses", TestDefragmenterInFlightPasses},
+    {"TransientPoolAliasing", TestTransientPoolAliasing},
+    {"TransientPoolSolver", TestTransientPoolSolver},
+    {"MemoryBudgetEviction", TestMemoryBudgetEviction},
+    {"MemoryBudgetDeferredEviction", TestMemoryBudgetDeferredEviction},
+    {"ValidationSampling", TestValidationSampling},
+    {"MemoryBindingsStress", TestMemoryBindingsStress},
+    {"ScratchArena", TestScratchArena},
+    {"LockStress", TestLockStress},
+    {"RwLockStress", TestRwLockStress},
+    {"ObjectPoolBlocks", TestObjectPoolBlocks},
+    {"ObjectPoolChurn", TestObjectPoolChurn},
+    {"ObjectPoolDestroyViaBase", TestObjectPoolDestroyViaBase},
+    {"DescriptorSlotAllocatorBasics", TestDescriptorSlotAllocatorBasics},
+    {"DescriptorSlotAllocatorChurn", TestDescriptorSlotAllocatorChurn},
+    {"DescriptorSlotAllocatorThroughput", TestDescriptorSlotAllocatorThroughput},
+    {"DescriptorSlotAllocatorThreadExit", TestDescriptorSlotAllocatorThreadExit},
+    {"BindlessTableIndices", TestBindlessTableIndices},
+    {"BindlessTableThreads", TestBindlessTableThreads},
+    {"BindlessTableStreaming", TestBindlessTableStreaming},
+    {"DescriptorPoolOccupancy", TestDescriptorPoolOccupancy},
+    {"DescriptorPoolFrames", TestDescriptorPoolFrames},
+    {"DescriptorSetCache", TestDescriptorSetCache},
+    {"PipelineCacheConcurrency", TestPipelineCacheConcurrency},
+    {"PipelineCacheFailures", TestPipelineCacheFailures},
+    {"PipelineCachePurge", TestPipelineCachePurge},
+};
+
+// Usage: "NRITests [substring of test names]"
+int main(int argc, char** argv) {
+    const char* filter = argc > 1 ? argv[1] : "";
+
+    uint32_t failedNum = 0;
+    uint32_t runNum = 0;
+    for (const Test& test : g_Tests) {
+        if (!strstr(test.name, filter))
+            continue;
+
+        printf("[%s]\n", test.name);
+        fflush(stdout);
+
+        bool isPassed = test.func();
+        printf("    %s\n", isPassed ? "passed" : "FAILED");
+
+        failedNum += isPassed ? 0 : 1;
+        runNum++;
+    }
+
+    printf("%u of %u tests passed\n", runNum - failedNum, runNum);
+
+    return failedNum ? 1 : 0;
+}
@@ -0,0 +1,341 @@
+// © 2021 NVIDIA Corporation
+
+#include "Tests.h"
+
+#include <algorithm>
+#include <atomic>
+
+using namespace nri;
+
+constexpr uint32_t BINDLESS_DESCRIPTOR_NUM = 65536;
+
+static void CountErrors(Message messageType, const char*, uint32_t, const char*, void* userArg) {
+    if (messageType == Message::ERROR)
+        ((std::atomic_uint32_t*)userArg)->fetch_add(1, std::memory_order_relaxed);
+}
+
+// A fence, a layout with one variable sized array of textures and a view to write into it
+struct TestBindlessObjects {
+    TestDevice device;
+    std::atomic_uint32_t errorNum = 0;
+    Fence* fence = nullptr;
+    PipelineLayout* pipelineLayout = nullptr;
+    Texture* texture = nullptr;
+    Memory* memory = nullptr;
+    Descriptor* descriptor = nullptr;
+    BindlessTableDesc bindlessTableDesc = {};
+
+    ~TestBindlessObjects() {
+        if (descriptor)
+            device.core.DestroyDescriptor(*descriptor);
+        if (texture)
+            device.core.DestroyTexture(*texture);
+        if (memory)
+            device.core.FreeMemory(*memory);
+        if (pipelineLayout)
+            device.core.DestroyPipelineLayout(*pipelineLayout);
+        if (fence)
+            device.core.DestroyFence(*fence);
+    }
+
+    inline bool Create(bool enableValidation) {
+        CallbackInterface callbackInterface = {};
+        callbackInterface.MessageCallback = CountErrors;
+        callbackInterface.AbortExecution = [](void*) {};
+        callbackInterface.userArg = &errorNum;
+
+        if (!device.Create(enableValidation, nullptr, &callbackInterface))
+            return false;
+
+        if (device.core.CreateFence(*device.device, 0, fence) != Result::SUCCESS)
+            return false;
+
+        DescriptorRangeDesc descriptorRangeDesc = {};
+        descriptorRangeDesc.descriptorNum = BINDLESS_DESCRIPTOR_NUM;
+        descriptorRangeDesc.descriptorType = DescriptorType::TEXTURE;
+        descriptorRangeDesc.shaderStages = StageBits::FRAGMENT_SHADER;
+        descriptorRangeDesc.flags = DescriptorRangeBits::PARTIALLY_BOUND | DescriptorRangeBits::VARIABLE_SIZED_ARRAY;
+
+        DescriptorSetDesc descriptorSetDesc = {};
+        descriptorSetDesc.ranges = &descriptorRangeDesc;
+        descriptorSetDesc.rangeNum = 1;
+
+        PipelineLayoutDesc pipelineLayoutDesc = {};
+        pipelineLayoutDesc.descriptorSets = &descriptorSetDesc;
+        pipelineLayoutDesc.descriptorSetNum = 1;
+        pipelineLayoutDesc.shaderStages = StageBits::FRAGMENT_SHADER;
+
+        if (device.core.CreatePipelineLayout(*device.device, pipelineLayoutDesc, pipelineLayout) != Result::SUCCESS)
+            return false;
+
+        TextureDesc textureDesc = {};
+        textureDesc.type = TextureType::TEXTURE_2D;
+        textureDesc.format = Format::RGBA8_UNORM;
+        textureDesc.width = 4;
+        textureDesc.height = 4;
+        textureDesc.mipNum = 1;
+        textureDesc.layerNum = 1;
+        textureDesc.usage = TextureUsageBits::SHADER_RESOURCE;
+
+        if (device.core.CreateTexture(*device.device, textureDesc, texture) != Result::SUCCESS)
+            return false;
+
+        ResourceGroupDesc resourceGroupDesc = {};
+        resourceGroupDesc.memoryLocation = MemoryLocation::DEVICE;
+        resourceGroupDesc.textures = &texture;
+        resourceGroupDesc.textureNum = 1;
+
+        if (device.helper.AllocateAndBindMemory(*device.device, resourceGroupDesc, &memory) != Result::SUCCESS)
+            return false;
+
+        Texture2DViewDesc textureViewDesc = {};
+        textureViewDesc.texture = texture;
+        textureViewDesc.viewType = Texture2DViewType::SHADER_RESOURCE_2D;
+        textureViewDesc.format = Format::RGBA8_UNORM;
+
+        if (device.core.CreateTexture2DView(textureViewDesc, descriptor) != Result::SUCCESS)
+            return false;
+
+        bindlessTableDesc.pipelineLayout = pipelineLayout;
+        bindlessTableDesc.fence = fence;
+        bindlessTableDesc.descriptorNum = BINDLESS_DESCRIPTOR_NUM;
+        bindlessTableDesc.descriptorType = DescriptorType::TEXTURE;
+
+        return true;
+    }
+
+    inline void Signal(uint64_t value) {
+        FenceSubmitDesc fenceSubmitDesc = {};
+        fenceSubmitDesc.fence = fence;
+        fenceSubmitDesc.value = value;
+        fenceSubmitDesc.stages = StageBits::ALL;
+
+        QueueSubmitDesc queueSubmitDesc = {};
+        queueSubmitDesc.signalFences = &fenceSubmitDesc;
+        queueSubmitDesc.signalFenceNum = 1;
+
+        device.core.QueueSubmit(*device.queue, queueSubmitDesc);
+    }
+};
+
+// Indices are unique and within the table, allocation is all or nothing, and freed indices come back only after the fence passes
+bool TestBindlessTableIndices() {
+    for (bool enableValidation : {false, true}) {
+        TestBindlessObjects objects;
+        TEST_CHECK(objects.Create(enableValidation));
+
+        TestDevice& device = objects.device;
+        BindlessTable* bindlessTable = nullptr;
+
+        // A table bigger than the range
+        BindlessTableDesc bindlessTableDesc = objects.bindlessTableDesc;
+        bindlessTableDesc.descriptorNum++;
+
+        Result result = device.helper.CreateBindlessTable(*device.device, bindlessTableDesc, bindlessTable);
+        if (result == Result::SUCCESS)
+            device.helper.DestroyBindlessTable(*bindlessTable);
+
+        if (enableValidation) {
+            TEST_CHECK(result == Result::INVALID_ARGUMENT && objects.errorNum == 1);
+            objects.errorNum = 0;
+        }
+
+        TEST_CHECK(device.helper.CreateBindlessTable(*device.device, objects.bindlessTableDesc, bindlessTable) == Result::SUCCESS);
+        TEST_CHECK(device.helper.GetBindlessTableDescriptorSet(*bindlessTable));
+
+        // Fill the table
+        std::vector<uint32_t> indices(BINDLESS_DESCRIPTOR_NUM);
+        TEST_CHECK(device.helper.AllocateBindlessIndices(*bindlessTable, indices.data(), BINDLESS_DESCRIPTOR_NUM) == Result::SUCCESS);
+
+        std::vector<uint32_t> sortedIndices = indices;
+        std::sort(sortedIndices.begin(), sortedIndices.end());
+        TEST_CHECK(std::adjacent_find(sortedIndices.begin(), sortedIndices.end()) == sortedIndices.end());
+        TEST_CHECK(sortedIndices.back() < BINDLESS_DESCRIPTOR_NUM);
+
+        uint32_t extraIndices[2] = {};
+        TEST_CHECK(device.helper.AllocateBindlessIndices(*bindlessTable, extraIndices, 2) == Result::OUT_OF_MEMORY);
+
+        std::vector<BindlessWriteDesc> bindlessWriteDescs(BINDLESS_DESCRIPTOR_NUM);
+        for (uint32_t i = 0; i < BINDLESS_DESCRIPTOR_NUM; i++)
+            bindlessWriteDescs[i] = {objects.descriptor, indices[i]};
+
+        device.helper.WriteBindlessDescriptors(*bindlessTable, bindlessWriteDescs.data(), BINDLESS_DESCRIPTOR_NUM);
+
+        // Deferred free
+        constexpr uint32_t FREED_NUM = 1000;
+
+        device.helper.FreeBindlessIndices(*bindlessTable, indices.data(), FREED_NUM, 1);
+        device.helper.UpdateBindlessTable(*bindlessTable);
+        TEST_CHECK(device.helper.AllocateBindlessIndices(*bindlessTable, extraIndices, 1) == Result::OUT_OF_MEMORY);
+
+        objects.Signal(1);
+        device.helper.UpdateBindlessTable(*bindlessTable);
+
+        std::vector<uint32_t> reusedIndices(FREED_NUM);
+        TEST_CHECK(device.helper.AllocateBindlessIndices(*bindlessTable, reusedIndices.data(), FREED_NUM) == Result::SUCCESS);
+
+        std::vector<uint32_t> freedIndices(indices.begin(), indices.begin() + FREED_NUM);
+        std::sort(freedIndices.begin(), freedIndices.end());
+        std::sort(reusedIndices.begin(), reusedIndices.end());
+        TEST_CHECK(freedIndices == reusedIndices);
+
+        device.helper.DestroyBindlessTable(*bindlessTable);
+
+        TEST_CHECK(objects.errorNum == 0);
+    }
+
+    return true;
+}
+
+// Several threads fill a small table at once, singly or in groups. Every index of the table is handed out: none are stranded
+// in other threads (including finished ones), and indices reclaimed by "Update" on the main thread are reachable by all threads
+bool TestBindlessTableThreads() {
+    constexpr uint32_t TABLE_SIZE = 100;
+    constexpr uint32_t THREAD_NUM = 8;
+    constexpr uint32_t ROUND_NUM = 4;
+
+    for (bool enableValidation : {false, true}) {
+        for (uint32_t groupSize : {1u, 7u}) {
+            TestBindlessObjects objects;
+            TEST_CHECK(objects.Create(enableValidation));
+
+            TestDevice& device = objects.device;
+
+            BindlessTableDesc bindlessTableDesc = objects.bindlessTableDesc;
+            bindlessTableDesc.descriptorNum = TABLE_SIZE;
+
+            BindlessTable* bindlessTable = nullptr;
+            TEST_CHECK(device.helper.CreateBindlessTable(*device.device, bindlessTableDesc, bindlessTable) == Result::SUCCESS);
+
+            for (uint32_t round = 0; round < ROUND_NUM; round++) {
+                std::vector<std::vector<uint32_t>> threadIndices(THREAD_NUM);
+                std::vector<std::thread> threads;
+                std::atomic_uint32_t readyNum = 0;
+
+                // Each thread allocates until the table is full
+                for (uint32_t t = 0; t < THREAD_NUM; t++) {
+                    threads.emplace_back([&, t] {
+                        readyNum.fetch_add(1);
+                        while (readyNum.load() != THREAD_NUM)
+                            std::this_thread::yield();
+
+                        uint32_t indices[8] = {};
+                        while (device.helper.AllocateBindlessIndices(*bindlessTable, indices, groupSize) == Result::SUCCESS)
+                            threadIndices[t].insert(threadIndices[t].end(), indices, indices + groupSize);
+                    });
+                }
+
+                for (std::thread& thread : threads)
+                    thread.join();
+
+                std::vector<uint32_t> allIndices;
+                for (const std::vector<uint32_t>& indices : threadIndices)
+                    allIndices.insert(allIndices.end(), indices.begin(), indices.end());
+
+                // Groups: all or nothing, less than a group is left
+                TEST_CHECK(allIndices.size() % groupSize == 0);
+                TEST_CHECK(TABLE_SIZE - allIndices.size() < groupSize);
+
+                uint32_t index = 0;
+                while (device.helper.AllocateBindlessIndices(*bindlessTable, &index, 1) == Result::SUCCESS)
+                    allIndices.push_back(index);
+
+                std::sort(allIndices.begin(), allIndices.end());
+                TEST_CHECK(allIndices.size() == TABLE_SIZE);
+                TEST_CHECK(std::adjacent_find(allIndices.begin(), allIndices.end()) == allIndices.end());
+                TEST_CHECK(allIndices.back() < TABLE_SIZE);
+
+                // Reclaimed on this thread, allocated by new threads in the next round
+                device.helper.FreeBindlessIndices(*bindlessTable, allIndices.data(), TABLE_SIZE, round + 1);
+                objects.Signal(round + 1);
+                device.helper.UpdateBindlessTable(*bindlessTable);
+            }
+
+            device.helper.DestroyBindlessTable(*bindlessTable);
+
+            TEST_CHECK(objects.errorNum == 0);
+        }
+    }
+
+    return true;
+}
+
+// Threads stream materials in and out: allocate indices in groups of 64, write them and free them a frame later
+bool TestBindlessTableStreaming() {
+    constexpr uint32_t FRAME_NUM = 200;
+    constexpr uint32_t GROUP_SIZE = 64;
+    constexpr uint32_t INDEX_NUM_PER_THREAD = GROUP_SIZE * 16;
+
+    for (bool enableValidation : {false, true}) {
+        for (uint32_t threadNum : {1u, 4u}) {
+            TestBindlessObjects objects;
+            TEST_CHECK(objects.Create(enableValidation));
+
+            TestDevice& device = objects.device;
+
+            BindlessTable* bindlessTable = nullptr;
+            TEST_CHECK(device.helper.CreateBindlessTable(*device.device, objects.bindlessTableDesc, bindlessTable) == Result::SUCCESS);
+
+            std::vector<std::vector<uint32_t>> previousIndices(threadNum);
+            std::atomic_bool isSucceeded = true;
+            double threadNs = 0.0;
+            double updateNs = 0.0;
+
+            for (uint32_t frame = 0; frame < FRAME_NUM; frame++) {
+                std::vector<double> ns(threadNum);
+                std::vector<std::thread> threads;
+
+                for (uint32_t t = 0; t < threadNum; t++) {
+                    threads.emplace_back([&, t] {
+                        TestTimer timer;
+
+                        std::vector<uint32_t> indices(INDEX_NUM_PER_THREAD);
+                        std::vector<BindlessWriteDesc> bindlessWriteDescs(GROUP_SIZE);
+
+                        for (uint32_t i = 0; i < INDEX_NUM_PER_THREAD; i += GROUP_SIZE) {
+                            if (device.helper.AllocateBindlessIndices(*bindlessTable, indices.data() + i, GROUP_SIZE) != Result::SUCCESS) {
+                                isSucceeded = false;
+                                return;
+                            }
+
+                            for (uint32_t j = 0; j < GROUP_SIZE; j++)
+                                bindlessWriteDescs[j] = {objects.descriptor, indices[i + j]};
+
+                            device.helper.WriteBindlessDescriptors(*bindlessTable, bindlessWriteDescs.data(), GROUP_SIZE);
+                        }
+
+                        if (frame)
+                            device.helper.FreeBindlessIndices(*bindlessTable, previousIndices[t].data(), INDEX_NUM_PER_THREAD, frame);
+
+                        previousIndices[t].swap(indices);
+                        ns[t] = timer.GetNanoseconds();
+                    });
+                }
+
+                for (std::thread& thread : threads)
+                    thread.join();
+
+                TEST_CHECK(isSucceeded);
+
+                for (double x : ns)
+                    threadNs += x;
+
+                objects.Signal(frame + 1);
+
+                TestTimer timer;
+                device.helper.UpdateBindlessTable(*bindlessTable);
+                updateNs += timer.GetNanoseconds();
+            }
+
+            double indexNum = double(FRAME_NUM) * threadNum * INDEX_NUM_PER_THREAD;
+            printf("    validation %s, %u thread(s): per index %.1f ns in threads (allocate, queue write, queue free), %.1f ns in update\n",
+                enableValidation ? "on" : "off", threadNum, threadNs / indexNum, updateNs / indexNum);
+
+            device.helper.DestroyBindlessTable(*bindlessTable);
+
+            TEST_CHECK(objects.errorNum == 0);
+        }
+    }
+
+    return true;
+}
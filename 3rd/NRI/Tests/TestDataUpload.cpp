@@ -0,0 +1,484 @@
+// © 2021 NVIDIA Corporation
+
+#include "Tests.h"
+
+#include "SharedExternal.h"
+
+#include "HelperDataUpload.h"
+
+#include <deque>
+#include <functional>
+#include <random>
+
+using namespace nri;
+
+// A GPU lagging behind by "LAG" submissions: copies are executed (and fences signaled) only when later submissions push them out
+namespace lagging_queue {
+
+constexpr size_t LAG = 2;
+
+struct FakeBuffer {
+    std::vector<uint8_t> data;
+};
+
+struct FakeCommandBuffer {
+    std::vector<std::function<void()>> commands;
+};
+
+static std::deque<std::pair<FakeCommandBuffer, uint64_t>> g_Submissions;
+static uint64_t g_FenceValue;
+static uint32_t g_SubmitNum;
+static uint32_t g_BlockingWaitNum;
+static int32_t g_CommandAllocatorNum;
+
+static void Execute(size_t keepNum) {
+    while (g_Submissions.size() > keepNum) {
+        for (const auto& command : g_Submissions.front().first.commands)
+            command();
+
+        g_FenceValue = g_Submissions.front().second;
+        g_Submissions.pop_front();
+    }
+}
+
+static Result CreateBuffer(Device&, const BufferDesc& bufferDesc, Buffer*& buffer) {
+    buffer = (Buffer*)new FakeBuffer{std::vector<uint8_t>((size_t)bufferDesc.size)};
+    return Result::SUCCESS;
+}
+
+static void DestroyBuffer(Buffer& buffer) {
+    delete (FakeBuffer*)&buffer;
+}
+
+static void* MapBuffer(Buffer& buffer, uint64_t offset, uint64_t) {
+    return ((FakeBuffer&)buffer).data.data() + offset;
+}
+
+static void UnmapBuffer(Buffer&) {
+}
+
+static void GetBufferMemoryDesc(const Buffer& buffer, MemoryLocation, MemoryDesc& memoryDesc) {
+    memoryDesc = {};
+    memoryDesc.size = ((const FakeBuffer&)buffer).data.size();
+}
+
+static Result AllocateMemory(Device&, const AllocateMemoryDesc&, Memory*& memory) {
+    memory = (Memory*)1;
+    return Result::SUCCESS;
+}
+
+static Result BindBufferMemory(Device&, const BufferMemoryBindingDesc*, uint32_t) {
+    return Result::SUCCESS;
+}
+
+static void FreeMemory(Memory&) {
+}
+
+static Result CreateFence(Device&, uint64_t, Fence*& fence) {
+    fence = (Fence*)1;
+    return Result::SUCCESS;
+}
+
+static void DestroyFence(Fence&) {
+}
+
+static uint64_t GetFenceValue(Fence&) {
+    return g_FenceValue;
+}
+
+static void Wait(Fence&, uint64_t value) {
+    if (value > g_FenceValue)
+        g_BlockingWaitNum++;
+
+    while (g_FenceValue < value)
+        Execute(g_Submissions.size() - 1);
+}
+
+static Result CreateCommandAllocator(Queue&, CommandAllocator*& commandAllocator) {
+    commandAllocator = (CommandAllocator*)1;
+    g_CommandAllocatorNum++;
+    return Result::SUCCESS;
+}
+
+static void DestroyCommandAllocator(CommandAllocator&) {
+    g_CommandAllocatorNum--;
+}
+
+static void ResetCommandAllocator(CommandAllocator&) {
+}
+
+static Result CreateCommandBuffer(CommandAllocator&, CommandBuffer*& commandBuffer) {
+    commandBuffer = (CommandBuffer*)new FakeCommandBuffer;
+    return Result::SUCCESS;
+}
+
+static void DestroyCommandBuffer(CommandBuffer& commandBuffer) {
+    delete (FakeCommandBuffer*)&commandBuffer;
+}
+
+static Result BeginCommandBuffer(CommandBuffer& commandBuffer, const DescriptorPool*) {
+    ((FakeCommandBuffer&)commandBuffer).commands.clear();
+    return Result::SUCCESS;
+}
+
+static Result EndCommandBuffer(CommandBuffer&) {
+    return Result::SUCCESS;
+}
+
+static void CmdBarrier(CommandBuffer&, const BarrierGroupDesc&) {
+}
+
+// Staging memory is read at execution time, like a GPU does
+static void CmdCopyBuffer(CommandBuffer& commandBuffer, Buffer& dstBuffer, uint64_t dstOffset, const Buffer& srcBuffer, uint64_t srcOffset, uint64_t size) {
+    FakeBuffer* dst = (FakeBuffer*)&dstBuffer;
+    const FakeBuffer* src = (const FakeBuffer*)&srcBuffer;
+
+    ((FakeCommandBuffer&)commandBuffer).commands.push_back([=] {
+        memcpy(dst->data.data() + dstOffset, src->data.data() + srcOffset, (size_t)size);
+    });
+}
+
+static void QueueSubmit(Queue&, const QueueSubmitDesc& queueSubmitDesc) {
+    g_SubmitNum++;
+    g_Submissions.push_back({*(FakeCommandBuffer*)queueSubmitDesc.commandBuffers[0], queueSubmitDesc.signalFences[0].value});
+
+    Execute(LAG);
+}
+
+} // namespace lagging_queue
+
+// Uploads bigger than the staging buffer are split into pieces, which are submitted without waiting for the GPU until a slot is reused
+bool TestDataUploadPipelining() {
+    TestDevice device;
+    TEST_CHECK(device.Create(false));
+
+    CoreInterface NRI = device.core;
+    {
+        using namespace lagging_queue;
+
+        NRI.CreateBuffer = CreateBuffer;
+        NRI.DestroyBuffer = DestroyBuffer;
+        NRI.MapBuffer = MapBuffer;
+        NRI.UnmapBuffer = UnmapBuffer;
+        NRI.GetBufferMemoryDesc = GetBufferMemoryDesc;
+        NRI.AllocateMemory = AllocateMemory;
+        NRI.BindBufferMemory = BindBufferMemory;
+        NRI.FreeMemory = FreeMemory;
+        NRI.CreateFence = CreateFence;
+        NRI.DestroyFence = DestroyFence;
+        NRI.GetFenceValue = GetFenceValue;
+        NRI.Wait = Wait;
+        NRI.CreateCommandAllocator = CreateCommandAllocator;
+        NRI.DestroyCommandAllocator = DestroyCommandAllocator;
+        NRI.ResetCommandAllocator = ResetCommandAllocator;
+        NRI.CreateCommandBuffer = CreateCommandBuffer;
+        NRI.DestroyCommandBuffer = DestroyCommandBuffer;
+        NRI.BeginCommandBuffer = BeginCommandBuffer;
+        NRI.EndCommandBuffer = EndCommandBuffer;
+        NRI.CmdBarrier = CmdBarrier;
+        NRI.CmdCopyBuffer = CmdCopyBuffer;
+        NRI.QueueSubmit = QueueSubmit;
+    }
+
+    constexpr uint32_t CALL_NUM = 50;
+
+    std::mt19937 rng(3);
+    std::vector<Buffer*> buffers;
+    std::vector<std::vector<uint8_t>> expected;
+
+    bool isDataValid = true;
+    {
+        HelperDataUpload dataUploader(NRI, *device.device, *device.queue);
+
+        DataUploaderDesc dataUploaderDesc = {};
+        dataUploaderDesc.stagingBufferSize = 4096;
+        dataUploaderDesc.uploadMaxNum = 3;
+        TEST_CHECK(dataUploader.Create(dataUploaderDesc) == Result::SUCCESS);
+
+        UploadTicket uploadTicket = {};
+        for (uint32_t i = 0; i < CALL_NUM; i++) {
+            // Data is released right after the call
+            std::vector<std::vector<uint8_t>> data(1 + rng() % 4);
+            std::vector<BufferUploadDesc> bufferUploadDescs;
+
+            for (std::vector<uint8_t>& bufferData : data) {
+                bufferData.resize(1 + rng() % 10000);
+                for (uint8_t& x : bufferData)
+                    x = (uint8_t)rng();
+
+                BufferDesc bufferDesc = {};
+                bufferDesc.size = bufferData.size();
+
+                Buffer* buffer = nullptr;
+                lagging_queue::CreateBuffer(*device.device, bufferDesc, buffer);
+                buffers.push_back(buffer);
+                expected.push_back(bufferData);
+
+                BufferUploadDesc bufferUploadDesc = {};
+                bufferUploadDesc.data = bufferData.data();
+                bufferUploadDesc.dataSize = bufferData.size();
+                bufferUploadDesc.buffer = buffer;
+                bufferUploadDescs.push_back(bufferUploadDesc);
+            }
+
+            TEST_CHECK(dataUploader.UploadData(nullptr, 0, bufferUploadDescs.data(), (uint32_t)bufferUploadDescs.size(), uploadTicket) == Result::SUCCESS);
+        }
+
+        lagging_queue::Wait(*uploadTicket.fence, uploadTicket.value);
+
+        for (size_t i = 0; i < buffers.size(); i++)
+            isDataValid = isDataValid && ((lagging_queue::FakeBuffer*)buffers[i])->data == expected[i];
+
+        printf("    %u uploads: %u pieces submitted, %u blocking waits\n", CALL_NUM, lagging_queue::g_SubmitNum, lagging_queue::g_BlockingWaitNum);
+    }
+
+    for (Buffer* buffer : buffers)
+        lagging_queue::DestroyBuffer(*buffer);
+
+    TEST_CHECK(isDataValid);
+    TEST_CHECK(lagging_queue::g_SubmitNum > CALL_NUM);
+    TEST_CHECK(lagging_queue::g_BlockingWaitNum <= 1); // only the final wait for the ticket
+    TEST_CHECK(lagging_queue::g_CommandAllocatorNum == 0);
+
+    return true;
+}
+
+// Real uploads of buffers and texture subresources (bigger than the staging buffer) on the NONE backend, checked via readback
+bool TestDataUploadHost() {
+    for (uint32_t enableValidation = 0; enableValidation < 2; enableValidation++) {
+        TestDevice device;
+        TEST_CHECK(device.Create(enableValidation != 0));
+
+        constexpr uint32_t WIDTH = 64;
+        constexpr uint32_t LAYER_NUM = 2;
+        constexpr uint32_t MIP_NUM = 2;
+        constexpr uint32_t BUFFER_SIZE = 100000;
+
+        // Resources
+        Buffer* buffer = nullptr;
+        BufferDesc bufferDesc = {};
+        bufferDesc.size = BUFFER_SIZE;
+        bufferDesc.usage = BufferUsageBits::SHADER_RESOURCE;
+        TEST_CHECK(device.core.CreateBuffer(*device.device, bufferDesc, buffer) == Result::SUCCESS);
+
+        Texture* texture = nullptr;
+        TextureDesc textureDesc = {};
+        textureDesc.type = TextureType::TEXTURE_2D;
+        textureDesc.format = Format::RGBA8_UNORM;
+        textureDesc.width = WIDTH;
+        textureDesc.height = WIDTH;
+        textureDesc.mipNum = MIP_NUM;
+        textureDesc.layerNum = LAYER_NUM;
+        textureDesc.usage = TextureUsageBits::SHADER_RESOURCE;
+        TEST_CHECK(device.core.CreateTexture(*device.device, textureDesc, texture) == Result::SUCCESS);
+
+        ResourceGroupDesc resourceGroupDesc = {};
+        resourceGroupDesc.memoryLocation = MemoryLocation::DEVICE;
+        resourceGroupDesc.buffers = &buffer;
+        resourceGroupDesc.bufferNum = 1;
+        resourceGroupDesc.textures = &texture;
+        resourceGroupDesc.textureNum = 1;
+
+        std::vector<Memory*> memories(device.helper.CalculateAllocationNumber(*device.device, resourceGroupDesc));
+        TEST_CHECK(device.helper.AllocateAndBindMemory(*device.device, resourceGroupDesc, memories.data()) == Result::SUCCESS);
+
+        TestBuffer readback(device);
+        TEST_CHECK(readback.Create(BUFFER_SIZE + WIDTH * WIDTH * 4, MemoryLocation::HOST_READBACK));
+
+        // Data
+        std::vector<uint8_t> bufferData(BUFFER_SIZE);
+        for (uint32_t i = 0; i < BUFFER_SIZE; i++)
+            bufferData[i] = (uint8_t)(i * 7);
+
+        std::vector<uint8_t> textureData[LAYER_NUM][MIP_NUM];
+        TextureSubresourceUploadDesc subresources[LAYER_NUM * MIP_NUM] = {};
+        for (uint32_t layer = 0; layer < LAYER_NUM; layer++) {
+            for (uint32_t mip = 0; mip < MIP_NUM; mip++) {
+                uint32_t w = WIDTH >> mip;
+
+                std::vector<uint8_t>& data = textureData[layer][mip];
+                data.resize(w * w * 4);
+                for (size_t i = 0; i < data.size(); i++)
+                    data[i] = (uint8_t)(i + layer * 31 + mip * 17);
+
+                TextureSubresourceUploadDesc& subresource = subresources[layer * MIP_NUM + mip];
+                subresource.slices = data.data();
+                subresource.sliceNum = 1;
+                subresource.rowPitch = w * 4;
+                subresource.slicePitch = w * w * 4;
+            }
+        }
+
+        TextureUploadDesc textureUploadDesc = {};
+        textureUploadDesc.subresources = subresources;
+        textureUploadDesc.texture = texture;
+        textureUploadDesc.after.access = AccessBits::SHADER_RESOURCE;
+        textureUploadDesc.after.layout = Layout::SHADER_RESOURCE;
+
+        BufferUploadDesc bufferUploadDesc = {};
+        bufferUploadDesc.data = bufferData.data();
+        bufferUploadDesc.dataSize = BUFFER_SIZE;
+        bufferUploadDesc.buffer = buffer;
+        bufferUploadDesc.after.access = AccessBits::SHADER_RESOURCE;
+
+        // Upload through a staging buffer smaller than the data (a subresource is never split, the buffer is)
+        DataUploaderDesc dataUploaderDesc = {};
+        dataUploaderDesc.stagingBufferSize = 8192;
+
+        DataUploader* dataUploader = nullptr;
+        TEST_CHECK(device.helper.CreateDataUploader(*device.queue, dataUploaderDesc, dataUploader) == Result::SUCCESS);
+
+        UploadTicket uploadTicket = {};
+        TEST_CHECK(device.helper.UploadDataAsync(*dataUploader, &textureUploadDesc, 1, &bufferUploadDesc, 1, uploadTicket) == Result::SUCCESS);
+        device.core.Wait(*uploadTicket.fence, uploadTicket.value);
+
+        // Read back the last subresource and the buffer
+        TestCommandBuffer commandBuffer(device);
+        TEST_CHECK(commandBuffer.Begin());
+        {
+            TextureRegionDesc textureRegionDesc = {};
+            textureRegionDesc.mipOffset = MIP_NUM - 1;
+            textureRegionDesc.layerOffset = LAYER_NUM - 1;
+
+            TextureDataLayoutDesc textureDataLayoutDesc = {};
+            textureDataLayoutDesc.offset = BUFFER_SIZE;
+            textureDataLayoutDesc.rowPitch = (WIDTH >> (MIP_NUM - 1)) * 4;
+            textureDataLayoutDesc.slicePitch = textureDataLayoutDesc.rowPitch * (WIDTH >> (MIP_NUM - 1));
+
+            device.core.CmdReadbackTextureToBuffer(*commandBuffer.commandBuffer, *readback.buffer, textureDataLayoutDesc, *texture, textureRegionDesc);
+            device.core.CmdCopyBuffer(*commandBuffer.commandBuffer, *readback.buffer, 0, *buffer, 0, BUFFER_SIZE);
+        }
+        TEST_CHECK(commandBuffer.Submit());
+
+        const uint8_t* mapped = (const uint8_t*)device.core.MapBuffer(*readback.buffer, 0, WHOLE_SIZE);
+        TEST_CHECK(mapped);
+
+        const std::vector<uint8_t>& lastSubresource = textureData[LAYER_NUM - 1][MIP_NUM - 1];
+        bool isDataValid = memcmp(mapped, bufferData.data(), BUFFER_SIZE) == 0 && memcmp(mapped + BUFFER_SIZE, lastSubresource.data(), lastSubresource.size()) == 0;
+        device.core.UnmapBuffer(*readback.buffer);
+        TEST_CHECK(isDataValid);
+
+        device.helper.DestroyDataUploader(*dataUploader);
+        device.core.DestroyTexture(*texture);
+        device.core.DestroyBuffer(*buffer);
+        for (Memory* memory : memories)
+            device.core.FreeMemory(*memory);
+    }
+
+    return true;
+}
+
+// Mips of a BC texture smaller than a block still occupy a whole block, regions can be given in texels (not rounded up to blocks)
+bool TestDataUploadHostBlockCompressed() {
+    constexpr uint32_t WIDTH = 12; // mips: 12, 6, 3, 1 (3, 2, 1, 1 blocks)
+    constexpr uint32_t MIP_NUM = 4;
+    constexpr uint32_t BLOCK_SIZE = 8;
+
+    for (uint32_t enableValidation = 0; enableValidation < 2; enableValidation++) {
+        TestDevice device;
+        TEST_CHECK(device.Create(enableValidation != 0));
+
+        const DeviceDesc& deviceDesc = device.core.GetDeviceDesc(*device.device);
+
+        Texture* texture = nullptr;
+        TextureDesc textureDesc = {};
+        textureDesc.type = TextureType::TEXTURE_2D;
+        textureDesc.format = Format::BC1_RGBA_UNORM;
+        textureDesc.width = WIDTH;
+        textureDesc.height = WIDTH;
+        textureDesc.mipNum = MIP_NUM;
+        textureDesc.usage = TextureUsageBits::SHADER_RESOURCE;
+        TEST_CHECK(device.core.CreateTexture(*device.device, textureDesc, texture) == Result::SUCCESS);
+
+        ResourceGroupDesc resourceGroupDesc = {};
+        resourceGroupDesc.memoryLocation = MemoryLocation::DEVICE;
+        resourceGroupDesc.textures = &texture;
+        resourceGroupDesc.textureNum = 1;
+
+        Memory* memory = nullptr;
+        TEST_CHECK(device.helper.AllocateAndBindMemory(*device.device, resourceGroupDesc, &memory) == Result::SUCCESS);
+
+        // Upload the whole texture
+        std::vector<uint8_t> textureData[MIP_NUM];
+        TextureSubresourceUploadDesc subresources[MIP_NUM] = {};
+        for (uint32_t mip = 0; mip < MIP_NUM; mip++) {
+            uint32_t blockNum = ((WIDTH >> mip) + 3) / 4;
+
+            std::vector<uint8_t>& data = textureData[mip];
+            data.resize(blockNum * blockNum * BLOCK_SIZE);
+            for (size_t i = 0; i < data.size(); i++)
+                data[i] = (uint8_t)(i * 3 + mip * 59 + 1);
+
+            TextureSubresourceUploadDesc& subresource = subresources[mip];
+            subresource.slices = data.data();
+            subresource.sliceNum = 1;
+            subresource.rowPitch = blockNum * BLOCK_SIZE;
+            subresource.slicePitch = blockNum * blockNum * BLOCK_SIZE;
+        }
+
+        TextureUploadDesc textureUploadDesc = {};
+        textureUploadDesc.subresources = subresources;
+        textureUploadDesc.texture = texture;
+        textureUploadDesc.after.access = AccessBits::SHADER_RESOURCE;
+        textureUploadDesc.after.layout = Layout::SHADER_RESOURCE;
+
+        TEST_CHECK(device.helper.UploadData(*device.queue, &textureUploadDesc, 1, nullptr, 0) == Result::SUCCESS);
+
+        // Overwrite the last mip with a region in texels, then read back the last two mips the same way
+        std::vector<uint8_t> lastMipData(BLOCK_SIZE, 0xA5);
+        uint32_t rowPitch = deviceDesc.uploadBufferTextureRowAlignment;
+
+        TestBuffer uploadBuffer(device);
+        TEST_CHECK(uploadBuffer.Create(BLOCK_SIZE, MemoryLocation::HOST_UPLOAD));
+        {
+            void* mapped = device.core.MapBuffer(*uploadBuffer.buffer, 0, WHOLE_SIZE);
+            TEST_CHECK(mapped);
+
+            memcpy(mapped, lastMipData.data(), BLOCK_SIZE);
+            device.core.UnmapBuffer(*uploadBuffer.buffer);
+        }
+
+        TestBuffer readbackBuffer(device);
+        TEST_CHECK(readbackBuffer.Create(rowPitch * 3, MemoryLocation::HOST_READBACK));
+
+        TestCommandBuffer commandBuffer(device);
+        TEST_CHECK(commandBuffer.Begin());
+        {
+            TextureRegionDesc textureRegionDesc = {};
+            textureRegionDesc.mipOffset = MIP_NUM - 1;
+            textureRegionDesc.width = 1;
+            textureRegionDesc.height = 1;
+            textureRegionDesc.depth = 1;
+
+            TextureDataLayoutDesc textureDataLayoutDesc = {};
+            textureDataLayoutDesc.rowPitch = rowPitch;
+            textureDataLayoutDesc.slicePitch = rowPitch;
+
+            device.core.CmdUploadBufferToTexture(*commandBuffer.commandBuffer, *texture, textureRegionDesc, *uploadBuffer.buffer, textureDataLayoutDesc);
+            device.core.CmdReadbackTextureToBuffer(*commandBuffer.commandBuffer, *readbackBuffer.buffer, textureDataLayoutDesc, *texture, textureRegionDesc);
+
+            textureRegionDesc.mipOffset = MIP_NUM - 2;
+            textureRegionDesc.width = WIDTH >> (MIP_NUM - 2);
+            textureRegionDesc.height = WIDTH >> (MIP_NUM - 2);
+
+            textureDataLayoutDesc.offset = rowPitch;
+            textureDataLayoutDesc.slicePitch = rowPitch;
+
+            device.core.CmdReadbackTextureToBuffer(*commandBuffer.commandBuffer, *readbackBuffer.buffer, textureDataLayoutDesc, *texture, textureRegionDesc);
+        }
+        TEST_CHECK(commandBuffer.Submit());
+
+        const uint8_t* mapped = (const uint8_t*)device.core.MapBuffer(*readbackBuffer.buffer, 0, WHOLE_SIZE);
+        TEST_CHECK(mapped);
+
+        const std::vector<uint8_t>& prevMipData = textureData[MIP_NUM - 2];
+        bool isDataValid = memcmp(mapped, lastMipData.data(), BLOCK_SIZE) == 0 && memcmp(mapped + rowPitch, prevMipData.data(), prevMipData.size()) == 0;
+        device.core.UnmapBuffer(*readbackBuffer.buffer);
+        TEST_CHECK(isDataValid);
+
+        device.core.DestroyTexture(*texture);
+        device.core.FreeMemory(*memory);
+    }
+
+    return true;
+}
@@ -0,0 +1,448 @@
+// © 2021 NVIDIA Corporation
+
+#include "Tests.h"
+
+#include <atomic>
+
+using namespace nri;
+
+// Two groups share a memory type: after most of the first group is released, the second (emptier) heap is moved into the gaps
+// of the first one. Moved contents are checked via readback, and the next frame retires the source heap without further moves
+bool TestDefragmenter() {
+    constexpr uint32_t BUFFER_NUM = 8;
+    constexpr uint32_t BUFFER_SIZE = 65536;
+    constexpr uint32_t TEXTURE_SIZE = 64 * 64 * 4;
+
+    for (bool enableValidation : {false, true}) {
+        TestDevice device;
+        TEST_CHECK(device.Create(enableValidation));
+
+        Fence* fence = nullptr;
+        TEST_CHECK(device.core.CreateFence(*device.device, 0, fence) == Result::SUCCESS);
+
+        DefragmenterDesc defragmenterDesc = {};
+        defragmenterDesc.fence = fence;
+
+        Defragmenter* defragmenter = nullptr;
+        TEST_CHECK(device.helper.CreateDefragmenter(*device.device, defragmenterDesc, defragmenter) == Result::SUCCESS);
+
+        BufferDesc bufferDesc = {};
+        bufferDesc.size = BUFFER_SIZE;
+
+        TextureDesc textureDesc = {};
+        textureDesc.type = TextureType::TEXTURE_2D;
+        textureDesc.format = Format::RGBA8_UNORM;
+        textureDesc.width = 64;
+        textureDesc.height = 64;
+        textureDesc.mipNum = 1;
+        textureDesc.layerNum = 1;
+
+        // Group A: 8 buffers and 2 textures
+        Buffer* buffersA[BUFFER_NUM] = {};
+        Texture* texturesA[2] = {};
+        for (Buffer*& buffer : buffersA)
+            TEST_CHECK(device.core.CreateBuffer(*device.device, bufferDesc, buffer) == Result::SUCCESS);
+        for (Texture*& texture : texturesA)
+            TEST_CHECK(device.core.CreateTexture(*device.device, textureDesc, texture) == Result::SUCCESS);
+
+        ResourceGroupDesc resourceGroupDesc = {};
+        resourceGroupDesc.memoryLocation = MemoryLocation::DEVICE;
+        resourceGroupDesc.buffers = buffersA;
+        resourceGroupDesc.bufferNum = BUFFER_NUM;
+        resourceGroupDesc.textures = texturesA;
+        resourceGroupDesc.textureNum = 2;
+        TEST_CHECK(device.helper.AllocateAndBindDefragmentableMemory(*defragmenter, resourceGroupDesc) == Result::SUCCESS);
+
+        // Group B: 2 buffers and 1 texture
+        Buffer* buffersB[2] = {};
+        Texture* textureB = nullptr;
+        for (Buffer*& buffer : buffersB)
+            TEST_CHECK(device.core.CreateBuffer(*device.device, bufferDesc, buffer) == Result::SUCCESS);
+        TEST_CHECK(device.core.CreateTexture(*device.device, textureDesc, textureB) == Result::SUCCESS);
+
+        resourceGroupDesc.buffers = buffersB;
+        resourceGroupDesc.bufferNum = 2;
+        resourceGroupDesc.textures = &textureB;
+        resourceGroupDesc.textureNum = 1;
+        TEST_CHECK(device.helper.AllocateAndBindDefragmentableMemory(*defragmenter, resourceGroupDesc) == Result::SUCCESS);
+
+        // Upload group B contents
+        std::vector<uint8_t> data[3];
+        for (uint32_t i = 0; i < 3; i++) {
+            data[i].resize(BUFFER_SIZE);
+            for (uint32_t j = 0; j < BUFFER_SIZE; j++)
+                data[i][j] = (uint8_t)(j * 13 + i * 101);
+        }
+
+        BufferUploadDesc bufferUploadDescs[2] = {};
+        for (uint32_t i = 0; i < 2; i++) {
+            bufferUploadDescs[i].data = data[i].data();
+            bufferUploadDescs[i].dataSize = BUFFER_SIZE;
+            bufferUploadDescs[i].buffer = buffersB[i];
+            bufferUploadDescs[i].after.access = AccessBits::COPY_SOURCE;
+        }
+
+        TextureSubresourceUploadDesc subresource = {};
+        subresource.slices = data[2].data();
+        subresource.sliceNum = 1;
+        subresource.rowPitch = 64 * 4;
+        subresource.slicePitch = TEXTURE_SIZE;
+
+        TextureUploadDesc textureUploadDesc = {};
+        textureUploadDesc.subresources = &subresource;
+        textureUploadDesc.texture = textureB;
+        textureUploadDesc.after.access = AccessBits::COPY_SOURCE;
+        textureUploadDesc.after.layout = Layout::COPY_SOURCE;
+
+        TEST_CHECK(device.helper.UploadData(*device.queue, &textureUploadDesc, 1, bufferUploadDescs, 2) == Result::SUCCESS);
+
+        // Release every other buffer and one texture of group A
+        Buffer* releasedBuffers[BUFFER_NUM / 2] = {};
+        for (uint32_t i = 0; i < BUFFER_NUM / 2; i++)
+            releasedBuffers[i] = buffersA[i * 2];
+
+        device.helper.ReleaseDefragmentableResources(*defragmenter, releasedBuffers, BUFFER_NUM / 2, texturesA, 1);
+        for (Buffer* buffer : releasedBuffers)
+            device.core.DestroyBuffer(*buffer);
+        device.core.DestroyTexture(*texturesA[0]);
+
+        // Plan: all of group B moves out of its memory
+        uint32_t moveNum = 0;
+        const DefragmentationMove* moves = device.helper.BeginDefragmentation(*defragmenter, 1ull << 30, 1, moveNum);
+        TEST_CHECK(moveNum == 3);
+
+        for (uint32_t i = 0; i < moveNum; i++) {
+            TEST_CHECK(moves[i].srcMemory == moves[0].srcMemory);
+            TEST_CHECK(moves[i].dstMemory != moves[0].srcMemory);
+        }
+
+        // Copy and replace
+        TestBuffer readbackBuffer(device);
+        TEST_CHECK(readbackBuffer.Create(BUFFER_SIZE * 2 + TEXTURE_SIZE, MemoryLocation::HOST_READBACK));
+
+        TestCommandBuffer commandBuffer(device);
+        TEST_CHECK(commandBuffer.Begin());
+
+        device.helper.CmdDefragment(*commandBuffer.commandBuffer, *defragmenter);
+
+        for (uint32_t i = 0; i < moveNum; i++) {
+            for (Buffer*& buffer : buffersB) {
+                if (buffer == moves[i].srcBuffer)
+                    buffer = moves[i].dstBuffer;
+            }
+
+            if (textureB == moves[i].srcTexture)
+                textureB = moves[i].dstTexture;
+        }
+
+        device.core.CmdCopyBuffer(*commandBuffer.commandBuffer, *readbackBuffer.buffer, 0, *buffersB[0], 0, BUFFER_SIZE);
+        device.core.CmdCopyBuffer(*commandBuffer.commandBuffer, *readbackBuffer.buffer, BUFFER_SIZE, *buffersB[1], 0, BUFFER_SIZE);
+
+        TextureRegionDesc textureRegionDesc = {};
+        TextureDataLayoutDesc textureDataLayoutDesc = {};
+        textureDataLayoutDesc.offset = BUFFER_SIZE * 2;
+        textureDataLayoutDesc.rowPitch = 64 * 4;
+        textureDataLayoutDesc.slicePitch = TEXTURE_SIZE;
+        device.core.CmdReadbackTextureToBuffer(*commandBuffer.commandBuffer, *readbackBuffer.buffer, textureDataLayoutDesc, *textureB, textureRegionDesc);
+
+        TEST_CHECK(device.core.EndCommandBuffer(*commandBuffer.commandBuffer) == Result::SUCCESS);
+
+        FenceSubmitDesc fenceSubmitDesc = {};
+        fenceSubmitDesc.fence = fence;
+        fenceSubmitDesc.value = 1;
+
+        QueueSubmitDesc queueSubmitDesc = {};
+        queueSubmitDesc.commandBuffers = &commandBuffer.commandBuffer;
+        queueSubmitDesc.commandBufferNum = 1;
+        queueSubmitDesc.signalFences = &fenceSubmitDesc;
+        queueSubmitDesc.signalFenceNum = 1;
+
+        device.core.QueueSubmit(*device.queue, queueSubmitDesc);
+        device.core.Wait(*fence, 1);
+
+        const uint8_t* mapped = (const uint8_t*)device.core.MapBuffer(*readbackBuffer.buffer, 0, WHOLE_SIZE);
+        bool isDataValid = memcmp(mapped, data[0].data(), BUFFER_SIZE) == 0
+            && memcmp(mapped + BUFFER_SIZE, data[1].data(), BUFFER_SIZE) == 0
+            && memcmp(mapped + BUFFER_SIZE * 2, data[2].data(), TEXTURE_SIZE) == 0;
+        device.core.UnmapBuffer(*readbackBuffer.buffer);
+        TEST_CHECK(isDataValid);
+
+        // The next frame retires the source memory, nothing is left to move
+        device.helper.BeginDefragmentation(*defragmenter, 1ull << 30, 2, moveNum);
+        TEST_CHECK(moveNum == 0);
+
+        // Teardown
+        Buffer* liveBuffers[BUFFER_NUM / 2 + 2] = {};
+        for (uint32_t i = 0; i < BUFFER_NUM / 2; i++)
+            liveBuffers[i] = buffersA[i * 2 + 1];
+        liveBuffers[BUFFER_NUM / 2] = buffersB[0];
+        liveBuffers[BUFFER_NUM / 2 + 1] = buffersB[1];
+
+        Texture* liveTextures[2] = {texturesA[1], textureB};
+
+        device.helper.ReleaseDefragmentableResources(*defragmenter, liveBuffers, BUFFER_NUM / 2 + 2, liveTextures, 2);
+        for (Buffer* buffer : liveBuffers)
+            device.core.DestroyBuffer(*buffer);
+        for (Texture* texture : liveTextures)
+            device.core.DestroyTexture(*texture);
+
+        device.helper.DestroyDefragmenter(*defragmenter);
+        device.core.DestroyFence(*fence);
+    }
+
+    return true;
+}
+
+static void CountErrors(Message messageType, const char*, uint32_t, const char*, void* userArg) {
+    if (messageType == Message::ERROR)
+        ((std::atomic_uint32_t*)userArg)->fetch_add(1, std::memory_order_relaxed);
+}
+
+// Emptied memory is freed only by "BeginDefragmentation" (retirement): released resources are destroyed after "ReleaseDefragmentableResources",
+// moved-out resources may be read by the GPU until the fence passes. Freeing memory earlier makes validation report resources still bound to it
+bool TestDefragmenterRetirement() {
+    constexpr uint32_t BUFFER_NUM = 4;
+
+    for (bool enableValidation : {false, true}) {
+        std::atomic_uint32_t errorNum = 0;
+
+        CallbackInterface callbackInterface = {};
+        callbackInterface.MessageCallback = CountErrors;
+        callbackInterface.AbortExecution = [](void*) {};
+        callbackInterface.userArg = &errorNum;
+
+        TestDevice device;
+        TEST_CHECK(device.Create(enableValidation, nullptr, &callbackInterface));
+
+        Fence* fence = nullptr;
+        TEST_CHECK(device.core.CreateFence(*device.device, 0, fence) == Result::SUCCESS);
+
+        DefragmenterDesc defragmenterDesc = {};
+        defragmenterDesc.fence = fence;
+
+        Defragmenter* defragmenter = nullptr;
+        TEST_CHECK(device.helper.CreateDefragmenter(*device.device, defragmenterDesc, defragmenter) == Result::SUCCESS);
+
+        // Memory in use on NONE with host memory
+        auto GetUsage = [&]() {
+            VideoMemoryInfo videoMemoryInfo = {};
+            device.helper.QueryVideoMemoryInfo(*device.device, MemoryLocation::DEVICE, videoMemoryInfo);
+
+            return videoMemoryInfo.usageSize;
+        };
+
+        auto CreateGroup = [&](Buffer** buffers, uint32_t bufferNum) {
+            BufferDesc bufferDesc = {};
+            bufferDesc.size = 65536;
+
+            for (uint32_t i = 0; i < bufferNum; i++) {
+                if (device.core.CreateBuffer(*device.device, bufferDesc, buffers[i]) != Result::SUCCESS)
+                    return false;
+            }
+
+            ResourceGroupDesc resourceGroupDesc = {};
+            resourceGroupDesc.memoryLocation = MemoryLocation::DEVICE;
+            resourceGroupDesc.buffers = buffers;
+            resourceGroupDesc.bufferNum = bufferNum;
+
+            return device.helper.AllocateAndBindDefragmentableMemory(*defragmenter, resourceGroupDesc) == Result::SUCCESS;
+        };
+
+        // Released: the emptied memory outlives "ReleaseDefragmentableResources" and the destruction of the resources
+        Buffer* buffers[BUFFER_NUM] = {};
+        TEST_CHECK(CreateGroup(buffers, BUFFER_NUM));
+
+        uint64_t groupUsage = GetUsage();
+        TEST_CHECK(groupUsage != 0);
+
+        device.helper.ReleaseDefragmentableResources(*defragmenter, buffers, BUFFER_NUM, nullptr, 0);
+        TEST_CHECK(GetUsage() == groupUsage);
+
+        for (Buffer* buffer : buffers)
+            device.core.DestroyBuffer(*buffer);
+        TEST_CHECK(GetUsage() == groupUsage);
+
+        uint32_t moveNum = 0;
+        device.helper.BeginDefragmentation(*defragmenter, 0, 0, moveNum);
+        TEST_CHECK(GetUsage() == 0);
+
+        // Moved out: the source memory outlives the moves until the fence passes
+        Buffer* buffersA[BUFFER_NUM] = {};
+        Buffer* buffersB[1] = {};
+        TEST_CHECK(CreateGroup(buffersA, BUFFER_NUM));
+        TEST_CHECK(CreateGroup(buffersB, 1));
+
+        uint64_t heapBUsage = GetUsage() - groupUsage;
+
+        device.helper.ReleaseDefragmentableResources(*defragmenter, buffersA, 1, nullptr, 0);
+        device.core.DestroyBuffer(*buffersA[0]);
+
+        const DefragmentationMove* moves = device.helper.BeginDefragmentation(*defragmenter, 1ull << 30, 1, moveNum);
+        TEST_CHECK(moveNum == 1 && moves[0].srcBuffer == buffersB[0]);
+        buffersB[0] = moves[0].dstBuffer;
+
+        TestCommandBuffer commandBuffer(device);
+        TEST_CHECK(commandBuffer.Begin());
+        device.helper.CmdDefragment(*commandBuffer.commandBuffer, *defragmenter);
+        TEST_CHECK(commandBuffer.Submit());
+
+        uint64_t usage = GetUsage();
+
+        device.helper.BeginDefragmentation(*defragmenter, 0, 1, moveNum);
+        TEST_CHECK(GetUsage() == usage);
+
+        FenceSubmitDesc fenceSubmitDesc = {};
+        fenceSubmitDesc.fence = fence;
+        fenceSubmitDesc.value = 1;
+
+        QueueSubmitDesc queueSubmitDesc = {};
+        queueSubmitDesc.signalFences = &fenceSubmitDesc;
+        queueSubmitDesc.signalFenceNum = 1;
+
+        device.core.QueueSubmit(*device.queue, queueSubmitDesc);
+
+        device.helper.BeginDefragmentation(*defragmenter, 0, 1, moveNum);
+        TEST_CHECK(GetUsage() == usage - heapBUsage);
+
+        // Teardown
+        device.helper.ReleaseDefragmentableResources(*defragmenter, buffersA + 1, BUFFER_NUM - 1, nullptr, 0);
+        device.helper.ReleaseDefragmentableResources(*defragmenter, buffersB, 1, nullptr, 0);
+        for (uint32_t i = 1; i < BUFFER_NUM; i++)
+            device.core.DestroyBuffer(*buffersA[i]);
+        device.core.DestroyBuffer(*buffersB[0]);
+
+        device.helper.BeginDefragmentation(*defragmenter, 0, 1, moveNum);
+        TEST_CHECK(GetUsage() == 0);
+
+        device.helper.DestroyDefragmenter(*defragmenter);
+        device.core.DestroyFence(*fence);
+
+        TEST_CHECK(errorNum == 0);
+    }
+
+    return true;
+}
+
+// Passes run every frame, while copies of previous passes are in flight. Heap X is partly emptied by the first pass (fence 1 is not signalled),
+// the second pass must not place a resource into the range vacated in X, because "CmdDefragment" copies of the first pass still read it.
+// Once the fence passes, X is a destination again
+bool TestDefragmenterInFlightPasses() {
+    constexpr uint64_t BUFFER_SIZE = 65536;
+    constexpr uint32_t BUFFER_A_NUM = 5;
+    constexpr uint32_t BUFFER_X_NUM = 3;
+
+    for (bool enableValidation : {false, true}) {
+        TestDevice device;
+        TEST_CHECK(device.Create(enableValidation));
+
+        Fence* fence = nullptr;
+        TEST_CHECK(device.core.CreateFence(*device.device, 0, fence) == Result::SUCCESS);
+
+        DefragmenterDesc defragmenterDesc = {};
+        defragmenterDesc.fence = fence;
+
+        Defragmenter* defragmenter = nullptr;
+        TEST_CHECK(device.helper.CreateDefragmenter(*device.device, defragmenterDesc, defragmenter) == Result::SUCCESS);
+
+        auto CreateGroup = [&](Buffer** buffers, uint32_t bufferNum) {
+            BufferDesc bufferDesc = {};
+            bufferDesc.size = BUFFER_SIZE;
+
+            for (uint32_t i = 0; i < bufferNum; i++) {
+                if (device.core.CreateBuffer(*device.device, bufferDesc, buffers[i]) != Result::SUCCESS)
+                    return false;
+            }
+
+            ResourceGroupDesc resourceGroupDesc = {};
+            resourceGroupDesc.memoryLocation = MemoryLocation::DEVICE;
+            resourceGroupDesc.buffers = buffers;
+            resourceGroupDesc.bufferNum = bufferNum;
+
+            return device.helper.AllocateAndBindDefragmentableMemory(*defragmenter, resourceGroupDesc) == Result::SUCCESS;
+        };
+
+        auto Replace = [](Buffer** buffers, uint32_t bufferNum, const DefragmentationMove& move) {
+            for (uint32_t i = 0; i < bufferNum; i++) {
+                if (buffers[i] == move.srcBuffer)
+                    buffers[i] = move.dstBuffer;
+            }
+        };
+
+        auto Defragment = [&](uint64_t fenceValue, bool signal) {
+            TestCommandBuffer commandBuffer(device);
+            if (!commandBuffer.Begin())
+                return false;
+
+            device.helper.CmdDefragment(*commandBuffer.commandBuffer, *defragmenter);
+
+            if (device.core.EndCommandBuffer(*commandBuffer.commandBuffer) != Result::SUCCESS)
+                return false;
+
+            FenceSubmitDesc fenceSubmitDesc = {};
+            fenceSubmitDesc.fence = fence;
+            fenceSubmitDesc.value = fenceValue;
+
+            QueueSubmitDesc queueSubmitDesc = {};
+            queueSubmitDesc.commandBuffers = &commandBuffer.commandBuffer;
+            queueSubmitDesc.commandBufferNum = 1;
+            queueSubmitDesc.signalFences = &fenceSubmitDesc;
+            queueSubmitDesc.signalFenceNum = signal ? 1 : 0;
+
+            device.core.QueueSubmit(*device.queue, queueSubmitDesc);
+
+            return device.helper.WaitForIdle(*device.queue) == Result::SUCCESS;
+        };
+
+        // A: one gap after a release, X: 3 buffers
+        Buffer* buffersA[BUFFER_A_NUM] = {};
+        Buffer* buffersX[BUFFER_X_NUM] = {};
+        TEST_CHECK(CreateGroup(buffersA, BUFFER_A_NUM));
+        TEST_CHECK(CreateGroup(buffersX, BUFFER_X_NUM));
+
+        device.helper.ReleaseDefragmentableResources(*defragmenter, buffersA + 1, 1, nullptr, 0);
+        device.core.DestroyBuffer(*buffersA[1]);
+        buffersA[1] = buffersA[BUFFER_A_NUM - 1];
+
+        // Pass 1: one buffer of X moves into the gap of A, fence 1 is not signalled
+        uint32_t moveNum = 0;
+        const DefragmentationMove* moves = device.helper.BeginDefragmentation(*defragmenter, BUFFER_SIZE, 1, moveNum);
+        TEST_CHECK(moveNum == 1);
+
+        Memory* memoryA = moves[0].dstMemory;
+        Memory* memoryX = moves[0].srcMemory;
+        Replace(buffersX, BUFFER_X_NUM, moves[0]);
+
+        TEST_CHECK(Defragment(1, false));
+
+        // Pass 2: Y (the emptiest) doesn't fit into A, and X is still read by the copy of pass 1
+        Buffer* bufferY = nullptr;
+        TEST_CHECK(CreateGroup(&bufferY, 1));
+
+        moves = device.helper.BeginDefragmentation(*defragmenter, 1ull << 30, 2, moveNum);
+        TEST_CHECK(moveNum == 0);
+
+        // Pass 3: the copy is completed, Y moves into the range vacated in X
+        TEST_CHECK(Defragment(1, true));
+
+        moves = device.helper.BeginDefragmentation(*defragmenter, 1ull << 30, 2, moveNum);
+        TEST_CHECK(moveNum == 1 && moves[0].srcBuffer == bufferY && moves[0].dstMemory == memoryX && moves[0].dstMemory != memoryA);
+        Replace(&bufferY, 1, moves[0]);
+
+        TEST_CHECK(Defragment(2, true));
+
+        // Teardown
+        device.helper.ReleaseDefragmentableResources(*defragmenter, buffersA, BUFFER_A_NUM - 1, nullptr, 0);
+        device.helper.ReleaseDefragmentableResources(*defragmenter, buffersX, BUFFER_X_NUM, nullptr, 0);
+        device.helper.ReleaseDefragmentableResources(*defragmenter, &bufferY, 1, nullptr, 0);
+        for (uint32_t i = 0; i < BUFFER_A_NUM - 1; i++)
+            device.core.DestroyBuffer(*buffersA[i]);
+        for (Buffer* buffer : buffersX)
+            device.core.DestroyBuffer(*buffer);
+        device.core.DestroyBuffer(*bufferY);
+
+        device.helper.DestroyDefragmenter(*defragmenter);
+        device.core.DestroyFence(*fence);
+    }
+
+    return true;
+}
@@ -0,0 +1,169 @@
+// © 2021 NVIDIA Corporation
+
+#include "Tests.h"
+
+using namespace nri;
+
+constexpr uint32_t POOL_SET_NUM = 4;
+constexpr uint32_t POOL_SAMPLER_NUM = 8;
+constexpr uint32_t POOL_CONSTANT_BUFFER_NUM = 4;
+
+// Without validation, to check the backend itself. NONE checks the capacity for all descriptor types at once (like D3D11):
+//  - a set of the first layout takes 2 samplers and 1 dynamic constant buffer, the variable sized array of the second one takes what is requested
+//  - allocation is all or nothing, a failed one leaves the pool usable
+//  - a reset releases all sets at once, peaks survive it
+bool TestDescriptorPoolOccupancy() {
+    TestDevice device;
+    TEST_CHECK(device.Create(false));
+
+    DescriptorRangeDesc descriptorRangeDescs[2] = {};
+    descriptorRangeDescs[0].descriptorNum = 2;
+    descriptorRangeDescs[0].descriptorType = DescriptorType::SAMPLER;
+    descriptorRangeDescs[0].shaderStages = StageBits::COMPUTE_SHADER;
+
+    descriptorRangeDescs[1].descriptorNum = POOL_SAMPLER_NUM;
+    descriptorRangeDescs[1].descriptorType = DescriptorType::SAMPLER;
+    descriptorRangeDescs[1].shaderStages = StageBits::COMPUTE_SHADER;
+    descriptorRangeDescs[1].flags = DescriptorRangeBits::VARIABLE_SIZED_ARRAY;
+
+    DynamicConstantBufferDesc dynamicConstantBufferDesc = {};
+    dynamicConstantBufferDesc.shaderStages = StageBits::COMPUTE_SHADER;
+
+    DescriptorSetDesc descriptorSetDescs[2] = {};
+    descriptorSetDescs[0].registerSpace = 0;
+    descriptorSetDescs[0].ranges = &descriptorRangeDescs[0];
+    descriptorSetDescs[0].rangeNum = 1;
+    descriptorSetDescs[0].dynamicConstantBuffers = &dynamicConstantBufferDesc;
+    descriptorSetDescs[0].dynamicConstantBufferNum = 1;
+
+    descriptorSetDescs[1].registerSpace = 1;
+    descriptorSetDescs[1].ranges = &descriptorRangeDescs[1];
+    descriptorSetDescs[1].rangeNum = 1;
+
+    PipelineLayoutDesc pipelineLayoutDesc = {};
+    pipelineLayoutDesc.descriptorSets = descriptorSetDescs;
+    pipelineLayoutDesc.descriptorSetNum = 2;
+    pipelineLayoutDesc.shaderStages = StageBits::COMPUTE_SHADER;
+
+    PipelineLayout* pipelineLayout = nullptr;
+    TEST_CHECK(device.core.CreatePipelineLayout(*device.device, pipelineLayoutDesc, pipelineLayout) == Result::SUCCESS);
+
+    DescriptorPoolDesc descriptorPoolDesc = {};
+    descriptorPoolDesc.descriptorSetMaxNum = POOL_SET_NUM;
+    descriptorPoolDesc.samplerMaxNum = POOL_SAMPLER_NUM;
+    descriptorPoolDesc.dynamicConstantBufferMaxNum = POOL_CONSTANT_BUFFER_NUM;
+
+    DescriptorPool* descriptorPool = nullptr;
+    TEST_CHECK(device.core.CreateDescriptorPool(*device.device, descriptorPoolDesc, descriptorPool) == Result::SUCCESS);
+
+    auto GetStats = [&]() {
+        DescriptorPoolStats descriptorPoolStats = {};
+        device.core.GetDescriptorPoolStats(*descriptorPool, descriptorPoolStats);
+
+        return descriptorPoolStats;
+    };
+
+    DescriptorPoolStats descriptorPoolStats = GetStats();
+    TEST_CHECK(descriptorPoolStats.descriptorSetNum == 0 && descriptorPoolStats.descriptorNum == 0);
+    TEST_CHECK(descriptorPoolStats.descriptorSetMaxNum == POOL_SET_NUM && descriptorPoolStats.descriptorMaxNum == POOL_SAMPLER_NUM + POOL_CONSTANT_BUFFER_NUM);
+
+    // 3 sets of 3 descriptors
+    DescriptorSet* descriptorSets[POOL_SET_NUM] = {};
+    TEST_CHECK(device.core.AllocateDescriptorSets(*descriptorPool, *pipelineLayout, 0, descriptorSets, 3, 0) == Result::SUCCESS);
+    TEST_CHECK(descriptorSets[0] && descriptorSets[1] && descriptorSets[2]);
+
+    descriptorPoolStats = GetStats();
+    TEST_CHECK(descriptorPoolStats.descriptorSetNum == 3 && descriptorPoolStats.descriptorNum == 9);
+
+    // Not enough descriptors for a variable sized array of 4, nothing is allocated
+    TEST_CHECK(device.core.AllocateDescriptorSets(*descriptorPool, *pipelineLayout, 1, descriptorSets, 1, 4) == Result::OUT_OF_MEMORY);
+
+    // But enough for 3, which fills the pool
+    TEST_CHECK(device.core.AllocateDescriptorSets(*descriptorPool, *pipelineLayout, 1, descriptorSets, 1, 3) == Result::SUCCESS);
+
+    descriptorPoolStats = GetStats();
+    TEST_CHECK(descriptorPoolStats.descriptorSetNum == 4 && descriptorPoolStats.descriptorNum == 12);
+
+    // Out of sets, even if no descriptors are needed
+    TEST_CHECK(device.core.AllocateDescriptorSets(*descriptorPool, *pipelineLayout, 1, descriptorSets, 1, 0) == Result::OUT_OF_MEMORY);
+
+    // A bad set index
+    TEST_CHECK(device.core.AllocateDescriptorSets(*descriptorPool, *pipelineLayout, 2, descriptorSets, 1, 0) == Result::INVALID_ARGUMENT);
+
+    // Reset releases everything, peaks stay
+    device.core.ResetDescriptorPool(*descriptorPool);
+
+    descriptorPoolStats = GetStats();
+    TEST_CHECK(descriptorPoolStats.descriptorSetNum == 0 && descriptorPoolStats.descriptorNum == 0);
+    TEST_CHECK(descriptorPoolStats.peakDescriptorSetNum == 4 && descriptorPoolStats.peakDescriptorNum == 12);
+
+    TEST_CHECK(device.core.AllocateDescriptorSets(*descriptorPool, *pipelineLayout, 0, descriptorSets, POOL_SET_NUM, 0) == Result::SUCCESS);
+
+    descriptorPoolStats = GetStats();
+    TEST_CHECK(descriptorPoolStats.descriptorSetNum == POOL_SET_NUM && descriptorPoolStats.descriptorNum == 12);
+    TEST_CHECK(descriptorPoolStats.peakDescriptorSetNum == 4 && descriptorPoolStats.peakDescriptorNum == 12);
+
+    device.core.DestroyDescriptorPool(*descriptorPool);
+    device.core.DestroyPipelineLayout(*pipelineLayout);
+
+    return true;
+}
+
+// Per-frame use: fill, reset, repeat. Through validation, which also counts descriptors per type
+bool TestDescriptorPoolFrames() {
+    TestDevice device;
+    TEST_CHECK(device.Create(true));
+
+    DescriptorRangeDesc descriptorRangeDesc = {};
+    descriptorRangeDesc.descriptorNum = 1;
+    descriptorRangeDesc.descriptorType = DescriptorType::SAMPLER;
+    descriptorRangeDesc.shaderStages = StageBits::COMPUTE_SHADER;
+
+    DescriptorSetDesc descriptorSetDesc = {};
+    descriptorSetDesc.ranges = &descriptorRangeDesc;
+    descriptorSetDesc.rangeNum = 1;
+
+    PipelineLayoutDesc pipelineLayoutDesc = {};
+    pipelineLayoutDesc.descriptorSets = &descriptorSetDesc;
+    pipelineLayoutDesc.descriptorSetNum = 1;
+    pipelineLayoutDesc.shaderStages = StageBits::COMPUTE_SHADER;
+
+    PipelineLayout* pipelineLayout = nullptr;
+    TEST_CHECK(device.core.CreatePipelineLayout(*device.device, pipelineLayoutDesc, pipelineLayout) == Result::SUCCESS);
+
+    constexpr uint32_t frameSetNum = 256;
+    constexpr uint32_t frameNum = 64;
+
+    DescriptorPoolDesc descriptorPoolDesc = {};
+    descriptorPoolDesc.descriptorSetMaxNum = frameSetNum;
+    descriptorPoolDesc.samplerMaxNum = frameSetNum;
+
+    DescriptorPool* descriptorPool = nullptr;
+    TEST_CHECK(device.core.CreateDescriptorPool(*device.device, descriptorPoolDesc, descriptorPool) == Result::SUCCESS);
+
+    TestTimer timer;
+    bool isAllocated = true;
+    for (uint32_t frame = 0; frame < frameNum; frame++) {
+        device.core.ResetDescriptorPool(*descriptorPool);
+
+        for (uint32_t i = 0; i < frameSetNum; i++) {
+            DescriptorSet* descriptorSet = nullptr;
+            isAllocated = isAllocated && device.core.AllocateDescriptorSets(*descriptorPool, *pipelineLayout, 0, &descriptorSet, 1, 0) == Result::SUCCESS;
+        }
+    }
+    double nanoseconds = timer.GetNanoseconds();
+
+    printf("    %.1f ns per set\n", nanoseconds / (frameNum * frameSetNum));
+
+    TEST_CHECK(isAllocated);
+
+    DescriptorPoolStats descriptorPoolStats = {};
+    device.core.GetDescriptorPoolStats(*descriptorPool, descriptorPoolStats);
+    TEST_CHECK(descriptorPoolStats.descriptorSetNum == frameSetNum && descriptorPoolStats.descriptorNum == frameSetNum);
+    TEST_CHECK(descriptorPoolStats.peakDescriptorSetNum == frameSetNum && descriptorPoolStats.peakDescriptorNum == frameSetNum);
+
+    device.core.DestroyDescriptorPool(*descriptorPool);
+    device.core.DestroyPipelineLayout(*pipelineLayout);
+
+    return true;
+}
@@ -0,0 +1,176 @@
+// © 2021 NVIDIA Corporation
+
+#include "Tests.h"
+
+#include <atomic>
+
+using namespace nri;
+
+constexpr uint32_t CACHE_SAMPLER_NUM = 12;
+constexpr uint32_t CACHE_POOL_SET_NUM = 4;
+
+static void CountErrors(Message messageType, const char*, uint32_t, const char*, void* userArg) {
+    if (messageType == Message::ERROR)
+        ((std::atomic_uint32_t*)userArg)->fetch_add(1, std::memory_order_relaxed);
+}
+
+// Keys are descriptor pointers: with validation samplers and sets are distinct objects (without it they are the same dummy object).
+// A pool holds 4 sets of a layout with one sampler:
+//  - hits return the same set and make it the most recently used, misses allocate until the pool is full
+//  - when the pool is full, the least recently used set is evicted once the fence reaches its value, otherwise a pool is added
+//  - purged sets are not found anymore and go first, but a purged set still in use doesn't block eviction of the sets behind it
+bool TestDescriptorSetCache() {
+    TestDevice device;
+    std::atomic_uint32_t errorNum = 0;
+
+    CallbackInterface callbackInterface = {};
+    callbackInterface.MessageCallback = CountErrors;
+    callbackInterface.AbortExecution = [](void*) {};
+    callbackInterface.userArg = &errorNum;
+
+    TEST_CHECK(device.Create(true, nullptr, &callbackInterface));
+
+    Fence* fence = nullptr;
+    TEST_CHECK(device.core.CreateFence(*device.device, 0, fence) == Result::SUCCESS);
+
+    auto Signal = [&](uint64_t value) {
+        FenceSubmitDesc fenceSubmitDesc = {};
+        fenceSubmitDesc.fence = fence;
+        fenceSubmitDesc.value = value;
+        fenceSubmitDesc.stages = StageBits::ALL;
+
+        QueueSubmitDesc queueSubmitDesc = {};
+        queueSubmitDesc.signalFences = &fenceSubmitDesc;
+        queueSubmitDesc.signalFenceNum = 1;
+
+        device.core.QueueSubmit(*device.queue, queueSubmitDesc);
+    };
+
+    DescriptorRangeDesc descriptorRangeDesc = {};
+    descriptorRangeDesc.descriptorNum = 1;
+    descriptorRangeDesc.descriptorType = DescriptorType::SAMPLER;
+    descriptorRangeDesc.shaderStages = StageBits::COMPUTE_SHADER;
+
+    DescriptorSetDesc descriptorSetDesc = {};
+    descriptorSetDesc.ranges = &descriptorRangeDesc;
+    descriptorSetDesc.rangeNum = 1;
+
+    PipelineLayoutDesc pipelineLayoutDesc = {};
+    pipelineLayoutDesc.descriptorSets = &descriptorSetDesc;
+    pipelineLayoutDesc.descriptorSetNum = 1;
+    pipelineLayoutDesc.shaderStages = StageBits::COMPUTE_SHADER;
+
+    PipelineLayout* pipelineLayout = nullptr;
+    TEST_CHECK(device.core.CreatePipelineLayout(*device.device, pipelineLayoutDesc, pipelineLayout) == Result::SUCCESS);
+
+    Descriptor* samplers[CACHE_SAMPLER_NUM] = {};
+    for (Descriptor*& sampler : samplers) {
+        SamplerDesc samplerDesc = {};
+        TEST_CHECK(device.core.CreateSampler(*device.device, samplerDesc, sampler) == Result::SUCCESS);
+    }
+
+    DescriptorSetCacheDesc descriptorSetCacheDesc = {};
+    descriptorSetCacheDesc.descriptorPoolDesc.descriptorSetMaxNum = CACHE_POOL_SET_NUM;
+    descriptorSetCacheDesc.descriptorPoolDesc.samplerMaxNum = CACHE_POOL_SET_NUM;
+    descriptorSetCacheDesc.fence = fence;
+
+    DescriptorSetCache* descriptorSetCache = nullptr;
+    TEST_CHECK(device.helper.CreateDescriptorSetCache(*device.device, descriptorSetCacheDesc, descriptorSetCache) == Result::SUCCESS);
+
+    auto Get = [&](uint32_t samplerIndex, uint64_t fenceValue) {
+        DescriptorRangeUpdateDesc descriptorRangeUpdateDesc = {};
+        descriptorRangeUpdateDesc.descriptors = &samplers[samplerIndex];
+        descriptorRangeUpdateDesc.descriptorNum = 1;
+
+        CachedDescriptorSetDesc cachedDescriptorSetDesc = {};
+        cachedDescriptorSetDesc.pipelineLayout = pipelineLayout;
+        cachedDescriptorSetDesc.ranges = &descriptorRangeUpdateDesc;
+        cachedDescriptorSetDesc.rangeNum = 1;
+
+        DescriptorSet* descriptorSet = nullptr;
+        if (device.helper.GetCachedDescriptorSet(*descriptorSetCache, cachedDescriptorSetDesc, fenceValue, descriptorSet) != Result::SUCCESS)
+            return (DescriptorSet*)nullptr;
+
+        return descriptorSet;
+    };
+
+    auto GetStats = [&]() {
+        DescriptorSetCacheStats descriptorSetCacheStats = {};
+        device.helper.GetDescriptorSetCacheStats(*descriptorSetCache, descriptorSetCacheStats);
+
+        return descriptorSetCacheStats;
+    };
+
+    // Fill the first pool in frame 1, a hit returns the same set
+    DescriptorSet* sets[CACHE_SAMPLER_NUM] = {};
+    for (uint32_t i = 0; i < CACHE_POOL_SET_NUM; i++)
+        sets[i] = Get(i, 1);
+
+    TEST_CHECK(sets[0] && sets[1] && sets[2] && sets[3]);
+    TEST_CHECK(sets[0] != sets[1] && sets[1] != sets[2] && sets[2] != sets[3]);
+    TEST_CHECK(Get(0, 1) == sets[0]);
+
+    DescriptorSetCacheStats descriptorSetCacheStats = GetStats();
+    TEST_CHECK(descriptorSetCacheStats.hitNum == 1 && descriptorSetCacheStats.missNum == 4 && descriptorSetCacheStats.evictionNum == 0);
+    TEST_CHECK(descriptorSetCacheStats.setNum == 4 && descriptorSetCacheStats.descriptorPoolNum == 1);
+
+    // Frame 2: the GPU hasn't finished frame 1, so nothing can be evicted and a pool is added
+    for (uint32_t i = 4; i < 8; i++)
+        sets[i] = Get(i, 2);
+
+    descriptorSetCacheStats = GetStats();
+    TEST_CHECK(descriptorSetCacheStats.missNum == 8 && descriptorSetCacheStats.evictionNum == 0);
+    TEST_CHECK(descriptorSetCacheStats.setNum == 8 && descriptorSetCacheStats.descriptorPoolNum == 2);
+
+    // Frame 1 is done. "sets[0]" and "sets[1]" have been used again, so "sets[2]" and then "sets[3]" are the least recently used
+    Signal(1);
+
+    TEST_CHECK(Get(1, 3) == sets[1]);
+    TEST_CHECK(Get(8, 3) == sets[2]);
+    TEST_CHECK(Get(2, 3) == sets[3]);
+
+    descriptorSetCacheStats = GetStats();
+    TEST_CHECK(descriptorSetCacheStats.hitNum == 2 && descriptorSetCacheStats.missNum == 10 && descriptorSetCacheStats.evictionNum == 2);
+    TEST_CHECK(descriptorSetCacheStats.setNum == 8 && descriptorSetCacheStats.descriptorPoolNum == 2);
+
+    // "sets[7]" (frame 2, still in use) is purged and becomes the first candidate, but "sets[0]" (frame 1) behind it is evicted
+    const Descriptor* purged = samplers[7];
+    device.helper.PurgeCachedDescriptorSets(*descriptorSetCache, &purged, 1);
+
+    TEST_CHECK(Get(9, 3) == sets[0]);
+
+    descriptorSetCacheStats = GetStats();
+    TEST_CHECK(descriptorSetCacheStats.evictionNum == 3 && descriptorSetCacheStats.descriptorPoolNum == 2);
+
+    // Frame 2 is done: the purged set goes first, purged keys miss
+    Signal(2);
+
+    TEST_CHECK(Get(7, 3) == sets[7]);
+
+    descriptorSetCacheStats = GetStats();
+    TEST_CHECK(descriptorSetCacheStats.hitNum == 2 && descriptorSetCacheStats.missNum == 12 && descriptorSetCacheStats.evictionNum == 4);
+
+    // Frame 3 is not done and every set is in it, so a pool is added again
+    for (uint32_t i = 4; i < 7; i++)
+        TEST_CHECK(Get(i, 3) == sets[i]);
+
+    DescriptorSet* set = Get(10, 4);
+    TEST_CHECK(set);
+    for (uint32_t i = 0; i < 8; i++)
+        TEST_CHECK(set != sets[i]);
+
+    descriptorSetCacheStats = GetStats();
+    TEST_CHECK(descriptorSetCacheStats.hitNum == 5 && descriptorSetCacheStats.missNum == 13);
+    TEST_CHECK(descriptorSetCacheStats.evictionNum == 4 && descriptorSetCacheStats.setNum == 9 && descriptorSetCacheStats.descriptorPoolNum == 3);
+    TEST_CHECK(errorNum == 0);
+
+    device.helper.DestroyDescriptorSetCache(*descriptorSetCache);
+
+    for (Descriptor* sampler : samplers)
+        device.core.DestroyDescriptor(*sampler);
+
+    device.core.DestroyPipelineLayout(*pipelineLayout);
+    device.core.DestroyFence(*fence);
+
+    return true;
+}
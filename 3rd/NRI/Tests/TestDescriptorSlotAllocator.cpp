@@ -0,0 +1,298 @@
+// © 2021 NVIDIA Corporation
+
+#include "Tests.h"
+
+#include "SharedExternal.h"
+
+#include <atomic>
+
+using namespace nri;
+
+constexpr uint32_t SLOT_PAGE_SIZE = 1024;
+
+struct SlotPages {
+    std::array<std::atomic_uint32_t, DESCRIPTOR_SLOT_POOL_MAX_NUM> pageNums = {};
+    std::atomic_bool isOrdered = true;
+};
+
+// Pages must be added in order, one at a time per pool
+static Result AddSlotPage(void* userArg, uint32_t poolIndex, uint32_t pageIndex) {
+    SlotPages& slotPages = *(SlotPages*)userArg;
+    if (slotPages.pageNums[poolIndex].load() != pageIndex)
+        slotPages.isOrdered = false;
+
+    slotPages.pageNums[poolIndex]++;
+
+    return Result::SUCCESS;
+}
+
+static const AllocationCallbacks g_AllocationCallbacks = {AlignedMalloc, AlignedRealloc, AlignedFree, nullptr, false};
+
+// Slots are unique, pages are added on demand up to the limit, pools are independent, and freed slots are reused without new pages
+bool TestDescriptorSlotAllocatorBasics() {
+    constexpr uint32_t PAGE_MAX_NUM = 4;
+    constexpr uint32_t SLOT_NUM = PAGE_MAX_NUM * SLOT_PAGE_SIZE;
+
+    SlotPages slotPages;
+    DescriptorSlotAllocator allocator(g_AllocationCallbacks, DeviceBase::GenerateId(), {AddSlotPage, &slotPages, 2, SLOT_PAGE_SIZE, PAGE_MAX_NUM});
+
+    std::vector<uint32_t> slots(SLOT_NUM);
+    std::vector<uint8_t> states(SLOT_NUM, 0);
+
+    for (uint32_t& slot : slots) {
+        TEST_CHECK(allocator.Allocate(0, slot) == Result::SUCCESS);
+        TEST_CHECK(slot < SLOT_NUM && states[slot] == 0);
+        states[slot] = 1;
+    }
+
+    TEST_CHECK(slotPages.pageNums[0] == PAGE_MAX_NUM && slotPages.pageNums[1] == 0);
+    TEST_CHECK(allocator.GetCapacity(0) == SLOT_NUM);
+
+    uint32_t slot = 0;
+    TEST_CHECK(allocator.Allocate(0, slot) == Result::OUT_OF_MEMORY);
+    TEST_CHECK(allocator.Allocate(1, slot) == Result::SUCCESS && slot == 0);
+
+    for (uint32_t s : slots)
+        allocator.Free(0, s);
+
+    for (uint32_t& s : slots) {
+        TEST_CHECK(allocator.Allocate(0, s) == Result::SUCCESS);
+        TEST_CHECK(states[s] == 1);
+        states[s] = 2;
+    }
+
+    TEST_CHECK(slotPages.pageNums[0] == PAGE_MAX_NUM);
+    TEST_CHECK(slotPages.isOrdered);
+
+    // Never allocated slots are rejected, repeated frees are detected once there are more frees than slots
+    TEST_CHECK(allocator.Free(1, SLOT_PAGE_SIZE) == Result::INVALID_ARGUMENT);
+
+    Result result = Result::SUCCESS;
+    for (uint32_t i = 0; i < 2 * SLOT_NUM && result == Result::SUCCESS; i++) // magazines are shared by pools
+        result = allocator.Free(1, slot);
+
+    TEST_CHECK(result == Result::INVALID_ARGUMENT);
+
+    return true;
+}
+
+// Short-lived threads leave slots in their caches, which are adopted by the next threads instead of growing the pool
+bool TestDescriptorSlotAllocatorThreadExit() {
+    constexpr uint32_t THREAD_NUM = 64;
+    constexpr uint32_t SLOT_NUM = 200;
+
+    SlotPages slotPages;
+    DescriptorSlotAllocator allocator(g_AllocationCallbacks, DeviceBase::GenerateId(), {AddSlotPage, &slotPages, 1, SLOT_PAGE_SIZE, 1});
+
+    // "THREAD_NUM" caches, each holding up to "2 * DESCRIPTOR_SLOT_MAGAZINE_SIZE" slots, would need 8 pages
+    bool isSucceeded = true;
+    for (uint32_t t = 0; t < THREAD_NUM && isSucceeded; t++) {
+        std::thread thread([&] {
+            std::vector<uint32_t> slots(SLOT_NUM);
+            for (uint32_t& slot : slots)
+                isSucceeded = isSucceeded && allocator.Allocate(0, slot) == Result::SUCCESS;
+
+            for (uint32_t slot : slots)
+                isSucceeded = isSucceeded && allocator.Free(0, slot) == Result::SUCCESS;
+        });
+
+        thread.join();
+    }
+
+    TEST_CHECK(isSucceeded);
+    TEST_CHECK(slotPages.pageNums[0] == 1);
+
+    // A thread with its own cache gets slots left by a finished thread, when the pool is exhausted
+    SlotPages otherSlotPages;
+    DescriptorSlotAllocator otherAllocator(g_AllocationCallbacks, DeviceBase::GenerateId(), {AddSlotPage, &otherSlotPages, 1, SLOT_PAGE_SIZE, 1});
+
+    std::vector<uint32_t> slots(SLOT_PAGE_SIZE);
+    TEST_CHECK(otherAllocator.Allocate(0, slots[0]) == Result::SUCCESS);
+
+    std::thread thread([&] {
+        std::vector<uint32_t> threadSlots(SLOT_NUM);
+        for (uint32_t& slot : threadSlots)
+            isSucceeded = isSucceeded && otherAllocator.Allocate(0, slot) == Result::SUCCESS;
+
+        for (uint32_t slot : threadSlots)
+            isSucceeded = isSucceeded && otherAllocator.Free(0, slot) == Result::SUCCESS;
+    });
+
+    thread.join();
+
+    for (uint32_t i = 1; i < SLOT_PAGE_SIZE; i++)
+        isSucceeded = isSucceeded && otherAllocator.Allocate(0, slots[i]) == Result::SUCCESS;
+
+    TEST_CHECK(isSucceeded);
+
+    return true;
+}
+
+// Threads allocate from two pools and free randomly, half of the frees are handed off to another thread.
+// A slot owned twice at the same time fails the test
+bool TestDescriptorSlotAllocatorChurn() {
+    constexpr uint32_t THREAD_NUM = 4;
+    constexpr uint32_t OPERATION_NUM = 400000;
+    constexpr uint32_t PAGE_MAX_NUM = 1024;
+
+    SlotPages slotPages;
+    DescriptorSlotAllocator allocator(g_AllocationCallbacks, DeviceBase::GenerateId(), {AddSlotPage, &slotPages, 2, SLOT_PAGE_SIZE, PAGE_MAX_NUM});
+
+    std::vector<std::atomic_uint8_t> owners(2 * PAGE_MAX_NUM * SLOT_PAGE_SIZE);
+    std::array<std::vector<uint32_t>, THREAD_NUM> handoffs;
+    std::array<Lock, THREAD_NUM> handoffLocks;
+    std::atomic_bool isSucceeded = true;
+
+    // Slots are encoded as "slot << 1 | pool"
+    auto release = [&](uint32_t encodedSlot) {
+        if (owners[encodedSlot].exchange(0) != 1)
+            isSucceeded = false;
+    };
+
+    TestTimer timer;
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < THREAD_NUM; t++) {
+        threads.emplace_back([&, t] {
+            std::vector<uint32_t> ownedSlots;
+            uint32_t random = t * 7919 + 1;
+
+            for (uint32_t i = 0; i < OPERATION_NUM && isSucceeded; i++) {
+                random = random * 1664525 + 1013904223;
+
+                if ((random >> 16) % 3 != 0 || ownedSlots.empty()) {
+                    uint32_t poolIndex = (random >> 28) & 1;
+
+                    uint32_t slot = 0;
+                    if (allocator.Allocate(poolIndex, slot) != Result::SUCCESS) {
+                        isSucceeded = false;
+                        break;
+                    }
+
+                    uint32_t encodedSlot = slot << 1 | poolIndex;
+                    if (owners[encodedSlot].exchange(1) != 0)
+                        isSucceeded = false;
+
+                    ownedSlots.push_back(encodedSlot);
+                } else {
+                    uint32_t encodedSlot = ownedSlots.back();
+                    ownedSlots.pop_back();
+                    release(encodedSlot);
+
+                    if ((random >> 8) & 1) {
+                        uint32_t next = (t + 1) % THREAD_NUM;
+
+                        ExclusiveScope lock(handoffLocks[next]);
+                        handoffs[next].push_back(encodedSlot);
+                    } else
+                        allocator.Free(encodedSlot & 1, encodedSlot >> 1);
+                }
+
+                if ((i & 1023) == 0) {
+                    std::vector<uint32_t> handoff;
+                    {
+                        ExclusiveScope lock(handoffLocks[t]);
+                        handoff.swap(handoffs[t]);
+                    }
+
+                    for (uint32_t encodedSlot : handoff)
+                        allocator.Free(encodedSlot & 1, encodedSlot >> 1);
+                }
+            }
+
+            for (uint32_t encodedSlot : ownedSlots) {
+                release(encodedSlot);
+                allocator.Free(encodedSlot & 1, encodedSlot >> 1);
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    printf("    %u threads: %.1f ms, pages %u + %u\n", THREAD_NUM, timer.GetNanoseconds() / 1000000.0, slotPages.pageNums[0].load(), slotPages.pageNums[1].load());
+
+    TEST_CHECK(isSucceeded);
+    TEST_CHECK(slotPages.isOrdered);
+
+    return true;
+}
+
+// Batches of allocations and frees per thread, compared against a free list behind a lock
+bool TestDescriptorSlotAllocatorThroughput() {
+    constexpr uint32_t ITERATION_NUM = 4000;
+    constexpr uint32_t BATCH_SIZE = 256;
+
+    struct LockedFreeList {
+        Lock lock;
+        std::vector<uint32_t> slots;
+        uint32_t capacity = 0;
+
+        uint32_t Allocate() {
+            ExclusiveScope scope(lock);
+
+            if (slots.empty()) {
+                for (uint32_t i = 0; i < SLOT_PAGE_SIZE; i++)
+                    slots.push_back(capacity + i);
+                capacity += SLOT_PAGE_SIZE;
+            }
+
+            uint32_t slot = slots.back();
+            slots.pop_back();
+
+            return slot;
+        }
+
+        void Free(uint32_t slot) {
+            ExclusiveScope scope(lock);
+            slots.push_back(slot);
+        }
+    };
+
+    auto measure = [](uint32_t threadNum, const auto& allocate, const auto& free) {
+        TestTimer timer;
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < threadNum; t++) {
+            threads.emplace_back([&] {
+                std::vector<uint32_t> slots(BATCH_SIZE);
+                for (uint32_t i = 0; i < ITERATION_NUM; i++) {
+                    for (uint32_t& slot : slots)
+                        slot = allocate();
+                    for (uint32_t slot : slots)
+                        free(slot);
+                }
+            });
+        }
+
+        for (std::thread& thread : threads)
+            thread.join();
+
+        return timer.GetNanoseconds() / (double(ITERATION_NUM) * BATCH_SIZE * threadNum);
+    };
+
+    for (uint32_t threadNum : {1u, 4u}) {
+        LockedFreeList lockedFreeList;
+        double lockedNs = measure(
+            threadNum, [&] { return lockedFreeList.Allocate(); }, [&](uint32_t slot) { lockedFreeList.Free(slot); });
+
+        SlotPages slotPages;
+        DescriptorSlotAllocator allocator(g_AllocationCallbacks, DeviceBase::GenerateId(), {AddSlotPage, &slotPages, 1, SLOT_PAGE_SIZE, 1024});
+
+        std::atomic_bool isSucceeded = true;
+        double allocatorNs = measure(
+            threadNum,
+            [&] {
+                uint32_t slot = 0;
+                if (allocator.Allocate(0, slot) != Result::SUCCESS)
+                    isSucceeded = false;
+
+                return slot;
+            },
+            [&](uint32_t slot) { allocator.Free(0, slot); });
+
+        printf("    alloc+free, %u thread(s): locked free list %.1f ns, slot allocator %.1f ns\n", threadNum, lockedNs, allocatorNs);
+
+        TEST_CHECK(isSucceeded);
+    }
+
+    return true;
+}
@@ -0,0 +1,130 @@
+// © 2021 NVIDIA Corporation
+
+#include "Tests.h"
+
+#include "SharedExternal.h"
+
+#include <atomic>
+
+using namespace nri;
+
+// More threads than cores, so waiters go through spinning and parking. A plain counter stays consistent
+bool TestLockStress() {
+    constexpr uint32_t THREAD_NUM = 16;
+    constexpr uint32_t ITERATION_NUM = 20000;
+
+    Lock lock;
+    uint64_t counter = 0;
+
+    TestTimer timer;
+    {
+        std::vector<std::thread> threads;
+        for (uint32_t i = 0; i < THREAD_NUM; i++) {
+            threads.emplace_back([&]() {
+                for (uint32_t j = 0; j < ITERATION_NUM; j++) {
+                    ExclusiveScope scope(lock);
+                    counter++;
+                }
+            });
+        }
+
+        for (std::thread& thread : threads)
+            thread.join();
+    }
+
+    printf("    %u threads x %u acquisitions: %.1f ms\n", THREAD_NUM, ITERATION_NUM, timer.GetNanoseconds() / 1000000.0);
+
+    TEST_CHECK(counter == (uint64_t)THREAD_NUM * ITERATION_NUM);
+
+#if NRI_ENABLE_LOCK_STATS
+    LockStats lockStats = lock.GetStats();
+    TEST_CHECK(lockStats.acquisitionNum == counter && lockStats.sharedAcquisitionNum == 0);
+    TEST_CHECK(lockStats.contendedAcquisitionNum <= lockStats.acquisitionNum);
+
+    printf("    contended: %llu, spins: %llu, parks: %llu\n", (unsigned long long)lockStats.contendedAcquisitionNum,
+        (unsigned long long)lockStats.spinNum, (unsigned long long)lockStats.parkNum);
+#endif
+
+    return true;
+}
+
+// Readers loop until all writers are done, so writers must not starve. Writers update two values, readers never see them differ
+bool TestRwLockStress() {
+    constexpr uint32_t READER_NUM = 12;
+    constexpr uint32_t WRITER_NUM = 4;
+    constexpr uint32_t WRITE_NUM = 2000;
+
+    RwLock lock;
+    uint64_t first = 0;
+    uint64_t second = 0;
+
+    std::atomic_uint32_t activeWriterNum = WRITER_NUM;
+    std::atomic_uint64_t readNum = 0;
+    std::atomic_uint32_t concurrentReaderNum = 0;
+    std::atomic_uint32_t concurrentReaderMaxNum = 0;
+    std::atomic_bool isSucceeded = true;
+
+    TestTimer timer;
+    {
+        std::vector<std::thread> threads;
+        for (uint32_t i = 0; i < WRITER_NUM; i++) {
+            threads.emplace_back([&]() {
+                for (uint32_t j = 0; j < WRITE_NUM; j++) {
+                    ExclusiveScope scope(lock);
+
+                    if (concurrentReaderNum.load(std::memory_order_relaxed))
+                        isSucceeded = false;
+
+                    first++;
+                    std::this_thread::yield();
+                    second++;
+                }
+
+                activeWriterNum.fetch_sub(1, std::memory_order_relaxed);
+            });
+        }
+
+        for (uint32_t i = 0; i < READER_NUM; i++) {
+            threads.emplace_back([&]() {
+                uint64_t localReadNum = 0;
+                while (activeWriterNum.load(std::memory_order_relaxed)) {
+                    SharedScope scope(lock);
+
+                    uint32_t readerNum = concurrentReaderNum.fetch_add(1, std::memory_order_relaxed) + 1;
+                    uint32_t readerMaxNum = concurrentReaderMaxNum.load(std::memory_order_relaxed);
+                    while (readerNum > readerMaxNum && !concurrentReaderMaxNum.compare_exchange_weak(readerMaxNum, readerNum, std::memory_order_relaxed))
+                        ;
+
+                    if (first != second)
+                        isSucceeded = false;
+
+                    concurrentReaderNum.fetch_sub(1, std::memory_order_relaxed);
+                    localReadNum++;
+                }
+
+                readNum.fetch_add(localReadNum, std::memory_order_relaxed);
+            });
+        }
+
+        for (std::thread& thread : threads)
+            thread.join();
+    }
+
+    printf("    %u writers x %u, %u readers x %llu (up to %u at once): %.1f ms\n", WRITER_NUM, WRITE_NUM, READER_NUM,
+        (unsigned long long)(readNum / READER_NUM), concurrentReaderMaxNum.load(), timer.GetNanoseconds() / 1000000.0);
+
+    TEST_CHECK(isSucceeded);
+    TEST_CHECK(first == (uint64_t)WRITER_NUM * WRITE_NUM && second == first);
+
+#if NRI_ENABLE_LOCK_STATS
+    LockStats lockStats = lock.GetStats();
+    TEST_CHECK(lockStats.sharedAcquisitionNum == readNum);
+    TEST_CHECK(lockStats.acquisitionNum == readNum + first);
+    TEST_CHECK(lockStats.contendedAcquisitionNum <= lockStats.acquisitionNum);
+
+    printf("    contended: %llu, spins: %llu, parks: %llu\n", (unsigned long long)lockStats.contendedAcquisitionNum,
+        (unsigned long long)lockStats.spinNum, (unsigned long long)lockStats.parkNum);
+#endif
+
+    return true;
+}
@@ -0,0 +1,248 @@
+// © 2021 NVIDIA Corporation
+
+#include "Tests.h"
+
+#include "SharedExternal.h"
+
+#include "HelperMemorySubAllocator.h"
+
+#include "Extensions/NRIResourceAllocator.h"
+
+#include <random>
+
+using namespace nri;
+
+// Random allocations and frees of mixed sizes and alignments never overlap, and freeing everything coalesces the heap back into one block
+bool TestMemoryAllocatorTLSF() {
+    TestDevice device;
+    TEST_CHECK(device.Create(false));
+
+    constexpr uint64_t HEAP_SIZE = 1 << 24;
+
+    MemoryHeapTLSF heap(((DeviceBase*)device.device)->GetStdAllocator());
+    heap.Initialize(HEAP_SIZE);
+
+    struct Allocation {
+        uint64_t offset;
+        uint64_t size;
+        uint32_t block;
+    };
+
+    std::vector<uint8_t> owners(HEAP_SIZE, 0);
+    std::vector<Allocation> allocations;
+    std::mt19937 random(1);
+
+    for (uint32_t i = 0; i < 200000; i++) {
+        if (allocations.empty() || random() % 100 < 55) {
+            uint64_t size = 1 + random() % (random() % 10 == 0 ? 200000 : 4000);
+            uint64_t alignment = 1ull << (random() % 17);
+
+            Allocation allocation = {};
+            if (!heap.Allocate(size, alignment, allocation.offset, allocation.block))
+                continue;
+
+            TEST_CHECK(allocation.offset % alignment == 0);
+            TEST_CHECK(allocation.offset + size <= HEAP_SIZE);
+
+            bool isFree = true;
+            for (uint64_t j = allocation.offset; j < allocation.offset + size; j++)
+                isFree = isFree && owners[j] == 0;
+            TEST_CHECK(isFree);
+
+            memset(&owners[allocation.offset], 1, (size_t)size);
+            allocation.size = size;
+            allocations.push_back(allocation);
+        } else {
+            size_t j = random() % allocations.size();
+            memset(&owners[allocations[j].offset], 0, (size_t)allocations[j].size);
+            heap.Free(allocations[j].block);
+
+            allocations[j] = allocations.back();
+            allocations.pop_back();
+        }
+    }
+
+    for (const Allocation& allocation : allocations)
+        heap.Free(allocation.block);
+
+    TEST_CHECK(heap.IsEmpty());
+
+    uint64_t offset = 0;
+    uint32_t block = 0;
+    TEST_CHECK(heap.Allocate(HEAP_SIZE, 1, offset, block) && offset == 0);
+    heap.Free(block);
+
+    // Timing
+    constexpr uint32_t BLOCK_NUM = 10000;
+    constexpr uint32_t ROUND_NUM = 10;
+
+    std::vector<uint32_t> blocks(BLOCK_NUM);
+
+    TestTimer timer;
+    for (uint32_t round = 0; round < ROUND_NUM; round++) {
+        for (uint32_t& b : blocks)
+            TEST_CHECK(heap.Allocate(64 + (random() & 1023), 256, offset, b));
+
+        for (uint32_t b : blocks)
+            heap.Free(b);
+    }
+
+    printf("    alloc+free: %.1f ns\n", timer.GetNanoseconds() / (BLOCK_NUM * ROUND_NUM));
+
+    return true;
+}
+
+// Buffers placed by the resource allocator of the NONE host memory mode keep their contents while neighbours come and go
+bool TestMemoryAllocatorResources() {
+    TestDevice device;
+    TEST_CHECK(device.Create(false));
+
+    ResourceAllocatorInterface resourceAllocator = {};
+    TEST_CHECK(nriGetInterface(*device.device, NRI_INTERFACE(ResourceAllocatorInterface), &resourceAllocator) == Result::SUCCESS);
+
+    struct Allocation {
+        Buffer* buffer;
+        uint64_t size;
+        uint8_t value;
+    };
+
+    std::vector<Allocation> allocations;
+    std::mt19937 random(2);
+
+    for (uint32_t i = 0; i < 20000; i++) {
+        if (allocations.empty() || random() % 2) {
+            AllocateBufferDesc allocateBufferDesc = {};
+            allocateBufferDesc.desc.size = 1 + random() % 100000;
+            allocateBufferDesc.memoryLocation = MemoryLocation::DEVICE;
+
+            Allocation allocation = {};
+            allocation.size = allocateBufferDesc.desc.size;
+            allocation.value = (uint8_t)(i * 7 + 1);
+            TEST_CHECK(resourceAllocator.AllocateBuffer(*device.device, allocateBufferDesc, allocation.buffer) == Result::SUCCESS);
+
+            uint8_t* mapped = (uint8_t*)device.core.MapBuffer(*allocation.buffer, 0, WHOLE_SIZE);
+            TEST_CHECK(mapped);
+            memset(mapped, allocation.value, (size_t)allocation.size);
+            device.core.UnmapBuffer(*allocation.buffer);
+
+            allocations.push_back(allocation);
+        } else {
+            size_t j = random() % allocations.size();
+
+            const uint8_t* mapped = (const uint8_t*)device.core.MapBuffer(*allocations[j].buffer, 0, WHOLE_SIZE);
+            bool isDataValid = mapped[0] == allocations[j].value && mapped[allocations[j].size - 1] == allocations[j].value;
+            device.core.UnmapBuffer(*allocations[j].buffer);
+            TEST_CHECK(isDataValid);
+
+            device.core.DestroyBuffer(*allocations[j].buffer);
+
+            allocations[j] = allocations.back();
+            allocations.pop_back();
+        }
+    }
+
+    // Larger than half a heap: gets a dedicated heap
+    AllocateTextureDesc allocateTextureDesc = {};
+    allocateTextureDesc.desc.type = TextureType::TEXTURE_2D;
+    allocateTextureDesc.desc.format = Format::RGBA8_UNORM;
+    allocateTextureDesc.desc.width = 8192;
+    allocateTextureDesc.desc.height = 4096;
+    allocateTextureDesc.desc.mipNum = 1;
+
+    Texture* texture = nullptr;
+    TEST_CHECK(resourceAllocator.AllocateTexture(*device.device, allocateTextureDesc, texture) == Result::SUCCESS);
+    device.core.DestroyTexture(*texture);
+
+    for (const Allocation& allocation : allocations)
+        device.core.DestroyBuffer(*allocation.buffer);
+
+    return true;
+}
+
+static void CountPackingReports(Message messageType, const char*, uint32_t, const char* message, void* userArg) {
+    if (messageType == Message::INFO && strstr(message, "Best-fit packing"))
+        (*(uint32_t*)userArg)++;
+}
+
+// A group of buffers (256 byte alignment) and textures (4 KB alignment) in 16 KB chunks. The default path packs in order and pads before
+// textures, best-fit packs textures first and fills the rest with buffers: fewer allocations and less memory. Efficiency is reported once
+bool TestMemoryAllocatorBestFit() {
+    constexpr uint32_t BUFFER_NUM = 8;
+    constexpr uint32_t TEXTURE_NUM = 6;
+
+    uint32_t reportNum = 0;
+
+    CallbackInterface callbackInterface = {};
+    callbackInterface.MessageCallback = CountPackingReports;
+    callbackInterface.userArg = &reportNum;
+
+    TestDevice device;
+    TEST_CHECK(device.Create(false, nullptr, &callbackInterface));
+
+    uint32_t allocationNums[2] = {};
+    uint64_t committedSizes[2] = {};
+
+    for (uint32_t pass = 0; pass < 2; pass++) {
+        bool enableBestFitPacking = pass == 1;
+
+        Buffer* buffers[BUFFER_NUM] = {};
+        for (Buffer*& buffer : buffers) {
+            BufferDesc bufferDesc = {};
+            bufferDesc.size = 1280;
+
+            TEST_CHECK(device.core.CreateBuffer(*device.device, bufferDesc, buffer) == Result::SUCCESS);
+        }
+
+        // 4096, 2304 and 1280 bytes
+        constexpr uint16_t textureSizes[][2] = {{32, 32}, {24, 24}, {16, 20}};
+
+        Texture* textures[TEXTURE_NUM] = {};
+        for (uint32_t i = 0; i < TEXTURE_NUM; i++) {
+            TextureDesc textureDesc = {};
+            textureDesc.type = TextureType::TEXTURE_2D;
+            textureDesc.format = Format::RGBA8_UNORM;
+            textureDesc.width = textureSizes[i % 3][0];
+            textureDesc.height = textureSizes[i % 3][1];
+            textureDesc.mipNum = 1;
+
+            TEST_CHECK(device.core.CreateTexture(*device.device, textureDesc, textures[i]) == Result::SUCCESS);
+        }
+
+        ResourceGroupDesc resourceGroupDesc = {};
+        resourceGroupDesc.memoryLocation = MemoryLocation::DEVICE;
+        resourceGroupDesc.buffers = buffers;
+        resourceGroupDesc.bufferNum = BUFFER_NUM;
+        resourceGroupDesc.textures = textures;
+        resourceGroupDesc.textureNum = TEXTURE_NUM;
+        resourceGroupDesc.preferredMemorySize = 16 * 1024;
+        resourceGroupDesc.enableBestFitPacking = enableBestFitPacking;
+
+        VideoMemoryInfo before = {};
+        TEST_CHECK(device.helper.QueryVideoMemoryInfo(*device.device, MemoryLocation::DEVICE, before) == Result::SUCCESS);
+
+        reportNum = 0;
+        allocationNums[pass] = device.helper.CalculateAllocationNumber(*device.device, resourceGroupDesc);
+
+        std::vector<Memory*> memories(allocationNums[pass], nullptr);
+        TEST_CHECK(device.helper.AllocateAndBindMemory(*device.device, resourceGroupDesc, memories.data()) == Result::SUCCESS);
+        TEST_CHECK(reportNum == (enableBestFitPacking ? 1 : 0));
+
+        VideoMemoryInfo after = {};
+        TEST_CHECK(device.helper.QueryVideoMemoryInfo(*device.device, MemoryLocation::DEVICE, after) == Result::SUCCESS);
+        committedSizes[pass] = after.usageSize - before.usageSize;
+
+        printf("    %s: %u allocations, %llu bytes\n", enableBestFitPacking ? "best-fit" : "default", allocationNums[pass], (unsigned long long)committedSizes[pass]);
+
+        for (Buffer* buffer : buffers)
+            device.core.DestroyBuffer(*buffer);
+        for (Texture* texture : textures)
+            device.core.DestroyTexture(*texture);
+        for (Memory* memory : memories)
+            device.core.FreeMemory(*memory);
+    }
+
+    TEST_CHECK(allocationNums[1] < allocationNums[0]);
+    TEST_CHECK(committedSizes[1] < committedSizes[0]);
+
+    return true;
+}
@@ -0,0 +1,126 @@
+// © 2021 NVIDIA Corporation
+
+#include "Tests.h"
+
+#include <atomic>
+
+using namespace nri;
+
+static void CountErrors(Message messageType, const char*, uint32_t, const char*, void* userArg) {
+    if (messageType == Message::ERROR)
+        ((std::atomic_uint32_t*)userArg)->fetch_add(1, std::memory_order_relaxed);
+}
+
+// Each iteration creates "bufferNum" buffers, queries memory requirements, binds them into the shared memory (or a per-thread one)
+// and destroys them in creation order
+static bool BindBuffers(TestDevice& device, Memory* sharedMemory, uint32_t bufferNum, uint32_t iterationNum) {
+    std::vector<Buffer*> buffers(bufferNum);
+
+    for (uint32_t iteration = 0; iteration < iterationNum; iteration++) {
+        Memory* ownMemory = nullptr;
+
+        for (uint32_t i = 0; i < bufferNum; i++) {
+            BufferDesc bufferDesc = {};
+            bufferDesc.size = 256;
+            bufferDesc.usage = BufferUsageBits::SHADER_RESOURCE;
+
+            if (device.core.CreateBuffer(*device.device, bufferDesc, buffers[i]) != Result::SUCCESS)
+                return false;
+
+            MemoryDesc memoryDesc = {};
+            device.core.GetBufferMemoryDesc(*buffers[i], MemoryLocation::HOST_UPLOAD, memoryDesc);
+
+            if (!sharedMemory && !ownMemory) {
+                AllocateMemoryDesc allocateMemoryDesc = {};
+                allocateMemoryDesc.size = memoryDesc.size * bufferNum;
+                allocateMemoryDesc.type = memoryDesc.type;
+
+                if (device.core.AllocateMemory(*device.device, allocateMemoryDesc, ownMemory) != Result::SUCCESS)
+                    return false;
+            }
+
+            BufferMemoryBindingDesc bufferMemoryBindingDesc = {};
+            bufferMemoryBindingDesc.memory = sharedMemory ? sharedMemory : ownMemory;
+            bufferMemoryBindingDesc.buffer = buffers[i];
+            bufferMemoryBindingDesc.offset = sharedMemory ? 0 : memoryDesc.size * i;
+
+            if (device.core.BindBufferMemory(*device.device, &bufferMemoryBindingDesc, 1) != Result::SUCCESS)
+                return false;
+        }
+
+        for (Buffer* buffer : buffers)
+            device.core.DestroyBuffer(*buffer);
+
+        if (ownMemory)
+            device.core.FreeMemory(*ownMemory);
+    }
+
+    return true;
+}
+
+// Concurrent creation, binding and destruction through validation, into per-thread memory and into one shared memory.
+// Scaling is printed for reference (it depends on the core count), no errors may be reported
+bool TestMemoryBindingsStress() {
+    constexpr uint32_t BUFFER_NUM = 512;
+    constexpr uint32_t ITERATION_NUM = 40;
+
+    std::atomic_uint32_t errorNum = 0;
+
+    CallbackInterface callbackInterface = {};
+    callbackInterface.MessageCallback = CountErrors;
+    callbackInterface.AbortExecution = [](void*) {};
+    callbackInterface.userArg = &errorNum;
+
+    TestDevice device;
+    TEST_CHECK(device.Create(true, nullptr, &callbackInterface));
+
+    Buffer* probe = nullptr;
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = 256;
+    TEST_CHECK(device.core.CreateBuffer(*device.device, bufferDesc, probe) == Result::SUCCESS);
+
+    MemoryDesc memoryDesc = {};
+    device.core.GetBufferMemoryDesc(*probe, MemoryLocation::HOST_UPLOAD, memoryDesc);
+    device.core.DestroyBuffer(*probe);
+
+    AllocateMemoryDesc allocateMemoryDesc = {};
+    allocateMemoryDesc.size = 1 << 20;
+    allocateMemoryDesc.type = memoryDesc.type;
+
+    Memory* sharedMemory = nullptr;
+    TEST_CHECK(device.core.AllocateMemory(*device.device, allocateMemoryDesc, sharedMemory) == Result::SUCCESS);
+
+    for (bool isMemoryShared : {false, true}) {
+        double baseRate = 0.0;
+
+        for (uint32_t threadNum = 1; threadNum <= 8; threadNum *= 2) {
+            std::atomic_bool isSucceeded = true;
+            std::vector<std::thread> threads;
+
+            TestTimer timer;
+            for (uint32_t t = 0; t < threadNum; t++) {
+                threads.emplace_back([&] {
+                    if (!BindBuffers(device, isMemoryShared ? sharedMemory : nullptr, BUFFER_NUM, ITERATION_NUM))
+                        isSucceeded = false;
+                });
+            }
+
+            for (std::thread& thread : threads)
+                thread.join();
+
+            double rate = threadNum * BUFFER_NUM * ITERATION_NUM / timer.GetNanoseconds() * 1000.0;
+            if (threadNum == 1)
+                baseRate = rate;
+
+            printf("    %s memory, %u thread(s): %.2f M buffers/s (%.2fx)\n", isMemoryShared ? "shared" : "per-thread", threadNum, rate, rate / baseRate);
+
+            TEST_CHECK(isSucceeded);
+            TEST_CHECK(errorNum == 0);
+        }
+    }
+
+    device.core.FreeMemory(*sharedMemory);
+    TEST_CHECK(errorNum == 0);
+
+    return true;
+}
@@ -0,0 +1,205 @@
+// © 2021 NVIDIA Corporation
+
+#include "Tests.h"
+
+#include <algorithm>
+
+using namespace nri;
+
+constexpr uint64_t BUDGET_BLOCK_SIZE = 1 << 20;
+
+struct EvictionLog {
+    TestDevice* device;
+    MemoryBudget* memoryBudget;
+    std::vector<Memory*> evicted;
+};
+
+// Resources are "destroyed" right away, memory is freed from the callback
+static bool EvictAndFree(Memory* memory, void* userArg) {
+    EvictionLog& evictionLog = *(EvictionLog*)userArg;
+    evictionLog.evicted.push_back(memory);
+    evictionLog.device->helper.FreeBudgetedMemory(*evictionLog.memoryBudget, *memory);
+
+    return true;
+}
+
+// A simulated local budget of 10 blocks: eviction takes the lowest priority first, then the least recently used, skips memory used in
+// the current frame and memory of higher priority than the request. Requests which still don't fit are rejected
+bool TestMemoryBudgetEviction() {
+    for (bool enableValidation : {false, true}) {
+        TestDevice device;
+        TEST_CHECK(device.Create(enableValidation));
+
+        Buffer* probe = nullptr;
+        BufferDesc bufferDesc = {};
+        bufferDesc.size = 256;
+        TEST_CHECK(device.core.CreateBuffer(*device.device, bufferDesc, probe) == Result::SUCCESS);
+
+        MemoryDesc memoryDesc = {};
+        device.core.GetBufferMemoryDesc(*probe, MemoryLocation::DEVICE, memoryDesc);
+        device.core.DestroyBuffer(*probe);
+
+        EvictionLog evictionLog = {&device, nullptr, {}};
+
+        MemoryBudgetDesc memoryBudgetDesc = {};
+        memoryBudgetDesc.EvictMemory = EvictAndFree;
+        memoryBudgetDesc.userArg = &evictionLog;
+        memoryBudgetDesc.localBudgetSize = 10 * BUDGET_BLOCK_SIZE;
+
+        MemoryBudget* memoryBudget = nullptr;
+        TEST_CHECK(device.helper.CreateMemoryBudget(*device.device, memoryBudgetDesc, memoryBudget) == Result::SUCCESS);
+        evictionLog.memoryBudget = memoryBudget;
+
+        auto Allocate = [&](uint64_t blockNum, float priority, Memory*& memory) {
+            AllocateMemoryDesc allocateMemoryDesc = {};
+            allocateMemoryDesc.size = blockNum * BUDGET_BLOCK_SIZE;
+            allocateMemoryDesc.type = memoryDesc.type;
+            allocateMemoryDesc.priority = priority;
+
+            return device.helper.AllocateBudgetedMemory(*memoryBudget, allocateMemoryDesc, MemoryLocation::DEVICE, memory);
+        };
+
+        auto GetStats = [&]() {
+            MemoryBudgetStats memoryBudgetStats = {};
+            device.helper.GetMemoryBudgetStats(*memoryBudget, MemoryLocation::DEVICE, memoryBudgetStats);
+
+            return memoryBudgetStats;
+        };
+
+        // Fill the budget in frame 0, "memories[7]" and "memories[8]" have low priority
+        Memory* memories[10] = {};
+        for (uint32_t i = 0; i < 10; i++)
+            TEST_CHECK(Allocate(1, (i == 7 || i == 8) ? 0.1f : 0.5f, memories[i]) == Result::SUCCESS);
+
+        MemoryBudgetStats memoryBudgetStats = GetStats();
+        TEST_CHECK(memoryBudgetStats.budgetSize == 10 * BUDGET_BLOCK_SIZE && memoryBudgetStats.committedSize == 10 * BUDGET_BLOCK_SIZE);
+        TEST_CHECK(memoryBudgetStats.headroomSize == 0 && memoryBudgetStats.evictedSize == 0 && memoryBudgetStats.rejectedNum == 0);
+
+        // Last used: "memories[1]" in frame 0, "memories[0]" in frame 1, "memories[5]" and "memories[8]" in frame 2, the rest in frame 3
+        Memory* const frame1[] = {memories[0], memories[5], memories[8]};
+        Memory* const frame2[] = {memories[5], memories[8]};
+        Memory* const frame3[] = {memories[2], memories[3], memories[4], memories[6], memories[7], memories[9]};
+
+        device.helper.UpdateMemoryBudget(*memoryBudget);
+        device.helper.TouchBudgetedMemory(*memoryBudget, frame1, 3);
+        device.helper.UpdateMemoryBudget(*memoryBudget);
+        device.helper.TouchBudgetedMemory(*memoryBudget, frame2, 2);
+        device.helper.UpdateMemoryBudget(*memoryBudget);
+        device.helper.TouchBudgetedMemory(*memoryBudget, frame3, 6);
+
+        // 2 blocks: the low priority one not used in this frame, then the least recently used
+        Memory* memory = nullptr;
+        TEST_CHECK(Allocate(2, 0.5f, memory) == Result::SUCCESS);
+        TEST_CHECK((evictionLog.evicted == std::vector<Memory*>{memories[8], memories[1]}));
+
+        memoryBudgetStats = GetStats();
+        TEST_CHECK(memoryBudgetStats.committedSize == 10 * BUDGET_BLOCK_SIZE && memoryBudgetStats.usageSize == 10 * BUDGET_BLOCK_SIZE);
+        TEST_CHECK(memoryBudgetStats.evictedSize == 2 * BUDGET_BLOCK_SIZE && memoryBudgetStats.rejectedNum == 0);
+
+        // Higher priority memory is not evicted for a lower priority request
+        evictionLog.evicted.clear();
+        Memory* rejected = nullptr;
+        TEST_CHECK(Allocate(1, 0.2f, rejected) == Result::OUT_OF_MEMORY && !rejected);
+        TEST_CHECK(evictionLog.evicted.empty());
+
+        // 3 blocks: only 2 blocks are not used in this frame, they get evicted, but the request is still rejected
+        TEST_CHECK(Allocate(3, 0.5f, rejected) == Result::OUT_OF_MEMORY && !rejected);
+        TEST_CHECK((evictionLog.evicted == std::vector<Memory*>{memories[0], memories[5]}));
+
+        memoryBudgetStats = GetStats();
+        TEST_CHECK(memoryBudgetStats.committedSize == 8 * BUDGET_BLOCK_SIZE && memoryBudgetStats.usageSize == 8 * BUDGET_BLOCK_SIZE);
+        TEST_CHECK(memoryBudgetStats.headroomSize == 2 * BUDGET_BLOCK_SIZE);
+        TEST_CHECK(memoryBudgetStats.evictedSize == 4 * BUDGET_BLOCK_SIZE && memoryBudgetStats.rejectedNum == 2);
+
+        // Next frame: "memories[7]" is not used anymore and goes first
+        device.helper.UpdateMemoryBudget(*memoryBudget);
+
+        evictionLog.evicted.clear();
+        TEST_CHECK(Allocate(3, 0.5f, memory) == Result::SUCCESS);
+        TEST_CHECK(evictionLog.evicted.size() == 1 && evictionLog.evicted[0] == memories[7]);
+
+        memoryBudgetStats = GetStats();
+        TEST_CHECK(memoryBudgetStats.committedSize == 10 * BUDGET_BLOCK_SIZE && memoryBudgetStats.headroomSize == 0);
+        TEST_CHECK(memoryBudgetStats.evictedSize == 5 * BUDGET_BLOCK_SIZE && memoryBudgetStats.rejectedNum == 2);
+
+        // Other locations are not affected
+        device.helper.GetMemoryBudgetStats(*memoryBudget, MemoryLocation::HOST_UPLOAD, memoryBudgetStats);
+        TEST_CHECK(memoryBudgetStats.committedSize == 0 && memoryBudgetStats.evictedSize == 0 && memoryBudgetStats.rejectedNum == 0);
+
+        device.helper.DestroyMemoryBudget(*memoryBudget);
+    }
+
+    return true;
+}
+
+// "false" from "EvictMemory" (memory still in use by the GPU) keeps the memory, accepted but not yet freed memory stays committed
+bool TestMemoryBudgetDeferredEviction() {
+    TestDevice device;
+    TEST_CHECK(device.Create(false));
+
+    Buffer* probe = nullptr;
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = 256;
+    TEST_CHECK(device.core.CreateBuffer(*device.device, bufferDesc, probe) == Result::SUCCESS);
+
+    MemoryDesc memoryDesc = {};
+    device.core.GetBufferMemoryDesc(*probe, MemoryLocation::DEVICE, memoryDesc);
+    device.core.DestroyBuffer(*probe);
+
+    struct DeferredEvictions {
+        std::vector<Memory*> accepted;
+        bool isAccepted;
+    } deferredEvictions = {{}, false};
+
+    MemoryBudgetDesc memoryBudgetDesc = {};
+    memoryBudgetDesc.EvictMemory = [](Memory* memory, void* userArg) {
+        DeferredEvictions& evictions = *(DeferredEvictions*)userArg;
+        if (evictions.isAccepted)
+            evictions.accepted.push_back(memory);
+
+        return evictions.isAccepted;
+    };
+    memoryBudgetDesc.userArg = &deferredEvictions;
+    memoryBudgetDesc.localBudgetSize = 4 * BUDGET_BLOCK_SIZE;
+
+    MemoryBudget* memoryBudget = nullptr;
+    TEST_CHECK(device.helper.CreateMemoryBudget(*device.device, memoryBudgetDesc, memoryBudget) == Result::SUCCESS);
+
+    AllocateMemoryDesc allocateMemoryDesc = {};
+    allocateMemoryDesc.size = BUDGET_BLOCK_SIZE;
+    allocateMemoryDesc.type = memoryDesc.type;
+    allocateMemoryDesc.priority = 0.5f;
+
+    Memory* memories[4] = {};
+    for (Memory*& memory : memories)
+        TEST_CHECK(device.helper.AllocateBudgetedMemory(*memoryBudget, allocateMemoryDesc, MemoryLocation::DEVICE, memory) == Result::SUCCESS);
+
+    device.helper.UpdateMemoryBudget(*memoryBudget);
+
+    // Refused
+    Memory* memory = nullptr;
+    TEST_CHECK(device.helper.AllocateBudgetedMemory(*memoryBudget, allocateMemoryDesc, MemoryLocation::DEVICE, memory) == Result::OUT_OF_MEMORY);
+
+    MemoryBudgetStats memoryBudgetStats = {};
+    device.helper.GetMemoryBudgetStats(*memoryBudget, MemoryLocation::DEVICE, memoryBudgetStats);
+    TEST_CHECK(memoryBudgetStats.evictedSize == 0 && memoryBudgetStats.rejectedNum == 1);
+
+    // Accepted: one block is enough, it stays committed (and is not offered again) until freed
+    deferredEvictions.isAccepted = true;
+    TEST_CHECK(device.helper.AllocateBudgetedMemory(*memoryBudget, allocateMemoryDesc, MemoryLocation::DEVICE, memory) == Result::OUT_OF_MEMORY);
+    TEST_CHECK(deferredEvictions.accepted.size() == 1);
+
+    device.helper.GetMemoryBudgetStats(*memoryBudget, MemoryLocation::DEVICE, memoryBudgetStats);
+    TEST_CHECK(memoryBudgetStats.committedSize == 4 * BUDGET_BLOCK_SIZE && memoryBudgetStats.evictedSize == BUDGET_BLOCK_SIZE && memoryBudgetStats.rejectedNum == 2);
+
+    device.helper.FreeBudgetedMemory(*memoryBudget, *deferredEvictions.accepted[0]);
+    TEST_CHECK(device.helper.AllocateBudgetedMemory(*memoryBudget, allocateMemoryDesc, MemoryLocation::DEVICE, memory) == Result::SUCCESS);
+    TEST_CHECK(deferredEvictions.accepted.size() == 1);
+
+    device.helper.GetMemoryBudgetStats(*memoryBudget, MemoryLocation::DEVICE, memoryBudgetStats);
+    TEST_CHECK(memoryBudgetStats.committedSize == 4 * BUDGET_BLOCK_SIZE && memoryBudgetStats.headroomSize == 0);
+
+    device.helper.DestroyMemoryBudget(*memoryBudget);
+
+    return true;
+}
@@ -0,0 +1,276 @@
+// © 2021 NVIDIA Corporation
+
+#include "Tests.h"
+
+#include "SharedExternal.h"
+
+#include <algorithm>
+#include <atomic>
+
+using namespace nri;
+
+struct AllocationCounters {
+    std::atomic_uint64_t allocationNum = 0;
+    std::atomic_uint64_t freeNum = 0;
+};
+
+static void* CountedAllocate(void* userArg, size_t size, size_t alignment) {
+    ((AllocationCounters*)userArg)->allocationNum.fetch_add(1, std::memory_order_relaxed);
+
+    return AlignedMalloc(userArg, size, alignment);
+}
+
+static void* CountedReallocate(void* userArg, void* memory, size_t size, size_t alignment) {
+    if (!memory)
+        ((AllocationCounters*)userArg)->allocationNum.fetch_add(1, std::memory_order_relaxed);
+
+    return AlignedRealloc(userArg, memory, size, alignment);
+}
+
+static void CountedFree(void* userArg, void* memory) {
+    if (memory)
+        ((AllocationCounters*)userArg)->freeNum.fetch_add(1, std::memory_order_relaxed);
+
+    AlignedFree(userArg, memory);
+}
+
+static AllocationCallbacks GetCountedAllocationCallbacks(AllocationCounters& allocationCounters) {
+    AllocationCallbacks allocationCallbacks = {};
+    allocationCallbacks.Allocate = CountedAllocate;
+    allocationCallbacks.Reallocate = CountedReallocate;
+    allocationCallbacks.Free = CountedFree;
+    allocationCallbacks.userArg = &allocationCounters;
+
+    return allocationCallbacks;
+}
+
+// Live blocks of all size classes are distinct and cache line aligned. Blocks allocated on one thread and freed on another
+// are reused, and everything goes back to the allocator with the pool
+bool TestObjectPoolBlocks() {
+    constexpr uint32_t BLOCK_NUM = 4096;
+    constexpr uint32_t ROUND_NUM = 64;
+
+    AllocationCounters allocationCounters;
+    AllocationCallbacks allocationCallbacks = GetCountedAllocationCallbacks(allocationCounters);
+
+    {
+        ObjectPool objectPool(allocationCallbacks, DeviceBase::GenerateId());
+
+        // Every size class
+        std::vector<std::pair<uint8_t*, size_t>> blocks;
+        for (uint32_t i = 0; i < BLOCK_NUM; i++) {
+            size_t size = 1 + (i * 37) % (OBJECT_POOL_GRANULARITY * OBJECT_POOL_SIZE_CLASS_NUM);
+            TEST_CHECK(ObjectPool::IsPooled(size, alignof(std::max_align_t)));
+
+            uint8_t* block = (uint8_t*)objectPool.Allocate(size);
+            TEST_CHECK(block);
+            TEST_CHECK((uintptr_t)block % OBJECT_POOL_GRANULARITY == 0);
+
+            memset(block, (int)i, size);
+            blocks.push_back({block, size});
+        }
+
+        std::sort(blocks.begin(), blocks.end());
+        for (size_t i = 1; i < blocks.size(); i++)
+            TEST_CHECK(blocks[i - 1].first + blocks[i - 1].second <= blocks[i].first);
+
+        for (const auto& block : blocks)
+            objectPool.Free(block.first);
+
+        // Producer and consumer threads: frees land in the cache of another thread and flow back through the pool
+        uint64_t allocationNumBefore = allocationCounters.allocationNum;
+
+        for (uint32_t round = 0; round < ROUND_NUM; round++) {
+            std::vector<void*> produced(BLOCK_NUM);
+
+            std::thread producer([&] {
+                for (void*& block : produced)
+                    block = objectPool.Allocate(128);
+            });
+            producer.join();
+
+            TEST_CHECK(std::find(produced.begin(), produced.end(), nullptr) == produced.end());
+
+            std::thread consumer([&] {
+                for (void* block : produced)
+                    objectPool.Free(block);
+            });
+            consumer.join();
+        }
+
+        // Threads are new every round, but blocks and caches of finished threads are reused
+        uint64_t roundAllocationNum = allocationCounters.allocationNum - allocationNumBefore;
+        printf("    %u rounds of %u cross-thread blocks: %llu allocator calls\n", ROUND_NUM, BLOCK_NUM, (unsigned long long)roundAllocationNum);
+        TEST_CHECK(roundAllocationNum < ROUND_NUM);
+    }
+
+    TEST_CHECK(allocationCounters.allocationNum == allocationCounters.freeNum);
+
+    return true;
+}
+
+struct PooledBase {
+    virtual ~PooledBase() {
+    }
+
+    uint32_t value = 0;
+};
+
+template <size_t N>
+struct PooledDerived : PooledBase {
+    PooledDerived(std::atomic_uint32_t& destructorNum)
+        : destructorNum(destructorNum) {
+    }
+
+    ~PooledDerived() override {
+        destructorNum++;
+    }
+
+    std::atomic_uint32_t& destructorNum;
+    std::array<uint8_t, N> payload = {};
+};
+
+// Objects destroyed via a base type go back where they were allocated: to the pool if small, to the allocator if big
+bool TestObjectPoolDestroyViaBase() {
+    constexpr uint32_t OBJECT_NUM = 1000;
+
+    AllocationCounters allocationCounters;
+    AllocationCallbacks allocationCallbacks = GetCountedAllocationCallbacks(allocationCounters);
+
+    std::atomic_uint32_t destructorNum = 0;
+    {
+        ObjectPool objectPool(allocationCallbacks, DeviceBase::GenerateId());
+
+        static_assert(ObjectPool::IsPooled(sizeof(PooledBase), alignof(PooledBase)), "the base must be pooled");
+        static_assert(!ObjectPool::IsPooled(sizeof(PooledDerived<4096>), alignof(PooledDerived<4096>)), "the big object must not be pooled");
+
+        std::vector<PooledBase*> objects;
+        for (uint32_t i = 0; i < OBJECT_NUM; i++) {
+            PooledBase* object = (i & 1) ? (PooledBase*)Allocate<PooledDerived<4096>>(objectPool, destructorNum) : (PooledBase*)Allocate<PooledDerived<16>>(objectPool, destructorNum);
+            TEST_CHECK(object);
+
+            object->value = i;
+            objects.push_back(object);
+        }
+
+        TEST_CHECK(!objectPool.Owns(objects[1]) && objectPool.Owns(objects[0]));
+
+        uint64_t bigObjectNum = OBJECT_NUM / 2;
+        uint64_t freeNumBefore = allocationCounters.freeNum;
+
+        for (PooledBase* object : objects)
+            Destroy(objectPool, object);
+
+        // Only big objects reach the allocator
+        TEST_CHECK(destructorNum == OBJECT_NUM);
+        TEST_CHECK(allocationCounters.freeNum - freeNumBefore == bigObjectNum);
+    }
+
+    TEST_CHECK(allocationCounters.allocationNum == allocationCounters.freeNum);
+
+    return true;
+}
+
+// Create and destroy buffers, textures and fences in batches from 1 and 4 threads: after warm-up, pooled objects don't
+// reach the allocator. Alternating between two devices on one thread stays on the per-thread cache fast path
+bool TestObjectPoolChurn() {
+    constexpr uint32_t OBJECT_NUM = 200000;
+    constexpr uint32_t BATCH_SIZE = 256;
+
+    for (bool enableValidation : {false, true}) {
+        for (uint32_t threadNum : {1u, 4u}) {
+            AllocationCounters allocationCounters;
+            AllocationCallbacks allocationCallbacks = GetCountedAllocationCallbacks(allocationCounters);
+
+            TestDevice device;
+            TEST_CHECK(device.Create(enableValidation, nullptr, nullptr, &allocationCallbacks));
+
+            uint32_t objectNumPerThread = OBJECT_NUM / threadNum;
+            uint64_t allocationNumBefore = allocationCounters.allocationNum;
+
+            std::atomic_bool isSucceeded = true;
+            std::vector<std::thread> threads;
+
+            TestTimer timer;
+            for (uint32_t t = 0; t < threadNum; t++) {
+                threads.emplace_back([&] {
+                    std::vector<Buffer*> buffers(BATCH_SIZE);
+                    std::vector<Texture*> textures(BATCH_SIZE);
+                    std::vector<Fence*> fences(BATCH_SIZE);
+
+                    BufferDesc bufferDesc = {};
+                    bufferDesc.size = 256;
+                    bufferDesc.usage = BufferUsageBits::SHADER_RESOURCE;
+
+                    TextureDesc textureDesc = {};
+                    textureDesc.type = TextureType::TEXTURE_2D;
+                    textureDesc.format = Format::RGBA8_UNORM;
+                    textureDesc.width = 16;
+                    textureDesc.height = 16;
+                    textureDesc.mipNum = 1;
+                    textureDesc.layerNum = 1;
+                    textureDesc.usage = TextureUsageBits::SHADER_RESOURCE;
+
+                    for (uint32_t i = 0; i < objectNumPerThread && isSucceeded; i += BATCH_SIZE) {
+                        for (uint32_t j = 0; j < BATCH_SIZE; j++) {
+                            bool isCreated = device.core.CreateBuffer(*device.device, bufferDesc, buffers[j]) == Result::SUCCESS
+                                && device.core.CreateTexture(*device.device, textureDesc, textures[j]) == Result::SUCCESS
+                                && device.core.CreateFence(*device.device, 0, fences[j]) == Result::SUCCESS;
+
+                            if (!isCreated) {
+                                isSucceeded = false;
+                                return;
+                            }
+                        }
+
+                        for (uint32_t j = 0; j < BATCH_SIZE; j++) {
+                            device.core.DestroyBuffer(*buffers[j]);
+                            device.core.DestroyTexture(*textures[j]);
+                            device.core.DestroyFence(*fences[j]);
+                        }
+                    }
+                });
+            }
+
+            for (std::thread& thread : threads)
+                thread.join();
+
+            double ns = timer.GetNanoseconds();
+            uint64_t objectNum = (uint64_t)objectNumPerThread * threadNum * 3;
+            uint64_t allocationNum = allocationCounters.allocationNum - allocationNumBefore;
+
+            printf("    validation %s, %u thread(s): %.2f M create+destroy/s, %llu allocator calls for %llu objects\n", enableValidation ? "on" : "off",
+                threadNum, objectNum / ns * 1000.0, (unsigned long long)allocationNum, (unsigned long long)objectNum);
+
+            TEST_CHECK(isSucceeded);
+            TEST_CHECK(allocationNum < 64);
+        }
+    }
+
+    // Two devices used alternately
+    {
+        constexpr uint32_t ITERATION_NUM = 1000000;
+
+        TestDevice devices[2];
+        for (TestDevice& device : devices)
+            TEST_CHECK(device.Create(true));
+
+        BufferDesc bufferDesc = {};
+        bufferDesc.size = 256;
+
+        for (uint32_t deviceNum = 1; deviceNum <= 2; deviceNum++) {
+            TestTimer timer;
+            for (uint32_t i = 0; i < ITERATION_NUM; i++) {
+                TestDevice& device = devices[i % deviceNum];
+
+                Buffer* buffer = nullptr;
+                TEST_CHECK(device.core.CreateBuffer(*device.device, bufferDesc, buffer) == Result::SUCCESS);
+                device.core.DestroyBuffer(*buffer);
+            }
+
+            printf("    %u device(s) alternating, validation on: %.1f ns per create+destroy\n", deviceNum, timer.GetNanoseconds() / ITERATION_NUM);
+        }
+    }
+
+    return true;
+}
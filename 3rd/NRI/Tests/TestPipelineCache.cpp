@@ -0,0 +1,314 @@
+// © 2021 NVIDIA Corporation
+
+#include "Tests.h"
+
+#include "SharedExternal.h"
+
+#include <atomic>
+
+using namespace nri;
+
+// Bytecode is not compiled on NONE, the cache only hashes it
+struct TestShader {
+    uint32_t words[16];
+
+    inline TestShader(uint32_t seed) {
+        for (uint32_t i = 0; i < 16; i++)
+            words[i] = seed * 16 + i;
+    }
+};
+
+static ComputePipelineDesc GetComputePipelineDesc(const PipelineLayout* pipelineLayout, const TestShader& shader, StageBits stage = StageBits::COMPUTE_SHADER) {
+    ComputePipelineDesc computePipelineDesc = {};
+    computePipelineDesc.pipelineLayout = pipelineLayout;
+    computePipelineDesc.shader.stage = stage;
+    computePipelineDesc.shader.bytecode = shader.words;
+    computePipelineDesc.shader.size = sizeof(shader.words);
+
+    return computePipelineDesc;
+}
+
+static PipelineLayout* CreatePipelineLayout(TestDevice& device) {
+    PipelineLayoutDesc pipelineLayoutDesc = {};
+    pipelineLayoutDesc.shaderStages = StageBits::COMPUTE_SHADER;
+
+    PipelineLayout* pipelineLayout = nullptr;
+    device.core.CreatePipelineLayout(*device.device, pipelineLayoutDesc, pipelineLayout);
+
+    return pipelineLayout;
+}
+
+static PipelineCacheStats GetStats(TestDevice& device, PipelineCache& pipelineCache) {
+    PipelineCacheStats pipelineCacheStats = {};
+    device.helper.GetPipelineCacheStats(pipelineCache, pipelineCacheStats);
+
+    return pipelineCacheStats;
+}
+
+// Every round, threads start together and request 2 new pipelines: one thread creates each of them outside of the lock, the others hit it
+// while it's in flight or already created. All get the same pipeline, each pipeline is created once
+bool TestPipelineCacheConcurrency() {
+    constexpr uint32_t THREAD_NUM = 8;
+    constexpr uint32_t ROUND_NUM = 500;
+
+    for (bool enableValidation : {false, true}) {
+        TestDevice device;
+        TEST_CHECK(device.Create(enableValidation));
+
+        PipelineLayout* pipelineLayout = CreatePipelineLayout(device);
+        TEST_CHECK(pipelineLayout);
+
+        PipelineCache* pipelineCache = nullptr;
+        TEST_CHECK(device.helper.CreatePipelineCache(*device.device, {}, pipelineCache) == Result::SUCCESS);
+
+        std::atomic_bool isSucceeded = true;
+
+        TestTimer timer;
+        for (uint32_t round = 0; round < ROUND_NUM; round++) {
+            std::array<Pipeline*, THREAD_NUM> pipelines = {};
+            std::atomic_uint32_t readyNum = 0;
+            std::vector<std::thread> threads;
+
+            for (uint32_t t = 0; t < THREAD_NUM; t++) {
+                threads.emplace_back([&, t] {
+                    TestShader shader(round * 2 + (t & 1));
+                    ComputePipelineDesc computePipelineDesc = GetComputePipelineDesc(pipelineLayout, shader);
+
+                    readyNum++;
+                    while (readyNum.load() != THREAD_NUM)
+                        std::this_thread::yield();
+
+                    if (device.helper.GetCachedComputePipeline(*pipelineCache, computePipelineDesc, pipelines[t]) != Result::SUCCESS || !pipelines[t])
+                        isSucceeded = false;
+                });
+            }
+
+            for (std::thread& thread : threads)
+                thread.join();
+
+            TEST_CHECK(isSucceeded);
+
+            // NONE returns the same dummy object for all pipelines, validation wraps it into a new one
+            if (enableValidation) {
+                TEST_CHECK(pipelines[0] != pipelines[1]);
+
+                for (uint32_t t = 2; t < THREAD_NUM; t++)
+                    TEST_CHECK(pipelines[t] == pipelines[t & 1]);
+            }
+        }
+
+        PipelineCacheStats pipelineCacheStats = GetStats(device, *pipelineCache);
+        printf("    validation %s, %u threads: %u rounds in %.1f ms, %llu misses, %llu hits\n", enableValidation ? "on" : "off", THREAD_NUM, ROUND_NUM,
+            timer.GetNanoseconds() / 1000000.0, (unsigned long long)pipelineCacheStats.missNum, (unsigned long long)pipelineCacheStats.hitNum);
+
+        TEST_CHECK(pipelineCacheStats.missNum == ROUND_NUM * 2);
+        TEST_CHECK(pipelineCacheStats.hitNum == ROUND_NUM * (THREAD_NUM - 2));
+        TEST_CHECK(pipelineCacheStats.pipelineNum == ROUND_NUM * 2);
+
+        device.helper.DestroyPipelineCache(*pipelineCache);
+        device.core.DestroyPipelineLayout(*pipelineLayout);
+    }
+
+    return true;
+}
+
+struct FailedCreation {
+    TestDevice* device;
+    PipelineCache* pipelineCache;
+    std::atomic_uint32_t errorNum;
+    uint64_t hitNumToWait; // the failing creation waits for the other threads to park on it
+};
+
+static void HoldFailedCreation(Message messageType, const char*, uint32_t, const char*, void* userArg) {
+    if (messageType != Message::ERROR)
+        return;
+
+    FailedCreation& failedCreation = *(FailedCreation*)userArg;
+    failedCreation.errorNum++;
+
+    while (GetStats(*failedCreation.device, *failedCreation.pipelineCache).hitNum < failedCreation.hitNumToWait)
+        std::this_thread::yield();
+}
+
+struct LiveAllocations {
+    std::atomic_int64_t num = 0;
+};
+
+static void* CountedAllocate(void* userArg, size_t size, size_t alignment) {
+    ((LiveAllocations*)userArg)->num++;
+
+    return AlignedMalloc(userArg, size, alignment);
+}
+
+static void* CountedReallocate(void* userArg, void* memory, size_t size, size_t alignment) {
+    if (!memory)
+        ((LiveAllocations*)userArg)->num++;
+
+    return AlignedRealloc(userArg, memory, size, alignment);
+}
+
+static void CountedFree(void* userArg, void* memory) {
+    if (memory)
+        ((LiveAllocations*)userArg)->num--;
+
+    AlignedFree(userArg, memory);
+}
+
+// Validation fails creations with a wrong shader stage. Threads waiting for a failing creation get the error, the failed entry is not cached
+// (the next request retries) and doesn't stay in the cache
+bool TestPipelineCacheFailures() {
+    constexpr uint32_t THREAD_NUM = 8;
+
+    FailedCreation failedCreation = {};
+
+    CallbackInterface callbackInterface = {};
+    callbackInterface.MessageCallback = HoldFailedCreation;
+    callbackInterface.AbortExecution = [](void*) {};
+    callbackInterface.userArg = &failedCreation;
+
+    LiveAllocations liveAllocations;
+
+    AllocationCallbacks allocationCallbacks = {};
+    allocationCallbacks.Allocate = CountedAllocate;
+    allocationCallbacks.Reallocate = CountedReallocate;
+    allocationCallbacks.Free = CountedFree;
+    allocationCallbacks.userArg = &liveAllocations;
+
+    TestDevice device;
+    TEST_CHECK(device.Create(true, nullptr, &callbackInterface, &allocationCallbacks));
+
+    PipelineLayout* pipelineLayout = CreatePipelineLayout(device);
+    TEST_CHECK(pipelineLayout);
+
+    PipelineCache* pipelineCache = nullptr;
+    TEST_CHECK(device.helper.CreatePipelineCache(*device.device, {}, pipelineCache) == Result::SUCCESS);
+
+    failedCreation.device = &device;
+    failedCreation.pipelineCache = pipelineCache;
+
+    TestShader shader(0);
+    ComputePipelineDesc failingDesc = GetComputePipelineDesc(pipelineLayout, shader, StageBits::VERTEX_SHADER);
+
+    // All threads request the failing pipeline, the creator holds the creation until the others wait for it
+    {
+        std::array<Pipeline*, THREAD_NUM> pipelines = {};
+        std::array<Result, THREAD_NUM> results = {};
+        std::atomic_uint32_t readyNum = 0;
+        failedCreation.hitNumToWait = THREAD_NUM - 1;
+
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < THREAD_NUM; t++) {
+            threads.emplace_back([&, t] {
+                readyNum++;
+                while (readyNum.load() != THREAD_NUM)
+                    std::this_thread::yield();
+
+                pipelines[t] = (Pipeline*)&pipelines;
+                results[t] = device.helper.GetCachedComputePipeline(*pipelineCache, failingDesc, pipelines[t]);
+            });
+        }
+
+        for (std::thread& thread : threads)
+            thread.join();
+
+        for (uint32_t t = 0; t < THREAD_NUM; t++)
+            TEST_CHECK(results[t] == Result::INVALID_ARGUMENT && !pipelines[t]);
+
+        PipelineCacheStats pipelineCacheStats = GetStats(device, *pipelineCache);
+        TEST_CHECK(failedCreation.errorNum == 1);
+        TEST_CHECK(pipelineCacheStats.missNum == 1 && pipelineCacheStats.hitNum == THREAD_NUM - 1 && pipelineCacheStats.pipelineNum == 0);
+    }
+
+    // Not cached: retried
+    Pipeline* pipeline = nullptr;
+    failedCreation.hitNumToWait = 0;
+    TEST_CHECK(device.helper.GetCachedComputePipeline(*pipelineCache, failingDesc, pipeline) == Result::INVALID_ARGUMENT && !pipeline);
+    TEST_CHECK(failedCreation.errorNum == 2 && GetStats(device, *pipelineCache).missNum == 2);
+
+    // The same pipeline with the right stage is created
+    ComputePipelineDesc computePipelineDesc = GetComputePipelineDesc(pipelineLayout, shader);
+    TEST_CHECK(device.helper.GetCachedComputePipeline(*pipelineCache, computePipelineDesc, pipeline) == Result::SUCCESS && pipeline);
+    TEST_CHECK(GetStats(device, *pipelineCache).pipelineNum == 1);
+
+    // Failed entries don't accumulate
+    int64_t liveAllocationNum = 0;
+    for (uint32_t i = 1; i <= 2000; i++) {
+        if (i == 100)
+            liveAllocationNum = liveAllocations.num;
+
+        TestShader failingShader(i);
+        failingDesc = GetComputePipelineDesc(pipelineLayout, failingShader, StageBits::VERTEX_SHADER);
+        TEST_CHECK(device.helper.GetCachedComputePipeline(*pipelineCache, failingDesc, pipeline) == Result::INVALID_ARGUMENT);
+    }
+
+    printf("    live allocations after 100 and 2000 failed creations: %lld and %lld\n", (long long)liveAllocationNum, (long long)liveAllocations.num.load());
+    TEST_CHECK(liveAllocations.num == liveAllocationNum);
+
+    device.helper.DestroyPipelineCache(*pipelineCache);
+    device.core.DestroyPipelineLayout(*pipelineLayout);
+
+    return true;
+}
+
+// Pipelines are keyed by the layout pointer: purging the layout destroys its pipelines, so a new layout (possibly at the same address) doesn't hit them.
+// Validation is needed for distinct layouts, NONE returns the same dummy object for all
+bool TestPipelineCachePurge() {
+    constexpr uint32_t PIPELINE_NUM = 4;
+
+    {
+        TestDevice device;
+        TEST_CHECK(device.Create(true));
+
+        PipelineLayout* pipelineLayouts[2] = {CreatePipelineLayout(device), CreatePipelineLayout(device)};
+        TEST_CHECK(pipelineLayouts[0] && pipelineLayouts[1]);
+
+        PipelineCache* pipelineCache = nullptr;
+        TEST_CHECK(device.helper.CreatePipelineCache(*device.device, {}, pipelineCache) == Result::SUCCESS);
+
+        Pipeline* pipelines[2][PIPELINE_NUM] = {};
+        for (uint32_t i = 0; i < 2; i++) {
+            for (uint32_t j = 0; j < PIPELINE_NUM; j++) {
+                TestShader shader(j);
+                TEST_CHECK(device.helper.GetCachedComputePipeline(*pipelineCache, GetComputePipelineDesc(pipelineLayouts[i], shader), pipelines[i][j]) == Result::SUCCESS);
+            }
+        }
+
+        TEST_CHECK(GetStats(device, *pipelineCache).pipelineNum == 2 * PIPELINE_NUM);
+
+        // Purge, destroy and create a layout
+        device.helper.PurgeCachedPipelines(*pipelineCache, *pipelineLayouts[0]);
+        TEST_CHECK(GetStats(device, *pipelineCache).pipelineNum == PIPELINE_NUM);
+
+        const PipelineLayout* purgedPipelineLayout = pipelineLayouts[0];
+        device.core.DestroyPipelineLayout(*pipelineLayouts[0]);
+        pipelineLayouts[0] = CreatePipelineLayout(device);
+        TEST_CHECK(pipelineLayouts[0]);
+
+        for (uint32_t i = 0; i < 2; i++) {
+            for (uint32_t j = 0; j < PIPELINE_NUM; j++) {
+                PipelineCacheStats before = GetStats(device, *pipelineCache);
+
+                TestShader shader(j);
+                Pipeline* pipeline = nullptr;
+                TEST_CHECK(device.helper.GetCachedComputePipeline(*pipelineCache, GetComputePipelineDesc(pipelineLayouts[i], shader), pipeline) == Result::SUCCESS);
+
+                PipelineCacheStats after = GetStats(device, *pipelineCache);
+                if (i == 0) {
+                    TEST_CHECK(after.missNum == before.missNum + 1);
+                } else {
+                    TEST_CHECK(after.hitNum == before.hitNum + 1 && pipeline == pipelines[1][j]);
+                }
+            }
+        }
+
+        printf("    the new layout %s the address of the purged one\n", pipelineLayouts[0] == purgedPipelineLayout ? "reuses" : "doesn't reuse");
+
+        TEST_CHECK(GetStats(device, *pipelineCache).pipelineNum == 2 * PIPELINE_NUM);
+
+        device.helper.DestroyPipelineCache(*pipelineCache);
+        device.core.DestroyPipelineLayout(*pipelineLayouts[0]);
+        device.core.DestroyPipelineLayout(*pipelineLayouts[1]);
+    }
+
+    return true;
+}
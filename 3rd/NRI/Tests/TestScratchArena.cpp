@@ -0,0 +1,140 @@
+// © 2021 NVIDIA Corporation
+
+#include "Tests.h"
+
+#include "SharedExternal.h"
+
+#include <atomic>
+
+using namespace nri;
+
+static void* CountedAllocate(void* userArg, size_t size, size_t alignment) {
+    ((std::atomic_uint64_t*)userArg)->fetch_add(1, std::memory_order_relaxed);
+
+    return AlignedMalloc(userArg, size, alignment);
+}
+
+static void* CountedReallocate(void* userArg, void* memory, size_t size, size_t alignment) {
+    ((std::atomic_uint64_t*)userArg)->fetch_add(1, std::memory_order_relaxed);
+
+    return AlignedRealloc(userArg, memory, size, alignment);
+}
+
+// Records "callNum" barriers of "bufferNum" buffers, counting allocator calls made while recording
+static bool RecordBarriers(TestDevice& device, const std::atomic_uint64_t& allocationNum, uint32_t bufferNum, uint32_t callNum, uint64_t& recordingAllocationNum, double& ns) {
+    std::vector<Buffer*> buffers(bufferNum);
+    std::vector<BufferBarrierDesc> bufferBarriers(bufferNum);
+
+    for (uint32_t i = 0; i < bufferNum; i++) {
+        BufferDesc bufferDesc = {};
+        bufferDesc.size = 256;
+        bufferDesc.usage = BufferUsageBits::SHADER_RESOURCE;
+
+        if (device.core.CreateBuffer(*device.device, bufferDesc, buffers[i]) != Result::SUCCESS)
+            return false;
+
+        bufferBarriers[i] = {};
+        bufferBarriers[i].buffer = buffers[i];
+        bufferBarriers[i].before = {AccessBits::COPY_DESTINATION, StageBits::COPY};
+        bufferBarriers[i].after = {AccessBits::SHADER_RESOURCE, StageBits::FRAGMENT_SHADER};
+    }
+
+    BarrierGroupDesc barrierGroupDesc = {};
+    barrierGroupDesc.buffers = bufferBarriers.data();
+    barrierGroupDesc.bufferNum = bufferNum;
+
+    {
+        TestCommandBuffer commandBuffer(device);
+        if (!commandBuffer.Begin())
+            return false;
+
+        uint64_t allocationNumBefore = allocationNum;
+
+        TestTimer timer;
+        for (uint32_t i = 0; i < callNum; i++)
+            device.core.CmdBarrier(*commandBuffer.commandBuffer, barrierGroupDesc);
+        ns = timer.GetNanoseconds();
+
+        recordingAllocationNum = allocationNum - allocationNumBefore;
+
+        if (device.core.EndCommandBuffer(*commandBuffer.commandBuffer) != Result::SUCCESS)
+            return false;
+    }
+
+    for (Buffer* buffer : buffers)
+        device.core.DestroyBuffer(*buffer);
+
+    return true;
+}
+
+// Big barrier batches through validation need scratch memory above the stack threshold. It comes from the per-thread arena,
+// which allocates once (the arena and its chunk) instead of calling the allocator on every "CmdBarrier"
+bool TestScratchArena() {
+    std::atomic_uint64_t allocationNum = 0;
+
+    AllocationCallbacks allocationCallbacks = {};
+    allocationCallbacks.Allocate = CountedAllocate;
+    allocationCallbacks.Reallocate = CountedReallocate;
+    allocationCallbacks.Free = AlignedFree;
+    allocationCallbacks.userArg = &allocationNum;
+
+    for (uint32_t bufferNum : {16u, 256u, 1024u, 4096u, 16384u}) {
+        TestDevice device;
+        TEST_CHECK(device.Create(true, nullptr, nullptr, &allocationCallbacks));
+
+        uint32_t callNum = 4000000 / bufferNum;
+        uint64_t recordingAllocationNum = 0;
+        double ns = 0.0;
+        TEST_CHECK(RecordBarriers(device, allocationNum, bufferNum, callNum, recordingAllocationNum, ns));
+
+        printf("    CmdBarrier(%5u buffers, %6u bytes): %8.1f ns/call, %llu allocator calls for %u calls\n", bufferNum,
+            bufferNum * (uint32_t)sizeof(BufferBarrierDesc), ns / callNum, (unsigned long long)recordingAllocationNum, callNum);
+
+        TEST_CHECK(recordingAllocationNum <= 2);
+    }
+
+    // Concurrent recording: each thread gets its own arena
+    {
+        constexpr uint32_t THREAD_NUM = 4;
+
+        TestDevice device;
+        TEST_CHECK(device.Create(true, nullptr, nullptr, &allocationCallbacks));
+
+        std::atomic_bool isSucceeded = true;
+        std::vector<std::thread> threads;
+
+        for (uint32_t t = 0; t < THREAD_NUM; t++) {
+            threads.emplace_back([&] {
+                uint64_t recordingAllocationNum = 0;
+                double ns = 0.0;
+                if (!RecordBarriers(device, allocationNum, 4096, 1000, recordingAllocationNum, ns))
+                    isSucceeded = false;
+            });
+        }
+
+        for (std::thread& thread : threads)
+            thread.join();
+
+        TEST_CHECK(isSucceeded);
+
+        // Short-lived threads: arenas (and chunks) of finished threads are reused, memory doesn't grow with the number of threads
+        uint64_t threadAllocationNum = 0;
+        for (uint32_t t = 0; t < 16 && isSucceeded; t++) {
+            std::thread thread([&] {
+                uint64_t recordingAllocationNum = 0;
+                double ns = 0.0;
+                if (!RecordBarriers(device, allocationNum, 4096, 10, recordingAllocationNum, ns))
+                    isSucceeded = false;
+
+                threadAllocationNum += recordingAllocationNum;
+            });
+
+            thread.join();
+        }
+
+        TEST_CHECK(isSucceeded);
+        TEST_CHECK(threadAllocationNum == 0);
+    }
+
+    return true;
+}
@@ -0,0 +1,998 @@
+// © 2021 NVIDIA Corporation
+
+#include "Tests.h"
+
+#include "SharedExternal.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <random>
+
+using namespace nri;
+
+// Requests from several threads get disjoint regions, and the data lands where the returned offsets point
+bool TestStreamerProducers() {
+    TestDevice device;
+    TEST_CHECK(device.Create(false));
+
+    constexpr uint32_t REQUEST_NUM = 50000;
+    constexpr uint32_t DATA_SIZE_MAX = 40;
+
+    static uint8_t data[DATA_SIZE_MAX];
+    for (uint32_t i = 0; i < DATA_SIZE_MAX; i++)
+        data[i] = (uint8_t)(i + 1);
+
+    for (uint32_t threadNum = 1; threadNum <= 8; threadNum *= 2) {
+        StreamerDesc streamerDesc = {};
+        streamerDesc.dynamicBufferMemoryLocation = MemoryLocation::HOST_UPLOAD;
+        streamerDesc.frameInFlightNum = 2;
+
+        Streamer* streamer = nullptr;
+        TEST_CHECK(device.streamer.CreateStreamer(*device.device, streamerDesc, streamer) == Result::SUCCESS);
+
+        // Produce
+        std::vector<std::vector<uint64_t>> offsets(threadNum);
+        std::vector<std::thread> threads;
+
+        TestTimer timer;
+        for (uint32_t t = 0; t < threadNum; t++) {
+            threads.emplace_back([&, t] {
+                offsets[t].reserve(REQUEST_NUM);
+
+                for (uint32_t i = 0; i < REQUEST_NUM; i++) {
+                    BufferUpdateRequestDesc bufferUpdateRequestDesc = {};
+                    bufferUpdateRequestDesc.data = data;
+                    bufferUpdateRequestDesc.dataSize = 1 + i % DATA_SIZE_MAX;
+
+                    offsets[t].push_back(device.streamer.AddStreamerBufferUpdateRequest(*streamer, bufferUpdateRequestDesc));
+                }
+            });
+        }
+
+        for (std::thread& thread : threads)
+            thread.join();
+
+        double ns = timer.GetNanoseconds();
+        printf("    %u thread(s): %.1f M requests/s\n", threadNum, threadNum * REQUEST_NUM / ns * 1000.0);
+
+        TEST_CHECK(device.streamer.CopyStreamerUpdateRequests(*streamer) == Result::SUCCESS);
+
+        // Check
+        std::vector<std::pair<uint64_t, uint64_t>> ranges;
+        for (uint32_t t = 0; t < threadNum; t++) {
+            for (uint32_t i = 0; i < REQUEST_NUM; i++)
+                ranges.push_back({offsets[t][i], offsets[t][i] + 1 + i % DATA_SIZE_MAX});
+        }
+
+        std::sort(ranges.begin(), ranges.end());
+        for (size_t i = 1; i < ranges.size(); i++)
+            TEST_CHECK(ranges[i - 1].second <= ranges[i].first);
+
+        Buffer* dynamicBuffer = device.streamer.GetStreamerDynamicBuffer(*streamer);
+        TEST_CHECK(dynamicBuffer);
+
+        const uint8_t* mapped = (const uint8_t*)device.core.MapBuffer(*dynamicBuffer, 0, WHOLE_SIZE);
+        TEST_CHECK(mapped);
+
+        bool isDataValid = true;
+        for (const auto& range : ranges)
+            isDataValid = isDataValid && memcmp(mapped + range.first, data, (size_t)(range.second - range.first)) == 0;
+
+        device.core.UnmapBuffer(*dynamicBuffer);
+        TEST_CHECK(isDataValid);
+
+        device.streamer.DestroyStreamer(*streamer);
+    }
+
+    return true;
+}
+
+// Reservations are written in place (directly to the mapped dynamic buffer if the region is free), including reservations made
+// before the dynamic buffer grows in the same frame
+bool TestStreamerReservations() {
+    TestDevice device;
+    TEST_CHECK(device.Create(false));
+
+    constexpr uint32_t REQUEST_NUM = 64;
+    constexpr uint32_t REQUEST_SIZE = 256;
+    constexpr uint32_t BIG_REQUEST_SIZE = 4 * 1024 * 1024;
+
+    TestBuffer dst(device);
+    TEST_CHECK(dst.Create(REQUEST_NUM * REQUEST_SIZE + BIG_REQUEST_SIZE));
+
+    StreamerDesc streamerDesc = {};
+    streamerDesc.dynamicBufferMemoryLocation = MemoryLocation::HOST_UPLOAD;
+    streamerDesc.frameInFlightNum = 2;
+
+    Streamer* streamer = nullptr;
+    TEST_CHECK(device.streamer.CreateStreamer(*device.device, streamerDesc, streamer) == Result::SUCCESS);
+
+    TestCommandBuffer commandBuffer(device);
+
+    uint32_t directNum = 0;
+    for (uint32_t frame = 0; frame < 4; frame++) {
+        // The last frame has a reservation which doesn't fit, the dynamic buffer grows
+        bool isGrowing = frame == 3;
+
+        Buffer* dynamicBuffer = device.streamer.GetStreamerDynamicBuffer(*streamer);
+        const uint8_t* dynamicData = dynamicBuffer ? (const uint8_t*)device.core.MapBuffer(*dynamicBuffer, 0, WHOLE_SIZE) : nullptr;
+        if (dynamicBuffer)
+            device.core.UnmapBuffer(*dynamicBuffer);
+
+        StreamerStats streamerStats = {};
+        device.streamer.GetStreamerStats(*streamer, streamerStats);
+
+        for (uint32_t i = 0; i <= REQUEST_NUM; i++) {
+            bool isBig = i == REQUEST_NUM;
+            if (isBig && !isGrowing)
+                break;
+
+            BufferUpdateRequestDesc bufferUpdateRequestDesc = {};
+            bufferUpdateRequestDesc.dataSize = isBig ? BIG_REQUEST_SIZE : REQUEST_SIZE;
+            bufferUpdateRequestDesc.dstBuffer = dst.buffer;
+            bufferUpdateRequestDesc.dstBufferOffset = i * REQUEST_SIZE;
+
+            uint64_t offset = 0;
+            uint8_t* data = (uint8_t*)device.streamer.ReserveStreamerBufferUpdateRequest(*streamer, bufferUpdateRequestDesc, offset);
+            TEST_CHECK(data);
+
+            memset(data, (int)(frame * 16 + i % 16 + 1), bufferUpdateRequestDesc.dataSize);
+
+            if (dynamicData && data >= dynamicData && data < dynamicData + streamerStats.dynamicBufferSize) {
+                TEST_CHECK(data == dynamicData + offset);
+                directNum++;
+            }
+        }
+
+        TEST_CHECK(device.streamer.CopyStreamerUpdateRequests(*streamer) == Result::SUCCESS);
+
+        TEST_CHECK(commandBuffer.Begin());
+        device.streamer.CmdUploadStreamerUpdateRequests(*commandBuffer.commandBuffer, *streamer);
+        TEST_CHECK(commandBuffer.Submit());
+
+        // Check
+        const uint8_t* mapped = (const uint8_t*)device.core.MapBuffer(*dst.buffer, 0, WHOLE_SIZE);
+        TEST_CHECK(mapped);
+
+        bool isDataValid = true;
+        for (uint32_t i = 0; i < REQUEST_NUM; i++) {
+            for (uint32_t j = 0; j < REQUEST_SIZE; j++)
+                isDataValid = isDataValid && mapped[i * REQUEST_SIZE + j] == (uint8_t)(frame * 16 + i % 16 + 1);
+        }
+
+        if (isGrowing)
+            isDataValid = isDataValid && mapped[REQUEST_NUM * REQUEST_SIZE] == (uint8_t)(frame * 16 + 1) && mapped[REQUEST_NUM * REQUEST_SIZE + BIG_REQUEST_SIZE - 1] == (uint8_t)(frame * 16 + 1);
+
+        device.core.UnmapBuffer(*dst.buffer);
+        TEST_CHECK(isDataValid);
+    }
+
+    StreamerStats streamerStats = {};
+    device.streamer.GetStreamerStats(*streamer, streamerStats);
+    printf("    %u of %u reservations written directly, %u grows\n", directNum, 4 * REQUEST_NUM + 1, streamerStats.growNum);
+
+    // The first frame has no dynamic buffer yet, the following ones fit
+    TEST_CHECK(directNum >= 3 * REQUEST_NUM);
+
+    device.streamer.DestroyStreamer(*streamer);
+
+    return true;
+}
+
+// Contiguous updates get merged into a few copies, unchanged ones get skipped (if requested), the destination matches a shadow copy
+// updated in submission order (partial updates overlap the blocks)
+bool TestStreamerCoalescing() {
+    TestDevice device;
+    TEST_CHECK(device.Create(false));
+
+    constexpr uint32_t FRAME_NUM = 200;
+    constexpr uint32_t BLOCK_NUM = 256;
+    constexpr uint32_t BLOCK_SIZE = 256;
+    constexpr uint32_t PARTIAL_SIZE = 100;
+
+    TestBuffer dst(device);
+    TEST_CHECK(dst.Create(BLOCK_NUM * BLOCK_SIZE));
+
+    TestCommandBuffer commandBuffer(device);
+
+    for (uint32_t skipUnchanged = 0; skipUnchanged < 2; skipUnchanged++) {
+        StreamerDesc streamerDesc = {};
+        streamerDesc.dynamicBufferMemoryLocation = MemoryLocation::HOST_UPLOAD;
+        streamerDesc.frameInFlightNum = 2;
+        streamerDesc.skipUnchangedBufferUpdates = skipUnchanged != 0;
+
+        Streamer* streamer = nullptr;
+        TEST_CHECK(device.streamer.CreateStreamer(*device.device, streamerDesc, streamer) == Result::SUCCESS);
+
+        std::mt19937 rng(1);
+        std::vector<uint8_t> blocks(BLOCK_NUM * BLOCK_SIZE);
+        for (uint8_t& x : blocks)
+            x = (uint8_t)rng();
+
+        std::vector<uint8_t> shadow(BLOCK_NUM * BLOCK_SIZE);
+        std::vector<uint8_t> partial(PARTIAL_SIZE);
+
+        uint32_t requestNum = 0;
+        uint32_t commandNum = 0;
+        uint32_t skippedNum = 0;
+        for (uint32_t frame = 0; frame < FRAME_NUM; frame++) {
+            // 10% of blocks change, 5% are written via reservations
+            for (uint32_t i = 0; i < BLOCK_NUM; i++) {
+                uint8_t* block = blocks.data() + i * BLOCK_SIZE;
+                if (rng() % 10 == 0) {
+                    for (uint32_t j = 0; j < BLOCK_SIZE; j++)
+                        block[j] = (uint8_t)rng();
+                }
+
+                BufferUpdateRequestDesc bufferUpdateRequestDesc = {};
+                bufferUpdateRequestDesc.dataSize = BLOCK_SIZE;
+                bufferUpdateRequestDesc.dstBuffer = dst.buffer;
+                bufferUpdateRequestDesc.dstBufferOffset = i * BLOCK_SIZE;
+
+                if (rng() % 20 == 0) {
+                    uint64_t offset = 0;
+                    void* data = device.streamer.ReserveStreamerBufferUpdateRequest(*streamer, bufferUpdateRequestDesc, offset);
+                    TEST_CHECK(data);
+
+                    memcpy(data, block, BLOCK_SIZE);
+                } else {
+                    bufferUpdateRequestDesc.data = block;
+                    device.streamer.AddStreamerBufferUpdateRequest(*streamer, bufferUpdateRequestDesc);
+                }
+
+                memcpy(shadow.data() + i * BLOCK_SIZE, block, BLOCK_SIZE);
+                requestNum++;
+            }
+
+            // Sometimes a partial update, submitted later, overwrites parts of a couple of blocks
+            if (rng() % 4 == 0) {
+                for (uint8_t& x : partial)
+                    x = (uint8_t)rng();
+
+                uint32_t offset = rng() % (BLOCK_NUM * BLOCK_SIZE - PARTIAL_SIZE);
+
+                BufferUpdateRequestDesc bufferUpdateRequestDesc = {};
+                bufferUpdateRequestDesc.data = partial.data();
+                bufferUpdateRequestDesc.dataSize = PARTIAL_SIZE;
+                bufferUpdateRequestDesc.dstBuffer = dst.buffer;
+                bufferUpdateRequestDesc.dstBufferOffset = offset;
+
+                device.streamer.AddStreamerBufferUpdateRequest(*streamer, bufferUpdateRequestDesc);
+
+                memcpy(shadow.data() + offset, partial.data(), PARTIAL_SIZE);
+                requestNum++;
+            }
+
+            TEST_CHECK(device.streamer.CopyStreamerUpdateRequests(*streamer) == Result::SUCCESS);
+
+            StreamerStats streamerStats = {};
+            device.streamer.GetStreamerStats(*streamer, streamerStats);
+            commandNum += streamerStats.uploadCommandNum;
+            skippedNum += streamerStats.skippedRequestNum;
+
+            TEST_CHECK(commandBuffer.Begin());
+            device.streamer.CmdUploadStreamerUpdateRequests(*commandBuffer.commandBuffer, *streamer);
+            TEST_CHECK(commandBuffer.Submit());
+
+            const uint8_t* mapped = (const uint8_t*)device.core.MapBuffer(*dst.buffer, 0, WHOLE_SIZE);
+            TEST_CHECK(mapped);
+
+            bool isDataValid = memcmp(mapped, shadow.data(), shadow.size()) == 0;
+            device.core.UnmapBuffer(*dst.buffer);
+            TEST_CHECK(isDataValid);
+
+            // Blocks partially overwritten in this frame must be updated in the next one, since their content has changed
+            blocks.swap(shadow);
+        }
+
+        printf("    skip unchanged %u: %u requests, %u copies, %u skipped\n", skipUnchanged, requestNum, commandNum, skippedNum);
+
+        // Skipped updates split runs of contiguous updates, but most blocks don't change
+        if (skipUnchanged) {
+            TEST_CHECK(skippedNum * 2 > requestNum);
+        } else {
+            TEST_CHECK(commandNum * 16 < requestNum && skippedNum == 0);
+        }
+
+        device.streamer.DestroyStreamer(*streamer);
+    }
+
+    return true;
+}
+
+// Overlapping updates are applied in submission order, even if they come from different threads (ordered by a join)
+bool TestStreamerOverlappingUpdates() {
+    TestDevice device;
+    TEST_CHECK(device.Create(false));
+
+    TestBuffer dst(device);
+    TEST_CHECK(dst.Create(1024));
+
+    StreamerDesc streamerDesc = {};
+    streamerDesc.dynamicBufferMemoryLocation = MemoryLocation::HOST_UPLOAD;
+    streamerDesc.frameInFlightNum = 2;
+
+    Streamer* streamer = nullptr;
+    TEST_CHECK(device.streamer.CreateStreamer(*device.device, streamerDesc, streamer) == Result::SUCCESS);
+
+    TestCommandBuffer commandBuffer(device);
+
+    uint8_t data[8][128];
+    auto AddUpdate = [&](uint8_t value, uint64_t offset, uint64_t size) {
+        memset(data[value], value, sizeof(data[value]));
+
+        BufferUpdateRequestDesc bufferUpdateRequestDesc = {};
+        bufferUpdateRequestDesc.data = data[value];
+        bufferUpdateRequestDesc.dataSize = size;
+        bufferUpdateRequestDesc.dstBuffer = dst.buffer;
+        bufferUpdateRequestDesc.dstBufferOffset = offset;
+
+        device.streamer.AddStreamerBufferUpdateRequest(*streamer, bufferUpdateRequestDesc);
+    };
+
+    AddUpdate(1, 0, 100);
+    AddUpdate(2, 50, 10);
+    std::thread([&] { AddUpdate(3, 40, 30); }).join(); // covers "2", but starts before it
+    AddUpdate(4, 200, 16);
+    AddUpdate(5, 216, 16); // contiguous, merged with "4"
+    AddUpdate(6, 500, 8);
+    AddUpdate(7, 496, 16); // covers "6", but starts before it
+
+    TEST_CHECK(device.streamer.CopyStreamerUpdateRequests(*streamer) == Result::SUCCESS);
+
+    StreamerStats streamerStats = {};
+    device.streamer.GetStreamerStats(*streamer, streamerStats);
+    TEST_CHECK(streamerStats.uploadCommandNum == 6);
+
+    TEST_CHECK(commandBuffer.Begin());
+    device.streamer.CmdUploadStreamerUpdateRequests(*commandBuffer.commandBuffer, *streamer);
+    TEST_CHECK(commandBuffer.Submit());
+
+    const uint8_t* mapped = (const uint8_t*)device.core.MapBuffer(*dst.buffer, 0, WHOLE_SIZE);
+    TEST_CHECK(mapped);
+
+    uint8_t expected[1024] = {};
+    memset(expected, 1, 100);
+    memset(expected + 40, 3, 30);
+    memset(expected + 200, 4, 16);
+    memset(expected + 216, 5, 16);
+    memset(expected + 496, 7, 16);
+
+    bool isDataValid = memcmp(mapped, expected, sizeof(expected)) == 0;
+    device.core.UnmapBuffer(*dst.buffer);
+    TEST_CHECK(isDataValid);
+
+    device.streamer.DestroyStreamer(*streamer);
+
+    return true;
+}
+
+// A texture and its source data, tightly packed in "expected"
+struct StreamerTestTexture {
+    TextureDesc desc;
+    Texture* texture;
+    uint32_t rowSize; // in bytes
+    uint32_t rowNum;  // in blocks
+    uint32_t dataRowPitch;
+    uint32_t dataSlicePitch;
+    std::vector<uint8_t> data;
+    std::vector<uint8_t> expected;
+};
+
+// Producer threads add texture updates, "CopyStreamerUpdateRequests" copies them with and without copy threads. Host mode uses
+// D3D12 upload alignments, so the layouts cover:
+//  - rows padded in the dynamic buffer (copied in groups of rows)
+//  - contiguous slices (merged into one row, split into pieces)
+//  - padded source slices (copied slice by slice)
+//  - block compressed rows
+// Textures are read back and compared byte for byte
+bool TestStreamerTextures() {
+    constexpr uint32_t THREAD_NUM = 4;
+
+    TestDevice device;
+    TEST_CHECK(device.Create(false));
+
+    const DeviceDesc& deviceDesc = device.core.GetDeviceDesc(*device.device);
+    TEST_CHECK(deviceDesc.uploadBufferTextureRowAlignment > 1);
+
+    for (uint32_t copyThreadNum : {0u, 4u}) {
+        StreamerDesc streamerDesc = {};
+        streamerDesc.dynamicBufferMemoryLocation = MemoryLocation::HOST_UPLOAD;
+        streamerDesc.frameInFlightNum = 2;
+        streamerDesc.copyThreadNum = copyThreadNum;
+
+        Streamer* streamer = nullptr;
+        TEST_CHECK(device.streamer.CreateStreamer(*device.device, streamerDesc, streamer) == Result::SUCCESS);
+
+        // Per thread: 2D with padded rows, 3D with contiguous slices, 3D with padded source slices, BC1
+        std::vector<StreamerTestTexture> textures(THREAD_NUM * 4);
+        for (uint32_t i = 0; i < textures.size(); i++) {
+            StreamerTestTexture& texture = textures[i];
+            texture.desc.type = TextureType::TEXTURE_2D;
+            texture.desc.format = Format::RGBA8_UNORM;
+            texture.desc.mipNum = 1;
+            texture.desc.layerNum = 1;
+            texture.desc.depth = 1;
+
+            uint32_t slicePadding = 0;
+            switch (i % 4) {
+                case 0:
+                    texture.desc.width = 300;
+                    texture.desc.height = 200;
+                    break;
+                case 1:
+                    texture.desc.type = TextureType::TEXTURE_3D;
+                    texture.desc.width = 64;
+                    texture.desc.height = 64;
+                    texture.desc.depth = 16;
+                    break;
+                case 2:
+                    texture.desc.type = TextureType::TEXTURE_3D;
+                    texture.desc.width = 64;
+                    texture.desc.height = 64;
+                    texture.desc.depth = 16;
+                    slicePadding = 256;
+                    break;
+                case 3:
+                    texture.desc.format = Format::BC1_RGBA_UNORM;
+                    texture.desc.width = 256;
+                    texture.desc.height = 256;
+                    break;
+            }
+
+            bool isBC = texture.desc.format == Format::BC1_RGBA_UNORM;
+            texture.rowSize = isBC ? texture.desc.width / 4 * 8 : texture.desc.width * 4;
+            texture.rowNum = isBC ? texture.desc.height / 4 : texture.desc.height;
+            texture.dataRowPitch = texture.rowSize;
+            texture.dataSlicePitch = texture.rowSize * texture.rowNum + slicePadding;
+
+            texture.expected.resize((size_t)texture.rowSize * texture.rowNum * texture.desc.depth);
+            for (size_t j = 0; j < texture.expected.size(); j++)
+                texture.expected[j] = (uint8_t)(j * 7 + j / 4093 + i * 31);
+
+            // Padding is garbage
+            texture.data.resize((size_t)texture.dataSlicePitch * texture.desc.depth, 0xCD);
+            for (uint32_t z = 0; z < texture.desc.depth; z++) {
+                const uint8_t* src = texture.expected.data() + (size_t)z * texture.rowSize * texture.rowNum;
+                memcpy(texture.data.data() + (size_t)z * texture.dataSlicePitch, src, (size_t)texture.rowSize * texture.rowNum);
+            }
+
+            TEST_CHECK(device.core.CreateTexture(*device.device, texture.desc, texture.texture) == Result::SUCCESS);
+        }
+
+        std::vector<Texture*> textureObjects;
+        for (const StreamerTestTexture& texture : textures)
+            textureObjects.push_back(texture.texture);
+
+        ResourceGroupDesc resourceGroupDesc = {};
+        resourceGroupDesc.memoryLocation = MemoryLocation::DEVICE;
+        resourceGroupDesc.textures = textureObjects.data();
+        resourceGroupDesc.textureNum = (uint32_t)textureObjects.size();
+
+        Memory* memory = nullptr;
+        TEST_CHECK(device.helper.AllocateAndBindMemory(*device.device, resourceGroupDesc, &memory) == Result::SUCCESS);
+
+        // Produce
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < THREAD_NUM; t++) {
+            threads.emplace_back([&, t] {
+                for (uint32_t i = t * 4; i < t * 4 + 4; i++) {
+                    const StreamerTestTexture& texture = textures[i];
+
+                    TextureUpdateRequestDesc textureUpdateRequestDesc = {};
+                    textureUpdateRequestDesc.data = texture.data.data();
+                    textureUpdateRequestDesc.dataRowPitch = texture.dataRowPitch;
+                    textureUpdateRequestDesc.dataSlicePitch = texture.dataSlicePitch;
+                    textureUpdateRequestDesc.dstTexture = texture.texture;
+                    textureUpdateRequestDesc.dstRegionDesc.width = WHOLE_SIZE;
+                    textureUpdateRequestDesc.dstRegionDesc.height = WHOLE_SIZE;
+                    textureUpdateRequestDesc.dstRegionDesc.depth = WHOLE_SIZE;
+
+                    device.streamer.AddStreamerTextureUpdateRequest(*streamer, textureUpdateRequestDesc);
+                }
+            });
+        }
+
+        for (std::thread& thread : threads)
+            thread.join();
+
+        TestTimer timer;
+        TEST_CHECK(device.streamer.CopyStreamerUpdateRequests(*streamer) == Result::SUCCESS);
+        double ns = timer.GetNanoseconds();
+
+        StreamerStats streamerStats = {};
+        device.streamer.GetStreamerStats(*streamer, streamerStats);
+        TEST_CHECK(streamerStats.textureRequestNum == textures.size());
+
+        uint64_t dataSize = 0;
+        for (const StreamerTestTexture& texture : textures)
+            dataSize += (uint64_t)texture.dataRowPitch * texture.rowNum * texture.desc.depth;
+        TEST_CHECK(streamerStats.copiedSize == dataSize);
+
+        printf("    %u copy thread(s): %.2f MB in %.1f us\n", copyThreadNum, dataSize / (1024.0 * 1024.0), ns / 1000.0);
+
+        // Upload and read back
+        std::vector<TextureDataLayoutDesc> readbackLayouts(textures.size());
+        uint64_t readbackSize = 0;
+        for (size_t i = 0; i < textures.size(); i++) {
+            const StreamerTestTexture& texture = textures[i];
+
+            TextureDataLayoutDesc& readbackLayout = readbackLayouts[i];
+            readbackLayout.offset = readbackSize;
+            readbackLayout.rowPitch = (texture.rowSize + deviceDesc.uploadBufferTextureRowAlignment - 1) / deviceDesc.uploadBufferTextureRowAlignment * deviceDesc.uploadBufferTextureRowAlignment;
+            readbackLayout.slicePitch = readbackLayout.rowPitch * texture.rowNum;
+
+            readbackSize += (uint64_t)readbackLayout.slicePitch * texture.desc.depth;
+        }
+
+        TestBuffer readbackBuffer(device);
+        TEST_CHECK(readbackBuffer.Create(readbackSize, MemoryLocation::HOST_READBACK));
+
+        TestCommandBuffer commandBuffer(device);
+        TEST_CHECK(commandBuffer.Begin());
+
+        device.streamer.CmdUploadStreamerUpdateRequests(*commandBuffer.commandBuffer, *streamer);
+
+        for (size_t i = 0; i < textures.size(); i++) {
+            TextureRegionDesc textureRegionDesc = {};
+            textureRegionDesc.width = WHOLE_SIZE;
+            textureRegionDesc.height = WHOLE_SIZE;
+            textureRegionDesc.depth = WHOLE_SIZE;
+
+            device.core.CmdReadbackTextureToBuffer(*commandBuffer.commandBuffer, *readbackBuffer.buffer, readbackLayouts[i], *textures[i].texture, textureRegionDesc);
+        }
+
+        TEST_CHECK(commandBuffer.Submit());
+
+        const uint8_t* mapped = (const uint8_t*)device.core.MapBuffer(*readbackBuffer.buffer, 0, WHOLE_SIZE);
+        TEST_CHECK(mapped);
+
+        bool isDataValid = true;
+        for (size_t i = 0; i < textures.size(); i++) {
+            const StreamerTestTexture& texture = textures[i];
+            const TextureDataLayoutDesc& readbackLayout = readbackLayouts[i];
+
+            for (uint32_t z = 0; z < texture.desc.depth; z++) {
+                for (uint32_t row = 0; row < texture.rowNum; row++) {
+                    const uint8_t* actual = mapped + readbackLayout.offset + (uint64_t)z * readbackLayout.slicePitch + (uint64_t)row * readbackLayout.rowPitch;
+                    const uint8_t* expected = texture.expected.data() + ((size_t)z * texture.rowNum + row) * texture.rowSize;
+                    isDataValid = isDataValid && memcmp(actual, expected, texture.rowSize) == 0;
+                }
+            }
+        }
+
+        device.core.UnmapBuffer(*readbackBuffer.buffer);
+        TEST_CHECK(isDataValid);
+
+        for (const StreamerTestTexture& texture : textures)
+            device.core.DestroyTexture(*texture.texture);
+        device.core.FreeMemory(*memory);
+
+        device.streamer.DestroyStreamer(*streamer);
+    }
+
+    return true;
+}
+
+// Fails big allocations while "isFailing" is set
+struct FailingAllocator {
+    size_t failSizeMin;
+    bool isFailing;
+};
+
+static void* FailingAllocate(void* userArg, size_t size, size_t alignment) {
+    const FailingAllocator& failingAllocator = *(FailingAllocator*)userArg;
+    if (failingAllocator.isFailing && size >= failingAllocator.failSizeMin)
+        return nullptr;
+
+    return AlignedMalloc(userArg, size, alignment);
+}
+
+// A grow, which fails, leaves requests queued and doesn't count the frame: after retries the data is uploaded once, and the replaced
+// buffer is released after the same number of frames as without failures (frame counting, no fence)
+bool TestStreamerFailedGrow() {
+    constexpr uint32_t FRAME_IN_FLIGHT_NUM = 2;
+    constexpr uint32_t BIG_SIZE = 8 * 1024 * 1024;
+
+    FailingAllocator failingAllocator = {BIG_SIZE, false};
+
+    AllocationCallbacks allocationCallbacks = {};
+    allocationCallbacks.Allocate = FailingAllocate;
+    allocationCallbacks.Reallocate = AlignedRealloc;
+    allocationCallbacks.Free = AlignedFree;
+    allocationCallbacks.userArg = &failingAllocator;
+
+    TestDevice device;
+    TEST_CHECK(device.Create(false, nullptr, nullptr, &allocationCallbacks));
+
+    StreamerDesc streamerDesc = {};
+    streamerDesc.dynamicBufferMemoryLocation = MemoryLocation::HOST_UPLOAD;
+    streamerDesc.frameInFlightNum = FRAME_IN_FLIGHT_NUM;
+
+    Streamer* streamer = nullptr;
+    TEST_CHECK(device.streamer.CreateStreamer(*device.device, streamerDesc, streamer) == Result::SUCCESS);
+
+    std::vector<uint8_t> data(BIG_SIZE);
+    for (size_t i = 0; i < data.size(); i++)
+        data[i] = (uint8_t)(i * 13 + i / 1021);
+
+    TestBuffer dstBuffer(device);
+    TEST_CHECK(dstBuffer.Create(BIG_SIZE, MemoryLocation::DEVICE));
+
+    // The first frame creates the dynamic buffer, the second one grows it (the first buffer goes to garbage)
+    for (uint32_t size : {64 * 1024u, 1024 * 1024u}) {
+        BufferUpdateRequestDesc bufferUpdateRequestDesc = {};
+        bufferUpdateRequestDesc.data = data.data();
+        bufferUpdateRequestDesc.dataSize = size;
+        device.streamer.AddStreamerBufferUpdateRequest(*streamer, bufferUpdateRequestDesc);
+
+        TEST_CHECK(device.streamer.CopyStreamerUpdateRequests(*streamer) == Result::SUCCESS);
+    }
+
+    StreamerStats streamerStats = {};
+    device.streamer.GetStreamerStats(*streamer, streamerStats);
+    TEST_CHECK(streamerStats.growNum == 2 && streamerStats.garbageBufferNum == 1);
+
+    // A big update can't grow the buffer
+    BufferUpdateRequestDesc bufferUpdateRequestDesc = {};
+    bufferUpdateRequestDesc.data = data.data();
+    bufferUpdateRequestDesc.dataSize = BIG_SIZE;
+    bufferUpdateRequestDesc.dstBuffer = dstBuffer.buffer;
+    device.streamer.AddStreamerBufferUpdateRequest(*streamer, bufferUpdateRequestDesc);
+
+    failingAllocator.isFailing = true;
+    for (uint32_t i = 0; i < 3; i++)
+        TEST_CHECK(device.streamer.CopyStreamerUpdateRequests(*streamer) == Result::OUT_OF_MEMORY);
+
+    device.streamer.GetStreamerStats(*streamer, streamerStats);
+    TEST_CHECK(streamerStats.growNum == 2 && streamerStats.garbageBufferNum == 1);
+
+    // The retry succeeds and uploads the data once
+    failingAllocator.isFailing = false;
+    TEST_CHECK(device.streamer.CopyStreamerUpdateRequests(*streamer) == Result::SUCCESS);
+
+    device.streamer.GetStreamerStats(*streamer, streamerStats);
+    TEST_CHECK(streamerStats.growNum == 3 && streamerStats.garbageBufferNum == 2);
+    TEST_CHECK(streamerStats.bufferRequestNum == 1 && streamerStats.requestedSize == BIG_SIZE && streamerStats.copiedSize == BIG_SIZE);
+
+    TestCommandBuffer commandBuffer(device);
+    TEST_CHECK(commandBuffer.Begin());
+    device.streamer.CmdUploadStreamerUpdateRequests(*commandBuffer.commandBuffer, *streamer);
+    TEST_CHECK(commandBuffer.Submit());
+
+    const uint8_t* mapped = (const uint8_t*)device.core.MapBuffer(*dstBuffer.buffer, 0, WHOLE_SIZE);
+    TEST_CHECK(mapped);
+    bool isDataValid = memcmp(mapped, data.data(), BIG_SIZE) == 0;
+    device.core.UnmapBuffer(*dstBuffer.buffer);
+    TEST_CHECK(isDataValid);
+
+    // The first replaced buffer is released by the "FRAME_IN_FLIGHT_NUM + 2"-th successful call after the replacement (failed calls don't count)
+    for (uint32_t frame = 0; frame <= FRAME_IN_FLIGHT_NUM; frame++) {
+        TEST_CHECK(device.streamer.CopyStreamerUpdateRequests(*streamer) == Result::SUCCESS);
+
+        device.streamer.GetStreamerStats(*streamer, streamerStats);
+        TEST_CHECK(streamerStats.garbageBufferNum == (frame < FRAME_IN_FLIGHT_NUM ? 2 : 1));
+    }
+
+    device.streamer.DestroyStreamer(*streamer);
+
+    return true;
+}
+
+// Frames of random sizes (with rare spikes) go through the ring while the "GPU" lags behind. Data of a frame must stay intact until
+// the GPU is done with it, also across grows and shrinks. Memory is reclaimed by "StreamerDesc::fence" (the GPU lags randomly) or by
+// counting "frameInFlightNum" frames (the GPU lags as much as allowed)
+bool TestStreamerRing() {
+    constexpr uint32_t FRAME_NUM = 1500;
+    constexpr uint32_t FRAME_IN_FLIGHT_NUM = 2;
+
+    struct InFlightUpdate {
+        Buffer* buffer;
+        uint64_t offset;
+        std::vector<uint8_t> data;
+        uint64_t fenceValue;
+    };
+
+    TestDevice device;
+    TEST_CHECK(device.Create(false));
+
+    for (bool useFence : {false, true}) {
+        for (uint32_t shrinkFrameNum : {0u, 8u}) {
+            Fence* fence = nullptr;
+            TEST_CHECK(device.core.CreateFence(*device.device, 0, fence) == Result::SUCCESS);
+
+            StreamerDesc streamerDesc = {};
+            streamerDesc.dynamicBufferMemoryLocation = MemoryLocation::HOST_UPLOAD;
+            streamerDesc.frameInFlightNum = FRAME_IN_FLIGHT_NUM;
+            streamerDesc.fence = useFence ? fence : nullptr;
+            streamerDesc.shrinkFrameNum = shrinkFrameNum;
+
+            Streamer* streamer = nullptr;
+            TEST_CHECK(device.streamer.CreateStreamer(*device.device, streamerDesc, streamer) == Result::SUCCESS);
+
+            auto IsIntact = [&](const InFlightUpdate& update) {
+                const uint8_t* mapped = (const uint8_t*)device.core.MapBuffer(*update.buffer, 0, WHOLE_SIZE);
+                bool isIntact = memcmp(mapped + update.offset, update.data.data(), update.data.size()) == 0;
+                device.core.UnmapBuffer(*update.buffer);
+
+                return isIntact;
+            };
+
+            std::mt19937 random(useFence ? 43 : 42);
+            std::deque<InFlightUpdate> inFlightUpdates;
+            uint64_t gpuFenceValue = 0;
+            uint64_t dynamicBufferMaxSize = 0;
+
+            for (uint32_t frame = 0; frame < FRAME_NUM; frame++) {
+                uint32_t requestNum = random() % 8;
+                bool isSpike = frame % 500 == 100;
+
+                std::vector<std::pair<uint64_t, std::vector<uint8_t>>> updates(requestNum);
+                for (auto& update : updates) {
+                    update.second.resize(1 + random() % (isSpike ? 4000000 : 20000));
+                    for (uint8_t& byte : update.second)
+                        byte = (uint8_t)random();
+
+                    BufferUpdateRequestDesc bufferUpdateRequestDesc = {};
+                    bufferUpdateRequestDesc.dataSize = update.second.size();
+
+                    if (random() & 1) {
+                        void* data = device.streamer.ReserveStreamerBufferUpdateRequest(*streamer, bufferUpdateRequestDesc, update.first);
+                        TEST_CHECK(data);
+
+                        memcpy(data, update.second.data(), update.second.size());
+                    } else {
+                        bufferUpdateRequestDesc.data = update.second.data();
+                        update.first = device.streamer.AddStreamerBufferUpdateRequest(*streamer, bufferUpdateRequestDesc);
+                    }
+                }
+
+                device.streamer.SetStreamerFenceValue(*streamer, frame + 1);
+                TEST_CHECK(device.streamer.CopyStreamerUpdateRequests(*streamer) == Result::SUCCESS);
+
+                Buffer* dynamicBuffer = device.streamer.GetStreamerDynamicBuffer(*streamer);
+                for (auto& update : updates) {
+                    InFlightUpdate inFlightUpdate = {dynamicBuffer, update.first, std::move(update.second), frame + 1};
+                    TEST_CHECK(IsIntact(inFlightUpdate));
+
+                    inFlightUpdates.push_back(std::move(inFlightUpdate));
+                }
+
+                StreamerStats streamerStats = {};
+                device.streamer.GetStreamerStats(*streamer, streamerStats);
+                dynamicBufferMaxSize = std::max(dynamicBufferMaxSize, streamerStats.dynamicBufferSize);
+
+                // The GPU reads data of completed frames, then signals. Without a fence, "CopyStreamerUpdateRequests" for a frame can precede
+                // waiting for the oldest frame in flight, i.e. the GPU lags by up to "frameInFlightNum + 1" frames
+                uint64_t lag = useFence ? random() % (FRAME_IN_FLIGHT_NUM * 2 + 1) : FRAME_IN_FLIGHT_NUM + 1;
+                uint64_t targetFenceValue = frame + 1 > lag ? frame + 1 - lag : 0;
+
+                for (; gpuFenceValue < targetFenceValue; gpuFenceValue++) {
+                    while (!inFlightUpdates.empty() && inFlightUpdates.front().fenceValue <= gpuFenceValue + 1) {
+                        TEST_CHECK(IsIntact(inFlightUpdates.front()));
+                        inFlightUpdates.pop_front();
+                    }
+
+                    FenceSubmitDesc fenceSubmitDesc = {};
+                    fenceSubmitDesc.fence = fence;
+                    fenceSubmitDesc.value = gpuFenceValue + 1;
+
+                    QueueSubmitDesc queueSubmitDesc = {};
+                    queueSubmitDesc.signalFences = &fenceSubmitDesc;
+                    queueSubmitDesc.signalFenceNum = 1;
+
+                    device.core.QueueSubmit(*device.queue, queueSubmitDesc);
+                }
+            }
+
+            StreamerStats streamerStats = {};
+            device.streamer.GetStreamerStats(*streamer, streamerStats);
+
+            printf("    %s, shrink after %u frames: max %.2f MB, final %.2f MB, %u grows, %u shrinks\n", useFence ? "fence" : "frame counting",
+                shrinkFrameNum, dynamicBufferMaxSize / 1048576.0, streamerStats.dynamicBufferSize / 1048576.0, streamerStats.growNum, streamerStats.shrinkNum);
+
+            if (shrinkFrameNum) {
+                TEST_CHECK(streamerStats.shrinkNum && streamerStats.dynamicBufferSize < dynamicBufferMaxSize);
+            } else {
+                TEST_CHECK(!streamerStats.shrinkNum);
+            }
+
+            device.streamer.DestroyStreamer(*streamer);
+            device.core.DestroyFence(*fence);
+        }
+    }
+
+    return true;
+}
+
+struct MessageCounters {
+    std::atomic_uint32_t warningNum = 0;
+    std::atomic_uint32_t errorNum = 0;
+};
+
+static void CountMessages(Message messageType, const char*, uint32_t, const char*, void* userArg) {
+    MessageCounters& messageCounters = *(MessageCounters*)userArg;
+    if (messageType == Message::WARNING)
+        messageCounters.warningNum++;
+    else if (messageType == Message::ERROR)
+        messageCounters.errorNum++;
+}
+
+// Constants of the frames in flight stay intact while the ring wraps around. If the ring is too small, the streamer waits
+// for the fence (in host mode the wait returns immediately) or, without a fence, warns about overwriting constants in use
+bool TestStreamerConstantRing() {
+    constexpr uint32_t FRAME_NUM = 200;
+    constexpr uint32_t FRAME_IN_FLIGHT_NUM = 2;
+    constexpr uint32_t BATCH_SIZE = 4;
+    constexpr uint32_t CONSTANT_SIZE = 48;
+
+    struct InFlightConstants {
+        uint32_t offset;
+        std::vector<uint8_t> data;
+        uint64_t fenceValue;
+    };
+
+    for (bool enableValidation : {false, true}) {
+        for (bool useFence : {false, true}) {
+            for (bool isRingSmall : {false, true}) {
+                MessageCounters messageCounters;
+
+                CallbackInterface callbackInterface = {};
+                callbackInterface.MessageCallback = CountMessages;
+                callbackInterface.AbortExecution = [](void*) {};
+                callbackInterface.userArg = &messageCounters;
+
+                TestDevice device;
+                TEST_CHECK(device.Create(enableValidation, nullptr, &callbackInterface));
+
+                Fence* fence = nullptr;
+                TEST_CHECK(device.core.CreateFence(*device.device, 0, fence) == Result::SUCCESS);
+
+                // A batch and a single constant per frame. The big ring holds all frames in flight, the small one doesn't hold even two frames
+                const DeviceDesc& deviceDesc = device.core.GetDeviceDesc(*device.device);
+                uint32_t alignment = deviceDesc.constantBufferOffsetAlignment;
+                uint32_t frameSize = (BATCH_SIZE + 1) * ((CONSTANT_SIZE + alignment - 1) / alignment * alignment);
+
+                StreamerDesc streamerDesc = {};
+                streamerDesc.constantBufferMemoryLocation = MemoryLocation::HOST_UPLOAD;
+                streamerDesc.constantBufferSize = isRingSmall ? frameSize + frameSize / 2 : frameSize * (FRAME_IN_FLIGHT_NUM + 3);
+                streamerDesc.dynamicBufferMemoryLocation = MemoryLocation::HOST_UPLOAD;
+                streamerDesc.frameInFlightNum = FRAME_IN_FLIGHT_NUM;
+                streamerDesc.fence = useFence ? fence : nullptr;
+
+                Streamer* streamer = nullptr;
+                TEST_CHECK(device.streamer.CreateStreamer(*device.device, streamerDesc, streamer) == Result::SUCCESS);
+
+                Buffer* constantBuffer = device.streamer.GetStreamerConstantBuffer(*streamer);
+                TEST_CHECK(constantBuffer);
+
+                // Read as the GPU sees it (the ring is kept mapped by the streamer)
+                TestBuffer readbackBuffer(device);
+                TEST_CHECK(readbackBuffer.Create(CONSTANT_SIZE, MemoryLocation::HOST_READBACK));
+
+                TestCommandBuffer commandBuffer(device);
+
+                auto IsIntact = [&](const InFlightConstants& constants) {
+                    if (!commandBuffer.Begin())
+                        return false;
+
+                    device.core.CmdCopyBuffer(*commandBuffer.commandBuffer, *readbackBuffer.buffer, 0, *constantBuffer, constants.offset, CONSTANT_SIZE);
+
+                    if (!commandBuffer.Submit())
+                        return false;
+
+                    const uint8_t* mapped = (const uint8_t*)device.core.MapBuffer(*readbackBuffer.buffer, 0, WHOLE_SIZE);
+                    bool isIntact = mapped && memcmp(mapped, constants.data.data(), constants.data.size()) == 0;
+                    device.core.UnmapBuffer(*readbackBuffer.buffer);
+
+                    return isIntact;
+                };
+
+                std::mt19937 random(42);
+                std::deque<InFlightConstants> inFlightConstants;
+                uint64_t gpuFenceValue = 0;
+                uint32_t previousOffset = 0;
+                uint32_t wrapNum = 0;
+                uint32_t rejectedNum = 0;
+
+                for (uint32_t frame = 0; frame < FRAME_NUM; frame++) {
+                    std::vector<InFlightConstants> frameConstants(BATCH_SIZE + 1);
+                    for (InFlightConstants& constants : frameConstants) {
+                        constants.data.resize(CONSTANT_SIZE);
+                        for (uint8_t& byte : constants.data)
+                            byte = (uint8_t)random();
+
+                        constants.fenceValue = frame + 1;
+                    }
+
+                    ConstantBufferUpdateRequestDesc constantBufferUpdateRequestDescs[BATCH_SIZE] = {};
+                    for (uint32_t i = 0; i < BATCH_SIZE; i++) {
+                        constantBufferUpdateRequestDescs[i].data = frameConstants[i].data.data();
+                        constantBufferUpdateRequestDescs[i].dataSize = CONSTANT_SIZE;
+                    }
+
+                    uint32_t offsets[BATCH_SIZE] = {};
+                    device.streamer.UpdateStreamerConstantBuffers(*streamer, constantBufferUpdateRequestDescs, BATCH_SIZE, offsets);
+
+                    for (uint32_t i = 0; i < BATCH_SIZE; i++)
+                        frameConstants[i].offset = offsets[i];
+
+                    frameConstants[BATCH_SIZE].offset = device.streamer.UpdateStreamerConstantBuffer(*streamer, frameConstants[BATCH_SIZE].data.data(), CONSTANT_SIZE);
+
+                    // Constants of this frame are aligned, don't overlap and are intact (or rejected, if the ring can't be freed)
+                    for (const InFlightConstants& constants : frameConstants) {
+                        if (constants.offset == INVALID_CONSTANT_OFFSET) {
+                            rejectedNum++;
+                            continue;
+                        }
+
+                        TEST_CHECK(constants.offset % alignment == 0 && constants.offset + CONSTANT_SIZE <= streamerDesc.constantBufferSize);
+                        TEST_CHECK(IsIntact(constants));
+
+                        if (constants.offset < previousOffset)
+                            wrapNum++;
+
+                        previousOffset = constants.offset;
+                    }
+
+                    if (useFence)
+                        device.streamer.SetStreamerFenceValue(*streamer, frame + 1);
+
+                    TEST_CHECK(device.streamer.CopyStreamerUpdateRequests(*streamer) == Result::SUCCESS);
+
+                    for (InFlightConstants& constants : frameConstants)
+                        inFlightConstants.push_back(std::move(constants));
+
+                    // The GPU reads constants of completed frames, then signals (see "TestStreamerRing" for the lag)
+                    uint64_t targetFenceValue = frame + 1 > FRAME_IN_FLIGHT_NUM + 1 ? frame - FRAME_IN_FLIGHT_NUM : 0;
+
+                    for (; gpuFenceValue < targetFenceValue; gpuFenceValue++) {
+                        while (!inFlightConstants.empty() && inFlightConstants.front().fenceValue <= gpuFenceValue + 1) {
+                            // "Wait" returns immediately in NONE, only the big ring proves it
+                            if (!isRingSmall) {
+                                TEST_CHECK(IsIntact(inFlightConstants.front()));
+                            }
+
+                            inFlightConstants.pop_front();
+                        }
+
+                        FenceSubmitDesc fenceSubmitDesc = {};
+                        fenceSubmitDesc.fence = fence;
+                        fenceSubmitDesc.value = gpuFenceValue + 1;
+
+                        QueueSubmitDesc queueSubmitDesc = {};
+                        queueSubmitDesc.signalFences = &fenceSubmitDesc;
+                        queueSubmitDesc.signalFenceNum = 1;
+
+                        device.core.QueueSubmit(*device.queue, queueSubmitDesc);
+                    }
+                }
+
+                printf("    validation %s, %s, %s ring: %u wraps, %u rejected\n", enableValidation ? "on" : "off", useFence ? "fence" : "frame counting",
+                    isRingSmall ? "small" : "big", wrapNum, rejectedNum);
+
+                // Frames in flight hold the small ring, until they are counted off
+                TEST_CHECK(wrapNum);
+                TEST_CHECK(messageCounters.warningNum == 0);
+                TEST_CHECK(messageCounters.errorNum == rejectedNum);
+
+                if (isRingSmall && !useFence) {
+                    TEST_CHECK(rejectedNum);
+                } else {
+                    TEST_CHECK(rejectedNum == 0);
+                }
+
+                // Constants bigger than the ring are rejected
+                std::vector<uint8_t> bigConstants(streamerDesc.constantBufferSize + 1);
+                TEST_CHECK(device.streamer.UpdateStreamerConstantBuffer(*streamer, bigConstants.data(), (uint32_t)bigConstants.size()) == INVALID_CONSTANT_OFFSET);
+                TEST_CHECK(messageCounters.errorNum == rejectedNum + 1);
+
+                device.streamer.DestroyStreamer(*streamer);
+                device.core.DestroyFence(*fence);
+            }
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,190 @@
+// © 2021 NVIDIA Corporation
+
+#include "Tests.h"
+
+#include <algorithm>
+#include <random>
+
+using namespace nri;
+
+// A synthetic frame graph: every third resource is a texture, the rest are buffers of random sizes living for up to a quarter of the passes
+struct TestFrameGraph {
+    TestDevice& device;
+    std::vector<TransientResourceDesc> resources;
+    std::vector<uint64_t> bufferSizes;
+    TransientPool* transientPool = nullptr;
+
+    inline TestFrameGraph(TestDevice& testDevice)
+        : device(testDevice) {
+    }
+
+    ~TestFrameGraph() {
+        for (const TransientResourceDesc& resource : resources) {
+            if (resource.buffer)
+                device.core.DestroyBuffer(*resource.buffer);
+            if (resource.texture)
+                device.core.DestroyTexture(*resource.texture);
+        }
+
+        if (transientPool)
+            device.helper.DestroyTransientPool(*transientPool);
+    }
+
+    inline bool CreateResources(uint32_t resourceNum, uint32_t passNum) {
+        std::mt19937 random(resourceNum * 31 + passNum);
+
+        resources.resize(resourceNum, {});
+        bufferSizes.resize(resourceNum, 0);
+
+        for (uint32_t i = 0; i < resourceNum; i++) {
+            TransientResourceDesc& resource = resources[i];
+            resource.firstPass = (uint32_t)(random() % passNum);
+            resource.lastPass = std::min(passNum - 1, resource.firstPass + (uint32_t)(random() % (passNum / 4 + 1)));
+            resource.firstUse = {AccessBits::COPY_DESTINATION, Layout::COPY_DESTINATION, StageBits::COPY};
+            resource.lastUse = {AccessBits::SHADER_RESOURCE, Layout::SHADER_RESOURCE, StageBits::FRAGMENT_SHADER};
+
+            if (i % 3 == 0) {
+                TextureDesc textureDesc = {};
+                textureDesc.type = TextureType::TEXTURE_2D;
+                textureDesc.format = Format::RGBA8_UNORM;
+                textureDesc.width = (Dim_t)(16 << (random() % 4));
+                textureDesc.height = textureDesc.width;
+                textureDesc.mipNum = 1;
+                textureDesc.layerNum = 1;
+
+                if (device.core.CreateTexture(*device.device, textureDesc, resource.texture) != Result::SUCCESS)
+                    return false;
+            } else {
+                BufferDesc bufferDesc = {};
+                bufferDesc.size = 256 + random() % 65536;
+                bufferSizes[i] = bufferDesc.size;
+
+                if (device.core.CreateBuffer(*device.device, bufferDesc, resource.buffer) != Result::SUCCESS)
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    inline bool CreatePool() {
+        TransientPoolDesc transientPoolDesc = {};
+        transientPoolDesc.resources = resources.data();
+        transientPoolDesc.resourceNum = (uint32_t)resources.size();
+        transientPoolDesc.memoryLocation = MemoryLocation::HOST_UPLOAD;
+
+        return device.helper.CreateTransientPool(*device.device, transientPoolDesc, transientPool) == Result::SUCCESS;
+    }
+};
+
+// Buffers with overlapping lifetimes never share bytes, data written at the first pass survives until the last pass,
+// and every resource gets exactly one barrier, in the pass where it starts
+bool TestTransientPoolAliasing() {
+    constexpr uint32_t RESOURCE_NUM = 300;
+    constexpr uint32_t PASS_NUM = 40;
+
+    for (bool enableValidation : {false, true}) {
+        TestDevice device;
+        TEST_CHECK(device.Create(enableValidation));
+
+        TestFrameGraph frameGraph(device);
+        TEST_CHECK(frameGraph.CreateResources(RESOURCE_NUM, PASS_NUM));
+        TEST_CHECK(frameGraph.CreatePool());
+
+        const std::vector<TransientResourceDesc>& resources = frameGraph.resources;
+        const std::vector<uint64_t>& bufferSizes = frameGraph.bufferSizes;
+
+        // Host memory: mapped pointers are the placement
+        std::vector<const uint8_t*> placements(RESOURCE_NUM, nullptr);
+        for (uint32_t i = 0; i < RESOURCE_NUM; i++) {
+            if (resources[i].buffer) {
+                placements[i] = (const uint8_t*)device.core.MapBuffer(*resources[i].buffer, 0, WHOLE_SIZE);
+                device.core.UnmapBuffer(*resources[i].buffer);
+                TEST_CHECK(placements[i]);
+            }
+        }
+
+        for (uint32_t i = 0; i < RESOURCE_NUM; i++) {
+            for (uint32_t j = i + 1; j < RESOURCE_NUM; j++) {
+                if (!placements[i] || !placements[j])
+                    continue;
+
+                bool isLifetimeOverlapping = resources[i].firstPass <= resources[j].lastPass && resources[j].firstPass <= resources[i].lastPass;
+                bool isMemoryOverlapping = placements[i] < placements[j] + bufferSizes[j] && placements[j] < placements[i] + bufferSizes[i];
+                TEST_CHECK(!(isLifetimeOverlapping && isMemoryOverlapping));
+            }
+        }
+
+        // Simulate the frame
+        uint32_t barrierNum = 0;
+        for (uint32_t pass = 0; pass < PASS_NUM; pass++) {
+            BarrierGroupDesc barrierGroupDesc = {};
+            device.helper.GetTransientPoolBarriers(*frameGraph.transientPool, pass, barrierGroupDesc);
+            barrierNum += barrierGroupDesc.bufferNum + barrierGroupDesc.textureNum;
+
+            for (uint32_t i = 0; i < barrierGroupDesc.bufferNum; i++)
+                TEST_CHECK(barrierGroupDesc.buffers[i].after.access == AccessBits::COPY_DESTINATION);
+
+            for (uint32_t i = 0; i < RESOURCE_NUM; i++) {
+                if (resources[i].buffer && resources[i].firstPass == pass) {
+                    uint8_t* mapped = (uint8_t*)device.core.MapBuffer(*resources[i].buffer, 0, WHOLE_SIZE);
+                    memset(mapped, (int)(i * 7 + 1), (size_t)bufferSizes[i]);
+                    device.core.UnmapBuffer(*resources[i].buffer);
+                }
+            }
+
+            for (uint32_t i = 0; i < RESOURCE_NUM; i++) {
+                if (resources[i].buffer && resources[i].lastPass == pass) {
+                    const uint8_t* mapped = (const uint8_t*)device.core.MapBuffer(*resources[i].buffer, 0, WHOLE_SIZE);
+
+                    bool isDataValid = true;
+                    for (uint64_t k = 0; k < bufferSizes[i]; k++)
+                        isDataValid = isDataValid && mapped[k] == (uint8_t)(i * 7 + 1);
+
+                    device.core.UnmapBuffer(*resources[i].buffer);
+                    TEST_CHECK(isDataValid);
+                }
+            }
+        }
+
+        TEST_CHECK(barrierNum == RESOURCE_NUM);
+    }
+
+    return true;
+}
+
+// Solver time and peak memory on growing frame graphs, compared against the live peak (the lower bound)
+bool TestTransientPoolSolver() {
+    TestDevice device;
+    TEST_CHECK(device.Create(false));
+
+    static const uint32_t sizes[][2] = {
+        {64, 16},
+        {300, 40},
+        {1000, 100},
+        {3000, 200},
+    };
+
+    for (const auto& size : sizes) {
+        TestFrameGraph frameGraph(device);
+        TEST_CHECK(frameGraph.CreateResources(size[0], size[1]));
+
+        TestTimer timer;
+        TEST_CHECK(frameGraph.CreatePool());
+        double ns = timer.GetNanoseconds();
+
+        TransientPoolStats transientPoolStats = {};
+        device.helper.GetTransientPoolStats(*frameGraph.transientPool, transientPoolStats);
+
+        double lowerBoundRatio = double(transientPoolStats.memorySize) / double(transientPoolStats.livePeakSize);
+        printf("    %u resources, %u passes: %.2f ms, %llu bytes (%.2fx the lower bound, %.1f%% of unaliased) in %u allocation(s)\n",
+            size[0], size[1], ns / 1000000.0, (unsigned long long)transientPoolStats.memorySize, lowerBoundRatio,
+            100.0 * double(transientPoolStats.memorySize) / double(transientPoolStats.unaliasedSize), transientPoolStats.memoryNum);
+
+        TEST_CHECK(transientPoolStats.memorySize >= transientPoolStats.livePeakSize);
+        TEST_CHECK(transientPoolStats.memorySize <= transientPoolStats.unaliasedSize);
+        TEST_CHECK(lowerBoundRatio < 1.25);
+    }
+
+    return true;
+}
@@ -0,0 +1,119 @@
+// © 2021 NVIDIA Corporation
+
+#include "Tests.h"
+
+using namespace nri;
+
+struct ValidationTier {
+    const char* name;
+    bool enableValidation;
+    ValidationDesc validationDesc;
+    uint32_t barrierErrorDivisor; // 0 - invalid barriers are not reported
+};
+
+static void CountErrors(Message messageType, const char*, uint32_t, const char*, void* userArg) {
+    if (messageType == Message::ERROR)
+        (*(uint32_t*)userArg)++;
+}
+
+// Per-call overhead of each tier for "CmdBarrier" (16 buffers + 16 textures, expensive checks) and "CmdDispatch" (state checks only).
+// An invalid barrier is reported on every sampled call, while state-machine errors are reported by every tier
+bool TestValidationSampling() {
+    constexpr uint32_t BARRIER_NUM = 16;
+    constexpr uint32_t CALL_NUM = 200000;
+
+    static const ValidationTier tiers[] = {
+        {"off", false, {}, 0},
+        {"full", true, {}, 1},
+        {"every 16th call", true, {ValidationBits::NONE, 16}, 16},
+        {"every 256th call", true, {ValidationBits::NONE, 256}, 256},
+        {"state only", true, {ValidationBits::ALL, 0}, 0},
+    };
+
+    for (bool isBarrierInvalid : {false, true}) {
+        printf(isBarrierInvalid ? "    with an invalid barrier:\n" : "    valid barriers:\n");
+
+        for (const ValidationTier& tier : tiers) {
+            uint32_t errorNum = 0;
+
+            CallbackInterface callbackInterface = {};
+            callbackInterface.MessageCallback = CountErrors;
+            callbackInterface.AbortExecution = [](void*) {};
+            callbackInterface.userArg = &errorNum;
+
+            TestDevice device;
+            TEST_CHECK(device.Create(tier.enableValidation, &tier.validationDesc, &callbackInterface));
+
+            Buffer* buffers[BARRIER_NUM] = {};
+            Texture* textures[BARRIER_NUM] = {};
+            BufferBarrierDesc bufferBarriers[BARRIER_NUM] = {};
+            TextureBarrierDesc textureBarriers[BARRIER_NUM] = {};
+
+            for (uint32_t i = 0; i < BARRIER_NUM; i++) {
+                BufferDesc bufferDesc = {};
+                bufferDesc.size = 256;
+                bufferDesc.usage = BufferUsageBits::SHADER_RESOURCE;
+                TEST_CHECK(device.core.CreateBuffer(*device.device, bufferDesc, buffers[i]) == Result::SUCCESS);
+
+                TextureDesc textureDesc = {};
+                textureDesc.type = TextureType::TEXTURE_2D;
+                textureDesc.format = Format::RGBA8_UNORM;
+                textureDesc.width = 16;
+                textureDesc.height = 16;
+                textureDesc.mipNum = 1;
+                textureDesc.layerNum = 1;
+                textureDesc.usage = TextureUsageBits::SHADER_RESOURCE;
+                TEST_CHECK(device.core.CreateTexture(*device.device, textureDesc, textures[i]) == Result::SUCCESS);
+
+                bufferBarriers[i].buffer = buffers[i];
+                bufferBarriers[i].before = {AccessBits::COPY_DESTINATION, StageBits::COPY};
+                bufferBarriers[i].after = {AccessBits::SHADER_RESOURCE, StageBits::FRAGMENT_SHADER};
+
+                textureBarriers[i].texture = textures[i];
+                textureBarriers[i].before = {AccessBits::COPY_DESTINATION, Layout::COPY_DESTINATION, StageBits::COPY};
+                textureBarriers[i].after = {AccessBits::SHADER_RESOURCE, Layout::SHADER_RESOURCE, StageBits::FRAGMENT_SHADER};
+                textureBarriers[i].mipNum = REMAINING_MIPS;
+                textureBarriers[i].layerNum = REMAINING_LAYERS;
+            }
+
+            if (isBarrierInvalid)
+                bufferBarriers[3].after.access = AccessBits::VERTEX_BUFFER; // not supported by the usage
+
+            BarrierGroupDesc barrierGroupDesc = {};
+            barrierGroupDesc.buffers = bufferBarriers;
+            barrierGroupDesc.bufferNum = BARRIER_NUM;
+            barrierGroupDesc.textures = textureBarriers;
+            barrierGroupDesc.textureNum = BARRIER_NUM;
+
+            TestCommandBuffer commandBuffer(device);
+            TEST_CHECK(commandBuffer.Begin());
+
+            TestTimer barrierTimer;
+            for (uint32_t i = 0; i < CALL_NUM; i++)
+                device.core.CmdBarrier(*commandBuffer.commandBuffer, barrierGroupDesc);
+            double barrierNs = barrierTimer.GetNanoseconds();
+
+            TestTimer dispatchTimer;
+            for (uint32_t i = 0; i < CALL_NUM; i++)
+                device.core.CmdDispatch(*commandBuffer.commandBuffer, {1, 1, 1});
+            double dispatchNs = dispatchTimer.GetNanoseconds();
+
+            printf("        %-18s CmdBarrier: %6.1f ns/call, CmdDispatch: %4.1f ns/call, errors %u\n", tier.name, barrierNs / CALL_NUM, dispatchNs / CALL_NUM, errorNum);
+
+            uint32_t expectedErrorNum = isBarrierInvalid && tier.barrierErrorDivisor ? (CALL_NUM + tier.barrierErrorDivisor - 1) / tier.barrierErrorDivisor : 0;
+            TEST_CHECK(errorNum == expectedErrorNum);
+
+            // A state-machine error: not in the recording state
+            TEST_CHECK(device.core.EndCommandBuffer(*commandBuffer.commandBuffer) == Result::SUCCESS);
+            device.core.CmdDispatch(*commandBuffer.commandBuffer, {1, 1, 1});
+            TEST_CHECK(errorNum == expectedErrorNum + (tier.enableValidation ? 1 : 0));
+
+            for (uint32_t i = 0; i < BARRIER_NUM; i++) {
+                device.core.DestroyBuffer(*buffers[i]);
+                device.core.DestroyTexture(*textures[i]);
+            }
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,143 @@
+// © 2021 NVIDIA Corporation
+
+// Headless checks of the shared code on the NONE backend in host memory mode (buffers and memory are real host allocations,
+// copies are executed on the CPU at submit). Timings are printed for reference only, they are not checked
+
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "NRI.h"
+
+#include "Extensions/NRIDeviceCreation.h"
+#include "Extensions/NRIHelper.h"
+#include "Extensions/NRIStreamer.h"
+
+#define TEST_CHECK(condition) \
+    if (!(condition)) { \
+        printf("    FAILED: %s (%s:%d)\n", #condition, __FILE__, __LINE__); \
+        return false; \
+    }
+
+struct TestDevice {
+    nri::Device* device = nullptr;
+    nri::Queue* queue = nullptr;
+    nri::CoreInterface core = {};
+    nri::HelperInterface helper = {};
+    nri::StreamerInterface streamer = {};
+
+    ~TestDevice() {
+        if (device)
+            nriDestroyDevice(*device);
+    }
+
+    inline bool Create(bool enableValidation, const nri::ValidationDesc* validationDesc = nullptr, const nri::CallbackInterface* callbackInterface = nullptr,
+        const nri::AllocationCallbacks* allocationCallbacks = nullptr) {
+        nri::DeviceCreationDesc deviceCreationDesc = {};
+        deviceCreationDesc.graphicsAPI = nri::GraphicsAPI::NONE;
+        deviceCreationDesc.enableNONEHostMemory = true;
+        deviceCreationDesc.enableNRIValidation = enableValidation;
+        if (validationDesc)
+            deviceCreationDesc.validationDesc = *validationDesc;
+        if (callbackInterface)
+            deviceCreationDesc.callbackInterface = *callbackInterface;
+        if (allocationCallbacks)
+            deviceCreationDesc.allocationCallbacks = *allocationCallbacks;
+
+        if (nriCreateDevice(deviceCreationDesc, device) != nri::Result::SUCCESS)
+            return false;
+
+        nriGetInterface(*device, NRI_INTERFACE(nri::CoreInterface), &core);
+        nriGetInterface(*device, NRI_INTERFACE(nri::HelperInterface), &helper);
+        nriGetInterface(*device, NRI_INTERFACE(nri::StreamerInterface), &streamer);
+
+        return core.GetQueue(*device, nri::QueueType::GRAPHICS, 0, queue) == nri::Result::SUCCESS;
+    }
+};
+
+// A command buffer executed synchronously
+struct TestCommandBuffer {
+    TestDevice& device;
+    nri::CommandAllocator* commandAllocator = nullptr;
+    nri::CommandBuffer* commandBuffer = nullptr;
+
+    inline TestCommandBuffer(TestDevice& testDevice)
+        : device(testDevice) {
+    }
+
+    ~TestCommandBuffer() {
+        if (commandBuffer)
+            device.core.DestroyCommandBuffer(*commandBuffer);
+        if (commandAllocator)
+            device.core.DestroyCommandAllocator(*commandAllocator);
+    }
+
+    inline bool Begin() {
+        if (!commandBuffer) {
+            if (device.core.CreateCommandAllocator(*device.queue, commandAllocator) != nri::Result::SUCCESS)
+                return false;
+            if (device.core.CreateCommandBuffer(*commandAllocator, commandBuffer) != nri::Result::SUCCESS)
+                return false;
+        }
+
+        return device.core.BeginCommandBuffer(*commandBuffer, nullptr) == nri::Result::SUCCESS;
+    }
+
+    inline bool Submit() {
+        if (device.core.EndCommandBuffer(*commandBuffer) != nri::Result::SUCCESS)
+            return false;
+
+        nri::QueueSubmitDesc queueSubmitDesc = {};
+        queueSubmitDesc.commandBuffers = &commandBuffer;
+        queueSubmitDesc.commandBufferNum = 1;
+
+        device.core.QueueSubmit(*device.queue, queueSubmitDesc);
+
+        return device.helper.WaitForIdle(*device.queue) == nri::Result::SUCCESS;
+    }
+};
+
+// A buffer bound to host-visible memory, to check results via mapping
+struct TestBuffer {
+    TestDevice& device;
+    nri::Buffer* buffer = nullptr;
+    nri::Memory* memory = nullptr;
+
+    inline TestBuffer(TestDevice& testDevice)
+        : device(testDevice) {
+    }
+
+    ~TestBuffer() {
+        if (buffer)
+            device.core.DestroyBuffer(*buffer);
+        if (memory)
+            device.core.FreeMemory(*memory);
+    }
+
+    inline bool Create(uint64_t size, nri::MemoryLocation memoryLocation = nri::MemoryLocation::HOST_UPLOAD) {
+        nri::BufferDesc bufferDesc = {};
+        bufferDesc.size = size;
+
+        if (device.core.CreateBuffer(*device.device, bufferDesc, buffer) != nri::Result::SUCCESS)
+            return false;
+
+        nri::ResourceGroupDesc resourceGroupDesc = {};
+        resourceGroupDesc.memoryLocation = memoryLocation;
+        resourceGroupDesc.buffers = &buffer;
+        resourceGroupDesc.bufferNum = 1;
+
+        return device.helper.AllocateAndBindMemory(*device.device, resourceGroupDesc, &memory) == nri::Result::SUCCESS;
+    }
+};
+
+struct TestTimer {
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+    inline double GetNanoseconds() const {
+        return std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+};
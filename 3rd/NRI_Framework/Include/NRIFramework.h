@@ -84,6 +84,7 @@ public:
     void BeginUI();
     //      Imgui::
     void EndUI(const nri::StreamerInterface& streamerInterface, nri::Streamer& streamer);
+    void ShowStreamerStats(const nri::StreamerInterface& streamerInterface, nri::Streamer& streamer); // called by "EndUI" if "m_ShowStreamerStats"
 
     // Render
     virtual void RenderFrame(uint32_t frameIndex) = 0;
@@ -152,6 +153,7 @@ protected:
     bool m_DebugAPI = false;
     bool m_DebugNRI = false;
     bool m_IsActive = true;
+    bool m_ShowStreamerStats = false;
 
     // Private
 private:
@@ -179,7 +181,6 @@ public:
 
 private:
     // UI
-    std::vector<uint8_t> m_UiData;
     nri::DescriptorPool* m_DescriptorPool = nullptr;
     nri::DescriptorSet* m_DescriptorSet = nullptr;
     nri::Descriptor* m_FontShaderResource = nullptr;
@@ -193,6 +194,12 @@ private:
     uint64_t m_IbOffset = 0;
     uint64_t m_VbOffset = 0;
 
+    // Streamer stats (history in KB)
+    std::array<float, 128> m_StreamerRequestedHistory = {};
+    std::array<float, 128> m_StreamerCopiedHistory = {};
+    std::array<float, 128> m_StreamerInFlightHistory = {};
+    uint32_t m_StreamerStatsFrame = 0;
+
     nri::Window m_NRIWindow = {};
 
     // Rendering
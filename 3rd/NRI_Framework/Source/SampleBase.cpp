@@ -753,6 +753,9 @@ void SampleBase::EndUI(const nri::StreamerInterface &streamerInterface,
   if (!HasUserInterface())
     return;
 
+  if (m_ShowStreamerStats)
+    ShowStreamerStats(streamerInterface, streamer);
+
   ImGui::EndFrame();
   ImGui::Render();
 
@@ -767,11 +770,19 @@ void SampleBase::EndUI(const nri::StreamerInterface &streamerInterface,
   if (!totalDataSize)
     return;
 
-  if (m_UiData.size() < totalDataSize)
-    m_UiData.resize(totalDataSize);
+  // Reserve space in the streamer and repack geometry directly into it
+  nri::BufferUpdateRequestDesc bufferUpdateRequestDesc = {};
+  bufferUpdateRequestDesc.dataSize = totalDataSize;
+
+  uint8_t *indexData =
+      (uint8_t *)streamerInterface.ReserveStreamerBufferUpdateRequest(
+          streamer, bufferUpdateRequestDesc, m_IbOffset);
+  if (!indexData) {
+    m_VbOffset = m_IbOffset; // nothing to render
+    return;
+  }
 
-  // Repack geometry
-  uint8_t *indexData = m_UiData.data();
+  m_VbOffset = m_IbOffset + indexDataSize;
   ImDrawVertOpt *vertexData = (ImDrawVertOpt *)(indexData + indexDataSize);
 
   auto float2_to_unorm_16_16 = [](const vec2 &v) -> uint32_t {
@@ -813,15 +824,51 @@ void SampleBase::EndUI(const nri::StreamerInterface &streamerInterface,
     memcpy(indexData, drawList.IdxBuffer.Data, size);
     indexData += size;
   }
+}
 
-  // Add update request
-  nri::BufferUpdateRequestDesc bufferUpdateRequestDesc = {};
-  bufferUpdateRequestDesc.data = m_UiData.data();
-  bufferUpdateRequestDesc.dataSize = m_UiData.size();
-
-  m_IbOffset = streamerInterface.AddStreamerBufferUpdateRequest(
-      streamer, bufferUpdateRequestDesc);
-  m_VbOffset = m_IbOffset + indexDataSize;
+void SampleBase::ShowStreamerStats(
+    const nri::StreamerInterface &streamerInterface, nri::Streamer &streamer) {
+  nri::StreamerStats stats = {};
+  streamerInterface.GetStreamerStats(streamer, stats);
+
+  uint32_t historyIndex =
+      m_StreamerStatsFrame++ % (uint32_t)m_StreamerRequestedHistory.size();
+  m_StreamerRequestedHistory[historyIndex] = stats.requestedSize / 1024.0f;
+  m_StreamerCopiedHistory[historyIndex] = stats.copiedSize / 1024.0f;
+  m_StreamerInFlightHistory[historyIndex] = stats.inFlightSize / 1024.0f;
+
+  // Plot starting from the oldest entry
+  int32_t historySize = (int32_t)m_StreamerRequestedHistory.size();
+  int32_t historyOffset = (int32_t)(historyIndex + 1) % historySize;
+  float capacity = stats.dynamicBufferSize / 1024.0f;
+  ImVec2 plotSize = ImVec2(0.0f, 40.0f);
+
+  ImGui::SetNextWindowPos(ImVec2(10.0f, 10.0f), ImGuiCond_Once);
+  ImGui::SetNextWindowSize(ImVec2(320.0f, 0.0f), ImGuiCond_Once);
+  ImGui::Begin("Streamer", &m_ShowStreamerStats);
+  {
+    ImGui::Text("Requests: %u buffers, %u textures", stats.bufferRequestNum,
+                stats.textureRequestNum);
+    ImGui::Text("Upload commands: %u (%u skipped)", stats.uploadCommandNum,
+                stats.skippedRequestNum);
+    ImGui::Text("Requested: %.1f KB (peak %.1f KB)",
+                stats.requestedSize / 1024.0f,
+                stats.peakRequestedSize / 1024.0f);
+    ImGui::PlotLines("##Requested", m_StreamerRequestedHistory.data(),
+                     historySize, historyOffset, nullptr, 0.0f, FLT_MAX,
+                     plotSize);
+    ImGui::Text("Copied: %.1f KB", stats.copiedSize / 1024.0f);
+    ImGui::PlotLines("##Copied", m_StreamerCopiedHistory.data(), historySize,
+                     historyOffset, nullptr, 0.0f, FLT_MAX, plotSize);
+    ImGui::Text("In flight: %.1f KB of %.1f KB", stats.inFlightSize / 1024.0f,
+                capacity);
+    ImGui::PlotLines("##InFlight", m_StreamerInFlightHistory.data(),
+                     historySize, historyOffset, nullptr, 0.0f, capacity,
+                     plotSize);
+    ImGui::Text("Grow: %u, shrink: %u, garbage: %u", stats.growNum,
+                stats.shrinkNum, stats.garbageBufferNum);
+  }
+  ImGui::End();
 }
 
 void SampleBase::RenderUI(const nri::CoreInterface &NRI,
@@ -1087,6 +1134,7 @@ void SampleBase::InitCmdLineDefault(cmdline::parser &cmdLine) {
   cmdLine.add<uint32_t>("dpiMode", 0, "DPI mode", false, m_DpiMode);
   cmdLine.add("debugAPI", 0, "enable graphics API validation layer");
   cmdLine.add("debugNRI", 0, "enable NRI validation layer");
+  cmdLine.add("streamerStats", 0, "show streamer statistics");
 }
 
 void SampleBase::ReadCmdLineDefault(cmdline::parser &cmdLine) {
@@ -1097,6 +1145,7 @@ void SampleBase::ReadCmdLineDefault(cmdline::parser &cmdLine) {
   m_VsyncInterval = (uint8_t)cmdLine.get<uint32_t>("vsyncInterval");
   m_DebugAPI = cmdLine.exist("debugAPI");
   m_DebugNRI = cmdLine.exist("debugNRI");
+  m_ShowStreamerStats = cmdLine.exist("streamerStats");
   m_DpiMode = cmdLine.get<uint32_t>("dpiMode");
 }
 
@@ -160,6 +160,9 @@ bool Sample::Initialize(nri::GraphicsAPI graphicsAPI) {
 			nri::nriGetInterface(*m_Device, NRI_INTERFACE(nri::SwapChainInterface),
 					(nri::SwapChainInterface *)&NRI));
 
+	// Fences
+	NRI_ABORT_ON_FAILURE(NRI.CreateFence(*m_Device, 0, m_FrameFence));
+
 	// Create streamer
 	nri::StreamerDesc streamerDesc = {};
 	streamerDesc.dynamicBufferMemoryLocation = nri::MemoryLocation::HOST_UPLOAD;
@@ -167,15 +170,14 @@ bool Sample::Initialize(nri::GraphicsAPI graphicsAPI) {
 			nri::BufferUsageBits::VERTEX_BUFFER | nri::BufferUsageBits::INDEX_BUFFER;
 	streamerDesc.constantBufferMemoryLocation = nri::MemoryLocation::HOST_UPLOAD;
 	streamerDesc.frameInFlightNum = BUFFERED_FRAME_MAX_NUM;
+	streamerDesc.fence = m_FrameFence;
+	streamerDesc.shrinkFrameNum = 120;
 	NRI_ABORT_ON_FAILURE(NRI.CreateStreamer(*m_Device, streamerDesc, m_Streamer));
 
 	// Command queue
 	NRI_ABORT_ON_FAILURE(
 			NRI.GetQueue(*m_Device, nri::QueueType::GRAPHICS, 0, m_GraphicsQueue));
 
-	// Fences
-	NRI_ABORT_ON_FAILURE(NRI.CreateFence(*m_Device, 0, m_FrameFence));
-
 	// Swap chain
 	nri::Format swapChainFormat;
 	{
@@ -660,6 +662,9 @@ bool Sample::Initialize(nri::GraphicsAPI graphicsAPI) {
 				descriptorRangeUpdateDescs);
 	}
 
+	nri::DataUploader *dataUploader = nullptr;
+	nri::UploadTicket uploadTicket = {};
+
 	{ // Upload data
 		std::vector<uint8_t> geometryBufferData(indexDataAlignedSize +
 				vertexDataSize);
@@ -707,18 +712,25 @@ bool Sample::Initialize(nri::GraphicsAPI graphicsAPI) {
 		std::vector<nri::BufferUploadDesc> uploadDescArray = { bufferData };
 		std::vector<nri::TextureUploadDesc> texUploadDescArray = { textureData, textureData1, textureData2 };
 
-		NRI_ABORT_ON_FAILURE(NRI.UploadData(*m_GraphicsQueue, texUploadDescArray.data(), texUploadDescArray.size(),
+		// Upload asynchronously, the user interface gets initialized in the meantime
+		nri::DataUploaderDesc dataUploaderDesc = {};
+		NRI_ABORT_ON_FAILURE(NRI.CreateDataUploader(*m_GraphicsQueue, dataUploaderDesc, dataUploader));
+
+		NRI_ABORT_ON_FAILURE(NRI.UploadDataAsync(*dataUploader, texUploadDescArray.data(), texUploadDescArray.size(),
 				uploadDescArray.data(),
-				uploadDescArray.size()));
+				uploadDescArray.size(), uploadTicket));
 	}
 
 	// User interface
 	bool initialized = InitUI(NRI, NRI, *m_Device, swapChainFormat);
 
+	NRI.Wait(*uploadTicket.fence, uploadTicket.value);
+	NRI.DestroyDataUploader(*dataUploader);
+
 	return initialized;
 }
 
-void Sample::PrepareFrame(uint32_t) {
+void Sample::PrepareFrame(uint32_t frameIndex) {
 	BeginUI();
 
 	ImGui::SetNextWindowPos(ImVec2(30, 30), ImGuiCond_Once);
@@ -739,6 +751,7 @@ void Sample::PrepareFrame(uint32_t) {
 	ImGui::ShowDemoWindow();
 
 	EndUI(NRI, *m_Streamer);
+	NRI.SetStreamerFenceValue(*m_Streamer, 1 + frameIndex);
 	NRI.CopyStreamerUpdateRequests(*m_Streamer);
 }
 
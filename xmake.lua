@@ -3,6 +3,13 @@ set_languages("c++20")
 
 add_requires("glfw", "glm", "assimp")
 
+-- "xmake f --nri_lock_stats=y": per-lock contention statistics (see "LockStats" in "3rd/NRI/Source/Shared/Lock.h")
+option("nri_lock_stats")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Enable per-lock contention statistics")
+option_end()
+
 
 target("Detex")
     set_kind("static")
@@ -27,6 +34,9 @@ target("NRI")
     if is_mode("debug") then
         add_defines("NRI_ENABLE_DEBUG_NAMES_AND_ANNOTATIONS")
     end
+    if has_config("nri_lock_stats") then
+        add_defines("NRI_ENABLE_LOCK_STATS=1")
+    end
     add_includedirs("3rd/NRI/Include", {public = true})
     add_includedirs("3rd/NRI/Source/Shared/", {public = true})
     add_includedirs("3rd/d3d12ma/include/", {public = true})
@@ -37,7 +47,7 @@ target("NRI")
     add_files("3rd/NRI/Source/NONE/*.cpp")
     add_files("3rd/NRI/Source/Validation/*.cpp")
     add_links("3rd/WinPixEventRuntime/bin/x64/WinPixEventRuntime.lib")
-    add_syslinks("dxgi", "d3d12", "dxguid")
+    add_syslinks("dxgi", "d3d12", "dxguid", "Synchronization")
 
 target("NRIFramework")
     set_kind("static")
@@ -57,6 +67,27 @@ target("DemoApp")
     add_packages("glfw", "glm", "assimp")
     add_files("main.cpp")
 
+-- Headless NRI checks on the NONE backend in host memory mode: "xmake build NRITests && xmake run NRITests [filter]"
+target("NRITests")
+    set_kind("binary")
+    set_default(false)
+    add_defines("NOMINMAX", "NRI_STATIC_LIBRARY", "NRI_ENABLE_NONE_SUPPORT", "NRI_ENABLE_VALIDATION_SUPPORT")
+    if has_config("nri_lock_stats") then
+        add_defines("NRI_ENABLE_LOCK_STATS=1")
+    end
+    add_includedirs("3rd/NRI/Include")
+    add_includedirs("3rd/NRI/Source/Shared/")
+    add_files("3rd/NRI/Source/Creation/*.cpp")
+    add_files("3rd/NRI/Source/Shared/*.cpp")
+    add_files("3rd/NRI/Source/NONE/*.cpp")
+    add_files("3rd/NRI/Source/Validation/*.cpp")
+    add_files("3rd/NRI/Tests/*.cpp")
+    if is_plat("windows") then
+        add_syslinks("Synchronization")
+    else
+        add_syslinks("pthread", "dl")
+    end
+
 target("ShaderCompiler")
     set_kind("phony") -- 这里可以是 phony，避免 xmake 生成实际的二进制文件
     set_default(false) -- 让它不在默认 `xmake build` 触发